@@ -0,0 +1,402 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+
+/** \file async_measurement.c
+
+	 \brief Acquisition of all devices on a separate thread
+
+The thread only touches the handles and the sample buffer which were passed to async_measurement_start. Both must not be
+used or freed by the caller until async_measurement_complete returned.
+
+All devices share the command buffers in io_operations.c, so only one measurement can run at a time in the module. The
+functions in led_analyzer.c which access the devices, free_devices and sample_buffer_free call
+async_measurement_wait_running first. This waits for the thread of a running measurement, so other accesses to the devices
+can not mix with the commands of the thread and the thread never uses freed handles or buffers. The result is kept for
+async_measurement_complete.
+
+On Linux the thread writes one byte into a pipe when it is done, the read end of the pipe can be watched by an event loop
+(async_measurement_get_fd). Windows has no file descriptor for this, the state must be polled there.
+
+ */
+
+#include "async_measurement.h"
+#include "led_analyzer.h"
+#include "sleep_ms.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#       include <windows.h>
+#else
+#       include <errno.h>
+#       include <fcntl.h>
+#       include <pthread.h>
+#       include <unistd.h>
+#endif
+
+
+struct ASYNC_MEASUREMENT_STRUCT
+{
+	/** handles of the devices, only used by the thread while the measurement is running */
+	void** apHandles;
+	/** buffer for the readings, only used by the thread while the measurement is running */
+	SAMPLE_BUFFER_T* ptBuffer;
+	/** time in ms to wait for the conversion before the devices are read */
+	unsigned int uiWaitTime;
+	/** number of devices which were read */
+	int iResult;
+	/** time of the reading of all devices in microseconds, without the wait */
+	unsigned long ulReadTime;
+	/** the thread is running (started and not completed yet) */
+	int fStarted;
+	/** the thread was joined, it is done and the result can be completed without waiting */
+	int fJoined;
+#if defined(_WIN32)
+	HANDLE hThread;
+	DWORD dwThreadId;
+#else
+	pthread_t tThread;
+	/** protects fDone */
+	pthread_mutex_t tMutex;
+	/** the thread is done */
+	int fDone;
+	/** the thread writes a byte to aiPipe[1] when it is done */
+	int aiPipe[2];
+#endif
+};
+
+
+
+/** the measurement whose thread was started and not joined yet, only one measurement can run at a time */
+static ASYNC_MEASUREMENT_T* volatile s_ptRunning = NULL;
+
+
+
+/** \brief the thread: waits for the conversion and reads all devices into the sample buffer. */
+static void async_measurement_run(ASYNC_MEASUREMENT_T* ptAsync)
+{
+	if( ptAsync->uiWaitTime!=0 )
+	{
+		sleep_ms(ptAsync->uiWaitTime);
+	}
+	ptAsync->iResult = sample_buffer_read_timed(ptAsync->apHandles, ptAsync->ptBuffer, &ptAsync->ulReadTime);
+}
+
+
+#if defined(_WIN32)
+static DWORD WINAPI async_measurement_thread(LPVOID pvParameter)
+{
+	async_measurement_run((ASYNC_MEASUREMENT_T*)pvParameter);
+	return 0;
+}
+#else
+static void* async_measurement_thread(void* pvParameter)
+{
+	ASYNC_MEASUREMENT_T* ptAsync;
+	ssize_t sizWritten;
+
+
+	ptAsync = (ASYNC_MEASUREMENT_T*)pvParameter;
+
+	/* Wait until async_measurement_start stored tThread, async_measurement_wait_running compares it. */
+	pthread_mutex_lock(&ptAsync->tMutex);
+	pthread_mutex_unlock(&ptAsync->tMutex);
+
+	async_measurement_run(ptAsync);
+
+	pthread_mutex_lock(&ptAsync->tMutex);
+	ptAsync->fDone = 1;
+	pthread_mutex_unlock(&ptAsync->tMutex);
+
+	/* The pipe is empty, one byte always fits. */
+	do
+	{
+		sizWritten = write(ptAsync->aiPipe[1], "", 1);
+	} while( sizWritten<0 && errno==EINTR );
+
+	return NULL;
+}
+#endif
+
+
+
+/** \brief waits for the thread of a measurement, the result stays in the measurement until it is completed. */
+static void async_measurement_join(ASYNC_MEASUREMENT_T* ptAsync)
+{
+	if( ptAsync->fStarted!=0 && ptAsync->fJoined==0 )
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(ptAsync->hThread, INFINITE);
+		CloseHandle(ptAsync->hThread);
+		ptAsync->hThread = NULL;
+#else
+		pthread_join(ptAsync->tThread, NULL);
+#endif
+		ptAsync->fJoined = 1;
+		if( s_ptRunning==ptAsync )
+		{
+			s_ptRunning = NULL;
+		}
+	}
+}
+
+
+
+/** \brief waits for the thread of the running measurement.
+
+This is called before the devices are accessed or handles and buffers are freed. It returns at once if no measurement is
+running or if it is called by the thread of the measurement itself. The result of the measurement is not completed, it is
+returned by the next async_measurement_complete.
+	*/
+void async_measurement_wait_running(void)
+{
+	ASYNC_MEASUREMENT_T* ptAsync;
+
+
+	ptAsync = s_ptRunning;
+	if( ptAsync!=NULL )
+	{
+#if defined(_WIN32)
+		if( GetCurrentThreadId()!=ptAsync->dwThreadId )
+#else
+		if( pthread_equal(pthread_self(), ptAsync->tThread)==0 )
+#endif
+		{
+			async_measurement_join(ptAsync);
+		}
+	}
+}
+
+
+
+/** \brief allocates an asynchronous measurement.
+
+	@return 			pointer to the measurement or NULL if no memory or no pipe could be allocated
+	*/
+ASYNC_MEASUREMENT_T* async_measurement_new(void)
+{
+	ASYNC_MEASUREMENT_T* ptAsync;
+
+
+	ptAsync = (ASYNC_MEASUREMENT_T*)calloc(1, sizeof(ASYNC_MEASUREMENT_T));
+#if !defined(_WIN32)
+	if( ptAsync!=NULL )
+	{
+		if( pipe(ptAsync->aiPipe)!=0 )
+		{
+			free(ptAsync);
+			ptAsync = NULL;
+		}
+		else
+		{
+			/* The read end is drained without blocking. Child processes must not inherit the pipe. */
+			fcntl(ptAsync->aiPipe[0], F_SETFL, fcntl(ptAsync->aiPipe[0], F_GETFL) | O_NONBLOCK);
+			fcntl(ptAsync->aiPipe[0], F_SETFD, FD_CLOEXEC);
+			fcntl(ptAsync->aiPipe[1], F_SETFD, FD_CLOEXEC);
+			pthread_mutex_init(&ptAsync->tMutex, NULL);
+		}
+	}
+#endif
+
+	return ptAsync;
+}
+
+
+
+/** \brief frees an asynchronous measurement, a running measurement is completed first.
+	@param ptAsync		pointer to the measurement, can be NULL
+	*/
+void async_measurement_free(ASYNC_MEASUREMENT_T* ptAsync)
+{
+	if( ptAsync!=NULL )
+	{
+		async_measurement_complete(ptAsync);
+#if !defined(_WIN32)
+		close(ptAsync->aiPipe[0]);
+		close(ptAsync->aiPipe[1]);
+		pthread_mutex_destroy(&ptAsync->tMutex);
+#endif
+		free(ptAsync);
+	}
+}
+
+
+
+/** \brief starts a measurement on a separate thread.
+
+The thread waits uiWaitTime ms for the conversion and reads all connected devices into the sample buffer like
+sample_buffer_read. The handles and the buffer must not be used until async_measurement_complete returned. Only one
+measurement can run at a time, this fails while another measurement is running.
+	@param ptAsync		pointer to the measurement
+	@param apHandles	array that stores ftdi2232h handles
+	@param ptBuffer		sample buffer
+	@param uiWaitTime	time to wait for the conversion in ms
+
+	@retval 0			the measurement was started
+	@retval -1			the last measurement was not completed yet, another measurement is running or the thread could not be
+						created
+	*/
+int async_measurement_start(ASYNC_MEASUREMENT_T* ptAsync, void** apHandles, SAMPLE_BUFFER_T* ptBuffer, unsigned int uiWaitTime)
+{
+	int iResult;
+
+
+	/* be pessimistic */
+	iResult = -1;
+
+	if( ptAsync->fStarted==0 && s_ptRunning==NULL )
+	{
+		ptAsync->apHandles = apHandles;
+		ptAsync->ptBuffer = ptBuffer;
+		ptAsync->uiWaitTime = uiWaitTime;
+		ptAsync->iResult = 0;
+		ptAsync->fJoined = 0;
+		/* Set the running measurement before the thread starts, it checks it in the functions of led_analyzer.c. */
+		s_ptRunning = ptAsync;
+#if defined(_WIN32)
+		ptAsync->hThread = CreateThread(NULL, 0, async_measurement_thread, ptAsync, CREATE_SUSPENDED, &ptAsync->dwThreadId);
+		if( ptAsync->hThread!=NULL )
+		{
+			ptAsync->fStarted = 1;
+			ResumeThread(ptAsync->hThread);
+			iResult = 0;
+		}
+#else
+		ptAsync->fDone = 0;
+		pthread_mutex_lock(&ptAsync->tMutex);
+		if( pthread_create(&ptAsync->tThread, NULL, async_measurement_thread, ptAsync)==0 )
+		{
+			ptAsync->fStarted = 1;
+			iResult = 0;
+		}
+		pthread_mutex_unlock(&ptAsync->tMutex);
+#endif
+		if( iResult!=0 )
+		{
+			s_ptRunning = NULL;
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief returns the state of a measurement without waiting.
+	@param ptAsync		pointer to the measurement
+
+	@return 			ASYNC_MEASUREMENT_IDLE, ASYNC_MEASUREMENT_RUNNING or ASYNC_MEASUREMENT_DONE
+	*/
+int async_measurement_poll(ASYNC_MEASUREMENT_T* ptAsync)
+{
+	int iState;
+
+
+	iState = ASYNC_MEASUREMENT_IDLE;
+	if( ptAsync->fStarted!=0 )
+	{
+#if defined(_WIN32)
+		if( ptAsync->fJoined!=0 || WaitForSingleObject(ptAsync->hThread, 0)==WAIT_OBJECT_0 )
+		{
+			iState = ASYNC_MEASUREMENT_DONE;
+		}
+		else
+		{
+			iState = ASYNC_MEASUREMENT_RUNNING;
+		}
+#else
+		pthread_mutex_lock(&ptAsync->tMutex);
+		iState = (ptAsync->fDone!=0) ? ASYNC_MEASUREMENT_DONE : ASYNC_MEASUREMENT_RUNNING;
+		pthread_mutex_unlock(&ptAsync->tMutex);
+#endif
+	}
+
+	return iState;
+}
+
+
+
+/** \brief completes a measurement, this waits for the thread if it is still running.
+
+The sample buffer contains the readings afterwards and the next measurement can be started.
+	@param ptAsync		pointer to the measurement
+
+	@return 			number of devices which were read or -1 if no measurement was started
+	*/
+int async_measurement_complete(ASYNC_MEASUREMENT_T* ptAsync)
+{
+	int iResult;
+#if !defined(_WIN32)
+	char cSignal;
+#endif
+
+
+	iResult = -1;
+	if( ptAsync->fStarted!=0 )
+	{
+		async_measurement_join(ptAsync);
+#if !defined(_WIN32)
+		/* Remove the signal, the pipe must be empty for the next measurement. */
+		while( read(ptAsync->aiPipe[0], &cSignal, 1)==1 ) {}
+#endif
+		ptAsync->fStarted = 0;
+		ptAsync->apHandles = NULL;
+		ptAsync->ptBuffer = NULL;
+		iResult = ptAsync->iResult;
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief returns the file descriptor which becomes readable when the measurement is done.
+
+The descriptor stays the same for all measurements. It is only readable, nothing must be read from it.
+	@param ptAsync		pointer to the measurement
+
+	@return 			file descriptor or -1 on Windows
+	*/
+int async_measurement_get_fd(ASYNC_MEASUREMENT_T* ptAsync)
+{
+#if defined(_WIN32)
+	(void)ptAsync;
+	return -1;
+#else
+	return ptAsync->aiPipe[0];
+#endif
+}
+
+
+
+/** \brief returns the time of the reading of the last completed measurement.
+
+The time only covers the reading of the devices, not the wait for the conversion.
+	@param ptAsync		pointer to the measurement
+
+	@return 			time in microseconds
+	*/
+unsigned long async_measurement_get_read_time(ASYNC_MEASUREMENT_T* ptAsync)
+{
+	return ptAsync->ulReadTime;
+}
@@ -0,0 +1,62 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+
+/** \file async_measurement.h
+
+	 \brief Acquisition of all devices on a separate thread (header)
+
+An asynchronous measurement waits for the conversion of the sensors and reads all devices into a sample buffer on its own
+thread. The caller starts it, continues with other work and collects the result with async_measurement_complete. The end
+of the acquisition can be polled or waited for on a file descriptor, which becomes readable when the thread is done.
+Only one measurement can run at a time in the module. Accesses to the devices from other threads wait for it.
+
+ */
+
+#ifndef __ASYNC_MEASUREMENT_H__
+#define __ASYNC_MEASUREMENT_H__
+
+#include "sample_buffer.h"
+
+/** \brief states of an asynchronous measurement */
+typedef enum ASYNC_MEASUREMENT_STATE_ENUM
+{
+	/** no measurement was started or the last one was completed */
+	ASYNC_MEASUREMENT_IDLE    = 0,
+	/** the thread is waiting for the conversion or reading the devices */
+	ASYNC_MEASUREMENT_RUNNING = 1,
+	/** the thread is done, async_measurement_complete returns without waiting */
+	ASYNC_MEASUREMENT_DONE    = 2
+} ASYNC_MEASUREMENT_STATE_T;
+
+typedef struct ASYNC_MEASUREMENT_STRUCT ASYNC_MEASUREMENT_T;
+
+ASYNC_MEASUREMENT_T* async_measurement_new     (void);
+void                 async_measurement_free    (ASYNC_MEASUREMENT_T* ptAsync);
+int                  async_measurement_start   (ASYNC_MEASUREMENT_T* ptAsync, void** apHandles, SAMPLE_BUFFER_T* ptBuffer, unsigned int uiWaitTime);
+int                  async_measurement_poll    (ASYNC_MEASUREMENT_T* ptAsync);
+int                  async_measurement_complete(ASYNC_MEASUREMENT_T* ptAsync);
+int                  async_measurement_get_fd  (ASYNC_MEASUREMENT_T* ptAsync);
+unsigned long        async_measurement_get_read_time(ASYNC_MEASUREMENT_T* ptAsync);
+void                 async_measurement_wait_running(void);
+
+#endif	/* __ASYNC_MEASUREMENT_H__ */
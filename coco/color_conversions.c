@@ -0,0 +1,657 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+/** \file color_conversions.c
+
+	 \brief Conversion of the raw RGBC readings of the TCS3472 into color spaces
+
+color_conversions converts the raw clear, red, green and blue readings of the sensors into LUX, CCT, normalized RGB, XYZ, Yxy,
+dominant wavelength with saturation and HSV. All calculations are done with double precision and follow the calculations
+in lua/color_conversions.lua step by step, so both give the same results.
+
+ */
+
+#include "color_conversions.h"
+#include "tcs_chroma_table.h"
+#include "tcs3472.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+/* InitOnceExecuteOnce needs at least Windows Vista. */
+#       if !defined(_WIN32_WINNT) || _WIN32_WINNT<0x0600
+#               undef _WIN32_WINNT
+#               define _WIN32_WINNT 0x0600
+#       endif
+#       include <windows.h>
+#else
+#       include <pthread.h>
+#endif
+
+#ifndef M_PI
+#       define M_PI 3.14159265358979323846
+#endif
+
+
+static void color_tables_init(void);
+
+
+/** \brief allocates the result arrays for a number of lanes.
+
+All arrays are allocated in one memory block, which is released with color_spaces_free.
+	@param uiLanes		number of lanes
+
+	@return 			pointer to the results or NULL if no memory could be allocated
+	*/
+COLOR_SPACES_T* color_spaces_new(unsigned int uiLanes)
+{
+	COLOR_SPACES_T* ptColorSpaces;
+	double* pdData;
+	size_t sizData;
+
+
+	/* Build the tables before the first conversion, e.g. before the results are passed to a measurement thread. */
+	color_tables_init();
+
+	/* 16 double arrays followed by the valid flags. */
+	sizData = sizeof(COLOR_SPACES_T) + 16 * uiLanes * sizeof(double) + uiLanes;
+	ptColorSpaces = (COLOR_SPACES_T*)malloc(sizData);
+	if( ptColorSpaces!=NULL )
+	{
+		pdData = (double*)(ptColorSpaces + 1);
+
+		ptColorSpaces->uiLanes      = uiLanes;
+		ptColorSpaces->adLux        = pdData;
+		ptColorSpaces->adCCT        = pdData +  1*uiLanes;
+		ptColorSpaces->adClearRatio = pdData +  2*uiLanes;
+		ptColorSpaces->adR_n        = pdData +  3*uiLanes;
+		ptColorSpaces->adG_n        = pdData +  4*uiLanes;
+		ptColorSpaces->adB_n        = pdData +  5*uiLanes;
+		ptColorSpaces->adX          = pdData +  6*uiLanes;
+		ptColorSpaces->adY          = pdData +  7*uiLanes;
+		ptColorSpaces->adZ          = pdData +  8*uiLanes;
+		ptColorSpaces->adx          = pdData +  9*uiLanes;
+		ptColorSpaces->ady          = pdData + 10*uiLanes;
+		ptColorSpaces->adWavelength = pdData + 11*uiLanes;
+		ptColorSpaces->adSaturation = pdData + 12*uiLanes;
+		ptColorSpaces->adH          = pdData + 13*uiLanes;
+		ptColorSpaces->adS          = pdData + 14*uiLanes;
+		ptColorSpaces->adV          = pdData + 15*uiLanes;
+		ptColorSpaces->aucValid     = (unsigned char*)(pdData + 16*uiLanes);
+	}
+
+	return ptColorSpaces;
+}
+
+
+
+/** \brief frees the result arrays allocated with color_spaces_new.
+	@param ptColorSpaces	pointer to the results, can be NULL
+	*/
+void color_spaces_free(COLOR_SPACES_T* ptColorSpaces)
+{
+	free(ptColorSpaces);
+}
+
+
+
+/** \brief gets the maximum clear level for an integration time.
+
+The levels are the ones of Color_conversions:maxClear, unknown integration times get the maximum level of 65535.
+	@param ucIntegrationtime	value of the integration time register
+
+	@return 					maximum clear level
+	*/
+unsigned int color_maxClear(unsigned char ucIntegrationtime)
+{
+	unsigned int uiMaxClear;
+
+
+	switch(ucIntegrationtime)
+	{
+		case TCS3472_INTEGRATION_2_4ms:
+			uiMaxClear = 1024;
+			break;
+		case TCS3472_INTEGRATION_24ms:
+			uiMaxClear = 10240;
+			break;
+		case TCS3472_INTEGRATION_100ms:
+			uiMaxClear = 43008;
+			break;
+		default:
+			uiMaxClear = 65535;
+			break;
+	}
+
+	return uiMaxClear;
+}
+
+
+
+/** \brief calculates the LUX level and the CCT of one lane.
+
+The calculation is specific to the spectral responsitivity of the TCS3472, it is described in AMS / TAOS Designer's Note 40
+(DN40 - Lux and CCT Calculations). Negative LUX levels (blue LEDs) are turned around.
+	@param dRed, dGreen, dBlue, dClear	raw readings
+	@param ucIntegrationtime			integration time setting of the reading
+	@param ucGain						gain setting of the reading
+	@param pdLux						stores the LUX level
+	@param pdCCT						stores the CCT in Kelvin, 0 if there is no red content
+	*/
+void color_calculate_CCT_LUX(double dRed, double dGreen, double dBlue, double dClear,
+                             unsigned char ucIntegrationtime, unsigned char ucGain, double* pdLux, double* pdCCT)
+{
+	const double R_Coef = 0.136;
+	const double G_Coef = 1.0;
+	const double B_Coef = -0.444;
+	const double CT_Coef = 3810;
+	const double CT_Offset = 1391;
+	/* combined device factor and glass attenuation */
+	const double DGF = 310 * 1.0;
+	double dIR;
+	double dCPL;
+	double dLux;
+
+
+	/* remove the IR content from the rgb values */
+	dIR = (dRed + dGreen + dBlue - dClear) / 2;
+	dRed   = (dRed   - dIR < 0) ? 0 : dRed   - dIR;
+	dGreen = (dGreen - dIR < 0) ? 0 : dGreen - dIR;
+	dBlue  = (dBlue  - dIR < 0) ? 0 : dBlue  - dIR;
+
+	*pdCCT = (dRed > 0) ? CT_Coef * (dBlue / dRed) + CT_Offset : 0;
+
+	/* counts per lux */
+	dCPL = ((256 - ucIntegrationtime) * 2.4) * getGainDivisor((tcs3472Gain_t)ucGain) / DGF;
+	dLux = ((R_Coef * dRed) + (G_Coef * dGreen) + (B_Coef * dBlue)) / dCPL;
+
+	*pdLux = (dLux < 0) ? -dLux : dLux;
+}
+
+
+
+/** sRGB gamma decoding of COLOR_GAMMA_LUT_SIZE+1 equidistant points from 0.04045 to COLOR_GAMMA_LUT_MAX */
+static double adGammaLut[COLOR_GAMMA_LUT_SIZE + 1];
+
+
+
+/** \brief gamma decoding of one sRGB component with pow.
+	@param dValue	sRGB component, normalized to the clear level
+
+	@return 		linear component
+	*/
+double color_srgb_decode_exact(double dValue)
+{
+	return (dValue > 0.04045) ? pow((dValue + 0.055) / 1.055, 2.4) : dValue / 12.92;
+}
+
+
+
+/** \brief gamma decoding of one sRGB component with the lookup table, the table must be built (see color_tables_init). */
+static double srgb_decode_lut(double dValue)
+{
+	double dPosition;
+	int iIndex;
+
+
+	if( dValue<=0.04045 || dValue>=COLOR_GAMMA_LUT_MAX )
+	{
+		return color_srgb_decode_exact(dValue);
+	}
+
+	dPosition = (dValue - 0.04045) * (COLOR_GAMMA_LUT_SIZE / (COLOR_GAMMA_LUT_MAX - 0.04045));
+	iIndex = (int)dPosition;
+
+	return adGammaLut[iIndex] + (dPosition - iIndex) * (adGammaLut[iIndex + 1] - adGammaLut[iIndex]);
+}
+
+
+
+/** \brief gamma decoding of one sRGB component with a lookup table.
+
+The normalized colors are ratios of two 16 bit counts, so the range of the pow branch is limited. Up to COLOR_GAMMA_LUT_MAX the
+decoding is interpolated linearly in a table of COLOR_GAMMA_LUT_SIZE intervals. The error of a linear interpolation is at most
+h^2/8 * max|f''|, with h = (2.0 - 0.04045) / 4096 and max|f''| = 3.94 (at 2.0) this is an absolute error below 1.2e-7.
+Relative to the decoded value it is below 1.1e-5 (at the lower end of the table). Values above COLOR_GAMMA_LUT_MAX use pow.
+	@param dValue	sRGB component, normalized to the clear level
+
+	@return 		linear component
+	*/
+double color_srgb_decode(double dValue)
+{
+	color_tables_init();
+	return srgb_decode_lut(dValue);
+}
+
+
+
+/** \brief converts sRGB into XYZ (Observer 2 degree, Illuminant D65).
+	@param dR, dG, dB		normalized red, green and blue from 0.0 to 1.0
+	@param pdX, pdY, pdZ	store the XYZ values
+	*/
+void color_RGB2XYZ(double dR, double dG, double dB, double* pdX, double* pdY, double* pdZ)
+{
+	color_tables_init();
+	dR = srgb_decode_lut(dR);
+	dG = srgb_decode_lut(dG);
+	dB = srgb_decode_lut(dB);
+
+	*pdX = dR * 0.4124564 + dG * 0.3575761 + dB * 0.1804375;
+	*pdY = dR * 0.2126729 + dG * 0.7151522 + dB * 0.0721750;
+	*pdZ = dR * 0.0193339 + dG * 0.1191920 + dB * 0.9503041;
+}
+
+
+
+/** \brief converts XYZ into the x and y chromaticity (Y stays the same).
+	@param dX, dY, dZ		XYZ values
+	@param pdx, pdy			store x and y, both are 0 if X, Y and Z are 0
+	*/
+void color_XYZ2Yxy(double dX, double dY, double dZ, double* pdx, double* pdy)
+{
+	if( dX==0 && dY==0 && dZ==0 )
+	{
+		*pdx = 0;
+		*pdy = 0;
+	}
+	else
+	{
+		*pdx = dX / (dX + dY + dZ);
+		*pdy = dY / (dX + dY + dZ);
+	}
+}
+
+
+
+/** hue angle (atan2 around the reference white point) of every entry in atTcsDirVector */
+static double adHueAngle[TCS_CHROMA_ENTRIES];
+/** length of every direction vector in atTcsDirVector */
+static double adLocusLength[TCS_CHROMA_ENTRIES];
+/** indices into atTcsDirVector, sorted by the hue angle */
+static unsigned short ausHueOrder[TCS_CHROMA_ENTRIES];
+/** the tables are built exactly once, the once primitive also makes them visible to all threads */
+#if defined(_WIN32)
+static INIT_ONCE tTablesOnce = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_once_t tTablesOnce = PTHREAD_ONCE_INIT;
+#endif
+
+
+
+/** \brief compares two entries of atTcsDirVector by their hue angle, used for sorting with qsort.
+*/
+static int compare_hue(const void* pvA, const void* pvB)
+{
+	unsigned short usA = *(const unsigned short*)pvA;
+	unsigned short usB = *(const unsigned short*)pvB;
+	int iResult;
+
+
+	if( adHueAngle[usA]<adHueAngle[usB] )
+	{
+		iResult = -1;
+	}
+	else if( adHueAngle[usA]>adHueAngle[usB] )
+	{
+		iResult = 1;
+	}
+	else
+	{
+		/* keep the table order for equal angles, the linear search took the first one */
+		iResult = (int)usA - (int)usB;
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief builds the gamma decoding table and the hue index of the spectral locus.
+
+The spectral locus of the TCS3472 is not monotonic in its hue angle, so the entries are sorted by their angle.
+*/
+static void color_tables_build(void)
+{
+	int i;
+
+
+	for(i=0; i<=COLOR_GAMMA_LUT_SIZE; i++)
+	{
+		adGammaLut[i] = pow((0.04045 + i * ((COLOR_GAMMA_LUT_MAX - 0.04045) / COLOR_GAMMA_LUT_SIZE) + 0.055) / 1.055, 2.4);
+	}
+
+	for(i=0; i<TCS_CHROMA_ENTRIES; i++)
+	{
+		adHueAngle[i] = atan2(atTcsDirVector[i].dY, atTcsDirVector[i].dX);
+		adLocusLength[i] = sqrt(atTcsDirVector[i].dX*atTcsDirVector[i].dX + atTcsDirVector[i].dY*atTcsDirVector[i].dY);
+		ausHueOrder[i] = (unsigned short)i;
+	}
+	qsort(ausHueOrder, TCS_CHROMA_ENTRIES, sizeof(unsigned short), compare_hue);
+}
+
+
+#if defined(_WIN32)
+static BOOL CALLBACK color_tables_build_once(PINIT_ONCE ptOnce, PVOID pvParameter, PVOID* ppvContext)
+{
+	(void)ptOnce;
+	(void)pvParameter;
+	(void)ppvContext;
+
+	color_tables_build();
+	return TRUE;
+}
+#endif
+
+
+
+/** \brief builds the tables of the conversions on the first call.
+
+color_spaces_new calls it, so the tables are ready before any conversion. Other threads which call it at the same time wait until
+the tables are built.
+*/
+static void color_tables_init(void)
+{
+#if defined(_WIN32)
+	InitOnceExecuteOnce(&tTablesOnce, color_tables_build_once, NULL, NULL);
+#else
+	pthread_once(&tTablesOnce, color_tables_build);
+#endif
+}
+
+
+
+/** \brief gets the absolute difference of two angles in the range of 0 to pi.
+*/
+static double angle_distance(double dA, double dB)
+{
+	double dDistance;
+
+
+	dDistance = fabs(dA - dB);
+	if( dDistance>M_PI )
+	{
+		dDistance = 2 * M_PI - dDistance;
+	}
+
+	return dDistance;
+}
+
+
+
+/** \brief finds the two entries of the spectral locus whose hue angles enclose an angle.
+
+The search is a binary search in the sorted hue index. The hue circle is closed, an angle below the first or above the
+last entry is enclosed by the last and the first entry (this is the purple line).
+	@param dAngle		hue angle from -pi to pi
+	@param piLower		stores the index (into atTcsDirVector) of the entry with the next smaller angle
+	@param piUpper		stores the index (into atTcsDirVector) of the entry with the next bigger or equal angle
+	*/
+static void hue_index_find(double dAngle, int* piLower, int* piUpper)
+{
+	int iLow;
+	int iHigh;
+	int iMid;
+
+
+	/* Find the first position in the sorted index with an angle >= dAngle. */
+	iLow = 0;
+	iHigh = TCS_CHROMA_ENTRIES;
+	while( iLow<iHigh )
+	{
+		iMid = (iLow + iHigh) / 2;
+		if( adHueAngle[ausHueOrder[iMid]]<dAngle )
+		{
+			iLow = iMid + 1;
+		}
+		else
+		{
+			iHigh = iMid;
+		}
+	}
+
+	*piUpper = ausHueOrder[iLow % TCS_CHROMA_ENTRIES];
+	*piLower = ausHueOrder[(iLow + TCS_CHROMA_ENTRIES - 1) % TCS_CHROMA_ENTRIES];
+}
+
+
+
+/** \brief gets the dominant wavelength and the saturation of a x,y chromaticity.
+
+Instead of the idealized CIE1931 2 degree observer curve the spectral sensitivity data of the TCS3472 is used, which gives a much better
+accuracy. The direction vector from the reference white point to x,y is compared with the direction vectors of the spectral locus,
+the one with the smallest angle gives the dominant wavelength. The saturation is the ratio of the distance of x,y to the white point
+and the distance of the spectral locus to the white point, capped at 1.0.
+The closest direction is found with a binary search in the hue angles of the locus (see hue_index_find). The result is the same as
+the one of the linear search over all entries in Color_conversions:Yxy2wavelength_lua. Only points which lie right in the middle
+between two entries can get the neighbouring entry, as the angles of the linear search are calculated with acos.
+	@param dx, dy			chromaticity
+	@param pdWavelength		stores the dominant wavelength in nm
+	@param pdSaturation		stores the saturation from 0 to 1
+
+	@retval 0  Succesful
+	@retval 1  No wavelength could be determined (x,y is 0 or the white point), wavelength and saturation are 0
+	*/
+int color_Yxy2wavelength(double dx, double dy, double* pdWavelength, double* pdSaturation)
+{
+	double dDirX;
+	double dDirY;
+	double dAngle;
+	double dSaturation;
+	int iLower;
+	int iUpper;
+	int iNearest;
+
+
+	*pdWavelength = 0;
+	*pdSaturation = 0;
+
+	dDirX = dx - COLOR_REFWHITE_X;
+	dDirY = dy - COLOR_REFWHITE_Y;
+
+	/* if too dark return zeros, x,y on the white point has no direction */
+	if( (dx==0 && dy==0) || (dDirX==0 && dDirY==0) )
+	{
+		return 1;
+	}
+
+	color_tables_init();
+
+	dAngle = atan2(dDirY, dDirX);
+	hue_index_find(dAngle, &iLower, &iUpper);
+
+	iNearest = iLower;
+	if( angle_distance(dAngle, adHueAngle[iUpper])<angle_distance(dAngle, adHueAngle[iLower]) ||
+	   (angle_distance(dAngle, adHueAngle[iUpper])==angle_distance(dAngle, adHueAngle[iLower]) && iUpper<iLower) )
+	{
+		iNearest = iUpper;
+	}
+
+	dSaturation = sqrt(dDirX*dDirX + dDirY*dDirY) / adLocusLength[iNearest];
+	*pdWavelength = atTcsDirVector[iNearest].dNm;
+	*pdSaturation = (dSaturation >= 1.0) ? 1.0 : dSaturation;
+
+	return 0;
+}
+
+
+
+/** \brief gets the dominant wavelength and the saturation of a x,y chromaticity, interpolated between the entries of the spectral locus.
+
+This works like color_Yxy2wavelength, but the wavelength and the distance of the locus are interpolated linearly by the hue angle between
+the two enclosing entries. The result is no longer bound to the 0.3125nm steps of the table. There is no interpolation on the purple line
+and where the locus folds back (the two enclosing entries are not neighbours in the table), the closest entry is taken there.
+	@param dx, dy			chromaticity
+	@param pdWavelength		stores the dominant wavelength in nm
+	@param pdSaturation		stores the saturation from 0 to 1
+
+	@retval 0  Succesful
+	@retval 1  No wavelength could be determined (x,y is 0 or the white point), wavelength and saturation are 0
+	*/
+int color_Yxy2wavelength_interpolated(double dx, double dy, double* pdWavelength, double* pdSaturation)
+{
+	double dDirX;
+	double dDirY;
+	double dAngle;
+	double dSpan;
+	double dRatio;
+	double dSaturation;
+	int iLower;
+	int iUpper;
+	int iResult;
+
+
+	iResult = color_Yxy2wavelength(dx, dy, pdWavelength, pdSaturation);
+	if( iResult==0 )
+	{
+		dDirX = dx - COLOR_REFWHITE_X;
+		dDirY = dy - COLOR_REFWHITE_Y;
+		dAngle = atan2(dDirY, dDirX);
+		hue_index_find(dAngle, &iLower, &iUpper);
+
+		dSpan = adHueAngle[iUpper] - adHueAngle[iLower];
+		if( (iUpper - iLower == 1 || iLower - iUpper == 1) && dSpan>0 )
+		{
+			dRatio = (dAngle - adHueAngle[iLower]) / dSpan;
+			*pdWavelength = atTcsDirVector[iLower].dNm + dRatio * (atTcsDirVector[iUpper].dNm - atTcsDirVector[iLower].dNm);
+			dSaturation = sqrt(dDirX*dDirX + dDirY*dDirY) / (adLocusLength[iLower] + dRatio * (adLocusLength[iUpper] - adLocusLength[iLower]));
+			*pdSaturation = (dSaturation >= 1.0) ? 1.0 : dSaturation;
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief converts RGB into HSV.
+	@param dR, dG, dB		red, green and blue from 0 to 1, values above 1 are capped
+	@param pdH, pdS, pdV	store hue from 0 to 360, saturation and value from 0 to 100
+	*/
+void color_RGB2HSV(double dR, double dG, double dB, double* pdH, double* pdS, double* pdV)
+{
+	double dMax;
+	double dMin;
+	double dDelta;
+	double dH;
+
+
+	dR = (dR > 1.0) ? 1.0 : dR;
+	dG = (dG > 1.0) ? 1.0 : dG;
+	dB = (dB > 1.0) ? 1.0 : dB;
+
+	dMax = (dR > dG) ? dR : dG;
+	dMax = (dB > dMax) ? dB : dMax;
+	dMin = (dR < dG) ? dR : dG;
+	dMin = (dB < dMin) ? dB : dMin;
+	dDelta = dMax - dMin;
+
+	dH = 0;
+	if( dMax!=dMin )
+	{
+		if( dR==dMax )
+		{
+			dH = (dG - dB) / dDelta + ((dG < dB) ? 6 : 0);
+		}
+		else if( dG==dMax )
+		{
+			dH = (dB - dR) / dDelta + 2;
+		}
+		else
+		{
+			dH = (dR - dG) / dDelta + 4;
+		}
+		dH = dH / 6;
+	}
+
+	*pdH = dH * 360;
+	*pdS = ((dMax == 0) ? 0 : dDelta / dMax) * 100;
+	*pdV = dMax * 100;
+}
+
+
+
+/** \brief converts the raw readings of all lanes into the color spaces.
+
+The input arrays must have ptColorSpaces->uiLanes elements. They can contain the lanes of one device or of several devices one after the other.
+	@param ptColorSpaces				results, allocated with color_spaces_new
+	@param ausClear, ausRed, ausGreen, ausBlue	raw readings
+	@param aucIntegrationtime			integration time settings of the readings
+	@param aucGain						gain settings of the readings
+	*/
+void color_spaces_calculate(COLOR_SPACES_T* ptColorSpaces, const unsigned short* ausClear, const unsigned short* ausRed,
+                            const unsigned short* ausGreen, const unsigned short* ausBlue,
+                            const unsigned char* aucIntegrationtime, const unsigned char* aucGain)
+{
+	unsigned int uiLane;
+	double dClearRatio;
+	double dLux;
+	double dCCT;
+
+
+	for(uiLane=0; uiLane<ptColorSpaces->uiLanes; uiLane++)
+	{
+		dClearRatio = (double)ausClear[uiLane] / color_maxClear(aucIntegrationtime[uiLane]);
+		color_calculate_CCT_LUX(ausRed[uiLane], ausGreen[uiLane], ausBlue[uiLane], ausClear[uiLane],
+		                        aucIntegrationtime[uiLane], aucGain[uiLane], &dLux, &dCCT);
+
+		ptColorSpaces->adLux[uiLane] = dLux;
+		ptColorSpaces->adClearRatio[uiLane] = 100 * dClearRatio;
+
+		/* Lanes which do not read any LED get no color values. */
+		if( dClearRatio<COLOR_MIN_CLEAR || dLux<COLOR_MIN_LUX )
+		{
+			ptColorSpaces->aucValid[uiLane] = 0;
+			ptColorSpaces->adCCT[uiLane] = 0;
+			ptColorSpaces->adR_n[uiLane] = 0;
+			ptColorSpaces->adG_n[uiLane] = 0;
+			ptColorSpaces->adB_n[uiLane] = 0;
+			ptColorSpaces->adX[uiLane] = 0;
+			ptColorSpaces->adY[uiLane] = 0;
+			ptColorSpaces->adZ[uiLane] = 0;
+			ptColorSpaces->adx[uiLane] = 0;
+			ptColorSpaces->ady[uiLane] = 0;
+			ptColorSpaces->adWavelength[uiLane] = 0;
+			ptColorSpaces->adSaturation[uiLane] = 0;
+			ptColorSpaces->adH[uiLane] = 0;
+			ptColorSpaces->adS[uiLane] = 0;
+			ptColorSpaces->adV[uiLane] = 0;
+		}
+		else
+		{
+			ptColorSpaces->aucValid[uiLane] = 1;
+			ptColorSpaces->adCCT[uiLane] = dCCT;
+			ptColorSpaces->adR_n[uiLane] = (double)ausRed[uiLane]   / ausClear[uiLane];
+			ptColorSpaces->adG_n[uiLane] = (double)ausGreen[uiLane] / ausClear[uiLane];
+			ptColorSpaces->adB_n[uiLane] = (double)ausBlue[uiLane]  / ausClear[uiLane];
+
+			color_RGB2XYZ(ptColorSpaces->adR_n[uiLane], ptColorSpaces->adG_n[uiLane], ptColorSpaces->adB_n[uiLane],
+			              &ptColorSpaces->adX[uiLane], &ptColorSpaces->adY[uiLane], &ptColorSpaces->adZ[uiLane]);
+			color_XYZ2Yxy(ptColorSpaces->adX[uiLane], ptColorSpaces->adY[uiLane], ptColorSpaces->adZ[uiLane],
+			              &ptColorSpaces->adx[uiLane], &ptColorSpaces->ady[uiLane]);
+			color_Yxy2wavelength(ptColorSpaces->adx[uiLane], ptColorSpaces->ady[uiLane],
+			                     &ptColorSpaces->adWavelength[uiLane], &ptColorSpaces->adSaturation[uiLane]);
+			color_RGB2HSV(ptColorSpaces->adR_n[uiLane], ptColorSpaces->adG_n[uiLane], ptColorSpaces->adB_n[uiLane],
+			              &ptColorSpaces->adH[uiLane], &ptColorSpaces->adS[uiLane], &ptColorSpaces->adV[uiLane]);
+		}
+	}
+}
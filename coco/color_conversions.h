@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+/** \file color_conversions.h
+
+	 \brief Conversion of the raw RGBC readings of the TCS3472 into color spaces (header)
+
+color_conversions converts the raw clear, red, green and blue readings of the sensors into LUX, CCT, normalized RGB, XYZ, Yxy,
+dominant wavelength with saturation and HSV. The conversions work on arrays of lanes (structure of arrays), so the readings of
+one or all connected devices can be converted in one call. The results are the same as the ones of Color_conversions:aus2colorTable
+in lua/color_conversions.lua.
+
+ */
+
+#ifndef __COLOR_CONVERSIONS_H__
+#define __COLOR_CONVERSIONS_H__
+
+/** Minimum LUX level, lanes below this level get no color values */
+#define COLOR_MIN_LUX 4.0
+/** Minimum clear level as ratio of the maximum clear level, lanes below this level get no color values */
+#define COLOR_MIN_CLEAR 0.0008
+
+/** Number of intervals of the sRGB gamma decoding table */
+#define COLOR_GAMMA_LUT_SIZE 4096
+/** Upper end of the sRGB gamma decoding table, normalized colors above it are decoded with pow */
+#define COLOR_GAMMA_LUT_MAX 2.0
+
+/** x chromaticity of the reference white point (sRGB, D65) */
+#define COLOR_REFWHITE_X 0.312727
+/** y chromaticity of the reference white point (sRGB, D65) */
+#define COLOR_REFWHITE_Y 0.329023
+
+
+/** \brief contains the results of a color conversion for several lanes
+
+Every member points to an array with one element per lane. Lanes which are too dark (see COLOR_MIN_LUX and COLOR_MIN_CLEAR)
+are marked as invalid, all their values beside LUX and the clear ratio are 0.
+*/
+typedef struct COLOR_SPACES_STRUCT
+{
+	/** number of lanes */
+	unsigned int uiLanes;
+	/** 1 if the lane was bright enough for the color calculations, 0 otherwise */
+	unsigned char* aucValid;
+	/** illuminance in LUX */
+	double* adLux;
+	/** correlated color temperature in Kelvin */
+	double* adCCT;
+	/** clear level in percent of the maximum clear level */
+	double* adClearRatio;
+	/** red normalized to the clear level */
+	double* adR_n;
+	/** green normalized to the clear level */
+	double* adG_n;
+	/** blue normalized to the clear level */
+	double* adB_n;
+	/** X of the XYZ color space */
+	double* adX;
+	/** Y of the XYZ color space, this is the Y of the Yxy color space as well */
+	double* adY;
+	/** Z of the XYZ color space */
+	double* adZ;
+	/** x chromaticity */
+	double* adx;
+	/** y chromaticity */
+	double* ady;
+	/** dominant wavelength in nm (not rounded) */
+	double* adWavelength;
+	/** saturation from 0 to 1 */
+	double* adSaturation;
+	/** hue from 0 to 360 */
+	double* adH;
+	/** saturation from 0 to 100 */
+	double* adS;
+	/** value from 0 to 100 */
+	double* adV;
+} COLOR_SPACES_T;
+
+
+COLOR_SPACES_T* color_spaces_new      (unsigned int uiLanes);
+void            color_spaces_free     (COLOR_SPACES_T* ptColorSpaces);
+void            color_spaces_calculate(COLOR_SPACES_T* ptColorSpaces, const unsigned short* ausClear, const unsigned short* ausRed,
+                                       const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                       const unsigned char* aucIntegrationtime, const unsigned char* aucGain);
+
+unsigned int color_maxClear           (unsigned char ucIntegrationtime);
+void         color_calculate_CCT_LUX  (double dRed, double dGreen, double dBlue, double dClear,
+                                       unsigned char ucIntegrationtime, unsigned char ucGain, double* pdLux, double* pdCCT);
+double       color_srgb_decode        (double dValue);
+double       color_srgb_decode_exact  (double dValue);
+void         color_RGB2XYZ            (double dR, double dG, double dB, double* pdX, double* pdY, double* pdZ);
+void         color_XYZ2Yxy            (double dX, double dY, double dZ, double* pdx, double* pdy);
+int          color_Yxy2wavelength     (double dx, double dy, double* pdWavelength, double* pdSaturation);
+int          color_Yxy2wavelength_interpolated(double dx, double dy, double* pdWavelength, double* pdSaturation);
+void         color_RGB2HSV            (double dR, double dG, double dB, double* pdH, double* pdS, double* pdV);
+
+#endif	/* __COLOR_CONVERSIONS_H__ */
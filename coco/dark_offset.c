@@ -0,0 +1,266 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+ 
+
+
+
+/** \file dark_offset.c
+
+	 \brief Dark offsets of the sensors for each gain and integration time
+
+ */
+
+#include "dark_offset.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/** \brief a device with attached dark offsets */
+typedef struct DARK_OFFSET_DEVICE_STRUCT
+{
+	/** the device, this is the first ftdi handle of the device */
+	const void* pvDevice;
+	/** a copy of the offsets, it belongs to the list */
+	DARK_OFFSET_T* ptOffsets;
+} DARK_OFFSET_DEVICE_T;
+
+/** the devices with attached offsets, unused entries have no device */
+static DARK_OFFSET_DEVICE_T atDevices[DARK_OFFSET_MAX_DEVICES];
+
+
+
+/** \brief allocates a set of dark offsets without any calibrated settings.
+
+	@return 			pointer to the offsets or NULL if no memory could be allocated
+	*/
+DARK_OFFSET_T* dark_offset_new(void)
+{
+	return (DARK_OFFSET_T*)calloc(1, sizeof(DARK_OFFSET_T));
+}
+
+
+
+/** \brief frees a set of dark offsets. */
+void dark_offset_free(DARK_OFFSET_T* ptOffsets)
+{
+	free(ptOffsets);
+}
+
+
+
+/** \brief sets the offsets of all sensors for one combination of gain and integration time.
+
+An existing entry for the combination is overwritten.
+	@param ptOffsets			the dark offsets
+	@param ucGain				gain register value (TCS3472_GAIN_1X ... TCS3472_GAIN_60X)
+	@param ucIntegrationtime	integration time register value
+	@param ausOffsets			64 offsets, organized by channel like the results of read_colors_oversampled
+
+	@retval 0			the offsets were set
+	@retval -1			there is no free entry for a new combination
+	@retval -2			the gain is invalid
+	*/
+int dark_offset_set(DARK_OFFSET_T* ptOffsets, unsigned char ucGain, unsigned char ucIntegrationtime, const unsigned short* ausOffsets)
+{
+	unsigned int uiEntry;
+
+
+	if( ucGain>=DARK_OFFSET_GAINS )
+	{
+		return -2;
+	}
+
+	uiEntry = ptOffsets->aucIndex[ucGain][ucIntegrationtime];
+	if( uiEntry==0 )
+	{
+		if( ptOffsets->uiSettings>=DARK_OFFSET_MAX_SETTINGS )
+		{
+			return -1;
+		}
+		ptOffsets->uiSettings++;
+		uiEntry = ptOffsets->uiSettings;
+		ptOffsets->aucIndex[ucGain][ucIntegrationtime] = (unsigned char)uiEntry;
+	}
+	memcpy(ptOffsets->ausOffsets[uiEntry - 1], ausOffsets, sizeof(ptOffsets->ausOffsets[0]));
+
+	return 0;
+}
+
+
+
+/** \brief returns the 64 offsets of one combination of gain and integration time or NULL if it is not calibrated. */
+const unsigned short* dark_offset_get(const DARK_OFFSET_T* ptOffsets, unsigned char ucGain, unsigned char ucIntegrationtime)
+{
+	unsigned int uiEntry;
+
+
+	if( ucGain>=DARK_OFFSET_GAINS )
+	{
+		return NULL;
+	}
+	uiEntry = ptOffsets->aucIndex[ucGain][ucIntegrationtime];
+
+	return (uiEntry==0) ? NULL : ptOffsets->ausOffsets[uiEntry - 1];
+}
+
+
+
+/** \brief subtracts the dark offsets from the readings of the 16 sensors of a device.
+
+Each sensor is corrected with the offsets of its own gain and integration time. The readings are limited to 0, sensors with
+a combination which is not calibrated are not changed.
+	@param ptOffsets			the dark offsets or NULL
+	@param ausClear				16 clear readings
+	@param ausRed				16 red readings
+	@param ausGreen				16 green readings
+	@param ausBlue				16 blue readings
+	@param aucIntegrationtime	16 integration times the readings were taken with
+	@param aucGain				16 gains the readings were taken with
+
+	@return 			bit mask of the corrected sensors
+	*/
+unsigned int dark_offset_apply(const DARK_OFFSET_T* ptOffsets, unsigned short* ausClear, unsigned short* ausRed,
+                               unsigned short* ausGreen, unsigned short* ausBlue,
+                               const unsigned char* aucIntegrationtime, const unsigned char* aucGain)
+{
+	const unsigned short* ausOffsets;
+	unsigned int uiCorrected;
+	int i;
+
+
+	uiCorrected = 0;
+	if( ptOffsets!=NULL && ptOffsets->uiSettings!=0 )
+	{
+		for(i=0; i<16; i++)
+		{
+			ausOffsets = dark_offset_get(ptOffsets, aucGain[i], aucIntegrationtime[i]);
+			if( ausOffsets!=NULL )
+			{
+				ausClear[i] = (ausClear[i]>ausOffsets[i]) ? (unsigned short)(ausClear[i] - ausOffsets[i]) : 0;
+				ausRed[i]   = (ausRed[i]>ausOffsets[16+i]) ? (unsigned short)(ausRed[i] - ausOffsets[16+i]) : 0;
+				ausGreen[i] = (ausGreen[i]>ausOffsets[32+i]) ? (unsigned short)(ausGreen[i] - ausOffsets[32+i]) : 0;
+				ausBlue[i]  = (ausBlue[i]>ausOffsets[48+i]) ? (unsigned short)(ausBlue[i] - ausOffsets[48+i]) : 0;
+				uiCorrected |= 1U << i;
+			}
+		}
+	}
+
+	return uiCorrected;
+}
+
+
+
+/** \brief attaches a copy of dark offsets to an open device.
+
+The offsets replace the ones which were attached to the device before. They must not be changed while a measurement of the
+device is running, e.g. an asynchronous one. free_devices detaches the offsets of its devices.
+	@param pvDevice		the device, this is its first ftdi handle
+	@param ptOffsets	the dark offsets, NULL detaches the offsets
+
+	@retval 0			the offsets were attached
+	@retval -1			the device is NULL or there are already offsets for DARK_OFFSET_MAX_DEVICES devices
+	@retval -2			no memory could be allocated
+	*/
+int dark_offset_attach(const void* pvDevice, const DARK_OFFSET_T* ptOffsets)
+{
+	DARK_OFFSET_DEVICE_T* ptFree;
+	DARK_OFFSET_T* ptCopy;
+	unsigned int uiDevice;
+
+
+	if( pvDevice==NULL )
+	{
+		return -1;
+	}
+	if( ptOffsets==NULL )
+	{
+		dark_offset_detach(pvDevice);
+		return 0;
+	}
+
+	ptFree = NULL;
+	for(uiDevice=0; uiDevice<DARK_OFFSET_MAX_DEVICES; uiDevice++)
+	{
+		if( atDevices[uiDevice].pvDevice==pvDevice )
+		{
+			memcpy(atDevices[uiDevice].ptOffsets, ptOffsets, sizeof(DARK_OFFSET_T));
+			return 0;
+		}
+		else if( atDevices[uiDevice].pvDevice==NULL && ptFree==NULL )
+		{
+			ptFree = atDevices + uiDevice;
+		}
+	}
+	if( ptFree==NULL )
+	{
+		return -1;
+	}
+
+	ptCopy = (DARK_OFFSET_T*)malloc(sizeof(DARK_OFFSET_T));
+	if( ptCopy==NULL )
+	{
+		return -2;
+	}
+	memcpy(ptCopy, ptOffsets, sizeof(DARK_OFFSET_T));
+	ptFree->ptOffsets = ptCopy;
+	ptFree->pvDevice = pvDevice;
+
+	return 0;
+}
+
+
+
+/** \brief removes the dark offsets of a device, nothing happens if the device has none. */
+void dark_offset_detach(const void* pvDevice)
+{
+	unsigned int uiDevice;
+
+
+	for(uiDevice=0; uiDevice<DARK_OFFSET_MAX_DEVICES; uiDevice++)
+	{
+		if( atDevices[uiDevice].pvDevice==pvDevice && pvDevice!=NULL )
+		{
+			free(atDevices[uiDevice].ptOffsets);
+			atDevices[uiDevice].ptOffsets = NULL;
+			atDevices[uiDevice].pvDevice = NULL;
+		}
+	}
+}
+
+
+
+/** \brief returns the dark offsets of a device or NULL if it has none. */
+const DARK_OFFSET_T* dark_offset_find(const void* pvDevice)
+{
+	unsigned int uiDevice;
+
+
+	for(uiDevice=0; uiDevice<DARK_OFFSET_MAX_DEVICES; uiDevice++)
+	{
+		if( atDevices[uiDevice].pvDevice==pvDevice && pvDevice!=NULL )
+		{
+			return atDevices[uiDevice].ptOffsets;
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,70 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+ 
+
+
+
+/** \file dark_offset.h
+
+	 \brief Dark offsets of the sensors for each gain and integration time (header)
+
+A sensor counts a few digits even without any light. At short integration times this dark offset is a large part of the
+signal of a dim LED. The offsets are measured once per device with all LEDs switched off (see lua/dark_offset.lua) for
+each combination of gain and integration time which is used later. They are attached to an open device, read_colors and
+read_colors_hdr subtract them from the raw readings before the colors are converted.
+
+ */
+
+#ifndef __DARK_OFFSET_H__
+#define __DARK_OFFSET_H__
+
+/** number of gain settings of a sensor (TCS3472_GAIN_1X ... TCS3472_GAIN_60X) */
+#define DARK_OFFSET_GAINS 4
+/** maximum number of calibrated combinations of gain and integration time per device */
+#define DARK_OFFSET_MAX_SETTINGS 64
+/** maximum number of devices with attached offsets */
+#define DARK_OFFSET_MAX_DEVICES 32
+
+/** \brief the dark offsets of the 16 sensors of one device */
+typedef struct DARK_OFFSET_STRUCT
+{
+	/** number of the used entries in ausOffsets */
+	unsigned int uiSettings;
+	/** entry in ausOffsets + 1 for each gain and integration time, 0 if the combination is not calibrated */
+	unsigned char aucIndex[DARK_OFFSET_GAINS][256];
+	/** 64 offsets per entry: index 0-15 are the clear offsets of sensor 0-15, 16-31 red, 32-47 green and 48-63 blue */
+	unsigned short ausOffsets[DARK_OFFSET_MAX_SETTINGS][64];
+} DARK_OFFSET_T;
+
+DARK_OFFSET_T*        dark_offset_new  (void);
+void                  dark_offset_free (DARK_OFFSET_T* ptOffsets);
+int                   dark_offset_set  (DARK_OFFSET_T* ptOffsets, unsigned char ucGain, unsigned char ucIntegrationtime,
+                                        const unsigned short* ausOffsets);
+const unsigned short* dark_offset_get  (const DARK_OFFSET_T* ptOffsets, unsigned char ucGain, unsigned char ucIntegrationtime);
+unsigned int          dark_offset_apply(const DARK_OFFSET_T* ptOffsets, unsigned short* ausClear, unsigned short* ausRed,
+                                        unsigned short* ausGreen, unsigned short* ausBlue,
+                                        const unsigned char* aucIntegrationtime, const unsigned char* aucGain);
+
+int                   dark_offset_attach(const void* pvDevice, const DARK_OFFSET_T* ptOffsets);
+void                  dark_offset_detach(const void* pvDevice);
+const DARK_OFFSET_T*  dark_offset_find  (const void* pvDevice);
+
+#endif	/* __DARK_OFFSET_H__ */
@@ -234,6 +234,89 @@ int i2c_write8_x(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigne
 }
 
 
+/** \brief i2c-function sends an individual data byte to each of the 16 i2c-busses in one transaction.
+
+Address and register are taken from aucSendBuffer and are sent on all 16 i2c-busses in parallel. The data byte
+which follows is taken from aucLaneData, one element per i2c-bus. This allows to write different values
+(e.g. different integration times) to all 16 slaves with a single usb transfer instead of 16 calls of i2c_write8_x.
+    @param ftdiA, ftdiB  pointer to ftdi_context
+    @param aucSendBuffer pointer to the buffer which contains address and register
+    @param aucLaneData   data byte for each i2c-bus, must hold 16 elements
+
+    @return    0 if succesful, errorcode if not
+        - @ref WRITE_ERR_CH_A
+        - @ref WRITE_ERR_CH_B
+        - @ref READ_ERR_CH_A
+        - @ref READ_ERR_CH_B
+        - @ref ERR_INCORRECT_AMOUNT
+*/
+int i2c_write8_lanes(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucSendBuffer, unsigned char* aucLaneData)
+{
+	unsigned int uiBufferIndex = 0;
+	unsigned char ucMask       = 0x80;
+	unsigned char ucBitnumber  = 7;
+	unsigned long ucDataToSend = 0;
+	unsigned long ulDataToSend = 0;
+	unsigned int uiLane;
+
+
+	i2c_startCond(ftdiA, ftdiB);
+
+	/* Send address and register on all datalines, leave Bit0 of the address for the WR Bit */
+	while( uiBufferIndex<2 )
+	{
+		while( ucMask!=((uiBufferIndex==0) ? 1 : 0) )
+		{
+			ucDataToSend = ((aucSendBuffer[uiBufferIndex] & ucMask)>>ucBitnumber);
+			ulDataToSend = ucDataToSend << 0U | ucDataToSend <<  2U| ucDataToSend <<  4U| ucDataToSend << 6U |
+			               ucDataToSend << 8U | ucDataToSend << 10U| ucDataToSend << 12U| ucDataToSend <<14U |
+			               ucDataToSend <<16U | ucDataToSend << 18U| ucDataToSend << 20U| ucDataToSend <<22U |
+			               ucDataToSend <<24U | ucDataToSend << 26U| ucDataToSend << 28U| ucDataToSend <<30U;
+
+			process_pins(SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, ulDataToSend);
+			i2c_clock(ulDataToSend);
+
+			ucMask >>= 1U;
+			ucBitnumber--;
+		}
+
+		if( uiBufferIndex==0 )
+		{
+			/* 0 write 1 read */
+			process_pins(SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, SDA_WRITE);
+			i2c_clock(SDA_WRITE);
+		}
+		i2c_getAck(ftdiA, ftdiB);
+
+		uiBufferIndex++;
+		ucMask = 0x80;
+		ucBitnumber = 7;
+	}
+
+	/* Now the data byte, every dataline gets the bit of its own lane */
+	while( ucMask )
+	{
+		ulDataToSend = 0;
+		for(uiLane=0; uiLane<16; uiLane++)
+		{
+			ucDataToSend = ((aucLaneData[uiLane] & ucMask)>>ucBitnumber);
+			ulDataToSend |= ucDataToSend << (uiLane*2);
+		}
+
+		process_pins(SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, ulDataToSend);
+		i2c_clock(ulDataToSend);
+
+		ucMask >>= 1U;
+		ucBitnumber--;
+	}
+	i2c_getAck(ftdiA, ftdiB);
+
+	i2c_stopCond(ftdiA, ftdiB);
+
+	return send_package_write8(ftdiA, ftdiB);
+}
+
+
 /** \brief i2c-function reads the slaves connected to all 16 i2c-busses and stores the information in aucRecBuffer.
 
 ftdiA and ftdiB represent Channel A and Channel B of a ftdi device and each of these channels has 8 i2c-busses. This function
@@ -630,6 +713,181 @@ int i2c_read72(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned
 
 }
 
+/** \brief i2c-function reads a window of consecutive registers of the slaves connected to all 16 i2c-busses.
+
+Address and the first register (with the autoincrement bit) are taken from aucSendBuffer. After a repeated start ucRecLength
+bytes are read from each slave in one transaction, like i2c_read72 with a variable number of bytes. A smaller window shortens
+the i2c frame in proportion, e.g. the clear channel alone needs 16 clocked bits instead of the 72 bits of a complete color reading.
+    @param ftdiA, ftdiB  pointer to ftdi_context
+    @param aucSendBuffer pointer to the buffer which contains address and register
+    @param ucLength      number of bytes in aucSendBuffer
+    @param aucRecBuffer  stores 16 * ucRecLength bytes, byte n of the slave on i2c-bus i is at index n*16+i
+    @param ucRecLength   number of bytes to read from each slave
+
+    @return    0 if succesful, errorcode if not
+        - @ref WRITE_ERR_CH_A
+        - @ref WRITE_ERR_CH_B
+        - @ref READ_ERR_CH_A
+        - @ref READ_ERR_CH_B
+        - @ref ERR_INCORRECT_AMOUNT
+*/
+int i2c_read_bytes(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucSendBuffer, unsigned char ucLength,
+                   unsigned char* aucRecBuffer, unsigned char ucRecLength)
+{
+	unsigned int uiBufferIndex = 0;
+	unsigned char ucMask       = 0x80;
+	unsigned char ucBitnumber  = 7;
+	unsigned long ucDataToSend = 0;
+	unsigned long ulDataToSend = 0;
+	unsigned int uiBits;
+
+
+	i2c_startCond(ftdiA, ftdiB);
+
+	/* Send address and register on all datalines, leave Bit0 of the address for the WR Bit */
+	while( uiBufferIndex<ucLength )
+	{
+		while( ucMask!=((uiBufferIndex==0) ? 1 : 0) )
+		{
+			ucDataToSend = ((aucSendBuffer[uiBufferIndex] & ucMask)>>ucBitnumber);
+			ulDataToSend = ucDataToSend << 0U | ucDataToSend <<  2U| ucDataToSend <<  4U| ucDataToSend << 6U |
+			               ucDataToSend << 8U | ucDataToSend << 10U| ucDataToSend << 12U| ucDataToSend <<14U |
+			               ucDataToSend <<16U | ucDataToSend << 18U| ucDataToSend << 20U| ucDataToSend <<22U |
+			               ucDataToSend <<24U | ucDataToSend << 26U| ucDataToSend << 28U| ucDataToSend <<30U;
+
+			process_pins(SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, ulDataToSend);
+			i2c_clock(ulDataToSend);
+
+			ucMask >>= 1U;
+			ucBitnumber--;
+		}
+
+		if( uiBufferIndex==0 )
+		{
+			/* 0 write 1 read */
+			process_pins(SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, SDA_WRITE);
+			i2c_clock(SDA_WRITE);
+		}
+		i2c_getAck(ftdiA, ftdiB);
+
+		uiBufferIndex++;
+		ucMask = 0x80;
+		ucBitnumber = 7;
+	}
+
+	/* Send a repeated start condition and the address again, this time with the RD Bit */
+	i2c_startCond(ftdiA, ftdiB);
+
+	while( ucMask!=1 )
+	{
+		ucDataToSend = ((aucSendBuffer[0] & ucMask)>>ucBitnumber);
+		ulDataToSend = ucDataToSend << 0U | ucDataToSend <<  2U| ucDataToSend <<  4U| ucDataToSend << 6U |
+		               ucDataToSend << 8U | ucDataToSend << 10U| ucDataToSend << 12U| ucDataToSend <<14U |
+		               ucDataToSend <<16U | ucDataToSend << 18U| ucDataToSend << 20U| ucDataToSend <<22U |
+		               ucDataToSend <<24U | ucDataToSend << 26U| ucDataToSend << 28U| ucDataToSend <<30U;
+
+		process_pins(SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, ulDataToSend);
+		i2c_clock(ulDataToSend);
+
+		ucMask >>= 1U;
+		ucBitnumber--;
+	}
+
+	process_pins(SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, SDA_READ );
+	i2c_clock(SDA_READ);
+	i2c_getAck(ftdiA, ftdiB);
+
+	/* Now the bytes can be read back beginning from the MSB, each byte is acknowledged like in i2c_read72 */
+	uiBits = 8U * ucRecLength;
+	while( uiBits-- )
+	{
+		i2c_clockInput(0);
+		if( (uiBits % 8)==0 ) i2c_giveAck(ftdiA, ftdiB);
+	}
+
+	i2c_stopCond(ftdiA, ftdiB);
+
+	return send_package_read_bytes(ftdiA, ftdiB, aucRecBuffer, ucRecLength);
+}
+
+
+/** \brief checks which of the 16 i2c-busses have a slave which acknowledges an address.
+
+Only the address byte with the write bit is sent, followed by a stop condition. Before the start condition the released data
+lines are sampled, a line which is low here is stuck and its acknowledge can not be trusted. The transaction is much shorter
+than a read of a register, so a missing or broken slave is found before any register is read.
+    @param ftdiA, ftdiB  pointer to ftdi_context
+    @param ucAddress     the address byte of the slaves, Bit0 (the WR Bit) is ignored
+    @param puiPresent    receives the busses with a slave which acknowledged the address and a released data line
+                         (Bit0 is the i2c-bus 0)
+
+    @return    0 if succesful, errorcode if not
+        - @ref WRITE_ERR_CH_A
+        - @ref WRITE_ERR_CH_B
+        - @ref READ_ERR_CH_A
+        - @ref READ_ERR_CH_B
+        - @ref ERR_INCORRECT_AMOUNT
+*/
+int i2c_probe(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char ucAddress, unsigned int* puiPresent)
+{
+	unsigned char ucMask       = 0x80;
+	unsigned char ucBitnumber  = 7;
+	unsigned long ucDataToSend = 0;
+	unsigned long ulDataToSend = 0;
+	/* sample 0 has the released data lines, sample 1 the acknowledge with the clock high, sample 2 with the clock low */
+	unsigned long aulPins[3];
+	unsigned int uiBus;
+	int iResult;
+
+
+	/* Release the datalines with the clocklines high and sample them */
+	process_pins_databack(SDA_0_INPUT | SDA_1_INPUT | SDA_2_INPUT | SDA_3_INPUT | SCL, SCL);
+
+	i2c_startCond(ftdiA, ftdiB);
+
+	/* Send Adress leave Bit0 for WR Bit */
+	while(ucMask!=1)
+	{
+		ucDataToSend = ((ucAddress & ucMask)>>ucBitnumber);
+		ulDataToSend = ucDataToSend << 0U | ucDataToSend <<  2U| ucDataToSend <<  4U| ucDataToSend << 6U |
+		               ucDataToSend << 8U | ucDataToSend << 10U| ucDataToSend << 12U| ucDataToSend <<14U |
+		               ucDataToSend <<16U | ucDataToSend << 18U| ucDataToSend << 20U| ucDataToSend <<22U |
+		               ucDataToSend <<24U | ucDataToSend << 26U| ucDataToSend << 28U| ucDataToSend <<30U;
+
+		process_pins(SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, ulDataToSend);
+		i2c_clock(ulDataToSend);
+
+		ucMask >>= 1U;
+		ucBitnumber--;
+	}
+
+	/* 0 write 1 read */
+	process_pins( SDA_0_OUTPUT  | SDA_1_OUTPUT | SDA_2_OUTPUT | SDA_3_OUTPUT | SCL, SDA_WRITE);
+	i2c_clock(SDA_WRITE);
+	i2c_getAck(ftdiA, ftdiB);
+
+	i2c_stopCond(ftdiA, ftdiB);
+
+	iResult = send_package_read_pins(ftdiA, ftdiB, aulPins, 3);
+	if( iResult!=0 )
+	{
+		return iResult;
+	}
+
+	/* The data line of bus i is bit 2*i, a slave acknowledges by pulling it low */
+	*puiPresent = 0;
+	for(uiBus=0; uiBus<16; uiBus++)
+	{
+		if( ((aulPins[0]>>(2*uiBus))&1)==1 && ((aulPins[1]>>(2*uiBus))&1)==0 )
+		{
+			*puiPresent |= 1U<<uiBus;
+		}
+	}
+
+	return 0;
+}
+
+
 /** \brief triggers a clock cycle on all clock lines, while sendindg out data on the data lines.
 	@param ulDataToSend  	data which is going to be clocked on all lines set as output
  */
@@ -82,9 +82,16 @@ int i2c_read72		 (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsign
 					  unsigned short* ausReadBuffer1, unsigned short* ausReadBuffer2,
 					  unsigned short* ausReadBuffer3, unsigned short* ausReadBuffer4, unsigned char ucRecLength);
 					  
+int  i2c_probe       (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char ucAddress, unsigned int* puiPresent);
+
+int  i2c_read_bytes  (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucSendBuffer, unsigned char ucLength,
+                      unsigned char* aucRecBuffer, unsigned char ucRecLength);
+
 int  i2c_read8       (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucSendBuffer, unsigned char ucLength,
                       unsigned char* aucRecBuffer, unsigned char ucRecLength);
 					  
 int  i2c_write8      (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucSendBuffer, unsigned char ucLength);
 
-int  i2c_write8_x    (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucSendBuffer, unsigned char ucLength, unsigned int uiX);
\ No newline at end of file
+int  i2c_write8_x    (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucSendBuffer, unsigned char ucLength, unsigned int uiX);
+
+int  i2c_write8_lanes(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucSendBuffer, unsigned char* aucLaneData);
\ No newline at end of file
@@ -51,6 +51,8 @@ command sent to the ftdi chip had been processed yet or that the usb package has
 */
 
  
+#include <string.h>
+
 #include "io_operations.h"
 #include "sleep_ms.h"
 
@@ -266,71 +268,141 @@ void process_pins_databack(unsigned long ulIOMask, unsigned long ulOutput)
 }
 
 
-/** \brief sends the content of the global buffers to the ftdi chip. 
+/** \brief returns the sensors which are connected to the open channels of a device.
 
-This function sends the content of the global Buffers aucBufferA and aucBufferB to the ftdi chip 
-Furthermore it reads back the data of pins which were configured as input. In case of i2c these read back pins
-can be acknowledge bits or data send back by the device. 
+A device which only has sensors on one interface is connected without opening the other one, see connect_to_devices_lanes.
+The context of the interface which is not open has no usb device. Sensors 0-7 are connected to channel A, sensors 8-15 to
+channel B.
 	@param[in] 		ftdiA, ftdiB pointer to a ftdi_context
-	@return			0 if succesful, errorcode if not 
+
+	@return			bit mask of the sensors on the open channels, bit 0 is sensor 0
+*/
+unsigned int get_channel_sensors(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB)
+{
+	unsigned int uiSensors;
+
+
+	uiSensors = 0;
+	if( ftdiA->usb_dev!=NULL )
+	{
+		uiSensors |= 0x00ffU;
+	}
+	if( ftdiB->usb_dev!=NULL )
+	{
+		uiSensors |= 0xff00U;
+	}
+
+	return uiSensors;
+}
+
+
+/** \brief sends the commands of the global buffers to the open channels and reads back their answers.
+
+A channel which is not open is neither written nor read. Its answer is all zero, so the sensors on the channel read as 0.
+This is used by all send_package_xx functions, the decoding of the answer and the reset of the indices is done by them.
+	@param[in] 		ftdiA, ftdiB pointer to a ftdi_context
+	@return			0 if succesful, errorcode if not
 		- @ref WRITE_ERR_CH_A
         - @ref WRITE_ERR_CH_B
         - @ref READ_ERR_CH_A
         - @ref READ_ERR_CH_B
         - @ref ERR_INCORRECT_AMOUNT
 */
-int send_package_write8(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB)
+static int send_package_transfer(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB)
 {
+	int iWritten;
+	int iRead;
 
-    unsigned int uiWritten;
-    unsigned int uiRead;
 
-	
 	/* Send to Channel A */
-    if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->in_ep, aucBufferA, indexA, &uiWritten, ftdiA->usb_write_timeout)<0)
-    {
-        printf("Writing to Channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
-        return WRITE_ERR_CH_A;
-    }
-	
+	if( ftdiA->usb_dev!=NULL && libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->in_ep, aucBufferA, indexA, &iWritten, ftdiA->usb_write_timeout)<0 )
+	{
+		printf("Writing to Channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
+		return WRITE_ERR_CH_A;
+	}
+
 	/* Send to chanel B */
-    if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->in_ep, aucBufferB, indexB, &uiWritten, ftdiB->usb_write_timeout)<0)
-    {
-        printf("Writing to Channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
-        return WRITE_ERR_CH_B;
-    }
-	
+	if( ftdiB->usb_dev!=NULL && libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->in_ep, aucBufferB, indexB, &iWritten, ftdiB->usb_write_timeout)<0 )
+	{
+		printf("Writing to Channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
+		return WRITE_ERR_CH_B;
+	}
+
 	/* Wait until all commands are sent and processed by the chip */
 	sleep_ms(1);
 
-	/* Read from Channel A */
-    if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->out_ep, aucBufferA, sizeof(aucBufferA), &uiRead, ftdiA->usb_read_timeout) < 0)
+	if( ftdiA->usb_dev==NULL )
 	{
-        printf("Reading from channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
-        return READ_ERR_CH_A;
-    }
-	
-	/* Compare expected number of bytes with the actual number of bytes */
-	if(uiRead != (readIndexA + 2 ))
+		memset(aucBufferA, 0, readIndexA + 2);
+	}
+	else
 	{
-		printf("Reading from Channel A failed! Expected %d bytes, read %d bytes!\n", (readIndexA+2), uiRead);
-		ftdi_usb_purge_buffers(ftdiA);
-		return ERR_INCORRECT_AMOUNT;
+		/* Read from Channel A */
+		if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->out_ep, aucBufferA, sizeof(aucBufferA), &iRead, ftdiA->usb_read_timeout) < 0)
+		{
+			printf("Reading from channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
+			return READ_ERR_CH_A;
+		}
+
+		/* Compare expected number of bytes with the actual number of bytes */
+		if((unsigned int)iRead != (readIndexA + 2 ))
+		{
+			printf("Reading from Channel A failed! Expected %d bytes, read %d bytes!\n", (readIndexA+2), iRead);
+			ftdi_usb_purge_buffers(ftdiA);
+			return ERR_INCORRECT_AMOUNT;
+		}
 	}
-	
-	/* Read from Channel B */
-    if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->out_ep, aucBufferB, sizeof(aucBufferB),&uiRead, ftdiB->usb_read_timeout) < 0)
+
+	if( ftdiB->usb_dev==NULL )
 	{
-        printf("Reading from channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
-        return READ_ERR_CH_B;
-    }
+		memset(aucBufferB, 0, readIndexB + 2);
+	}
+	else
+	{
+		/* Read from Channel B */
+		if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->out_ep, aucBufferB, sizeof(aucBufferB), &iRead, ftdiB->usb_read_timeout) < 0)
+		{
+			printf("Reading from channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
+			return READ_ERR_CH_B;
+		}
+
+		/* Compare expected number of bytes with the actual number of bytes */
+		if((unsigned int)iRead != (readIndexB + 2 ))
+		{
+			printf("Reading from Channel B failed! Expected %d bytes, read %d bytes!\n", (readIndexB+2), iRead);
+			ftdi_usb_purge_buffers(ftdiB);
+			return ERR_INCORRECT_AMOUNT;
+		}
+	}
 
-	/* Compare expected number of bytes with the actual number of bytes */
-	if(uiRead != (readIndexB + 2 ))
+	return 0;
+}
+
+
+/** \brief sends the content of the global buffers to the ftdi chip. 
+
+This function sends the content of the global Buffers aucBufferA and aucBufferB to the ftdi chip 
+Furthermore it reads back the data of pins which were configured as input. In case of i2c these read back pins
+can be acknowledge bits or data send back by the device. 
+	@param[in] 		ftdiA, ftdiB pointer to a ftdi_context
+	@return			0 if succesful, errorcode if not 
+		- @ref WRITE_ERR_CH_A
+        - @ref WRITE_ERR_CH_B
+        - @ref READ_ERR_CH_A
+        - @ref READ_ERR_CH_B
+        - @ref ERR_INCORRECT_AMOUNT
+*/
+int send_package_write8(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB)
+{
+
+    int iResult;
+
+	
+	/* Send to both channels and read back their answers */
+	iResult = send_package_transfer(ftdiA, ftdiB);
+	if( iResult!=0 )
 	{
-		printf("Reading from Channel B failed! Expected %d bytes, read %d bytes!\n", (readIndexB+2), uiRead);
-		ftdi_usb_purge_buffers(ftdiB);
-		return ERR_INCORRECT_AMOUNT;
+		return iResult;
 	}
 	
 	/* Reset the index Counters for channel A and channel B */
@@ -365,8 +437,7 @@ The parameter aucReadbuffer will be used for storing 16 read back unsigned char
 int send_package_read8(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, unsigned char* aucReadBuffer, unsigned char ucReadBufferLength)
 {
 
-    unsigned int uiWritten;
-    unsigned int uiRead;
+    int iResult;
 
     /* Fill your readBuffer with zeroes, so nothing can go wrong mate ! */
     int i = 0;
@@ -375,51 +446,11 @@ int send_package_read8(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, u
         aucReadBuffer[i] = 0;
     }
 		
-	/* Send to Channel A */
-    if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->in_ep, aucBufferA, indexA, &uiWritten, ftdiA->usb_write_timeout)<0)
-    {
-        printf("Writing to Channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
-        return WRITE_ERR_CH_A;
-    }
-	
-	/* Send to chanel B */
-    if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->in_ep, aucBufferB, indexB, &uiWritten, ftdiB->usb_write_timeout)<0)
-    {
-        printf("Writing to Channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
-        return WRITE_ERR_CH_B;
-    }
-	
-	/* Wait until all commands are sent and processed by the chip */
-	sleep_ms(1);
-
-	/* Read from Channel A */
-    if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->out_ep, aucBufferA, sizeof(aucBufferA), &uiRead, ftdiA->usb_read_timeout) < 0)
+	/* Send to both channels and read back their answers */
+	iResult = send_package_transfer(ftdiA, ftdiB);
+	if( iResult!=0 )
 	{
-        printf("Reading from channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
-        return READ_ERR_CH_A;
-    }
-	
-	/* Compare expected number of bytes with the actual number of bytes */
-	if(uiRead != (readIndexA + 2 ))
-	{
-		printf("Reading from Channel A failed! Expected %d bytes, read %d bytes!\n", (readIndexA+2), uiRead);
-		ftdi_usb_purge_buffers(ftdiA);
-		return ERR_INCORRECT_AMOUNT;
-	}
-	
-	/* Read from Channel B */
-    if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->out_ep, aucBufferB, sizeof(aucBufferB),&uiRead, ftdiB->usb_read_timeout) < 0)
-	{
-        printf("Reading from channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
-        return READ_ERR_CH_B;
-    }
-
-	/* Compare expected number of bytes with the actual number of bytes */
-	if(uiRead != (readIndexB + 2 ))
-	{
-		printf("Reading from Channel B failed! Expected %d bytes, read %d bytes!\n", (readIndexB+2), uiRead);
-		ftdi_usb_purge_buffers(ftdiB);
-		return ERR_INCORRECT_AMOUNT;
+		return iResult;
 	}
 	
 
@@ -519,8 +550,7 @@ The parameter ausReadbuffer will be used for storing 16 read back unsigned short
 int send_package_read16(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, unsigned short* ausReadBuffer, unsigned char ucReadBufferLength)
 {
 
-    unsigned int uiWritten;
-    unsigned int uiRead;
+    int iResult;
 
     /* Fill your readBuffer with zeroes, so nothing can go wrong mate ! */
     int i = 0;
@@ -529,51 +559,11 @@ int send_package_read16(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB,
         ausReadBuffer[i] = 0;
     }	
 	
- 	/* Send to Channel A */
-    if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->in_ep, aucBufferA, indexA, &uiWritten, ftdiA->usb_write_timeout)<0)
-    {
-        printf("Writing to Channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
-        return WRITE_ERR_CH_A;
-    }
-	
-	/* Send to chanel B */
-    if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->in_ep, aucBufferB, indexB, &uiWritten, ftdiB->usb_write_timeout)<0)
-    {
-        printf("Writing to Channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
-        return WRITE_ERR_CH_B;
-    }
-	
-	/* Wait until all commands are sent and processed by the chip */
-	sleep_ms(1);
-
-	/* Read from Channel A */
-    if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->out_ep, aucBufferA, sizeof(aucBufferA), &uiRead, ftdiA->usb_read_timeout) < 0)
-	{
-        printf("Reading from channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
-        return READ_ERR_CH_A;
-    }
-	
-	/* Compare expected number of bytes with the actual number of bytes */
-	if(uiRead != (readIndexA + 2 ))
+	/* Send to both channels and read back their answers */
+	iResult = send_package_transfer(ftdiA, ftdiB);
+	if( iResult!=0 )
 	{
-		printf("Reading from Channel A failed! Expected %d bytes, read %d bytes!\n", (readIndexA+2), uiRead);
-		ftdi_usb_purge_buffers(ftdiA);
-		return ERR_INCORRECT_AMOUNT;
-	}
-	
-	/* Read from Channel B */
-    if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->out_ep, aucBufferB, sizeof(aucBufferB),&uiRead, ftdiB->usb_read_timeout) < 0)
-	{
-        printf("Reading from channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
-        return READ_ERR_CH_B;
-    }
-
-	/* Compare expected number of bytes with the actual number of bytes */
-	if(uiRead != (readIndexB + 2 ))
-	{
-		printf("Reading from Channel B failed! Expected %d bytes, read %d bytes!\n", (readIndexB+2), uiRead);
-		ftdi_usb_purge_buffers(ftdiB);
-		return ERR_INCORRECT_AMOUNT;
+		return iResult;
 	}
 	
 
@@ -732,8 +722,7 @@ The parameter ausReadbuffer will be used for storing 16 read back unsigned short
 int send_package_read72(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, unsigned char* aucReadBuffer, unsigned short* ausReadBuffer1, unsigned short* ausReadBuffer2,
 						  unsigned short* ausReadBuffer3, unsigned short* ausReadBuffer4, unsigned char ucReadBufferLength)
 {
-    unsigned int uiWritten;
-    unsigned int uiRead;
+    int iResult;
 
     /* Fill your readBuffer with zeroes, so nothing can go wrong mate ! */
     int i = 0;
@@ -746,51 +735,11 @@ int send_package_read72(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB,
         ausReadBuffer4[i] = 0;
     }
 	
- 	/* Send to Channel A */
-    if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->in_ep, aucBufferA, indexA, &uiWritten, ftdiA->usb_write_timeout)<0)
-    {
-        printf("Writing to Channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
-        return WRITE_ERR_CH_A;
-    }
-	
-	/* Send to chanel B */
-    if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->in_ep, aucBufferB, indexB, &uiWritten, ftdiB->usb_write_timeout)<0)
-    {
-        printf("Writing to Channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
-        return WRITE_ERR_CH_B;
-    }
-	
-	/* Wait until all commands are sent and processed by the chip */
-	sleep_ms(1);
-
-	/* Read from Channel A */
-    if(libusb_bulk_transfer(ftdiA->usb_dev, ftdiA->out_ep, aucBufferA, sizeof(aucBufferA), &uiRead, ftdiA->usb_read_timeout) < 0)
+	/* Send to both channels and read back their answers */
+	iResult = send_package_transfer(ftdiA, ftdiB);
+	if( iResult!=0 )
 	{
-        printf("Reading from channel %s failed!\n", ftdiA->interface==0?"A":(ftdiA->interface==1?"B":" error - invalid channel"));
-        return READ_ERR_CH_A;
-    }
-	
-	/* Compare expected number of bytes with the actual number of bytes */
-	if(uiRead != (readIndexA + 2 ))
-	{
-		printf("Reading from Channel A failed! Expected %d bytes, read %d bytes!\n", (readIndexA+2), uiRead);
-		ftdi_usb_purge_buffers(ftdiA);
-		return ERR_INCORRECT_AMOUNT;
-	}
-	
-	/* Read from Channel B */
-    if(libusb_bulk_transfer(ftdiB->usb_dev, ftdiB->out_ep, aucBufferB, sizeof(aucBufferB),&uiRead, ftdiB->usb_read_timeout) < 0)
-	{
-        printf("Reading from channel %s failed!\n", ftdiB->interface==0?"A":(ftdiB->interface==1?"B":" error - invalid channel"));
-        return READ_ERR_CH_B;
-    }
-
-	/* Compare expected number of bytes with the actual number of bytes */
-	if(uiRead != (readIndexB + 2 ))
-	{
-		printf("Reading from Channel B failed! Expected %d bytes, read %d bytes!\n", (readIndexB+2), uiRead);
-		ftdi_usb_purge_buffers(ftdiB);
-		return ERR_INCORRECT_AMOUNT;
+		return iResult;
 	}
 	
 	/* Index - Start of data */
@@ -1341,3 +1290,120 @@ int send_package_read72(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB,
     return 0;
 }
 
+
+
+/** \brief sends the content of the global buffers to the ftdi chip and decodes any number of bytes read back from 16 sensors.
+
+This function works like send_package_read72, but the number of data bytes is a parameter. It is used for reads of a window of
+consecutive registers, so a read of the clear channel only needs 2 data bytes instead of the 9 of a complete color reading.
+The bytes are stored with the sensors first: byte n of sensor i is at index n*16+i.
+	@param[in] 		ftdiA, ftdiB pointer to a ftdi_context
+	@param[in, out] aucReadBuffer pointer to an array of 16 * ucBytes unsigned char values
+	@param[in]		ucBytes number of bytes read from each sensor
+
+	@return			0 if succesful, errorcode if not
+		- @ref WRITE_ERR_CH_A
+        - @ref WRITE_ERR_CH_B
+        - @ref READ_ERR_CH_A
+        - @ref READ_ERR_CH_B
+        - @ref ERR_INCORRECT_AMOUNT
+
+*/
+int send_package_read_bytes(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, unsigned char* aucReadBuffer, unsigned char ucBytes)
+{
+	int iResult;
+	unsigned int uiBytenumber;
+	unsigned int uiBit;
+	unsigned int uiSensor;
+	unsigned int uiShift;
+	unsigned char* pucByte;
+
+
+	memset(aucReadBuffer, 0, 16U * ucBytes);
+
+	/* Send to both channels and read back their answers */
+	iResult = send_package_transfer(ftdiA, ftdiB);
+	if( iResult!=0 )
+	{
+		return iResult;
+	}
+
+	/* Index - Start of data, each bit has 4 bytes (see the info at the top of this file), the msb of each byte comes first */
+	uiBytenumber = 14;
+	for(uiBit=0; uiBit<8U*ucBytes; uiBit++)
+	{
+		pucByte = aucReadBuffer + (uiBit/8)*16;
+		uiShift = 7 - (uiBit%8);
+
+		/* The data line of the 4 sensors of a channel byte are the even bits: DA0-3 on AD, DA4-7 on AC, DA8-11 on BD, DA12-15 on BC */
+		for(uiSensor=0; uiSensor<4; uiSensor++)
+		{
+			pucByte[uiSensor]    |= ((aucBufferA[uiBytenumber]   >> (2*uiSensor)) & 1) << uiShift;
+			pucByte[uiSensor+4]  |= ((aucBufferA[uiBytenumber+1] >> (2*uiSensor)) & 1) << uiShift;
+			pucByte[uiSensor+8]  |= ((aucBufferB[uiBytenumber]   >> (2*uiSensor)) & 1) << uiShift;
+			pucByte[uiSensor+12] |= ((aucBufferB[uiBytenumber+1] >> (2*uiSensor)) & 1) << uiShift;
+		}
+		uiBytenumber += 4;
+	}
+
+	/* Reset the index counters for Channel A and channel B */
+	indexA = 0;
+	indexB = 0;
+	readIndexA = 0;
+	readIndexB = 0;
+
+	return 0;
+}
+
+
+
+/** \brief sends the content of the global buffers to the ftdi chip and returns the pin states which were read back.
+
+Every process_pins_databack reads back the low and the high byte of both channels. This function does not decode any i2c data,
+it returns these pin states, e.g. to check the acknowledge bits of the slaves. Sample n is stored in aulPins[n] with the same bit
+order as ulOutput of writeOutputs: Bit0 is AD0, Bit31 is BC7. The data line of sensor i is bit 2*i.
+	@param[in] 		ftdiA, ftdiB pointer to a ftdi_context
+	@param[in, out] aulPins pointer to an array of uiSamples values
+	@param[in]		uiSamples number of process_pins_databack calls since the last send_package_xx function
+
+	@return			0 if succesful, errorcode if not
+		- @ref WRITE_ERR_CH_A
+        - @ref WRITE_ERR_CH_B
+        - @ref READ_ERR_CH_A
+        - @ref READ_ERR_CH_B
+        - @ref ERR_INCORRECT_AMOUNT
+
+*/
+int send_package_read_pins(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, unsigned long* aulPins, unsigned int uiSamples)
+{
+	int iResult;
+	unsigned int uiSample;
+	unsigned int uiBytenumber;
+
+
+	/* Send to both channels and read back their answers */
+	iResult = send_package_transfer(ftdiA, ftdiB);
+	if( iResult!=0 )
+	{
+		return iResult;
+	}
+
+	/* The answer starts with 2 bytes status information of the ftdi, then each sample has a low and a high byte */
+	uiBytenumber = 2;
+	for(uiSample=0; uiSample<uiSamples; uiSample++)
+	{
+		aulPins[uiSample] = ((unsigned long)aucBufferA[uiBytenumber])            |
+		                    ((unsigned long)aucBufferA[uiBytenumber+1] << 8U)  |
+		                    ((unsigned long)aucBufferB[uiBytenumber]   << 16U) |
+		                    ((unsigned long)aucBufferB[uiBytenumber+1] << 24U);
+		uiBytenumber += 2;
+	}
+
+	/* Reset the index counters for Channel A and channel B */
+	indexA = 0;
+	indexB = 0;
+	readIndexA = 0;
+	readIndexB = 0;
+
+	return 0;
+}
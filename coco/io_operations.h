@@ -68,6 +68,8 @@ int writeOutputs           (struct ftdi_context *ftdiA, struct ftdi_context *ftd
 
 int readInputs             (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, const unsigned char* readBack);
 
+unsigned int get_channel_sensors(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB);
+
 void process_pins          (unsigned long ulIOMask, unsigned long ulOutput);
 
 void process_pins_databack (unsigned long ulIOMask, unsigned long ulOutput);
@@ -81,5 +83,9 @@ int send_package_read16    (struct ftdi_context *ftdiA, struct ftdi_context *ftd
 int send_package_read72  (struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, unsigned char* aucReadBuffer, unsigned short* ausReadBuffer1, unsigned short* ausReadBuffer2,
 						    unsigned short* ausReadBuffer3, unsigned short* ausReadBuffer4, unsigned char ucReadBufferLength);
 
+int send_package_read_bytes(struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, unsigned char* aucReadBuffer, unsigned char ucBytes);
+
+int send_package_read_pins (struct ftdi_context *ftdiA, struct ftdi_context *ftdiB, unsigned long* aulPins, unsigned int uiSamples);
+
 
 
@@ -30,6 +30,8 @@ provides the functions which are required for the application CoCo App.
 */
 
 #include "led_analyzer.h"
+/* The stable interface is included as well, the compiler checks that both declarations are the same. */
+#include "led_analyzer_api.h"
 
 /* This is for the "malloc" function. */
 #include <stdlib.h>
@@ -37,6 +39,10 @@ provides the functions which are required for the application CoCo App.
 #include <string.h>
 /* This is for the "sleep_ms" macro. */
 #include "sleep_ms.h"
+#include "timestamp_us.h"
+#include "dark_offset.h"
+#include "async_measurement.h"
+#include "test_plan.h"
 
 /** \brief scans for connected color controller devices and stores their serial numbers in an array.
 
@@ -128,6 +134,83 @@ int scan_devices(char** asSerial, unsigned int asLength)
 
 
 
+/** \brief creates the handle of one channel of a color controller and opens it.
+
+The handle of a channel which is not opened is created anyway, so every device keeps its 2 handles in apHandles. It has no
+usb device and all transfers skip it, see get_channel_sensors.
+    @param ppvHandle    receives the handle of the channel
+    @param tInterface   the channel, INTERFACE_A or INTERFACE_B
+    @param devCounter   index of the device, only used for messages
+    @param strSerial    serial number of the device
+    @param fOpen        0 creates the handle without opening the channel, otherwise the channel is opened
+
+    @retval  0 success
+    @retval -1 error with ftdi functions
+*/
+static int connect_channel(void** ppvHandle, enum ftdi_interface tInterface, int devCounter, const char* strSerial, int fOpen)
+{
+	struct ftdi_context* ptFtdi;
+	char cChannel;
+	int f;
+
+
+	cChannel = (tInterface==INTERFACE_A) ? 'A' : 'B';
+
+	ptFtdi = ftdi_new();
+	*ppvHandle = ptFtdi;
+	if( ptFtdi==NULL )
+	{
+		fprintf(stderr, "... ftdi_new failed!\n");
+		return -1;
+	}
+
+	f = ftdi_set_interface(ptFtdi, tInterface);
+	if( f<0 )
+	{
+		fprintf(stderr, "... unable to attach to device %d interface %c: %d, (%s) \n", devCounter, cChannel, f, ftdi_get_error_string(ptFtdi));
+		return -1;
+	}
+
+	if( fOpen==0 )
+	{
+		printf("color controller %d Channel %c - not opened, no sensors are populated\n", devCounter, cChannel);
+		return 0;
+	}
+
+	f = ftdi_usb_open_desc(ptFtdi, VID, PID, NULL, strSerial);
+	if( f<0 )
+	{
+		fprintf(stderr, "... unable to open device %d interface %c: %d (%s)\n", devCounter, cChannel, f, ftdi_get_error_string(ptFtdi));
+		return -1;
+	}
+	else
+	{
+		printf("color controller %d Channel %c - open succeeded\n", devCounter, cChannel);
+	}
+
+	f = ftdi_set_bitmode(ptFtdi, 0xFF, BITMODE_MPSSE);
+	if( f<0 )
+	{
+		fprintf(stderr, "... unable to set the mode on device %d Channel %c: %d (%s) \n", devCounter, cChannel, f, ftdi_get_error_string(ptFtdi));
+		return -1;
+	}
+	else
+	{
+		printf("enabling MPSSE mode on device %d Channel %c\n", devCounter, cChannel);
+	}
+
+	f = ftdi_usb_purge_buffers(ptFtdi);
+	if( f<0 )
+	{
+		fprintf(stderr, "... unable to purge buffers on device %d Channel %c: %d (%s) \n", devCounter, cChannel, f, ftdi_get_error_string(ptFtdi));
+		return -1;
+	}
+
+	return 0;
+}
+
+
+
 /** \brief connects to all USB devices with a given serial number.
 
 Function opens all USB devices which have a serial number that equals one of the serial numbers given in asSerial.
@@ -144,13 +227,38 @@ each connected color controller will get 2 handles in apHandles.
 */
 
 int connect_to_devices(void** apHandles, int apHlength, char** asSerial)
+{
+	return connect_to_devices_lanes(apHandles, apHlength, asSerial, NULL);
+}
+
+
+
+/** \brief connects to all USB devices with a given serial number and opens only the channels with populated sensors.
+
+Works like connect_to_devices, but each device has a mask of its populated sensors. Sensors 0-7 are connected to channel A,
+sensors 8-15 to channel B. A channel without populated sensors is not opened, so no commands are sent to it and no answer is
+waited for. This halves the USB traffic of a fixture which only has sensors on one channel. The sensors of a channel which is
+not opened read as 0 and are never reported as failed. Each device still gets 2 handles in apHandles.
+    @param apHandles    stores the handles of all opened USB color controller devices
+    @param apHlength    maximum number of handles apHandles can store
+    @param asSerial     stores the serial numbers of all connected color controller devices
+    @param ausLanes     the populated sensors of each device in the order of asSerial, bit 0 is sensor 0,
+                        NULL connects both channels of all devices
+
+    @retval  0 opened no color controller device
+    @retval -1 error with ftdi functions, insufficient length of apHandles or a device without populated sensors
+    @retval >0 number of opened color controller devices
+*/
+int connect_to_devices_lanes(void** apHandles, int apHlength, char** asSerial, const unsigned short* ausLanes)
 {
 	int numbOfDevs;
 	int iArrayPos;
 	int devCounter;
+	unsigned int uiLanes;
 	int f;
 
 
+	async_measurement_wait_running();
 	numbOfDevs = get_number_of_serials(asSerial);
 	printf("Number of Color Controllers found: %d\n\n", numbOfDevs);
 
@@ -169,222 +277,893 @@ int connect_to_devices(void** apHandles, int apHlength, char** asSerial)
 	{
 		printf("Connecting to device %d - %s\n", devCounter, asSerial[devCounter]);
 
-		if( iArrayPos+2<=apHlength )
+		uiLanes = (ausLanes==NULL) ? LANES_ALL : ausLanes[devCounter];
+		if( (uiLanes&LANES_ALL)==0 )
 		{
-			/* Ch A */
-			apHandles[iArrayPos] = ftdi_new();
-			if( apHandles[iArrayPos]==0 )
-			{
-				fprintf(stderr, "... ftdi_new failed!\n");
-				return -1;
-			}
+			printf("... device %d has no populated sensors\n", devCounter);
+			return -1;
+		}
 
-			f = ftdi_set_interface(apHandles[iArrayPos], INTERFACE_A);
-			if( f<0 )
-			{
-				fprintf(stderr, "... unable to attach to device %d interface A: %d, (%s) \n", devCounter, f, ftdi_get_error_string(apHandles[iArrayPos]));
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
-			}
+		/* Ch A */
+		f = connect_channel(&apHandles[iArrayPos], INTERFACE_A, devCounter, asSerial[devCounter], (uiLanes&LANES_CHANNEL_A)!=0);
+		if( f<0 )
+		{
+			return -1;
+		}
+		iArrayPos ++;
 
-			if( asSerial[devCounter]==NULL)
-			{
-				printf("... serial number non-existent ... make sure a color controller device is connected\n");
-				ftdi_deinit(apHandles[iArrayPos]);
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
-			}
+		/* Ch B */
+		f = connect_channel(&apHandles[iArrayPos], INTERFACE_B, devCounter, asSerial[devCounter], (uiLanes&LANES_CHANNEL_B)!=0);
+		if( f<0 )
+		{
+			return -1;
+		}
+		iArrayPos ++;
 
-			f = ftdi_usb_open_desc(apHandles[iArrayPos], VID, PID, NULL, asSerial[devCounter]);
-			if( f<0 )
-			{
-				fprintf(stderr, "... unable to open device %d interface A: %d (%s)\n", devCounter, f, ftdi_get_error_string(apHandles[iArrayPos]));
-				ftdi_deinit(apHandles[iArrayPos]);
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
-			}
-			else
-			{
-				 printf("color controller %d Channel A - open succeeded\n", devCounter);
-			}
+		/* Go to the next device found */
+		devCounter ++;
+
+		printf("\n");
+	}
+
+	printf("\n");
+
+	return devCounter;
+}
+
+
+
+/** \brief returns number of serial numbers stored in the serial number array.
+    @param asSerial     stores the serial numbers of all connected color controller devices
+
+    @return             number of elements in the serial number array
+*/
+int get_number_of_serials(char** asSerial)
+{
+	int counter = 0;
+
+
+	while( asSerial[counter]!=NULL )
+	{
+		counter++;
+	}
+
+	return counter;
+}
+
+
+/** \brief returns number of handles stored in the handle array.
+    @param apHandles array that stores the handles
+
+    @return number of elements in the handle array
+*/
+
+int get_number_of_handles(void ** apHandles)
+{
+	int counter = 0;
+
+
+	while( apHandles[counter]!=NULL )
+	{
+		counter++;
+	}
+
+	return counter;
+}
+
+
+/** \brief returns the device number corresponding to a certain handleIndex.
+
+As each device has 2 handles, the device index and the handle index are not the same. Following functions
+provides an easy way to get the device number if a handle index is given 
+    @param handleIndex  index of the handle
+
+    @return             device index that corresponds to the handle index
+*/
+int handleToDevice(int handleIndex)
+{
+	return (int)(handleIndex/2);
+}
+
+
+
+
+
+/** \brief initializes the sensors of a color controller device.
+
+Function initializes the 16 sensors of a color controller device. Initializing includes turning the sensors on
+clearing their interrupt flags and identifying them to be sure that the i2c-protocol works and following color readings
+are valid.
+    @param apHandles       array that stores ftdi2232h handles
+    @param devIndex        device index of current color controller device
+
+    @retval 0  Succesful
+    @retval >0 Flag in DWORD HIGH marks what kind of error occured, 16 bits in DWORD LOW mark which of the 16 sensors failed
+    @retval <0 USB errors, i2c errors or indexing errors occured, check return value for further information
+*/
+int init_sensors(void** apHandles, int devIndex)
+{
+	/* 2 handles per device, device 0 has handles 0,1 .. device 1 has handles 2,3 and so on*/
+	int handleIndex = devIndex * 2;
+	int iErrorcode = 0;
+	unsigned char aucTempbuffer[16];
+	int iResult;
+
+	// be optimistic
+	iResult = 0;
+
+	async_measurement_wait_running();
+	int iHandleLength = get_number_of_handles(apHandles);
+
+
+	if( handleIndex>=iHandleLength )
+	{
+		printf("Exceeded maximum amount of handles ... \n");
+		printf("Amount of handles: %d trying to index: %d\n", iHandleLength, handleIndex);
+		return ERR_INDEXING;
+	}
+
+	iResult = tcs_clearInt(apHandles[handleIndex], apHandles[handleIndex+1]);
+	if(iResult != 0)
+	{
+		printf("... failed to clear interrupt channel on device %d...\n", devIndex);
+		return iResult;
+	}
+
+	iResult = tcs_ON(apHandles[handleIndex], apHandles[handleIndex+1]);
+	if(iResult != 0)
+	{
+		printf("... failed to turn the sensors on on device %d...\n", devIndex);
+		return iResult;
+	}
+
+// Checks whether the sensors are activated
+	iErrorcode = tcs_identify(apHandles[handleIndex], apHandles[handleIndex+1], aucTempbuffer);
+	if( iErrorcode>0 )
+	{
+		return (iErrorcode | ERR_FLAG_ID);
+	}
+
+	return iErrorcode;
+}
+
+
+
+/** \brief checks which sensors of a color controller device are present.
+
+Function sends only the address of the sensors and checks which of them acknowledge it. This is a single short USB
+transaction, so missing or broken sensors are found before a complete identification or reading. The sensors on a
+channel which is not open (see connect_to_devices_lanes) are never present.
+    @param apHandles       array that stores ftdi2232h handles
+    @param devIndex        device index of current color controller device
+
+    @retval >=0 bit mask of the present sensors, bit 0 is sensor 0
+    @retval <0 USB errors, i2c errors or indexing errors occured, check return value for further information
+*/
+int probe_sensors(void** apHandles, int devIndex)
+{
+	int iHandleLength;
+	int handleIndex;
+	int iResult;
+
+
+	async_measurement_wait_running();
+	iHandleLength = get_number_of_handles(apHandles);
+	handleIndex = devIndex * 2;
+	if( handleIndex>=iHandleLength )
+	{
+		printf("Exceeded maximum amount of handles ... \n");
+		printf("Amount of handles: %d trying to index: %d\n", iHandleLength, handleIndex);
+		return ERR_INDEXING;
+	}
+
+	iResult = tcs_probe(apHandles[handleIndex], apHandles[handleIndex+1]);
+	if( iResult<0 )
+	{
+		printf("... failed to probe the sensors on device %d...\n", devIndex);
+		return iResult;
+	}
+
+	return (int)(get_channel_sensors(apHandles[handleIndex], apHandles[handleIndex+1]) & ~(unsigned int)iResult);
+}
 
-			f=ftdi_set_bitmode(apHandles[iArrayPos], 0xFF, BITMODE_MPSSE);
-			if( f<0 )
+
+
+/** \brief translates the error code of a tcs_readColors call into an error code of the led_analyzer.
+    @param iErrorcode   return value of tcs_readColors
+
+    @return             0 or an error code / error flag as described in E_ERROR
+*/
+static int read_colors_result(int iErrorcode)
+{
+	int iResult;
+
+
+	/* Fatal error has occured as we could not read from channel A and channel B */
+	if(iErrorcode <= -1 && iErrorcode >= -4)
+	{
+		iResult = ERR_DEVICE_FATAL;
+	}
+	/* Usb error has occured - read different amount of bytes than expected */
+	else if(iErrorcode <= -5 && iErrorcode >= -6)
+	{
+		iResult = ERR_USB;
+	}
+	/* Some sensors have not finished their conversion cycle yet */
+	else if(iErrorcode >  0)
+	{
+		iResult = iErrorcode | ERR_FLAG_INCOMPL_CONV;
+	}
+	else
+	{
+		iResult = 0;
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief reads the RGBC colors of all sensors under a device and checks if the colors are valid
+
+Function reads the colors red, green, blue and clear of all 16 sensors under a device and stores them in adequate buffers.
+Furthermore the function will check if maximum clear levels have been exceeded. If so, the color reading won't be valid, as the sensor has
+been saturated, and color reading for failing sensor(s) should be redone. If maximum clear levels are beeing exceeded too often, one
+should consider lowering gain and/or integration time settings. The function will return a returncode which can be used to determine
+which of the color sensors have exceeded maximum clear levels. Furthermore the function will store the sensors' measured
+LUX level in an array. This level is calculated by a formula given in AMS / TAOS Designer's Note 40.
+If dark offsets are attached to the device (see dark_offset.h), they are subtracted from the readings.
+    @param apHandles            array that stores ftdi2232h handles
+    @param devIndex             device index of current color controller device
+    @param ausClear             stores 16 clear colors
+    @param ausRed               stores 16 red colors
+    @param ausGreen             stores 16 green colors
+    @param ausBlue              stores 16 blue colors
+    @param aucIntegrationtime   stores 16 integration time values of the sensors
+    @param aucGain              stores 16 gain values of the sensors
+
+    @retval 0  Succesful
+    @retval >0 Flag in DWORD HIGH marks what kind of error occured, 16 bits in DWORD LOW mark which of the 16 sensors failed
+    @retval <0 USB errors, i2c errors or indexing errors occured, check return value for further information
+*/
+int read_colors(void** apHandles, int devIndex, unsigned short* ausClear, unsigned short* ausRed,
+                unsigned short* ausGreen, unsigned short* ausBlue,
+                unsigned char* aucIntegrationtime, unsigned char* aucGain)
+{
+	int iHandleLength;
+	int handleIndex;
+	int iErrorcode;
+	unsigned char aucTempbuffer[16];
+	int iResult;
+
+	// Be optimistic
+	iErrorcode = 0;
+
+	async_measurement_wait_running();
+	iHandleLength = get_number_of_handles(apHandles);
+	handleIndex = devIndex * 2;
+	/* Transform device index into handle index, as each device has two handles */
+	if( handleIndex>=iHandleLength )
+	{
+		printf("Exceeded maximum amount of handles ... \n");
+		printf("Amount of handles: %d trying to index: %d\n", iHandleLength, handleIndex);
+		iResult = ERR_INDEXING;
+	}
+	else
+	{
+		tcs_getIntegrationtime(apHandles[handleIndex], apHandles[handleIndex+1], aucIntegrationtime);
+		tcs_getGain(apHandles[handleIndex], apHandles[handleIndex+1], aucGain);
+
+		iErrorcode = tcs_readColors(apHandles[handleIndex], apHandles[handleIndex+1], ausClear, ausRed, ausGreen, ausBlue);
+		iResult = read_colors_result(iErrorcode);
+		if( iResult==0 )
+		{
+			/* Clear levels have been exceeded on some sensors */
+			iErrorcode = tcs_exClear(apHandles[handleIndex], apHandles[handleIndex+1], ausClear, aucIntegrationtime);
+			if( iErrorcode>0 )
 			{
-				fprintf(stderr, "... unable to set the mode on device %d Channel A: %d (%s) \n", devCounter, f, ftdi_get_error_string(apHandles[iArrayPos]));
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
+				iResult = iErrorcode | ERR_FLAG_EXCEEDED_CLEAR;
 			}
 			else
 			{
-				printf("enabling MPSSE mode on device %d Channel A\n", devCounter);
+				iResult = iErrorcode;
 			}
 
-			f=ftdi_usb_purge_buffers(apHandles[iArrayPos]);
-			if( f<0 )
-			{
-				fprintf(stderr, "... unable to purge buffers on device %d Channel A: %d (%s) \n", devCounter, f, ftdi_get_error_string(apHandles[iArrayPos]));
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
-			}
+			/* The saturation is checked with the raw readings, the dark offsets are subtracted afterwards. */
+			dark_offset_apply(dark_offset_find(apHandles[handleIndex]), ausClear, ausRed, ausGreen, ausBlue,
+			                  aucIntegrationtime, aucGain);
+		}
+	}
+	
+	return iResult;
+}
 
 
-			iArrayPos ++;
 
-			/* Ch B */
-			apHandles[iArrayPos] = ftdi_new();
-			if( apHandles[iArrayPos]==0 )
-			{
-				fprintf(stderr, "... ftdi_new failed!\n");
-				return -1;
-			}
+/** \brief reads the RGBC colors of all sensors under all connected color controller devices.
 
-			f = ftdi_set_interface(apHandles[iArrayPos], INTERFACE_B);
-			if( f<0 )
-			{
-				fprintf(stderr, "... unable to attach to device %d interface B: %d, (%s) \n", devCounter, f, ftdi_get_error_string(apHandles[iArrayPos]));
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
-			}
+The readings of all devices are stored one after the other, the values of device n start at index n*16. Each device is read
+with read_colors, its result is stored in aiResults. An error on one device does not stop the reading of the other devices.
+    @param apHandles            array that stores ftdi2232h handles
+    @param ausClear             stores 16 clear colors per device
+    @param ausRed               stores 16 red colors per device
+    @param ausGreen             stores 16 green colors per device
+    @param ausBlue              stores 16 blue colors per device
+    @param aucIntegrationtime   stores 16 integration time values per device
+    @param aucGain              stores 16 gain values per device
+    @param aiResults            stores the return value of read_colors for each device
+
+    @return                     number of devices which were read
+*/
+int read_colors_all(void** apHandles, unsigned short* ausClear, unsigned short* ausRed,
+                    unsigned short* ausGreen, unsigned short* ausBlue,
+                    unsigned char* aucIntegrationtime, unsigned char* aucGain, int* aiResults)
+{
+	int iDevices;
+	int devIndex;
 
-			if( asSerial[devCounter]==NULL )
-			{
-				printf("... serial number non-existent ... make sure a correct color controller device is connected\n");
-				ftdi_deinit(apHandles[iArrayPos]);
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
-			}
 
-			f = ftdi_usb_open_desc(apHandles[iArrayPos],VID, PID, NULL, asSerial[devCounter]);
-			if( f<0 )
+	async_measurement_wait_running();
+	iDevices = get_number_of_handles(apHandles) / 2;
+	for(devIndex=0; devIndex<iDevices; devIndex++)
+	{
+		aiResults[devIndex] = read_colors(apHandles, devIndex, ausClear + devIndex*16, ausRed + devIndex*16,
+		                                  ausGreen + devIndex*16, ausBlue + devIndex*16,
+		                                  aucIntegrationtime + devIndex*16, aucGain + devIndex*16);
+	}
+
+	return iDevices;
+}
+
+
+
+/** \brief reads a window of the color registers of all sensors under a color controller device.
+
+Works like read_colors, but only the registers of the window are transferred, so the i2c frame shrinks with the window. This
+is enough for presence and brightness checks, which only need the clear channel. The windows are
+    - READ_WINDOW_CLEAR:        clear channel only, there is no check for incomplete conversions
+    - READ_WINDOW_STATUS_CLEAR: status register and clear channel
+    - READ_WINDOW_RGB:          red, green and blue channels, there are no checks for incomplete conversions or saturation
+    - READ_WINDOW_FULL:         status register and all channels, the same registers as read_colors
+The channels which are not part of the window are not changed and can be NULL, all channels stay unchanged if the reading
+failed or was incomplete. With the flag READ_WINDOW_KEEP_SETTINGS
+aucIntegrationtime and aucGain already hold the settings of the sensors (e.g. from an earlier reading) and are not read
+again, this saves two more i2c transactions for repeated readings. The saturation check and the dark offsets use them.
+    @param apHandles            array that stores ftdi2232h handles
+    @param devIndex             device index of current color controller device
+    @param uiWindow             one of the READ_WINDOW_* windows, optionally ored with READ_WINDOW_KEEP_SETTINGS
+    @param ausClear             stores 16 clear colors
+    @param ausRed               stores 16 red colors
+    @param ausGreen             stores 16 green colors
+    @param ausBlue              stores 16 blue colors
+    @param aucIntegrationtime   stores 16 integration time values
+    @param aucGain              stores 16 gain values
+
+    @retval 0  Succesful
+    @retval >0 errorflags as described in E_ERROR ored with the sensors which failed
+    @retval <0 unknown window or indexing errors occured
+*/
+int read_colors_window(void** apHandles, int devIndex, unsigned int uiWindow, unsigned short* ausClear, unsigned short* ausRed,
+                       unsigned short* ausGreen, unsigned short* ausBlue,
+                       unsigned char* aucIntegrationtime, unsigned char* aucGain)
+{
+	int iHandleLength;
+	int handleIndex;
+	int iErrorcode;
+	int iResult;
+	tcs_window_t tWindow;
+	unsigned short ausWindowClear[16] = {0};
+	unsigned short ausWindowRed[16] = {0};
+	unsigned short ausWindowGreen[16] = {0};
+	unsigned short ausWindowBlue[16] = {0};
+
+
+	async_measurement_wait_running();
+	iHandleLength = get_number_of_handles(apHandles);
+	handleIndex = devIndex * 2;
+	if( handleIndex>=iHandleLength )
+	{
+		printf("Exceeded maximum amount of handles ... \n");
+		printf("Amount of handles: %d trying to index: %d\n", iHandleLength, handleIndex);
+		return ERR_INDEXING;
+	}
+
+	tWindow = (tcs_window_t)(uiWindow & READ_WINDOW_MASK);
+	if( tWindow>TCS_WINDOW_FULL )
+	{
+		printf("Unknown register window: %u\n", uiWindow);
+		return ERR_INDEXING;
+	}
+
+	if( (uiWindow & READ_WINDOW_KEEP_SETTINGS)==0 )
+	{
+		tcs_getIntegrationtime(apHandles[handleIndex], apHandles[handleIndex+1], aucIntegrationtime);
+		tcs_getGain(apHandles[handleIndex], apHandles[handleIndex+1], aucGain);
+	}
+
+	iErrorcode = tcs_readWindow(apHandles[handleIndex], apHandles[handleIndex+1], tWindow, ausWindowClear, ausWindowRed,
+	                            ausWindowGreen, ausWindowBlue);
+	iResult = read_colors_result(iErrorcode);
+	if( iResult==0 )
+	{
+		if( tWindow!=TCS_WINDOW_RGB )
+		{
+			/* Clear levels have been exceeded on some sensors */
+			iErrorcode = tcs_exClear(apHandles[handleIndex], apHandles[handleIndex+1], ausWindowClear, aucIntegrationtime);
+			if( iErrorcode>0 )
 			{
-				fprintf(stderr, "... unable to open device %d interface B: %d (%s)\n", devCounter, f, ftdi_get_error_string(apHandles[iArrayPos]));
-				ftdi_deinit(apHandles[iArrayPos]);
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
+				iResult = iErrorcode | ERR_FLAG_EXCEEDED_CLEAR;
 			}
-			else
+		}
+
+		/* The channels outside of the window are 0, their offsets do not matter. */
+		dark_offset_apply(dark_offset_find(apHandles[handleIndex]), ausWindowClear, ausWindowRed, ausWindowGreen, ausWindowBlue,
+		                  aucIntegrationtime, aucGain);
+
+		if( tWindow!=TCS_WINDOW_RGB )
+		{
+			memcpy(ausClear, ausWindowClear, sizeof(ausWindowClear));
+		}
+		if( tWindow==TCS_WINDOW_RGB || tWindow==TCS_WINDOW_FULL )
+		{
+			memcpy(ausRed, ausWindowRed, sizeof(ausWindowRed));
+			memcpy(ausGreen, ausWindowGreen, sizeof(ausWindowGreen));
+			memcpy(ausBlue, ausWindowBlue, sizeof(ausWindowBlue));
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief takes one exposure with the given integration time and gain on all 16 sensors of a device.
+
+The settings are written to all sensors and the integration is restarted, so the result belongs to a complete
+integration cycle with the new settings.
+    @param ftdiA, ftdiB         pointer to ftdi_context
+    @param ucIntegrationtime    integration time for the exposure
+    @param ucGain               gain for the exposure
+
+    @retval 0  Succesful
+    @retval <0 USB or i2c errors occured, check return value for further information
+*/
+static int hdr_start_exposure(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char ucIntegrationtime, unsigned char ucGain)
+{
+	int iResult;
+
+
+	iResult = tcs_setIntegrationTime(ftdiA, ftdiB, ucIntegrationtime);
+	if( iResult==0 )
+	{
+		iResult = tcs_setGain(ftdiA, ftdiB, ucGain);
+		if( iResult==0 )
+		{
+			iResult = tcs_restartIntegration(ftdiA, ftdiB);
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief reads the RGBC colors of all sensors under a device with two exposures and merges them per sensor (HDR mode).
+
+Bright and dark LEDs on one device can not always be captured with one setting, as bright LEDs saturate the sensors
+while dark LEDs hardly produce any counts. This function takes two exposures, a short (less sensitive) and a long
+(more sensitive) one. Sensitivity is the product of gain and integration time, the two settings are sorted accordingly,
+so a gain bracket works as well as an integration time bracket. The long exposure is started right after the
+short one has been read back, the short results are evaluated while the long exposure integrates.
+For each sensor the best reading is chosen: the long exposure if it is neither saturated nor below the noise floor
+(HDR_MIN_CLEAR), the short exposure otherwise. The clear, red, green and blue values of the chosen reading are stored
+together with the integration time and gain it was taken with, so all following calculations which normalize by
+gain and integration time (e.g. LUX) work without changes. The dark offsets of the chosen setting are subtracted like
+in read_colors. After the measurement the previous settings of all sensors are restored.
+    @param apHandles            array that stores ftdi2232h handles
+    @param devIndex             device index of current color controller device
+    @param ucIntTimeShort       integration time of the short exposure
+    @param ucGainShort          gain of the short exposure
+    @param ucIntTimeLong        integration time of the long exposure
+    @param ucGainLong           gain of the long exposure
+    @param ausClear             stores 16 clear colors
+    @param ausRed               stores 16 red colors
+    @param ausGreen             stores 16 green colors
+    @param ausBlue              stores 16 blue colors
+    @param aucIntegrationtime   stores 16 integration time values the chosen readings were taken with
+    @param aucGain              stores 16 gain values the chosen readings were taken with
+
+    @retval 0  Succesful
+    @retval >0 Flag in DWORD HIGH marks what kind of error occured, 16 bits in DWORD LOW mark which of the 16 sensors failed
+    @retval <0 USB errors, i2c errors or indexing errors occured, check return value for further information
+*/
+int read_colors_hdr(void** apHandles, int devIndex, unsigned char ucIntTimeShort, unsigned char ucGainShort,
+                    unsigned char ucIntTimeLong, unsigned char ucGainLong,
+                    unsigned short* ausClear, unsigned short* ausRed, unsigned short* ausGreen, unsigned short* ausBlue,
+                    unsigned char* aucIntegrationtime, unsigned char* aucGain)
+{
+	int iHandleLength;
+	int handleIndex;
+	int iErrorcode;
+	int iResult;
+	int iSaturated;
+	int iSatShort;
+	int iSatLong;
+	int iUseLong;
+	unsigned int uiSensitivityShort;
+	unsigned int uiSensitivityLong;
+	unsigned int uiMaxClearShort;
+	unsigned int uiMaxClearLong;
+	unsigned char ucSwap;
+	unsigned char aucOldIntTime[16];
+	unsigned char aucOldGain[16];
+	unsigned short ausExpClear[16];
+	unsigned short ausExpRed[16];
+	unsigned short ausExpGreen[16];
+	unsigned short ausExpBlue[16];
+	int i;
+
+
+	async_measurement_wait_running();
+	iHandleLength = get_number_of_handles(apHandles);
+	handleIndex = devIndex * 2;
+	if( handleIndex>=iHandleLength )
+	{
+		printf("Exceeded maximum amount of handles ... \n");
+		printf("Amount of handles: %d trying to index: %d\n", iHandleLength, handleIndex);
+		return ERR_INDEXING;
+	}
+
+	/* Sort the two exposures by their sensitivity (gain * integration time). */
+	uiSensitivityShort = getGainDivisor(ucGainShort) * (256U - ucIntTimeShort);
+	uiSensitivityLong  = getGainDivisor(ucGainLong)  * (256U - ucIntTimeLong);
+	if( uiSensitivityShort>uiSensitivityLong )
+	{
+		ucSwap = ucIntTimeShort;
+		ucIntTimeShort = ucIntTimeLong;
+		ucIntTimeLong = ucSwap;
+		ucSwap = ucGainShort;
+		ucGainShort = ucGainLong;
+		ucGainLong = ucSwap;
+	}
+	uiMaxClearShort = tcs_getMaxClear(ucIntTimeShort);
+	uiMaxClearLong  = tcs_getMaxClear(ucIntTimeLong);
+
+	/* Remember the current settings, they are restored after the measurement. */
+	iResult = tcs_getIntegrationtime(apHandles[handleIndex], apHandles[handleIndex+1], aucOldIntTime);
+	if( iResult!=0 )
+	{
+		return read_colors_result(iResult);
+	}
+	iResult = tcs_getGain(apHandles[handleIndex], apHandles[handleIndex+1], aucOldGain);
+	if( iResult!=0 )
+	{
+		return read_colors_result(iResult);
+	}
+
+	/* Short exposure. */
+	iResult = hdr_start_exposure(apHandles[handleIndex], apHandles[handleIndex+1], ucIntTimeShort, ucGainShort);
+	if( iResult==0 )
+	{
+		sleep_ms(HDR_INIT_TIME_MS + tcs_getConversionTime_ms(ucIntTimeShort));
+		iErrorcode = tcs_readColors(apHandles[handleIndex], apHandles[handleIndex+1], ausExpClear, ausExpRed, ausExpGreen, ausExpBlue);
+		iResult = read_colors_result(iErrorcode);
+	}
+
+	/* Long exposure, it integrates while the short exposure is evaluated below. */
+	if( iResult==0 )
+	{
+		iResult = hdr_start_exposure(apHandles[handleIndex], apHandles[handleIndex+1], ucIntTimeLong, ucGainLong);
+	}
+
+	if( iResult==0 )
+	{
+		for(i=0; i<16; i++)
+		{
+			ausClear[i] = ausExpClear[i];
+			ausRed[i]   = ausExpRed[i];
+			ausGreen[i] = ausExpGreen[i];
+			ausBlue[i]  = ausExpBlue[i];
+			aucIntegrationtime[i] = ucIntTimeShort;
+			aucGain[i] = ucGainShort;
+		}
+
+		sleep_ms(HDR_INIT_TIME_MS + tcs_getConversionTime_ms(ucIntTimeLong));
+		iErrorcode = tcs_readColors(apHandles[handleIndex], apHandles[handleIndex+1], ausExpClear, ausExpRed, ausExpGreen, ausExpBlue);
+		iResult = read_colors_result(iErrorcode);
+	}
+
+	/* Merge the two exposures. The short one was copied to the result arrays, the long one is in ausExpXXX now. */
+	if( iResult==0 )
+	{
+		iSaturated = 0;
+		for(i=0; i<16; i++)
+		{
+			iSatShort = (ausClear[i]>=uiMaxClearShort);
+			iSatLong  = (ausExpClear[i]>=uiMaxClearLong);
+
+			if( iSatLong==0 && ausExpClear[i]>=HDR_MIN_CLEAR )
 			{
-				printf("color controller %d Channel B - open succeeded\n", devCounter);
+				iUseLong = 1;
 			}
-
-			f = ftdi_set_bitmode(apHandles[iArrayPos], 0xFF, BITMODE_MPSSE);
-			if( f<0 )
+			else if( iSatShort==0 && ausClear[i]>=HDR_MIN_CLEAR )
 			{
-				fprintf(stderr, "unable to set the mode on device %d Channel B: %d (%s) \n", devCounter, f, ftdi_get_error_string(apHandles[iArrayPos]));
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
+				iUseLong = 0;
 			}
 			else
 			{
-				printf("enabling MPSSE mode on device %d Channel B\n", devCounter);
+				/* No reading is in the valid range. Take the one with more counts which is not saturated. */
+				iUseLong = (iSatLong==0);
+				if( iSatLong!=0 && iSatShort!=0 )
+				{
+					iSaturated |= (1<<i);
+				}
 			}
 
-			f = ftdi_usb_purge_buffers(apHandles[iArrayPos]);
-			if( f<0 )
+			if( iUseLong!=0 )
 			{
-				fprintf(stderr, "... unable to purge buffers on device %d Channel B: %d (%s) \n", devCounter, f, ftdi_get_error_string(apHandles[iArrayPos]));
-				ftdi_free(apHandles[iArrayPos]);
-				return -1;
+				ausClear[i] = ausExpClear[i];
+				ausRed[i]   = ausExpRed[i];
+				ausGreen[i] = ausExpGreen[i];
+				ausBlue[i]  = ausExpBlue[i];
+				aucIntegrationtime[i] = ucIntTimeLong;
+				aucGain[i] = ucGainLong;
 			}
+		}
 
-			iArrayPos ++;
+		if( iSaturated!=0 )
+		{
+			iResult = iSaturated | ERR_FLAG_EXCEEDED_CLEAR;
 		}
-		/* Go to the next device found */
-		devCounter ++;
 
-		printf("\n");
+		/* Each sensor is corrected with the offsets of the exposure which was chosen for it. */
+		dark_offset_apply(dark_offset_find(apHandles[handleIndex]), ausClear, ausRed, ausGreen, ausBlue,
+		                  aucIntegrationtime, aucGain);
 	}
 
-	printf("\n");
+	/* Restore the previous settings of all sensors. */
+	iErrorcode = tcs_setIntegrationTime_lanes(apHandles[handleIndex], apHandles[handleIndex+1], aucOldIntTime);
+	if( iErrorcode==0 )
+	{
+		iErrorcode = tcs_setGain_lanes(apHandles[handleIndex], apHandles[handleIndex+1], aucOldGain);
+	}
+	if( iErrorcode!=0 && iResult==0 )
+	{
+		iResult = read_colors_result(iErrorcode);
+	}
 
-	return devCounter;
+	return iResult;
 }
 
 
 
-/** \brief returns number of serial numbers stored in the serial number array.
-    @param asSerial     stores the serial numbers of all connected color controller devices
+/** \brief compares two unsigned short values, used for sorting with qsort.
+*/
+static int compare_ushort(const void* pvA, const void* pvB)
+{
+	return (int)(*(const unsigned short*)pvA) - (int)(*(const unsigned short*)pvB);
+}
 
-    @return             number of elements in the serial number array
+
+
+/** \brief reads the RGBC colors of all sensors under a device several times and returns statistics of the readings (oversampling).
+
+Single readings of the sensors are noisy. This function takes uiSamples conversions back to back and calculates the mean,
+the variance, the minimum, the maximum and the median of every color channel of every sensor. Mean and variance are calculated
+with Welford's online algorithm. Between two readings the function waits for the conversion time of the slowest sensor, so every
+sample is a new conversion.
+All result arrays are organized by channel first, each of them has 64 elements: index 0-15 contain the clear values of sensor
+0-15, index 16-31 the red, 32-47 the green and 48-63 the blue values.
+    @param apHandles            array that stores ftdi2232h handles
+    @param devIndex             device index of current color controller device
+    @param uiSamples            number of conversions to take, maximum is OVERSAMPLING_MAX_SAMPLES
+    @param afMean               stores 64 mean values
+    @param afVariance           stores 64 sample variances (0 for uiSamples = 1)
+    @param ausMin               stores 64 minimum values
+    @param ausMax               stores 64 maximum values
+    @param ausMedian            stores 64 median values
+    @param aucIntegrationtime   stores 16 integration time values of the sensors
+    @param aucGain              stores 16 gain values of the sensors
+
+    @retval 0  Succesful
+    @retval >0 Flag in DWORD HIGH marks what kind of error occured, 16 bits in DWORD LOW mark which of the 16 sensors failed
+    @retval <0 USB errors, i2c errors or indexing errors occured, check return value for further information
 */
-int get_number_of_serials(char** asSerial)
+int read_colors_oversampled(void** apHandles, int devIndex, unsigned int uiSamples,
+                            float* afMean, float* afVariance, unsigned short* ausMin, unsigned short* ausMax, unsigned short* ausMedian,
+                            unsigned char* aucIntegrationtime, unsigned char* aucGain)
 {
-	int counter = 0;
+	int iHandleLength;
+	int handleIndex;
+	int iErrorcode;
+	int iResult;
+	int iSaturated;
+	unsigned int uiRetries;
+	unsigned int uiSample;
+	unsigned int uiWaitTime;
+	unsigned int uiValue;
+	unsigned short* ausSamples;
+	unsigned short ausReading[64];
+	double adMean[64];
+	double adM2[64];
+	double dDelta;
+	int i;
 
 
-	while( asSerial[counter]!=NULL )
+	async_measurement_wait_running();
+	iHandleLength = get_number_of_handles(apHandles);
+	handleIndex = devIndex * 2;
+	if( handleIndex>=iHandleLength )
 	{
-		counter++;
+		printf("Exceeded maximum amount of handles ... \n");
+		printf("Amount of handles: %d trying to index: %d\n", iHandleLength, handleIndex);
+		return ERR_INDEXING;
 	}
 
-	return counter;
-}
-
-
-/** \brief returns number of handles stored in the handle array.
-    @param apHandles array that stores the handles
+	if( uiSamples==0 || uiSamples>OVERSAMPLING_MAX_SAMPLES )
+	{
+		printf("Invalid amount of samples for oversampling ... \n");
+		printf("Maximum amount of samples: %u requested: %u\n", OVERSAMPLING_MAX_SAMPLES, uiSamples);
+		return ERR_INDEXING;
+	}
 
-    @return number of elements in the handle array
-*/
+	iResult = tcs_getIntegrationtime(apHandles[handleIndex], apHandles[handleIndex+1], aucIntegrationtime);
+	if( iResult==0 )
+	{
+		iResult = tcs_getGain(apHandles[handleIndex], apHandles[handleIndex+1], aucGain);
+	}
+	if( iResult!=0 )
+	{
+		return read_colors_result(iResult);
+	}
 
-int get_number_of_handles(void ** apHandles)
-{
-	int counter = 0;
+	/* The slowest sensor determines the time between two samples. */
+	uiWaitTime = 0;
+	for(i=0; i<16; i++)
+	{
+		if( tcs_getConversionTime_ms(aucIntegrationtime[i])>uiWaitTime )
+		{
+			uiWaitTime = tcs_getConversionTime_ms(aucIntegrationtime[i]);
+		}
+	}
 
+	/* The samples of each channel and sensor are kept in one consecutive block for the median. */
+	ausSamples = (unsigned short*)malloc(sizeof(unsigned short) * 64 * uiSamples);
+	if( ausSamples==NULL )
+	{
+		printf("Could not allocate memory for %u samples ... \n", uiSamples);
+		return ERR_DEVICE_FATAL;
+	}
 
-	while( apHandles[counter]!=NULL )
+	for(i=0; i<64; i++)
 	{
-		counter++;
+		adMean[i] = 0.0;
+		adM2[i] = 0.0;
+		ausMin[i] = 0xffff;
+		ausMax[i] = 0;
 	}
 
-	return counter;
-}
+	iSaturated = 0;
+	for(uiSample=0; uiSample<uiSamples && iResult==0; uiSample++)
+	{
+		sleep_ms(uiWaitTime + 1);
 
+		/* Give sensors which are not finished yet some more time. */
+		uiRetries = 0;
+		do
+		{
+			iErrorcode = tcs_readColors(apHandles[handleIndex], apHandles[handleIndex+1],
+			                            ausReading, ausReading+16, ausReading+32, ausReading+48);
+			uiRetries++;
+			if( iErrorcode>0 && uiRetries<OVERSAMPLING_MAX_RETRIES )
+			{
+				sleep_ms(HDR_INIT_TIME_MS);
+			}
+		} while( iErrorcode>0 && uiRetries<OVERSAMPLING_MAX_RETRIES );
 
-/** \brief returns the device number corresponding to a certain handleIndex.
+		iResult = read_colors_result(iErrorcode);
+		if( iResult!=0 )
+		{
+			break;
+		}
 
-As each device has 2 handles, the device index and the handle index are not the same. Following functions
-provides an easy way to get the device number if a handle index is given 
-    @param handleIndex  index of the handle
+		for(i=0; i<64; i++)
+		{
+			uiValue = ausReading[i];
+			ausSamples[i*uiSamples + uiSample] = (unsigned short)uiValue;
 
-    @return             device index that corresponds to the handle index
-*/
-int handleToDevice(int handleIndex)
-{
-	return (int)(handleIndex/2);
-}
+			/* Welford's online algorithm */
+			dDelta = uiValue - adMean[i];
+			adMean[i] += dDelta / (uiSample + 1);
+			adM2[i] += dDelta * (uiValue - adMean[i]);
+
+			if( uiValue<ausMin[i] )
+			{
+				ausMin[i] = (unsigned short)uiValue;
+			}
+			if( uiValue>ausMax[i] )
+			{
+				ausMax[i] = (unsigned short)uiValue;
+			}
+		}
+
+		for(i=0; i<16; i++)
+		{
+			if( ausReading[i]>=tcs_getMaxClear(aucIntegrationtime[i]) )
+			{
+				iSaturated |= (1<<i);
+			}
+		}
+	}
+
+	if( iResult==0 )
+	{
+		for(i=0; i<64; i++)
+		{
+			afMean[i] = (float)adMean[i];
+			afVariance[i] = (uiSamples>1) ? (float)(adM2[i] / (uiSamples - 1)) : 0.0f;
+
+			qsort(ausSamples + i*uiSamples, uiSamples, sizeof(unsigned short), compare_ushort);
+			if( (uiSamples & 1)!=0 )
+			{
+				ausMedian[i] = ausSamples[i*uiSamples + uiSamples/2];
+			}
+			else
+			{
+				ausMedian[i] = (unsigned short)((ausSamples[i*uiSamples + uiSamples/2 - 1] + ausSamples[i*uiSamples + uiSamples/2] + 1) / 2);
+			}
+		}
 
+		if( iSaturated!=0 )
+		{
+			iResult = iSaturated | ERR_FLAG_EXCEEDED_CLEAR;
+		}
+	}
 
+	free(ausSamples);
 
+	return iResult;
+}
 
 
-/** \brief initializes the sensors of a color controller device.
 
-Function initializes the 16 sensors of a color controller device. Initializing includes turning the sensors on
-clearing their interrupt flags and identifying them to be sure that the i2c-protocol works and following color readings
-are valid.
-    @param apHandles       array that stores ftdi2232h handles
-    @param devIndex        device index of current color controller device
+/** \brief reads the clear channel of all sensors under a device back to back with the shortest integration time (burst mode).
+
+Burst mode is used to capture time resolved signals, like blinking or PWM driven LEDs. The integration time of all
+sensors is set to 2.4ms and only the status register and the clear channel are read, which keeps the i2c transfer short.
+Each sample is stored with a timestamp, so jitter of the usb transfers does not falsify the frequency measurement. The
+timestamp of a sample is the middle of its i2c transfer in microseconds, relative to the start of the burst. The previous
+integration time settings of the sensors are restored after the burst.
+A reading starts at least BURST_PERIOD_US after the end of the previous one, so every sample has a new conversion and a
+fast usb connection does not return the same conversion several times. A reading where a sensor has no valid conversion
+(AVALID not set) is dropped and taken again, up to OVERSAMPLING_MAX_RETRIES times in a row.
+    @param apHandles        array that stores ftdi2232h handles
+    @param devIndex         device index of current color controller device
+    @param uiSamples        number of samples to take, maximum is BURST_MAX_SAMPLES
+    @param ausClear         stores uiSamples * 16 clear values, the 16 values of sample n start at index n*16
+    @param auiTimestamps    stores uiSamples timestamps in microseconds
 
     @retval 0  Succesful
     @retval >0 Flag in DWORD HIGH marks what kind of error occured, 16 bits in DWORD LOW mark which of the 16 sensors failed
     @retval <0 USB errors, i2c errors or indexing errors occured, check return value for further information
 */
-int init_sensors(void** apHandles, int devIndex)
+int read_clear_burst(void** apHandles, int devIndex, unsigned int uiSamples, unsigned short* ausClear, unsigned int* auiTimestamps)
 {
-	/* 2 handles per device, device 0 has handles 0,1 .. device 1 has handles 2,3 and so on*/
-	int handleIndex = devIndex * 2;
-	int iErrorcode = 0;
-	unsigned char aucTempbuffer[16];
+	int iHandleLength;
+	int handleIndex;
+	int iErrorcode;
 	int iResult;
-
-	// be optimistic
-	iResult = 0;
-
-	int iHandleLength = get_number_of_handles(apHandles);
+	unsigned char aucOldIntTime[16];
+	unsigned long long ullStart;
+	unsigned long long ullBefore;
+	unsigned long long ullAfter;
+	unsigned int uiSample;
+	unsigned int uiRetries;
 
 
+	async_measurement_wait_running();
+	iHandleLength = get_number_of_handles(apHandles);
+	handleIndex = devIndex * 2;
 	if( handleIndex>=iHandleLength )
 	{
 		printf("Exceeded maximum amount of handles ... \n");
@@ -392,111 +1171,246 @@ int init_sensors(void** apHandles, int devIndex)
 		return ERR_INDEXING;
 	}
 
-	iResult = tcs_clearInt(apHandles[handleIndex], apHandles[handleIndex+1]);
-	if(iResult != 0)
+	if( uiSamples>BURST_MAX_SAMPLES )
 	{
-		printf("... failed to clear interrupt channel on device %d...\n", devIndex);
-		return iResult;
+		printf("Exceeded maximum amount of burst samples ... \n");
+		printf("Maximum amount of samples: %u requested: %u\n", BURST_MAX_SAMPLES, uiSamples);
+		return ERR_INDEXING;
 	}
 
-	iResult = tcs_ON(apHandles[handleIndex], apHandles[handleIndex+1]);
-	if(iResult != 0)
+	iResult = tcs_getIntegrationtime(apHandles[handleIndex], apHandles[handleIndex+1], aucOldIntTime);
+	if( iResult!=0 )
 	{
-		printf("... failed to turn the sensors on on device %d...\n", devIndex);
-		return iResult;
+		return read_colors_result(iResult);
 	}
 
-// Checks whether the sensors are activated
-	iErrorcode = tcs_identify(apHandles[handleIndex], apHandles[handleIndex+1], aucTempbuffer);
-	if( iErrorcode>0 )
+	iResult = tcs_setIntegrationTime(apHandles[handleIndex], apHandles[handleIndex+1], TCS3472_INTEGRATION_2_4ms);
+	if( iResult==0 )
 	{
-		return (iErrorcode | ERR_FLAG_ID);
+		iResult = tcs_restartIntegration(apHandles[handleIndex], apHandles[handleIndex+1]);
 	}
 
-	return iErrorcode;
+	if( iResult==0 )
+	{
+		/* Wait for the first complete conversion with the new setting. */
+		sleep_ms(HDR_INIT_TIME_MS + tcs_getConversionTime_ms(TCS3472_INTEGRATION_2_4ms));
+
+		ullStart = timestamp_us();
+		/* The first reading does not have to wait, the conversion above is complete. */
+		ullAfter = ullStart - BURST_PERIOD_US;
+		uiRetries = 0;
+		uiSample = 0;
+		while( uiSample<uiSamples )
+		{
+			/* Wait one conversion after the end of the last reading, so this reading has a new conversion.
+			 * Most of the wait is slept, only the last BURST_SPIN_US are busy-waited to hit the end exactly.
+			 */
+			ullBefore = timestamp_us();
+			if( ullBefore - ullAfter + BURST_SPIN_US < BURST_PERIOD_US )
+			{
+				sleep_us((unsigned int)(BURST_PERIOD_US - BURST_SPIN_US - (ullBefore - ullAfter)));
+			}
+			while( ullBefore - ullAfter < BURST_PERIOD_US )
+			{
+				ullBefore = timestamp_us();
+			}
+
+			iErrorcode = tcs_readWindow(apHandles[handleIndex], apHandles[handleIndex+1], TCS_WINDOW_STATUS_CLEAR, ausClear + uiSample*16,
+			                            NULL, NULL, NULL);
+			ullAfter = timestamp_us();
+			if( iErrorcode<0 || (iErrorcode>0 && uiRetries>=OVERSAMPLING_MAX_RETRIES) )
+			{
+				iResult = read_colors_result(iErrorcode);
+				break;
+			}
+			else if( iErrorcode>0 )
+			{
+				/* Some sensors have no valid conversion, drop the reading and take it again. */
+				uiRetries++;
+			}
+			else
+			{
+				auiTimestamps[uiSample] = (unsigned int)(((ullBefore + ullAfter) / 2) - ullStart);
+				uiRetries = 0;
+				uiSample++;
+			}
+		}
+	}
+
+	/* Restore the previous integration time of all sensors. */
+	iErrorcode = tcs_setIntegrationTime_lanes(apHandles[handleIndex], apHandles[handleIndex+1], aucOldIntTime);
+	if( iErrorcode!=0 && iResult==0 )
+	{
+		iResult = read_colors_result(iErrorcode);
+	}
+
+	return iResult;
 }
 
 
 
-/** \brief reads the RGBC colors of all sensors under a device and checks if the colors are valid
+/** \brief analyzes the clear values of a burst (see read_clear_burst) for periodic signals like blinking LEDs.
 
-Function reads the colors red, green, blue and clear of all 16 sensors under a device and stores them in adequate buffers.
-Furthermore the function will check if maximum clear levels have been exceeded. If so, the color reading won't be valid, as the sensor has
-been saturated, and color reading for failing sensor(s) should be redone. If maximum clear levels are beeing exceeded too often, one
-should consider lowering gain and/or integration time settings. The function will return a returncode which can be used to determine
-which of the color sensors have exceeded maximum clear levels. Furthermore the function will store the sensors' measured
-LUX level in an array. This level is calculated by a formula given in AMS / TAOS Designer's Note 40.
-    @param apHandles            array that stores ftdi2232h handles
-    @param devIndex             device index of current color controller device
-    @param ausClear             stores 16 clear colors
-    @param ausRed               stores 16 red colors
-    @param ausGreen             stores 16 green colors
-    @param ausBlue              stores 16 blue colors
-    @param aucIntegrationtime   stores 16 integration time values of the sensors
-    @param aucGain              stores 16 gain values of the sensors
+For each sensor the swing between the darkest and the brightest sample is determined. If the swing is big enough, the samples are
+divided into on and off states with a hysteresis of BLINK_HYSTERESIS_PERCENT around the middle of the swing. The period is the
+mean distance of the rising edges, the duty cycle is the share of the on time within the complete periods. The on and off levels
+are the mean clear values of all samples in on and off state. Sensors without a swing or with less than 2 rising edges get a
+period of 0, in this case the on and off levels are both set to the mean clear value and the duty cycle is 0% for a dark sensor and
+100% for a bright one.
+    @param ausClear         uiSamples * 16 clear values as stored by read_clear_burst
+    @param auiTimestamps    uiSamples timestamps in microseconds as stored by read_clear_burst
+    @param uiSamples        number of samples in ausClear and auiTimestamps
+    @param afPeriod_ms      stores 16 periods in milliseconds, 0 if no periodic signal was detected
+    @param afDutyCycle      stores 16 duty cycles in percent
+    @param ausOnLevel       stores 16 mean clear levels of the on state
+    @param ausOffLevel      stores 16 mean clear levels of the off state
 
     @retval 0  Succesful
-    @retval >0 Flag in DWORD HIGH marks what kind of error occured, 16 bits in DWORD LOW mark which of the 16 sensors failed
-    @retval <0 USB errors, i2c errors or indexing errors occured, check return value for further information
+    @retval >0 16 bits in DWORD LOW mark which of the 16 sensors showed no periodic signal
 */
-int read_colors(void** apHandles, int devIndex, unsigned short* ausClear, unsigned short* ausRed,
-                unsigned short* ausGreen, unsigned short* ausBlue,
-                unsigned char* aucIntegrationtime, unsigned char* aucGain)
+int analyze_blink(unsigned short* ausClear, unsigned int* auiTimestamps, unsigned int uiSamples,
+                  float* afPeriod_ms, float* afDutyCycle, unsigned short* ausOnLevel, unsigned short* ausOffLevel)
 {
-	int iHandleLength;
-	int handleIndex;
-	int iErrorcode;
-	unsigned char aucTempbuffer[16];
 	int iResult;
+	unsigned int uiSensor;
+	unsigned int uiSample;
+	unsigned int uiMin;
+	unsigned int uiMax;
+	unsigned int uiValue;
+	unsigned int uiSwing;
+	unsigned int uiThresholdHigh;
+	unsigned int uiThresholdLow;
+	unsigned int uiRisingEdges;
+	unsigned int uiFirstEdge;
+	unsigned int uiLastEdge;
+	unsigned int uiOnCount;
+	unsigned int uiOffCount;
+	unsigned long ulOnSum;
+	unsigned long ulOffSum;
+	unsigned long ulSum;
+	double dOnTime;
+	int iState;
 
-	// Be optimistic
-	iErrorcode = 0;
 
-	iHandleLength = get_number_of_handles(apHandles);
-	handleIndex = devIndex * 2;
-	/* Transform device index into handle index, as each device has two handles */
-	if( handleIndex>=iHandleLength )
-	{
-		printf("Exceeded maximum amount of handles ... \n");
-		printf("Amount of handles: %d trying to index: %d\n", iHandleLength, handleIndex);
-		iResult = ERR_INDEXING;
-	}
-	else
+	iResult = 0;
+	for(uiSensor=0; uiSensor<16; uiSensor++)
 	{
-		tcs_getIntegrationtime(apHandles[handleIndex], apHandles[handleIndex+1], aucIntegrationtime);
-		tcs_getGain(apHandles[handleIndex], apHandles[handleIndex+1], aucGain);
+		afPeriod_ms[uiSensor] = 0.0f;
+		afDutyCycle[uiSensor] = 0.0f;
+		ausOnLevel[uiSensor] = 0;
+		ausOffLevel[uiSensor] = 0;
 
-		iErrorcode = tcs_readColors(apHandles[handleIndex], apHandles[handleIndex+1], ausClear, ausRed, ausGreen, ausBlue);
-		/* Fatal error has occured as we could not read from channel A and channel B */
-		if(iErrorcode <= -1 && iErrorcode >= -4)
+		if( uiSamples==0 )
 		{
-			iResult = ERR_DEVICE_FATAL;
+			iResult |= (1<<uiSensor);
+			continue;
 		}
-		/* Usb error has occured - read different amount of bytes than expected */
-		else if(iErrorcode <= -5 && iErrorcode >= -6)
+
+		uiMin = 0xffff;
+		uiMax = 0;
+		ulSum = 0;
+		for(uiSample=0; uiSample<uiSamples; uiSample++)
 		{
-			iResult = ERR_USB;
+			uiValue = ausClear[uiSample*16 + uiSensor];
+			if( uiValue<uiMin )
+			{
+				uiMin = uiValue;
+			}
+			if( uiValue>uiMax )
+			{
+				uiMax = uiValue;
+			}
+			ulSum += uiValue;
 		}
-		/* Some sensors have not finished their conversion cycle yet */
-		else if(iErrorcode >  0)
+
+		uiSwing = uiMax - uiMin;
+		/* The swing must be above the noise floor and a noticeable part of the brightest value. */
+		if( uiSwing<BLINK_MIN_SWING || uiSwing*10<uiMax )
 		{
-			iResult = iErrorcode | ERR_FLAG_INCOMPL_CONV;
+			ausOnLevel[uiSensor] = (unsigned short)(ulSum / uiSamples);
+			ausOffLevel[uiSensor] = ausOnLevel[uiSensor];
+			afDutyCycle[uiSensor] = (uiMin>=BLINK_MIN_SWING) ? 100.0f : 0.0f;
+			iResult |= (1<<uiSensor);
+			continue;
 		}
-		else
+
+		uiThresholdHigh = uiMin + (uiSwing * (50 + BLINK_HYSTERESIS_PERCENT)) / 100;
+		uiThresholdLow  = uiMin + (uiSwing * (50 - BLINK_HYSTERESIS_PERCENT)) / 100;
+
+		/* First pass: find the rising edges and the on / off levels. */
+		iState = (ausClear[uiSensor] >= uiMin + uiSwing/2);
+		uiRisingEdges = 0;
+		uiFirstEdge = 0;
+		uiLastEdge = 0;
+		uiOnCount = 0;
+		uiOffCount = 0;
+		ulOnSum = 0;
+		ulOffSum = 0;
+		for(uiSample=0; uiSample<uiSamples; uiSample++)
 		{
-			/* Clear levels have been exceeded on some sensors */
-			iErrorcode = tcs_exClear(apHandles[handleIndex], apHandles[handleIndex+1], ausClear, aucIntegrationtime);
-			if( iErrorcode>0 )
+			uiValue = ausClear[uiSample*16 + uiSensor];
+			if( iState==0 && uiValue>=uiThresholdHigh )
 			{
-				iResult = iErrorcode | ERR_FLAG_EXCEEDED_CLEAR;
+				iState = 1;
+				if( uiRisingEdges==0 )
+				{
+					uiFirstEdge = uiSample;
+				}
+				uiLastEdge = uiSample;
+				uiRisingEdges++;
+			}
+			else if( iState!=0 && uiValue<=uiThresholdLow )
+			{
+				iState = 0;
+			}
+
+			if( iState!=0 )
+			{
+				ulOnSum += uiValue;
+				uiOnCount++;
 			}
 			else
 			{
-				iResult = iErrorcode;
+				ulOffSum += uiValue;
+				uiOffCount++;
+			}
+		}
+
+		ausOnLevel[uiSensor]  = (unsigned short)((uiOnCount>0)  ? ulOnSum/uiOnCount   : uiMax);
+		ausOffLevel[uiSensor] = (unsigned short)((uiOffCount>0) ? ulOffSum/uiOffCount : uiMin);
+
+		if( uiRisingEdges<2 || auiTimestamps[uiLastEdge]==auiTimestamps[uiFirstEdge] )
+		{
+			afDutyCycle[uiSensor] = (100.0f * uiOnCount) / uiSamples;
+			iResult |= (1<<uiSensor);
+			continue;
+		}
+
+		/* Second pass: sum up the on time within the complete periods between the first and the last rising edge. */
+		iState = 1;
+		dOnTime = 0.0;
+		for(uiSample=uiFirstEdge; uiSample<uiLastEdge; uiSample++)
+		{
+			uiValue = ausClear[uiSample*16 + uiSensor];
+			if( uiValue>=uiThresholdHigh )
+			{
+				iState = 1;
+			}
+			else if( uiValue<=uiThresholdLow )
+			{
+				iState = 0;
+			}
+
+			if( iState!=0 )
+			{
+				dOnTime += (double)(auiTimestamps[uiSample+1] - auiTimestamps[uiSample]);
 			}
 		}
+
+		afPeriod_ms[uiSensor] = (float)((auiTimestamps[uiLastEdge] - auiTimestamps[uiFirstEdge]) / 1000.0 / (uiRisingEdges - 1));
+		afDutyCycle[uiSensor] = (float)(100.0 * dOnTime / (double)(auiTimestamps[uiLastEdge] - auiTimestamps[uiFirstEdge]));
 	}
-	
+
 	return iResult;
 }
 
@@ -515,6 +1429,7 @@ void free_devices(void** apHandles)
 	int iHandleLength;
 
 
+	async_measurement_wait_running();
 	iHandleLength = get_number_of_handles(apHandles);
 	printf("Number of handles to delete: %d\n", iHandleLength);
 
@@ -522,6 +1437,8 @@ void free_devices(void** apHandles)
 	while( index<iHandleLength )
 	{
 		printf("Freeing handle # %d on device # %d\n", index, handleToDevice(index));
+		/* The dark offsets are attached to the first handle of a device. */
+		dark_offset_detach(apHandles[index]);
 		ftdi_usb_close(apHandles[index]);
 		ftdi_free(apHandles[index]);
 		apHandles[index] = NULL;
@@ -552,6 +1469,7 @@ int set_intTime_x(void** apHandles, int devIndex, unsigned int uiX, unsigned cha
 	int iResult;
 
 
+	async_measurement_wait_running();
 	iHandleLength = get_number_of_handles(apHandles);
 	handleIndex = devIndex * 2;
 	if(handleIndex >= iHandleLength)
@@ -590,6 +1508,7 @@ int set_gain_x(void** apHandles, int devIndex, unsigned int uiX, unsigned char g
 	int iResult;
 
 
+	async_measurement_wait_running();
 	iHandleLength = get_number_of_handles(apHandles);
 	handleIndex = devIndex * 2;
 	if(handleIndex >= iHandleLength)
@@ -627,6 +1546,7 @@ int set_gain(void** apHandles, int devIndex, unsigned char gain)
 	int iResult;
 
 
+	async_measurement_wait_running();
 	iHandleLength = get_number_of_handles(apHandles);
 	handleIndex = devIndex * 2;
 	if(handleIndex >= iHandleLength)
@@ -662,6 +1582,7 @@ int get_gain(void** apHandles, int devIndex, unsigned char* aucGains)
 	int iResult;
 
 
+	async_measurement_wait_running();
 	iHandleLength = get_number_of_handles(apHandles);
 	handleIndex = devIndex * 2;
 	if(handleIndex >= iHandleLength)
@@ -700,6 +1621,7 @@ int set_intTime(void** apHandles, int devIndex, unsigned char integrationtime)
 	int iResult;
 
 
+	async_measurement_wait_running();
 	iHandleLength = get_number_of_handles(apHandles);
 	handleIndex = devIndex * 2;
 	if(handleIndex >= iHandleLength)
@@ -737,6 +1659,7 @@ int get_intTime(void** apHandles, int devIndex, unsigned char* aucIntegrationtim
 	int iResult;
 
 
+	async_measurement_wait_running();
 	iHandleLength = get_number_of_handles(apHandles);
 	handleIndex = devIndex * 2;
 	if(handleIndex >= iHandleLength)
@@ -755,6 +1678,18 @@ int get_intTime(void** apHandles, int devIndex, unsigned char* aucIntegrationtim
 
 
 
+/** \brief returns the version of the stable C interface (see led_analyzer_api.h).
+
+Bindings which do not use SWIG, e.g. the LuaJIT FFI binding, check the version before they use the library.
+	@return 			LED_ANALYZER_API_VERSION
+*/
+int led_analyzer_api_version(void)
+{
+	return LED_ANALYZER_API_VERSION;
+}
+
+
+
 /** waits for a time specified in uiWaitTime ]1 ms ... 10 s] max 
     @param uiWaitTime   time in milliseconds to wait in order to let the sensors complete their ADC measurements
 */
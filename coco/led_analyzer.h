@@ -42,6 +42,48 @@ provides the functions which are required for the application CoCo App.
 /** Maximum Length of characters a descriptor in the ftdi2232h eeprom can have */
 #define MAX_DESCLENGTH 128
 
+/** Time in ms which is added to the conversion time after an integration restart (power on to ADC enable takes 2.4ms) */
+#define HDR_INIT_TIME_MS 3
+/** Clear level below which an exposure in HDR mode is considered to be too dark to be used */
+#define HDR_MIN_CLEAR 20
+
+/** Maximum number of samples in one burst (burst mode, clear channel only) */
+#define BURST_MAX_SAMPLES 8192
+/** Time in microseconds between the end of a burst reading and the start of the next one, this is one conversion with
+    the integration time of the burst (2.4ms), so every reading has a new conversion */
+#define BURST_PERIOD_US 2400
+/** Time in microseconds before the next burst reading which is busy-waited, the time before is slept */
+#define BURST_SPIN_US 200
+/** Minimum difference between the darkest and the brightest sample to detect a blinking LED */
+#define BLINK_MIN_SWING 8
+/** Hysteresis in percent of the swing around its middle, which is used to separate the on and off states of a blinking LED */
+#define BLINK_HYSTERESIS_PERCENT 10
+
+/** Maximum number of conversions in one oversampled reading */
+#define OVERSAMPLING_MAX_SAMPLES 1024
+/** Maximum number of attempts to read a sample if some sensors have not completed their conversion yet */
+#define OVERSAMPLING_MAX_RETRIES 5
+
+/** Register window of read_colors_window - clear channel only */
+#define READ_WINDOW_CLEAR 0
+/** Register window of read_colors_window - status register and clear channel */
+#define READ_WINDOW_STATUS_CLEAR 1
+/** Register window of read_colors_window - red, green and blue channels */
+#define READ_WINDOW_RGB 2
+/** Register window of read_colors_window - status register and all channels, like read_colors */
+#define READ_WINDOW_FULL 3
+/** Mask for the register window in the parameter of read_colors_window */
+#define READ_WINDOW_MASK 0xff
+/** Flag for read_colors_window - the caller passes the integration time and gain settings, they are not read from the sensors */
+#define READ_WINDOW_KEEP_SETTINGS 0x100
+
+/** Populated sensors of connect_to_devices_lanes - all 16 sensors */
+#define LANES_ALL 0xffff
+/** Populated sensors of connect_to_devices_lanes - the sensors 0-7 on channel A */
+#define LANES_CHANNEL_A 0x00ff
+/** Populated sensors of connect_to_devices_lanes - the sensors 8-15 on channel B */
+#define LANES_CHANNEL_B 0xff00
+
 /** \brief Contains Errorcodes and Errorflags which indicate what kind of errors occured
 
 The errorflags indicate what kind of error occured. They get ored with the erroflag of the sensors in order to
@@ -71,9 +113,27 @@ enum E_ERROR
 
 int  scan_devices(char** asSerial, unsigned int uiLength);	
 int  connect_to_devices(void** apHandles, int apHlength, char** asLength);
+int  connect_to_devices_lanes(void** apHandles, int apHlength, char** asSerial, const unsigned short* ausLanes);
+int  probe_sensors(void** apHandles, int devIndex);
 int  read_colors(void** apHandles, int devIndex, unsigned short *ausClear, unsigned short* ausRed,
 	 unsigned short *ausGreen, unsigned short* ausBlue,
 	 unsigned char *aucIntegrationtime, unsigned char* aucGain);
+int  read_colors_all(void** apHandles, unsigned short* ausClear, unsigned short* ausRed,
+	 unsigned short* ausGreen, unsigned short* ausBlue,
+	 unsigned char* aucIntegrationtime, unsigned char* aucGain, int* aiResults);
+int  read_colors_window(void** apHandles, int devIndex, unsigned int uiWindow, unsigned short* ausClear, unsigned short* ausRed,
+	 unsigned short* ausGreen, unsigned short* ausBlue,
+	 unsigned char* aucIntegrationtime, unsigned char* aucGain);
+int  read_colors_hdr(void** apHandles, int devIndex, unsigned char ucIntTimeShort, unsigned char ucGainShort,
+	 unsigned char ucIntTimeLong, unsigned char ucGainLong,
+	 unsigned short *ausClear, unsigned short* ausRed, unsigned short *ausGreen, unsigned short* ausBlue,
+	 unsigned char *aucIntegrationtime, unsigned char* aucGain);
+int  read_colors_oversampled(void** apHandles, int devIndex, unsigned int uiSamples,
+	 float* afMean, float* afVariance, unsigned short* ausMin, unsigned short* ausMax, unsigned short* ausMedian,
+	 unsigned char* aucIntegrationtime, unsigned char* aucGain);
+int  read_clear_burst(void** apHandles, int devIndex, unsigned int uiSamples, unsigned short* ausClear, unsigned int* auiTimestamps);
+int  analyze_blink(unsigned short* ausClear, unsigned int* auiTimestamps, unsigned int uiSamples,
+	 float* afPeriod_ms, float* afDutyCycle, unsigned short* ausOnLevel, unsigned short* ausOffLevel);
 int  init_sensors(void** apHandles, int devIndex);
 int  get_number_of_handles(void ** apHandles);
 int  handleToDevice(int handle);
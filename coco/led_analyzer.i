@@ -4,6 +4,7 @@
 // this declares a batch of function for manipulating C integer arrays
 %array_functions(unsigned short, ushort)
 %array_functions(unsigned long, ulong)
+%array_functions(unsigned int, uint)
 %array_functions(int, integer)
 %array_functions(void*, apvoid)
 %array_functions(char*, astring)
@@ -25,7 +26,636 @@
 %include "led_analyzer.h"
 
 %{
+	#include <math.h>
+	#include <stdlib.h>
+
 	#include "led_analyzer.h"
+	#include "led_analyzer_lua.h"
+%}
+
+
+// Native functions, they build their Lua results directly in C.
+%native(aus2colorTable) int native_aus2colorTable(lua_State* L);
+%native(Yxy2wavelength) int native_Yxy2wavelength(lua_State* L);
+%native(read_all) int native_read_all(lua_State* L);
+%native(read_all_colorTables) int native_read_all_colorTables(lua_State* L);
+%native(read_oversampled) int native_read_oversampled(lua_State* L);
+%native(new_sample_buffer) int native_new_sample_buffer(lua_State* L);
+%native(read_all_buffer) int native_read_all_buffer(lua_State* L);
+%native(view_ushort) int native_view_ushort(lua_State* L);
+%native(view_puchar) int native_view_puchar(lua_State* L);
+%native(view_uint) int native_view_uint(lua_State* L);
+%native(view_afloat) int native_view_afloat(lua_State* L);
+%native(encode_result_frame) int native_encode_result_frame(lua_State* L);
+%native(decode_result_frame) int native_decode_result_frame(lua_State* L);
+%native(new_async) int native_new_async(lua_State* L);
+%native(start_async) int native_start_async(lua_State* L);
+%native(buffer_colorTables) int native_buffer_colorTables(lua_State* L);
+%native(new_test_plan) int native_new_test_plan(lua_State* L);
+%native(buffer_validate) int native_buffer_validate(lua_State* L);
+%native(new_sequential_test) int native_new_sequential_test(lua_State* L);
+%native(open_measurement_log) int native_open_measurement_log(lua_State* L);
+%native(open_measurement_segment) int native_open_measurement_segment(lua_State* L);
+%native(read_measurement_index) int native_read_measurement_index(lua_State* L);
+%native(new_dark_offset) int native_new_dark_offset(lua_State* L);
+%native(set_dark_offsets) int native_set_dark_offsets(lua_State* L);
+
+%{
+	/* aus2colorTable(ausClear, ausRed, ausGreen, ausBlue, aucIntegrationtime, aucGain, length)
+	 * Converts the readings of 'length' lanes into a color table, see Color_conversions:aus2colorTable.
+	 */
+	static int native_aus2colorTable(lua_State* L)
+	{
+		unsigned short* ausClear;
+		unsigned short* ausRed;
+		unsigned short* ausGreen;
+		unsigned short* ausBlue;
+		unsigned char* aucIntegrationtime;
+		unsigned char* aucGain;
+		unsigned int uiLength;
+		COLOR_SPACES_T* ptColorSpaces;
+
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 1, (void**)&ausClear, SWIGTYPE_p_unsigned_short, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 2, (void**)&ausRed, SWIGTYPE_p_unsigned_short, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 3, (void**)&ausGreen, SWIGTYPE_p_unsigned_short, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 4, (void**)&ausBlue, SWIGTYPE_p_unsigned_short, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 5, (void**)&aucIntegrationtime, SWIGTYPE_p_unsigned_char, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 6, (void**)&aucGain, SWIGTYPE_p_unsigned_char, 0)) )
+		{
+			return luaL_error(L, "aus2colorTable: expected 4 ushort arrays and 2 puchar arrays");
+		}
+		uiLength = (unsigned int)luaL_checknumber(L, 7);
+
+		ptColorSpaces = color_spaces_new(uiLength);
+		if( ptColorSpaces==NULL )
+		{
+			return luaL_error(L, "aus2colorTable: out of memory");
+		}
+		color_spaces_calculate(ptColorSpaces, ausClear, ausRed, ausGreen, ausBlue, aucIntegrationtime, aucGain);
+		led_analyzer_push_colorTable(L, ptColorSpaces, 0, uiLength, ausClear, ausRed, ausGreen, ausBlue, aucIntegrationtime, aucGain);
+		color_spaces_free(ptColorSpaces);
+
+		return 1;
+	}
+
+	/* nm, saturation = Yxy2wavelength(x, y, fInterpolate)
+	 * Gets the dominant wavelength and the saturation (0 to 1) of a x,y chromaticity, see color_Yxy2wavelength.
+	 * If fInterpolate is true, the wavelength is interpolated between the entries of the spectral locus.
+	 */
+	static int native_Yxy2wavelength(lua_State* L)
+	{
+		double dx;
+		double dy;
+		double dWavelength;
+		double dSaturation;
+
+		dx = luaL_checknumber(L, 1);
+		dy = luaL_checknumber(L, 2);
+		if( lua_toboolean(L, 3) )
+		{
+			color_Yxy2wavelength_interpolated(dx, dy, &dWavelength, &dSaturation);
+		}
+		else
+		{
+			color_Yxy2wavelength(dx, dy, &dWavelength, &dSaturation);
+		}
+		lua_pushnumber(L, dWavelength);
+		lua_pushnumber(L, dSaturation);
+
+		return 2;
+	}
+
+	/* Reads all connected devices with read_colors_all.
+	 * Pushes the readings (fColorTables = 0) or the color tables (fColorTables = 1) and a table with the result of every device.
+	 */
+	static int read_all_push(lua_State* L, int fColorTables)
+	{
+		void** apHandles;
+		char** asSerials;
+		int iDevices;
+		unsigned short* ausReadings;
+		unsigned char* aucSettings;
+		int* aiResults;
+		COLOR_SPACES_T* ptColorSpaces;
+
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 1, (void**)&apHandles, SWIGTYPE_p_p_void, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 2, (void**)&asSerials, SWIGTYPE_p_p_char, 0)) )
+		{
+			return luaL_error(L, "read_all: expected the handle array and the serial array");
+		}
+
+		/* One block for the readings, one for the settings, 16 lanes per device. */
+		iDevices = get_number_of_handles(apHandles) / 2;
+		ausReadings = (unsigned short*)malloc(sizeof(unsigned short) * 4 * 16 * (iDevices + 1));
+		aucSettings = (unsigned char*)malloc(2 * 16 * (iDevices + 1));
+		aiResults = (int*)malloc(sizeof(int) * (iDevices + 1));
+		ptColorSpaces = NULL;
+		if( ausReadings==NULL || aucSettings==NULL || aiResults==NULL )
+		{
+			free(ausReadings);
+			free(aucSettings);
+			free(aiResults);
+			return luaL_error(L, "read_all: out of memory");
+		}
+
+		iDevices = read_colors_all(apHandles, ausReadings, ausReadings + 16*iDevices, ausReadings + 32*iDevices, ausReadings + 48*iDevices,
+		                           aucSettings, aucSettings + 16*iDevices, aiResults);
+
+		if( fColorTables==0 )
+		{
+			led_analyzer_push_readings(L, asSerials, iDevices, ausReadings, ausReadings + 16*iDevices, ausReadings + 32*iDevices, ausReadings + 48*iDevices,
+			                           aucSettings, aucSettings + 16*iDevices, aiResults);
+		}
+		else
+		{
+			ptColorSpaces = color_spaces_new(16 * iDevices);
+			if( ptColorSpaces!=NULL )
+			{
+				color_spaces_calculate(ptColorSpaces, ausReadings, ausReadings + 16*iDevices, ausReadings + 32*iDevices, ausReadings + 48*iDevices,
+				                       aucSettings, aucSettings + 16*iDevices);
+				led_analyzer_push_colorTables(L, asSerials, iDevices, ptColorSpaces, ausReadings, ausReadings + 16*iDevices,
+				                              ausReadings + 32*iDevices, ausReadings + 48*iDevices, aucSettings, aucSettings + 16*iDevices);
+				color_spaces_free(ptColorSpaces);
+			}
+			else
+			{
+				lua_pushnil(L);
+			}
+		}
+		led_analyzer_push_results(L, asSerials, iDevices, aiResults);
+
+		free(ausReadings);
+		free(aucSettings);
+		free(aiResults);
+
+		return 2;
+	}
+
+	/* tReadings, tResults = read_all(apHandles, asSerials)
+	 * Reads all connected devices in one call.
+	 * tReadings[serial] = { result = iResult, lanes = { [1..16] = { clear, red, green, blue, gain, intTime, status } } }
+	 * tResults[serial] = iResult
+	 */
+	static int native_read_all(lua_State* L)
+	{
+		return read_all_push(L, 0);
+	}
+
+	/* tColorTables, tResults = read_all_colorTables(apHandles, asSerials)
+	 * Reads all connected devices in one call and converts the readings of all devices in one pass.
+	 * tColorTables[serial] has the same structure as the result of Color_conversions:aus2colorTable.
+	 * tResults[serial] = iResult
+	 */
+	static int native_read_all_colorTables(lua_State* L)
+	{
+		return read_all_push(L, 1);
+	}
+
+	/* iResult, tStatistics = read_oversampled(apHandles, devIndex, uiSamples, ausClear, ausRed, ausGreen, ausBlue, aucIntegrationtime, aucGain)
+	 * Reads one device with read_colors_oversampled and stores the rounded means of the 16 sensors in ausClear, ausRed,
+	 * ausGreen and ausBlue, so they can be converted like a single reading.
+	 * tStatistics[sensor][channel] = { mean, stddev, min, max, median }, channel is clear, red, green or blue.
+	 * tStatistics is nil if iResult is not 0.
+	 */
+	static int native_read_oversampled(lua_State* L)
+	{
+		void** apHandles;
+		int devIndex;
+		unsigned int uiSamples;
+		unsigned short* apusChannels[4];
+		unsigned char* aucIntegrationtime;
+		unsigned char* aucGain;
+		float afMean[64];
+		float afVariance[64];
+		unsigned short ausMin[64];
+		unsigned short ausMax[64];
+		unsigned short ausMedian[64];
+		unsigned int uiIndex;
+		int iResult;
+
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 1, (void**)&apHandles, SWIGTYPE_p_p_void, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 4, (void**)&apusChannels[0], SWIGTYPE_p_unsigned_short, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 5, (void**)&apusChannels[1], SWIGTYPE_p_unsigned_short, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 6, (void**)&apusChannels[2], SWIGTYPE_p_unsigned_short, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 7, (void**)&apusChannels[3], SWIGTYPE_p_unsigned_short, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 8, (void**)&aucIntegrationtime, SWIGTYPE_p_unsigned_char, 0)) ||
+		    !SWIG_IsOK(SWIG_ConvertPtr(L, 9, (void**)&aucGain, SWIGTYPE_p_unsigned_char, 0)) )
+		{
+			return luaL_error(L, "read_oversampled: expected the handle array, 4 ushort arrays and 2 puchar arrays");
+		}
+		devIndex = (int)luaL_checknumber(L, 2);
+		uiSamples = (unsigned int)luaL_checknumber(L, 3);
+
+		iResult = read_colors_oversampled(apHandles, devIndex, uiSamples, afMean, afVariance, ausMin, ausMax, ausMedian,
+		                                  aucIntegrationtime, aucGain);
+		lua_pushnumber(L, iResult);
+		if( iResult!=0 )
+		{
+			lua_pushnil(L);
+			return 2;
+		}
+
+		for(uiIndex=0; uiIndex<64; uiIndex++)
+		{
+			apusChannels[uiIndex / 16][uiIndex % 16] = (unsigned short)floor(afMean[uiIndex] + 0.5);
+		}
+		led_analyzer_push_statistics(L, afMean, afVariance, ausMin, ausMax, ausMedian);
+
+		return 2;
+	}
+
+	/* tBuffer = new_sample_buffer(iDevices)
+	 * Creates a sample buffer for iDevices devices. The arrays of the buffer can be read through the views
+	 * tBuffer.clear, .red, .green, .blue, .gain, .intTime (index devIndex*16 + lane + 1) and tBuffer.results (index devIndex + 1).
+	 */
+	static int native_new_sample_buffer(lua_State* L)
+	{
+		lua_Number dDevices;
+
+		dDevices = luaL_checknumber(L, 1);
+		if( dDevices<1 || dDevices>128 )
+		{
+			return luaL_error(L, "new_sample_buffer: the number of devices must be between 1 and 128");
+		}
+		if( led_analyzer_push_sample_buffer(L, (unsigned int)dDevices)==NULL )
+		{
+			return luaL_error(L, "new_sample_buffer: out of memory");
+		}
+
+		return 1;
+	}
+
+	/* iDevices, uiReadTime_us = read_all_buffer(apHandles, tBuffer)
+	 * Reads all connected devices into the sample buffer. No Lua objects are created, the views of the buffer show the new values.
+	 * The second result is the time of the reading in microseconds.
+	 */
+	static int native_read_all_buffer(lua_State* L)
+	{
+		void** apHandles;
+		SAMPLE_BUFFER_T* ptBuffer;
+		unsigned long ulReadTime;
+
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 1, (void**)&apHandles, SWIGTYPE_p_p_void, 0)) )
+		{
+			return luaL_error(L, "read_all_buffer: expected the handle array");
+		}
+		ptBuffer = led_analyzer_check_sample_buffer(L, 2);
+
+		lua_pushnumber(L, sample_buffer_read_timed(apHandles, ptBuffer, &ulReadTime));
+		lua_pushnumber(L, (lua_Number)ulReadTime);
+
+		return 2;
+	}
+
+	/* Creates a view on a SWIG array. The view does not copy the array, the array must not be deleted while the view is in use. */
+	static int view_push_swig(lua_State* L, swig_type_info* ptType, LED_ANALYZER_VIEW_TYPE_T tType)
+	{
+		void* pvData;
+		lua_Number dLength;
+
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 1, &pvData, ptType, 0)) )
+		{
+			return luaL_error(L, "view: expected an array of type %s", ptType->str);
+		}
+		dLength = luaL_checknumber(L, 2);
+		if( dLength<0 )
+		{
+			return luaL_error(L, "view: the length must not be negative");
+		}
+		led_analyzer_push_view(L, pvData, (unsigned int)dLength, tType, 0);
+
+		return 1;
+	}
+
+	/* tView = view_ushort(ausArray, length)
+	 * tView = view_puchar(aucArray, length)
+	 * tView = view_uint(auiArray, length)
+	 * tView = view_afloat(afArray, length)
+	 * Read-only views on arrays created with new_ushort etc. Elements start at index 1, #tView is the length.
+	 */
+	static int native_view_ushort(lua_State* L)
+	{
+		return view_push_swig(L, SWIGTYPE_p_unsigned_short, LED_ANALYZER_VIEW_USHORT);
+	}
+
+	static int native_view_puchar(lua_State* L)
+	{
+		return view_push_swig(L, SWIGTYPE_p_unsigned_char, LED_ANALYZER_VIEW_UCHAR);
+	}
+
+	static int native_view_uint(lua_State* L)
+	{
+		return view_push_swig(L, SWIGTYPE_p_unsigned_int, LED_ANALYZER_VIEW_UINT);
+	}
+
+	static int native_view_afloat(lua_State* L)
+	{
+		return view_push_swig(L, SWIGTYPE_p_float, LED_ANALYZER_VIEW_FLOAT);
+	}
+
+	/* strFrame = encode_result_frame(tColorTables, fRaw, tResults)
+	 * Encodes the color tables of several devices (tColorTables[serial] = color table) into a binary result frame, see result_frame.h.
+	 * The raw readings are included if fRaw is true. tResults[serial] is optional and contains the result of each device.
+	 * Returns nil and an error message if the tables can not be encoded.
+	 */
+	static int native_encode_result_frame(lua_State* L)
+	{
+		unsigned char ucFlags;
+
+		luaL_checktype(L, 1, LUA_TTABLE);
+		ucFlags = lua_toboolean(L, 2) ? RESULT_FRAME_FLAG_RAW : 0;
+		if( led_analyzer_push_result_frame(L, 1, lua_istable(L, 3) ? 3 : 0, ucFlags)!=0 )
+		{
+			lua_pushnil(L);
+			lua_insert(L, -2);
+			return 2;
+		}
+
+		return 1;
+	}
+
+	/* tColorTables, tResults = decode_result_frame(strFrame)
+	 * Decodes a binary result frame. The color tables have the same structure as the ones of encode_result_frame.
+	 * Returns nil and an error message if the frame is invalid.
+	 */
+	static int native_decode_result_frame(lua_State* L)
+	{
+		const char* pcFrame;
+		size_t sizFrame;
+
+		pcFrame = luaL_checklstring(L, 1, &sizFrame);
+		if( led_analyzer_push_decoded_frame(L, (const unsigned char*)pcFrame, (unsigned int)sizFrame)!=0 )
+		{
+			lua_pushnil(L);
+			lua_insert(L, -2);
+			return 2;
+		}
+
+		return 2;
+	}
+
+	/* tAsync = new_async()
+	 * Creates an asynchronous measurement. It is started with start_async, tAsync:poll() returns true when it is done,
+	 * tAsync:complete() waits for it and returns the number of devices which were read. tAsync:fd() is a file descriptor
+	 * which becomes readable when the measurement is done (nil on Windows), it can be watched by an event loop.
+	 */
+	static int native_new_async(lua_State* L)
+	{
+		if( led_analyzer_push_async(L)==NULL )
+		{
+			return luaL_error(L, "new_async: out of memory");
+		}
+
+		return 1;
+	}
+
+	/* fOk = start_async(tAsync, apHandles, tBuffer, uiWaitTime)
+	 * Waits uiWaitTime ms for the conversion and reads all connected devices into the sample buffer on a separate thread,
+	 * like read_all_buffer. Only one measurement can run at a time in the module, all devices share the command buffers.
+	 * Reading or configuring the devices, free_devices and freeing the buffer wait for the running measurement first.
+	 * Returns nil and an error message if the last measurement was not completed yet or another one is running.
+	 */
+	static int native_start_async(lua_State* L)
+	{
+		void** apHandles;
+
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 2, (void**)&apHandles, SWIGTYPE_p_p_void, 0)) )
+		{
+			return luaL_error(L, "start_async: expected the handle array");
+		}
+
+		return led_analyzer_start_async(L, apHandles);
+	}
+
+	/* tColorTables, tResults = buffer_colorTables(tBuffer, asSerials)
+	 * Converts the last reading in a sample buffer like read_all_colorTables, the buffer is not changed.
+	 */
+	static int native_buffer_colorTables(lua_State* L)
+	{
+		SAMPLE_BUFFER_T* ptBuffer;
+		char** asSerials;
+		int iDevices;
+		COLOR_SPACES_T* ptColorSpaces;
+
+		ptBuffer = led_analyzer_check_sample_buffer(L, 1);
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 2, (void**)&asSerials, SWIGTYPE_p_p_char, 0)) )
+		{
+			return luaL_error(L, "buffer_colorTables: expected the serial array");
+		}
+
+		iDevices = (int)ptBuffer->uiValidDevices;
+		ptColorSpaces = color_spaces_new(16 * iDevices);
+		if( ptColorSpaces==NULL )
+		{
+			return luaL_error(L, "buffer_colorTables: out of memory");
+		}
+		color_spaces_calculate(ptColorSpaces, ptBuffer->ausClear, ptBuffer->ausRed, ptBuffer->ausGreen, ptBuffer->ausBlue,
+		                       ptBuffer->aucIntegrationtime, ptBuffer->aucGain);
+		led_analyzer_push_colorTables(L, asSerials, iDevices, ptColorSpaces, ptBuffer->ausClear, ptBuffer->ausRed,
+		                              ptBuffer->ausGreen, ptBuffer->ausBlue, ptBuffer->aucIntegrationtime, ptBuffer->aucGain);
+		led_analyzer_push_results(L, asSerials, iDevices, ptBuffer->aiResults);
+		color_spaces_free(ptColorSpaces);
+
+		return 2;
+	}
+
+	/* tPlan = new_test_plan(uiSteps, uiDevices)
+	 * Creates a test plan without any test entries, see lua/test_plan.lua.
+	 */
+	static int native_new_test_plan(lua_State* L)
+	{
+		lua_Number dSteps;
+		lua_Number dDevices;
+
+		dSteps = luaL_checknumber(L, 1);
+		dDevices = luaL_checknumber(L, 2);
+		if( dSteps<1 || dDevices<1 )
+		{
+			return luaL_error(L, "new_test_plan: a plan needs at least one step and one device");
+		}
+		if( led_analyzer_push_test_plan(L, (unsigned int)dSteps, (unsigned int)dDevices)==NULL )
+		{
+			return luaL_error(L, "new_test_plan: out of memory");
+		}
+
+		return 1;
+	}
+
+	/* tTest = new_sequential_test(uiDevices)
+	 * Creates the state of a sequential test for uiDevices devices, see Color_control:startMeasurementsSequential.
+	 */
+	static int native_new_sequential_test(lua_State* L)
+	{
+		lua_Number dDevices;
+
+		dDevices = luaL_checknumber(L, 1);
+		if( dDevices<1 || dDevices>65536 )
+		{
+			return luaL_error(L, "new_sequential_test: invalid number of devices: %d", (int)dDevices);
+		}
+		if( led_analyzer_push_sequential_test(L, (unsigned int)dDevices)==NULL )
+		{
+			return luaL_error(L, "new_sequential_test: out of memory");
+		}
+
+		return 1;
+	}
+
+	/* tSummary = buffer_validate(tBuffer, asSerials, tPlan, uiStep, auiPlanDevices, fLuxCheck, fAllValues)
+	 * Validates the last measurement in a sample buffer against step uiStep (starting at 0) of a test plan.
+	 * auiPlanDevices has the device of the plan (starting at 0) for each measured device, devices without an entry are
+	 * skipped. The summary has the same format as Color_validation:summarizeCoCo.
+	 */
+	static int native_buffer_validate(lua_State* L)
+	{
+		SAMPLE_BUFFER_T* ptBuffer;
+		char** asSerials;
+		TEST_PLAN_T* ptPlan;
+		lua_Number dStep;
+		int iDevices;
+		COLOR_SPACES_T* ptColorSpaces;
+
+		ptBuffer = led_analyzer_check_sample_buffer(L, 1);
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 2, (void**)&asSerials, SWIGTYPE_p_p_char, 0)) )
+		{
+			return luaL_error(L, "buffer_validate: expected the serial array");
+		}
+		ptPlan = led_analyzer_check_test_plan(L, 3);
+		dStep = luaL_checknumber(L, 4);
+		luaL_checktype(L, 5, LUA_TTABLE);
+		if( dStep<0 || dStep>=ptPlan->uiSteps )
+		{
+			return luaL_error(L, "buffer_validate: the plan has no step %d", (int)dStep);
+		}
+
+		iDevices = (int)ptBuffer->uiValidDevices;
+		ptColorSpaces = color_spaces_new(16 * iDevices);
+		if( ptColorSpaces==NULL )
+		{
+			return luaL_error(L, "buffer_validate: out of memory");
+		}
+		color_spaces_calculate(ptColorSpaces, ptBuffer->ausClear, ptBuffer->ausRed, ptBuffer->ausGreen, ptBuffer->ausBlue,
+		                       ptBuffer->aucIntegrationtime, ptBuffer->aucGain);
+		led_analyzer_push_validation(L, ptPlan, (unsigned int)dStep, asSerials, iDevices, ptColorSpaces, 5,
+		                             lua_toboolean(L, 6), lua_toboolean(L, 7));
+		color_spaces_free(ptColorSpaces);
+
+		return 1;
+	}
+
+	/* tLog = open_measurement_log(strPrefix, uiSegmentRecords)
+	 * Opens a binary log of the measured lanes, see measurement_log.h. New records go to a new segment file after the
+	 * existing ones. Returns nil and an error message if the index of the log is damaged.
+	 */
+	static int native_open_measurement_log(lua_State* L)
+	{
+		const char* pcPrefix;
+		lua_Number dSegmentRecords;
+
+		pcPrefix = luaL_checkstring(L, 1);
+		dSegmentRecords = luaL_checknumber(L, 2);
+		if( dSegmentRecords<1 )
+		{
+			return luaL_error(L, "open_measurement_log: a segment needs at least one record");
+		}
+		if( led_analyzer_push_measurement_log(L, pcPrefix, (unsigned long)dSegmentRecords)==NULL )
+		{
+			lua_pushnil(L);
+			lua_pushfstring(L, "failed to open the measurement log %s, the index is damaged", pcPrefix);
+			return 2;
+		}
+
+		return 1;
+	}
+
+	/* tSegment = open_measurement_segment(strPath)
+	 * Maps a segment file of a measurement log for reading. Returns nil and an error message if it can not be mapped.
+	 */
+	static int native_open_measurement_segment(lua_State* L)
+	{
+		const char* pcPath;
+
+		pcPath = luaL_checkstring(L, 1);
+		if( led_analyzer_push_measurement_segment(L, pcPath)==NULL )
+		{
+			lua_pushnil(L);
+			lua_pushfstring(L, "failed to map the segment %s", pcPath);
+			return 2;
+		}
+
+		return 1;
+	}
+
+	/* atIndex = read_measurement_index(strPrefix)
+	 * Reads the index of a measurement log, see led_analyzer_push_measurement_index. Returns nil and an error message if
+	 * the index is damaged.
+	 */
+	static int native_read_measurement_index(lua_State* L)
+	{
+		int iResult;
+
+		iResult = led_analyzer_push_measurement_index(L, luaL_checkstring(L, 1));
+		if( iResult==-2 )
+		{
+			return luaL_error(L, "read_measurement_index: out of memory");
+		}
+		else if( iResult!=0 )
+		{
+			lua_pushnil(L);
+			lua_pushstring(L, "the index of the measurement log is damaged");
+			return 2;
+		}
+
+		return 1;
+	}
+
+	/* tOffsets = new_dark_offset()
+	 * Creates dark offsets without any calibrated settings, see lua/dark_offset.lua.
+	 */
+	static int native_new_dark_offset(lua_State* L)
+	{
+		if( led_analyzer_push_dark_offset(L)==NULL )
+		{
+			return luaL_error(L, "new_dark_offset: out of memory");
+		}
+
+		return 1;
+	}
+
+	/* fOk = set_dark_offsets(apHandles, devIndex, tOffsets)
+	 * Attaches a copy of the dark offsets to an open device, read_colors and read_colors_hdr subtract them from the
+	 * readings until the device is freed. tOffsets = nil removes the offsets of the device.
+	 * Returns true or nil and an error message.
+	 */
+	static int native_set_dark_offsets(lua_State* L)
+	{
+		void** apHandles;
+		lua_Number dDevice;
+		const DARK_OFFSET_T* ptOffsets;
+		int iResult;
+
+		if( !SWIG_IsOK(SWIG_ConvertPtr(L, 1, (void**)&apHandles, SWIGTYPE_p_p_void, 0)) )
+		{
+			return luaL_error(L, "set_dark_offsets: expected the handle array");
+		}
+		dDevice = luaL_checknumber(L, 2);
+		ptOffsets = lua_isnoneornil(L, 3) ? NULL : led_analyzer_check_dark_offset(L, 3);
+		if( dDevice<0 || 2*(int)dDevice>=get_number_of_handles(apHandles) )
+		{
+			return luaL_error(L, "set_dark_offsets: there is no device %d", (int)dDevice);
+		}
+
+		/* The offsets belong to the first handle of the device. */
+		iResult = dark_offset_attach(apHandles[2*(int)dDevice], ptOffsets);
+		if( iResult!=0 )
+		{
+			lua_pushnil(L);
+			lua_pushstring(L, (iResult==-2) ? "out of memory" : "too many devices with dark offsets");
+			return 2;
+		}
+		lua_pushboolean(L, 1);
+		return 1;
+	}
 %}
 
 %include <typemaps.i>
@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+ 
+
+
+/** \file led_analyzer_api.h
+
+	 \brief Stable C interface of the led_analyzer library
+
+This header lists all functions and structures which can be used from outside of the Lua module, e.g. through the LuaJIT FFI
+(see lua/led_analyzer_ffi.lua). It only uses plain C types, no ftdi or Lua types. Changes to any declaration in this file
+must increase LED_ANALYZER_API_VERSION and must be done in lua/led_analyzer_ffi.lua as well.
+
+The declarations are the same as in led_analyzer.h, color_conversions.h, sample_buffer.h, async_measurement.h,
+dark_offset.h and test_plan.h. led_analyzer.c includes this header together with the others, so the compiler reports any difference.
+
+ */
+
+#ifndef __LED_ANALYZER_API_H__
+#define __LED_ANALYZER_API_H__
+
+#include "color_conversions.h"
+#include "sample_buffer.h"
+#include "async_measurement.h"
+#include "dark_offset.h"
+#include "test_plan.h"
+
+/** Version of the C interface, compare with the result of led_analyzer_api_version */
+#define LED_ANALYZER_API_VERSION 8
+
+int  led_analyzer_api_version(void);
+
+/* Devices */
+int  scan_devices(char** asSerial, unsigned int uiLength);
+int  connect_to_devices(void** apHandles, int apHlength, char** asLength);
+int  init_sensors(void** apHandles, int devIndex);
+int  get_number_of_handles(void ** apHandles);
+int  get_number_of_serials(char** asSerial);
+int  swap_up(char** asSerial, char* curSerial);
+int  swap_down(char** asSerial, char* curSerial);
+void free_devices(void** apHandles);
+void wait4Conversion(unsigned int uiWaitTime);
+
+/* Settings */
+int  set_gain(void** apHandles, int devIndex, unsigned char gain);
+int  set_gain_x(void** apHandles, int devIndex, unsigned int uiX, unsigned char gain);
+int  get_gain(void** apHandles, int devIndex, unsigned char* aucGains);
+int  set_intTime(void** apHandles, int devIndex, unsigned char integrationtime);
+int  set_intTime_x(void** apHandles, int devIndex, unsigned int uiX, unsigned char integrationtime);
+int  get_intTime(void** apHandles, int devIndex, unsigned char* aucIntTimeSettings);
+
+/* Readings */
+int  read_colors(void** apHandles, int devIndex, unsigned short *ausClear, unsigned short* ausRed,
+	 unsigned short *ausGreen, unsigned short* ausBlue,
+	 unsigned char *aucIntegrationtime, unsigned char* aucGain);
+int  read_colors_all(void** apHandles, unsigned short* ausClear, unsigned short* ausRed,
+	 unsigned short* ausGreen, unsigned short* ausBlue,
+	 unsigned char* aucIntegrationtime, unsigned char* aucGain, int* aiResults);
+int  read_colors_hdr(void** apHandles, int devIndex, unsigned char ucIntTimeShort, unsigned char ucGainShort,
+	 unsigned char ucIntTimeLong, unsigned char ucGainLong,
+	 unsigned short *ausClear, unsigned short* ausRed, unsigned short *ausGreen, unsigned short* ausBlue,
+	 unsigned char *aucIntegrationtime, unsigned char* aucGain);
+int  read_colors_oversampled(void** apHandles, int devIndex, unsigned int uiSamples,
+	 float* afMean, float* afVariance, unsigned short* ausMin, unsigned short* ausMax, unsigned short* ausMedian,
+	 unsigned char* aucIntegrationtime, unsigned char* aucGain);
+int  read_clear_burst(void** apHandles, int devIndex, unsigned int uiSamples, unsigned short* ausClear, unsigned int* auiTimestamps);
+int  analyze_blink(unsigned short* ausClear, unsigned int* auiTimestamps, unsigned int uiSamples,
+	 float* afPeriod_ms, float* afDutyCycle, unsigned short* ausOnLevel, unsigned short* ausOffLevel);
+
+/* Readings of a register window, since version 3 */
+int  read_colors_window(void** apHandles, int devIndex, unsigned int uiWindow, unsigned short* ausClear, unsigned short* ausRed,
+	 unsigned short* ausGreen, unsigned short* ausBlue,
+	 unsigned char* aucIntegrationtime, unsigned char* aucGain);
+
+/* Devices with sensors on one channel only, since version 4 */
+int  connect_to_devices_lanes(void** apHandles, int apHlength, char** asSerial, const unsigned short* ausLanes);
+
+/* Presence of the sensors, since version 5 */
+int  probe_sensors(void** apHandles, int devIndex);
+
+/* Sample buffers */
+SAMPLE_BUFFER_T* sample_buffer_new (unsigned int uiDevices);
+void             sample_buffer_free(SAMPLE_BUFFER_T* ptBuffer);
+int              sample_buffer_read(void** apHandles, SAMPLE_BUFFER_T* ptBuffer);
+int              sample_buffer_read_timed(void** apHandles, SAMPLE_BUFFER_T* ptBuffer, unsigned long* pulTime_us);
+
+/* Asynchronous measurements, since version 2 */
+ASYNC_MEASUREMENT_T* async_measurement_new     (void);
+void                 async_measurement_free    (ASYNC_MEASUREMENT_T* ptAsync);
+int                  async_measurement_start   (ASYNC_MEASUREMENT_T* ptAsync, void** apHandles, SAMPLE_BUFFER_T* ptBuffer, unsigned int uiWaitTime);
+int                  async_measurement_poll    (ASYNC_MEASUREMENT_T* ptAsync);
+int                  async_measurement_complete(ASYNC_MEASUREMENT_T* ptAsync);
+int                  async_measurement_get_fd  (ASYNC_MEASUREMENT_T* ptAsync);
+
+/* Read times, since version 7 */
+unsigned long        async_measurement_get_read_time(ASYNC_MEASUREMENT_T* ptAsync);
+
+/* Dark offsets, since version 6 */
+DARK_OFFSET_T*        dark_offset_new   (void);
+void                  dark_offset_free  (DARK_OFFSET_T* ptOffsets);
+int                   dark_offset_set   (DARK_OFFSET_T* ptOffsets, unsigned char ucGain, unsigned char ucIntegrationtime,
+                                         const unsigned short* ausOffsets);
+const unsigned short* dark_offset_get   (const DARK_OFFSET_T* ptOffsets, unsigned char ucGain, unsigned char ucIntegrationtime);
+int                   dark_offset_attach(const void* pvDevice, const DARK_OFFSET_T* ptOffsets);
+
+/* Test plans and sequential tests, since version 8 */
+TEST_PLAN_T*            test_plan_new              (unsigned int uiSteps, unsigned int uiDevices);
+void                    test_plan_free             (TEST_PLAN_T* ptPlan);
+TEST_PLAN_LANE_T*       test_plan_get_lane         (TEST_PLAN_T* ptPlan, unsigned int uiStep, unsigned int uiDevice, unsigned int uiLane);
+TEST_PLAN_SEQUENTIAL_T* test_plan_sequential_new   (unsigned int uiLanes);
+void                    test_plan_sequential_free  (TEST_PLAN_SEQUENTIAL_T* ptSequential);
+void                    test_plan_sequential_reset (TEST_PLAN_SEQUENTIAL_T* ptSequential);
+void                    test_plan_sequential_add   (TEST_PLAN_SEQUENTIAL_T* ptSequential, const unsigned short* ausClear,
+                                                    const unsigned short* ausRed, const unsigned short* ausGreen,
+                                                    const unsigned short* ausBlue, const unsigned char* aucIntegrationtime,
+                                                    const unsigned char* aucGain);
+unsigned int            test_plan_sequential_decide(const TEST_PLAN_SEQUENTIAL_T* ptSequential, const TEST_PLAN_T* ptPlan,
+                                                    unsigned int uiStep, unsigned int uiDevice, unsigned int uiFirstLane,
+                                                    int fLuxCheck, double dZ, unsigned int* puiTested);
+void                    test_plan_sequential_mean  (const TEST_PLAN_SEQUENTIAL_T* ptSequential, unsigned short* ausClear,
+                                                    unsigned short* ausRed, unsigned short* ausGreen, unsigned short* ausBlue);
+
+/* Color spaces */
+COLOR_SPACES_T* color_spaces_new      (unsigned int uiLanes);
+void            color_spaces_free     (COLOR_SPACES_T* ptColorSpaces);
+void            color_spaces_calculate(COLOR_SPACES_T* ptColorSpaces, const unsigned short* ausClear, const unsigned short* ausRed,
+                                       const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                       const unsigned char* aucIntegrationtime, const unsigned char* aucGain);
+int             color_Yxy2wavelength  (double dx, double dy, double* pdWavelength, double* pdSaturation);
+int             color_Yxy2wavelength_interpolated(double dx, double dy, double* pdWavelength, double* pdSaturation);
+
+#endif	/* __LED_ANALYZER_API_H__ */
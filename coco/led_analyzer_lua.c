@@ -0,0 +1,2665 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+/** \file led_analyzer_lua.c
+
+	 \brief Lua specific functions of the led_analyzer
+
+led_analyzer_lua contains the functions which build Lua tables directly in C. Creating the result tables in C saves
+all the single getitem calls through SWIG, which are needed to read C arrays from Lua.
+
+ */
+
+#include "led_analyzer_lua.h"
+
+#include "lauxlib.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/** \brief sets a number field in the table on top of the stack. */
+static void set_number(lua_State* L, const char* pcKey, double dValue)
+{
+	lua_pushnumber(L, dValue);
+	lua_setfield(L, -2, pcKey);
+}
+
+
+
+/** \brief sets an integer field in the table on top of the stack. */
+static void set_integer(lua_State* L, const char* pcKey, long lValue)
+{
+	lua_pushinteger(L, (lua_Integer)lValue);
+	lua_setfield(L, -2, pcKey);
+}
+
+
+
+/** \brief pushes the serial number of a device as a key onto the Lua stack.
+
+Devices without a serial number in asSerials get their device index as key.
+*/
+static void push_serial(lua_State* L, char** asSerials, int devIndex)
+{
+	char acIndex[16];
+	int i;
+
+
+	/* asSerials ends with a NULL entry, do not read behind it. */
+	i = 0;
+	while( i<devIndex && asSerials[i]!=NULL )
+	{
+		i++;
+	}
+
+	if( i==devIndex && asSerials[i]!=NULL )
+	{
+		lua_pushstring(L, asSerials[devIndex]);
+	}
+	else
+	{
+		sprintf(acIndex, "%d", devIndex);
+		lua_pushstring(L, acIndex);
+	}
+}
+
+
+
+/** \brief gets the status of one lane from the result of read_colors.
+
+The status contains the error flags of the device result, if the lane is marked as failing. Negative results (USB, i2c or
+indexing errors) affect all lanes.
+*/
+static int lane_status(int iResult, unsigned int uiLane)
+{
+	int iStatus;
+
+
+	if( iResult<0 )
+	{
+		iStatus = iResult;
+	}
+	else if( (iResult & (1<<uiLane))!=0 )
+	{
+		iStatus = iResult & 0x7fff0000;
+	}
+	else
+	{
+		iStatus = 0;
+	}
+
+	return iStatus;
+}
+
+
+
+/** \brief pushes the color table of a number of lanes onto the Lua stack.
+
+The table has the same structure as the table returned by Color_conversions:aus2colorTable in lua/color_conversions.lua. It
+contains one entry per lane (starting at index 1) with the subtables Wavelength, RGB_tsc, XYZ, Yxy, HSV and Settings.
+	@param L					Lua state
+	@param ptColorSpaces		converted colors, calculated with color_spaces_calculate
+	@param uiFirstLane			index of the first lane to push (e.g. devIndex*16)
+	@param uiLanes				number of lanes to push
+	@param ausClear, ausRed, ausGreen, ausBlue	raw readings, which were passed to color_spaces_calculate
+	@param aucIntegrationtime	integration time settings of the readings
+	@param aucGain				gain settings of the readings
+	*/
+void led_analyzer_push_colorTable(lua_State* L, const COLOR_SPACES_T* ptColorSpaces, unsigned int uiFirstLane, unsigned int uiLanes,
+                                  const unsigned short* ausClear, const unsigned short* ausRed,
+                                  const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                  const unsigned char* aucIntegrationtime, const unsigned char* aucGain)
+{
+	unsigned int uiLane;
+	unsigned int i;
+
+
+	lua_createtable(L, (int)uiLanes, 0);
+	for(i=0; i<uiLanes; i++)
+	{
+		uiLane = uiFirstLane + i;
+
+		lua_createtable(L, 0, 6);
+
+		/* Wavelength */
+		lua_createtable(L, 0, 9);
+		set_number(L, "lux", ptColorSpaces->adLux[uiLane]);
+		set_number(L, "clear_ratio", ptColorSpaces->adClearRatio[uiLane]);
+		if( ptColorSpaces->aucValid[uiLane]==0 )
+		{
+			set_integer(L, "nm", 0);
+			set_integer(L, "sat", 0);
+			set_integer(L, "cct", 0);
+			set_integer(L, "r_estimate", 0);
+			set_integer(L, "g_estimate", 0);
+			set_integer(L, "b_estimate", 0);
+		}
+		else
+		{
+			set_integer(L, "nm", (long)floor(ptColorSpaces->adWavelength[uiLane] + 0.5));
+			set_number(L, "sat", ptColorSpaces->adSaturation[uiLane] * 100);
+			set_number(L, "cct", ptColorSpaces->adCCT[uiLane]);
+		}
+		lua_setfield(L, -2, "Wavelength");
+
+		/* RGB_tsc */
+		lua_createtable(L, 0, 7);
+		if( ptColorSpaces->aucValid[uiLane]==0 )
+		{
+			set_integer(L, "clear_tsc", 0);
+			set_integer(L, "red_tsc", 0);
+			set_integer(L, "green_tsc", 0);
+			set_integer(L, "blue_tsc", 0);
+		}
+		else
+		{
+			set_number(L, "clear", ausClear[uiLane]);
+			set_number(L, "red", ausRed[uiLane]);
+			set_number(L, "green", ausGreen[uiLane]);
+			set_number(L, "blue", ausBlue[uiLane]);
+			set_number(L, "R_n", ptColorSpaces->adR_n[uiLane]);
+			set_number(L, "G_n", ptColorSpaces->adG_n[uiLane]);
+			set_number(L, "B_n", ptColorSpaces->adB_n[uiLane]);
+		}
+		lua_setfield(L, -2, "RGB_tsc");
+
+		/* XYZ, Yxy and HSV contain plain zeros for dark lanes. */
+		lua_createtable(L, 0, 3);
+		if( ptColorSpaces->aucValid[uiLane]==0 )
+		{
+			set_integer(L, "X", 0);
+			set_integer(L, "Y", 0);
+			set_integer(L, "Z", 0);
+		}
+		else
+		{
+			set_number(L, "X", ptColorSpaces->adX[uiLane]);
+			set_number(L, "Y", ptColorSpaces->adY[uiLane]);
+			set_number(L, "Z", ptColorSpaces->adZ[uiLane]);
+		}
+		lua_setfield(L, -2, "XYZ");
+
+		lua_createtable(L, 0, 3);
+		if( ptColorSpaces->aucValid[uiLane]==0 )
+		{
+			set_integer(L, "Y", 0);
+			set_integer(L, "x", 0);
+			set_integer(L, "y", 0);
+		}
+		else
+		{
+			set_number(L, "Y", ptColorSpaces->adY[uiLane]);
+			set_number(L, "x", ptColorSpaces->adx[uiLane]);
+			set_number(L, "y", ptColorSpaces->ady[uiLane]);
+		}
+		lua_setfield(L, -2, "Yxy");
+
+		lua_createtable(L, 0, 3);
+		if( ptColorSpaces->aucValid[uiLane]==0 )
+		{
+			set_integer(L, "H", 0);
+			set_integer(L, "S", 0);
+			set_integer(L, "V", 0);
+		}
+		else
+		{
+			set_number(L, "H", ptColorSpaces->adH[uiLane]);
+			set_number(L, "S", ptColorSpaces->adS[uiLane]);
+			set_number(L, "V", ptColorSpaces->adV[uiLane]);
+		}
+		lua_setfield(L, -2, "HSV");
+
+		/* Settings */
+		lua_createtable(L, 0, 2);
+		set_number(L, "gain", aucGain[uiLane]);
+		set_number(L, "intTime", aucIntegrationtime[uiLane]);
+		lua_setfield(L, -2, "Settings");
+
+		lua_rawseti(L, -2, (int)(i + 1));
+	}
+}
+
+
+
+/** \brief pushes the raw readings of all devices onto the Lua stack.
+
+The table has one entry per device, the key is the serial number of the device. Each entry contains the result of read_colors for
+the device and a table "lanes" with 16 entries (starting at index 1). A lane contains the raw readings clear, red, green and blue,
+the settings gain and intTime and a status. The status is 0 for a good reading, otherwise it contains the error flags (see E_ERROR).
+	@param L					Lua state
+	@param asSerials			serial numbers of the devices
+	@param iDevices				number of devices
+	@param ausClear, ausRed, ausGreen, ausBlue	raw readings, 16 per device
+	@param aucIntegrationtime	integration time settings, 16 per device
+	@param aucGain				gain settings, 16 per device
+	@param aiResults			result of read_colors for every device
+	*/
+void led_analyzer_push_readings(lua_State* L, char** asSerials, int iDevices,
+                                const unsigned short* ausClear, const unsigned short* ausRed,
+                                const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                const unsigned char* aucIntegrationtime, const unsigned char* aucGain, const int* aiResults)
+{
+	int devIndex;
+	unsigned int uiLane;
+	unsigned int i;
+
+
+	lua_createtable(L, 0, iDevices);
+	for(devIndex=0; devIndex<iDevices; devIndex++)
+	{
+		push_serial(L, asSerials, devIndex);
+
+		lua_createtable(L, 0, 2);
+		set_integer(L, "result", aiResults[devIndex]);
+
+		lua_createtable(L, 16, 0);
+		for(i=0; i<16; i++)
+		{
+			uiLane = devIndex*16 + i;
+
+			lua_createtable(L, 0, 7);
+			set_number(L, "clear", ausClear[uiLane]);
+			set_number(L, "red", ausRed[uiLane]);
+			set_number(L, "green", ausGreen[uiLane]);
+			set_number(L, "blue", ausBlue[uiLane]);
+			set_number(L, "gain", aucGain[uiLane]);
+			set_number(L, "intTime", aucIntegrationtime[uiLane]);
+			set_integer(L, "status", lane_status(aiResults[devIndex], i));
+			lua_rawseti(L, -2, (int)(i + 1));
+		}
+		lua_setfield(L, -2, "lanes");
+
+		lua_settable(L, -3);
+	}
+}
+
+
+
+/** \brief pushes the color tables of all devices onto the Lua stack.
+
+The table has one entry per device, the key is the serial number of the device. Each entry is a color table like the one of
+Color_conversions:aus2colorTable.
+	@param L					Lua state
+	@param asSerials			serial numbers of the devices
+	@param iDevices				number of devices
+	@param ptColorSpaces		converted colors of all devices (16 lanes per device)
+	@param ausClear, ausRed, ausGreen, ausBlue	raw readings, 16 per device
+	@param aucIntegrationtime	integration time settings, 16 per device
+	@param aucGain				gain settings, 16 per device
+	*/
+void led_analyzer_push_colorTables(lua_State* L, char** asSerials, int iDevices, const COLOR_SPACES_T* ptColorSpaces,
+                                   const unsigned short* ausClear, const unsigned short* ausRed,
+                                   const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                   const unsigned char* aucIntegrationtime, const unsigned char* aucGain)
+{
+	int devIndex;
+
+
+	lua_createtable(L, 0, iDevices);
+	for(devIndex=0; devIndex<iDevices; devIndex++)
+	{
+		push_serial(L, asSerials, devIndex);
+		led_analyzer_push_colorTable(L, ptColorSpaces, devIndex*16, 16, ausClear, ausRed, ausGreen, ausBlue, aucIntegrationtime, aucGain);
+		lua_settable(L, -3);
+	}
+}
+
+
+
+/** \brief pushes the results of read_colors for all devices onto the Lua stack.
+
+The table has one entry per device, the key is the serial number of the device.
+	@param L					Lua state
+	@param asSerials			serial numbers of the devices
+	@param iDevices				number of devices
+	@param aiResults			result of read_colors for every device
+	*/
+void led_analyzer_push_results(lua_State* L, char** asSerials, int iDevices, const int* aiResults)
+{
+	int devIndex;
+
+
+	lua_createtable(L, 0, iDevices);
+	for(devIndex=0; devIndex<iDevices; devIndex++)
+	{
+		push_serial(L, asSerials, devIndex);
+		lua_pushinteger(L, aiResults[devIndex]);
+		lua_settable(L, -3);
+	}
+}
+
+
+
+/** \brief pushes the statistics of an oversampled reading of one device onto the Lua stack.
+
+The table has one entry per sensor (starting at index 1) with the subtables clear, red, green and blue. Each subtable has the
+fields mean, stddev, min, max and median of the channel.
+	@param L					Lua state
+	@param afMean, afVariance, ausMin, ausMax, ausMedian	statistics of read_colors_oversampled, 16 per channel
+	*/
+void led_analyzer_push_statistics(lua_State* L, const float* afMean, const float* afVariance, const unsigned short* ausMin,
+                                  const unsigned short* ausMax, const unsigned short* ausMedian)
+{
+	static const char* const apcChannels[4] = { "clear", "red", "green", "blue" };
+	unsigned int uiSensor;
+	unsigned int uiChannel;
+	unsigned int uiIndex;
+
+
+	lua_createtable(L, 16, 0);
+	for(uiSensor=0; uiSensor<16; uiSensor++)
+	{
+		lua_createtable(L, 0, 4);
+		for(uiChannel=0; uiChannel<4; uiChannel++)
+		{
+			uiIndex = uiChannel*16 + uiSensor;
+
+			lua_createtable(L, 0, 5);
+			set_number(L, "mean", afMean[uiIndex]);
+			set_number(L, "stddev", sqrt(afVariance[uiIndex]));
+			set_number(L, "min", ausMin[uiIndex]);
+			set_number(L, "max", ausMax[uiIndex]);
+			set_number(L, "median", ausMedian[uiIndex]);
+			lua_setfield(L, -2, apcChannels[uiChannel]);
+		}
+		lua_rawseti(L, -2, (int)(uiSensor + 1));
+	}
+}
+
+
+
+/*-------------------------------------------------------------------------*/
+/* Views                                                                   */
+/*-------------------------------------------------------------------------*/
+
+/** name of the metatable for views */
+#define VIEW_METATABLE "led_analyzer.view"
+/** name of the metatable for sample buffers */
+#define SAMPLE_BUFFER_METATABLE "led_analyzer.sample_buffer"
+/** name of the metatable for asynchronous measurements */
+#define ASYNC_METATABLE "led_analyzer.async"
+/** name of the metatable for test plans */
+#define TEST_PLAN_METATABLE "led_analyzer.test_plan"
+/** name of the metatable for measurement logs */
+#define MEASUREMENT_LOG_METATABLE "led_analyzer.measurement_log"
+/** name of the metatable for segments of measurement logs */
+#define MEASUREMENT_SEGMENT_METATABLE "led_analyzer.measurement_segment"
+/** name of the metatable for dark offsets */
+#define DARK_OFFSET_METATABLE "led_analyzer.dark_offset"
+/** name of the metatable for sequential tests */
+#define SEQUENTIAL_TEST_METATABLE "led_analyzer.sequential_test"
+
+#if LUA_VERSION_NUM >= 502
+#       define view_setuservalue(L,idx) lua_setuservalue(L,idx)
+#       define view_getuservalue(L,idx) lua_getuservalue(L,idx)
+#else
+#       define view_setuservalue(L,idx) lua_setfenv(L,idx)
+#       define view_getuservalue(L,idx) lua_getfenv(L,idx)
+#endif
+
+/** \brief a read-only view on a C array, it does not copy the data */
+typedef struct VIEW_STRUCT
+{
+	/** first element of the array */
+	const void* pvData;
+	/** number of elements */
+	unsigned int uiLength;
+	/** type of the elements */
+	LED_ANALYZER_VIEW_TYPE_T tType;
+	/** points to the C pointer of the owner, it is NULL after the owner was freed, NULL if the view has no owner */
+	void* const* ppvOwner;
+} VIEW_T;
+
+/** names of the view types, in the order of LED_ANALYZER_VIEW_TYPE_T */
+static const char* const apcViewTypeNames[] = { "ushort", "uchar", "int", "uint", "float", "double" };
+
+
+
+/** \brief gets the view at a stack index, raises an error if the owner of the array was already freed. */
+static VIEW_T* check_view(lua_State* L, int iIndex)
+{
+	VIEW_T* ptView;
+
+
+	ptView = (VIEW_T*)luaL_checkudata(L, iIndex, VIEW_METATABLE);
+	if( ptView->ppvOwner!=NULL && *ptView->ppvOwner==NULL )
+	{
+		luaL_error(L, "the buffer of the view was already freed");
+	}
+
+	return ptView;
+}
+
+
+
+/** \brief reads one element of a view and pushes it onto the Lua stack. */
+static void view_push_element(lua_State* L, const VIEW_T* ptView, unsigned int uiIndex)
+{
+	switch(ptView->tType)
+	{
+		case LED_ANALYZER_VIEW_USHORT:
+			lua_pushnumber(L, ((const unsigned short*)ptView->pvData)[uiIndex]);
+			break;
+		case LED_ANALYZER_VIEW_UCHAR:
+			lua_pushnumber(L, ((const unsigned char*)ptView->pvData)[uiIndex]);
+			break;
+		case LED_ANALYZER_VIEW_INT:
+			lua_pushnumber(L, ((const int*)ptView->pvData)[uiIndex]);
+			break;
+		case LED_ANALYZER_VIEW_UINT:
+			lua_pushnumber(L, ((const unsigned int*)ptView->pvData)[uiIndex]);
+			break;
+		case LED_ANALYZER_VIEW_FLOAT:
+			lua_pushnumber(L, ((const float*)ptView->pvData)[uiIndex]);
+			break;
+		case LED_ANALYZER_VIEW_DOUBLE:
+			lua_pushnumber(L, ((const double*)ptView->pvData)[uiIndex]);
+			break;
+	}
+}
+
+
+
+/** \brief view:get(index) - returns the element at index (starting at 1) or nil if the index is out of range. */
+static int view_get(lua_State* L)
+{
+	VIEW_T* ptView;
+	lua_Number dIndex;
+
+
+	ptView = check_view(L, 1);
+	dIndex = luaL_checknumber(L, 2);
+	if( dIndex>=1 && dIndex<=ptView->uiLength && dIndex==(unsigned int)dIndex )
+	{
+		view_push_element(L, ptView, (unsigned int)dIndex - 1);
+	}
+	else
+	{
+		lua_pushnil(L);
+	}
+
+	return 1;
+}
+
+
+
+/** \brief view:length() - returns the number of elements. */
+static int view_length(lua_State* L)
+{
+	VIEW_T* ptView;
+
+
+	ptView = check_view(L, 1);
+	lua_pushnumber(L, ptView->uiLength);
+
+	return 1;
+}
+
+
+
+/** \brief view:type() - returns the name of the element type. */
+static int view_type(lua_State* L)
+{
+	VIEW_T* ptView;
+
+
+	ptView = check_view(L, 1);
+	lua_pushstring(L, apcViewTypeNames[ptView->tType]);
+
+	return 1;
+}
+
+
+
+/** \brief view:totable() - copies all elements into a new table. */
+static int view_totable(lua_State* L)
+{
+	VIEW_T* ptView;
+	unsigned int uiIndex;
+
+
+	ptView = check_view(L, 1);
+	lua_createtable(L, (int)ptView->uiLength, 0);
+	for(uiIndex=0; uiIndex<ptView->uiLength; uiIndex++)
+	{
+		view_push_element(L, ptView, uiIndex);
+		lua_rawseti(L, -2, (int)(uiIndex + 1));
+	}
+
+	return 1;
+}
+
+
+
+/** \brief __index of a view, numbers are element indices (starting at 1), strings are methods. */
+static int view_index(lua_State* L)
+{
+	if( lua_type(L, 2)==LUA_TNUMBER )
+	{
+		return view_get(L);
+	}
+
+	luaL_getmetatable(L, VIEW_METATABLE);
+	lua_pushvalue(L, 2);
+	lua_rawget(L, -2);
+
+	return 1;
+}
+
+
+
+/** \brief __newindex of a view, views are read-only. */
+static int view_newindex(lua_State* L)
+{
+	return luaL_error(L, "views on led_analyzer buffers are read-only");
+}
+
+
+
+/** \brief pushes a new view on a C array onto the Lua stack.
+
+The view does not copy the data, it reads the array each time an element is accessed. The array must live as long as the view.
+If the array belongs to a Lua object (e.g. a sample buffer), pass the stack index of that object in iOwner. The view keeps a
+reference to it, so the object is not collected before the view. The owner must be a userdata which holds the pointer to its
+C memory and sets it to NULL when the memory is freed, the view raises an error after that. Pass 0 if there is no owner.
+	@param L			Lua state
+	@param pvData		first element of the array
+	@param uiLength		number of elements
+	@param tType		type of the elements
+	@param iOwner		stack index of the Lua object which owns the array or 0
+	*/
+void led_analyzer_push_view(lua_State* L, const void* pvData, unsigned int uiLength, LED_ANALYZER_VIEW_TYPE_T tType, int iOwner)
+{
+	VIEW_T* ptView;
+
+
+	if( iOwner<0 )
+	{
+		/* Convert the relative index, the stack grows below. */
+		iOwner = lua_gettop(L) + iOwner + 1;
+	}
+
+	ptView = (VIEW_T*)lua_newuserdata(L, sizeof(VIEW_T));
+	ptView->pvData = pvData;
+	ptView->uiLength = uiLength;
+	ptView->tType = tType;
+	ptView->ppvOwner = (iOwner!=0) ? (void* const*)lua_touserdata(L, iOwner) : NULL;
+
+	if( luaL_newmetatable(L, VIEW_METATABLE)!=0 )
+	{
+		lua_pushcfunction(L, view_index);
+		lua_setfield(L, -2, "__index");
+		lua_pushcfunction(L, view_newindex);
+		lua_setfield(L, -2, "__newindex");
+		lua_pushcfunction(L, view_length);
+		lua_setfield(L, -2, "__len");
+		lua_pushcfunction(L, view_get);
+		lua_setfield(L, -2, "get");
+		lua_pushcfunction(L, view_length);
+		lua_setfield(L, -2, "length");
+		lua_pushcfunction(L, view_type);
+		lua_setfield(L, -2, "type");
+		lua_pushcfunction(L, view_totable);
+		lua_setfield(L, -2, "totable");
+	}
+	lua_setmetatable(L, -2);
+
+	/* Keep the owner alive as long as the view exists. */
+	if( iOwner!=0 )
+	{
+		lua_createtable(L, 1, 0);
+		lua_pushvalue(L, iOwner);
+		lua_rawseti(L, -2, 1);
+		view_setuservalue(L, -2);
+	}
+}
+
+
+
+/*-------------------------------------------------------------------------*/
+/* Sample buffers                                                          */
+/*-------------------------------------------------------------------------*/
+
+/** \brief gets the sample buffer at a stack index. */
+static SAMPLE_BUFFER_T* check_sample_buffer(lua_State* L, int iIndex)
+{
+	SAMPLE_BUFFER_T** pptBuffer;
+
+
+	pptBuffer = (SAMPLE_BUFFER_T**)luaL_checkudata(L, iIndex, SAMPLE_BUFFER_METATABLE);
+	if( *pptBuffer==NULL )
+	{
+		luaL_error(L, "the sample buffer was already freed");
+	}
+
+	return *pptBuffer;
+}
+
+
+
+/** \brief gets the sample buffer at a stack index, for the functions in led_analyzer.i. */
+SAMPLE_BUFFER_T* led_analyzer_check_sample_buffer(lua_State* L, int iIndex)
+{
+	return check_sample_buffer(L, iIndex);
+}
+
+
+
+/** \brief buffer:devices() - returns the number of devices of the last reading and the number of devices the buffer can hold. */
+static int sample_buffer_devices(lua_State* L)
+{
+	SAMPLE_BUFFER_T* ptBuffer;
+
+
+	ptBuffer = check_sample_buffer(L, 1);
+	lua_pushnumber(L, ptBuffer->uiValidDevices);
+	lua_pushnumber(L, ptBuffer->uiDevices);
+
+	return 2;
+}
+
+
+
+/** \brief buffer:sequence() - returns the number of readings stored in the buffer so far. */
+static int sample_buffer_sequence(lua_State* L)
+{
+	SAMPLE_BUFFER_T* ptBuffer;
+
+
+	ptBuffer = check_sample_buffer(L, 1);
+	lua_pushnumber(L, (lua_Number)ptBuffer->ulSequence);
+
+	return 1;
+}
+
+
+
+/** \brief buffer:lane(devIndex, lane) - returns clear, red, green, blue, gain, intTime of one lane (devIndex and lane start at 0). */
+static int sample_buffer_lane(lua_State* L)
+{
+	SAMPLE_BUFFER_T* ptBuffer;
+	lua_Number dDevice;
+	lua_Number dLane;
+	unsigned int uiIndex;
+
+
+	ptBuffer = check_sample_buffer(L, 1);
+	dDevice = luaL_checknumber(L, 2);
+	dLane = luaL_checknumber(L, 3);
+	if( dDevice<0 || dDevice>=ptBuffer->uiDevices || dLane<0 || dLane>=16 )
+	{
+		return luaL_error(L, "device %d lane %d is out of range", (int)dDevice, (int)dLane);
+	}
+
+	uiIndex = (unsigned int)dDevice * 16 + (unsigned int)dLane;
+	lua_pushnumber(L, ptBuffer->ausClear[uiIndex]);
+	lua_pushnumber(L, ptBuffer->ausRed[uiIndex]);
+	lua_pushnumber(L, ptBuffer->ausGreen[uiIndex]);
+	lua_pushnumber(L, ptBuffer->ausBlue[uiIndex]);
+	lua_pushnumber(L, ptBuffer->aucGain[uiIndex]);
+	lua_pushnumber(L, ptBuffer->aucIntegrationtime[uiIndex]);
+
+	return 6;
+}
+
+
+
+/** \brief buffer:result(devIndex) - returns the result of read_colors for one device (devIndex starts at 0). */
+static int sample_buffer_result(lua_State* L)
+{
+	SAMPLE_BUFFER_T* ptBuffer;
+	lua_Number dDevice;
+
+
+	ptBuffer = check_sample_buffer(L, 1);
+	dDevice = luaL_checknumber(L, 2);
+	if( dDevice<0 || dDevice>=ptBuffer->uiDevices )
+	{
+		return luaL_error(L, "device %d is out of range", (int)dDevice);
+	}
+	lua_pushnumber(L, ptBuffer->aiResults[(unsigned int)dDevice]);
+
+	return 1;
+}
+
+
+
+/** \brief __gc and buffer:free() - frees the memory of the buffer. The views of the buffer raise an error after this. */
+static int sample_buffer_gc(lua_State* L)
+{
+	SAMPLE_BUFFER_T** pptBuffer;
+
+
+	pptBuffer = (SAMPLE_BUFFER_T**)luaL_checkudata(L, 1, SAMPLE_BUFFER_METATABLE);
+	sample_buffer_free(*pptBuffer);
+	*pptBuffer = NULL;
+
+	return 0;
+}
+
+
+
+/** \brief __index of a sample buffer, the views (clear, red, ...) are stored in the user value, methods in the metatable. */
+static int sample_buffer_index(lua_State* L)
+{
+	check_sample_buffer(L, 1);
+
+	view_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_rawget(L, -2);
+	if( lua_isnil(L, -1) )
+	{
+		luaL_getmetatable(L, SAMPLE_BUFFER_METATABLE);
+		lua_pushvalue(L, 2);
+		lua_rawget(L, -2);
+	}
+
+	return 1;
+}
+
+
+
+/** \brief pushes a new sample buffer onto the Lua stack.
+
+The buffer is a userdata which owns the C memory, it is freed by the garbage collector. The arrays of the buffer can be read
+through the views buffer.clear, buffer.red, buffer.green, buffer.blue, buffer.gain, buffer.intTime (16 elements per device) and
+buffer.result (1 element per device). The views are created once with the buffer, reading them does not create any Lua objects.
+	@param L			Lua state
+	@param uiDevices	number of devices the buffer can hold
+
+	@return 			pointer to the buffer or NULL if no memory could be allocated, nothing is pushed then
+	*/
+SAMPLE_BUFFER_T* led_analyzer_push_sample_buffer(lua_State* L, unsigned int uiDevices)
+{
+	SAMPLE_BUFFER_T* ptBuffer;
+	SAMPLE_BUFFER_T** pptBuffer;
+	unsigned int uiLanes;
+
+
+	ptBuffer = sample_buffer_new(uiDevices);
+	if( ptBuffer!=NULL )
+	{
+		uiLanes = 16 * uiDevices;
+
+		pptBuffer = (SAMPLE_BUFFER_T**)lua_newuserdata(L, sizeof(SAMPLE_BUFFER_T*));
+		*pptBuffer = ptBuffer;
+
+		if( luaL_newmetatable(L, SAMPLE_BUFFER_METATABLE)!=0 )
+		{
+			lua_pushcfunction(L, sample_buffer_index);
+			lua_setfield(L, -2, "__index");
+			lua_pushcfunction(L, view_newindex);
+			lua_setfield(L, -2, "__newindex");
+			lua_pushcfunction(L, sample_buffer_gc);
+			lua_setfield(L, -2, "__gc");
+			lua_pushcfunction(L, sample_buffer_gc);
+			lua_setfield(L, -2, "free");
+			lua_pushcfunction(L, sample_buffer_devices);
+			lua_setfield(L, -2, "devices");
+			lua_pushcfunction(L, sample_buffer_sequence);
+			lua_setfield(L, -2, "sequence");
+			lua_pushcfunction(L, sample_buffer_lane);
+			lua_setfield(L, -2, "lane");
+			lua_pushcfunction(L, sample_buffer_result);
+			lua_setfield(L, -2, "result");
+		}
+		lua_setmetatable(L, -2);
+
+		/* The views keep the buffer alive, the buffer keeps the views in its user value. */
+		lua_createtable(L, 0, 7);
+		led_analyzer_push_view(L, ptBuffer->ausClear, uiLanes, LED_ANALYZER_VIEW_USHORT, -2);
+		lua_setfield(L, -2, "clear");
+		led_analyzer_push_view(L, ptBuffer->ausRed, uiLanes, LED_ANALYZER_VIEW_USHORT, -2);
+		lua_setfield(L, -2, "red");
+		led_analyzer_push_view(L, ptBuffer->ausGreen, uiLanes, LED_ANALYZER_VIEW_USHORT, -2);
+		lua_setfield(L, -2, "green");
+		led_analyzer_push_view(L, ptBuffer->ausBlue, uiLanes, LED_ANALYZER_VIEW_USHORT, -2);
+		lua_setfield(L, -2, "blue");
+		led_analyzer_push_view(L, ptBuffer->aucGain, uiLanes, LED_ANALYZER_VIEW_UCHAR, -2);
+		lua_setfield(L, -2, "gain");
+		led_analyzer_push_view(L, ptBuffer->aucIntegrationtime, uiLanes, LED_ANALYZER_VIEW_UCHAR, -2);
+		lua_setfield(L, -2, "intTime");
+		led_analyzer_push_view(L, ptBuffer->aiResults, uiDevices, LED_ANALYZER_VIEW_INT, -2);
+		lua_setfield(L, -2, "results");
+		view_setuservalue(L, -2);
+	}
+
+	return ptBuffer;
+}
+
+
+
+/*-------------------------------------------------------------------------*/
+/* Asynchronous measurements                                               */
+/*-------------------------------------------------------------------------*/
+
+/** \brief gets the asynchronous measurement at a stack index. */
+static ASYNC_MEASUREMENT_T* check_async(lua_State* L, int iIndex)
+{
+	ASYNC_MEASUREMENT_T** pptAsync;
+
+
+	pptAsync = (ASYNC_MEASUREMENT_T**)luaL_checkudata(L, iIndex, ASYNC_METATABLE);
+	if( *pptAsync==NULL )
+	{
+		luaL_error(L, "the asynchronous measurement was already freed");
+	}
+
+	return *pptAsync;
+}
+
+
+
+/** \brief async:poll() - returns true if the measurement is done, false if it is running and nil if none was started. */
+static int async_poll(lua_State* L)
+{
+	int iState;
+
+
+	iState = async_measurement_poll(check_async(L, 1));
+	if( iState==ASYNC_MEASUREMENT_IDLE )
+	{
+		lua_pushnil(L);
+	}
+	else
+	{
+		lua_pushboolean(L, iState==ASYNC_MEASUREMENT_DONE);
+	}
+
+	return 1;
+}
+
+
+
+/** \brief async:complete() - waits for the measurement and returns the number of devices which were read.
+
+The second result is the time of the reading in microseconds. Returns nil and an error message if no measurement was
+started. The handles and the buffer of the measurement are released.
+ */
+static int async_complete(lua_State* L)
+{
+	int iDevices;
+
+
+	iDevices = async_measurement_complete(check_async(L, 1));
+
+	/* The measurement does not need the handles and the buffer any more. */
+	lua_newtable(L);
+	view_setuservalue(L, 1);
+
+	if( iDevices<0 )
+	{
+		lua_pushnil(L);
+		lua_pushstring(L, "no measurement was started");
+		return 2;
+	}
+	lua_pushnumber(L, iDevices);
+	lua_pushnumber(L, (lua_Number)async_measurement_get_read_time(check_async(L, 1)));
+
+	return 2;
+}
+
+
+
+/** \brief async:fd() - returns the file descriptor which becomes readable when the measurement is done, nil on Windows. */
+static int async_fd(lua_State* L)
+{
+	int iFd;
+
+
+	iFd = async_measurement_get_fd(check_async(L, 1));
+	if( iFd<0 )
+	{
+		lua_pushnil(L);
+	}
+	else
+	{
+		lua_pushnumber(L, iFd);
+	}
+
+	return 1;
+}
+
+
+
+/** \brief __gc and async:free() - waits for a running measurement and frees it. */
+static int async_gc(lua_State* L)
+{
+	ASYNC_MEASUREMENT_T** pptAsync;
+
+
+	pptAsync = (ASYNC_MEASUREMENT_T**)luaL_checkudata(L, 1, ASYNC_METATABLE);
+	async_measurement_free(*pptAsync);
+	*pptAsync = NULL;
+
+	return 0;
+}
+
+
+
+/** \brief pushes a new asynchronous measurement onto the Lua stack.
+
+The measurement is a userdata with the methods poll, complete, fd and free. It is started with start_async in led_analyzer.i.
+	@param L			Lua state
+
+	@return 			pointer to the measurement or NULL if it could not be allocated, nothing is pushed then
+	*/
+ASYNC_MEASUREMENT_T* led_analyzer_push_async(lua_State* L)
+{
+	ASYNC_MEASUREMENT_T* ptAsync;
+	ASYNC_MEASUREMENT_T** pptAsync;
+
+
+	ptAsync = async_measurement_new();
+	if( ptAsync!=NULL )
+	{
+		pptAsync = (ASYNC_MEASUREMENT_T**)lua_newuserdata(L, sizeof(ASYNC_MEASUREMENT_T*));
+		*pptAsync = ptAsync;
+
+		if( luaL_newmetatable(L, ASYNC_METATABLE)!=0 )
+		{
+			lua_pushvalue(L, -1);
+			lua_setfield(L, -2, "__index");
+			lua_pushcfunction(L, async_gc);
+			lua_setfield(L, -2, "__gc");
+			lua_pushcfunction(L, async_gc);
+			lua_setfield(L, -2, "free");
+			lua_pushcfunction(L, async_poll);
+			lua_setfield(L, -2, "poll");
+			lua_pushcfunction(L, async_complete);
+			lua_setfield(L, -2, "complete");
+			lua_pushcfunction(L, async_fd);
+			lua_setfield(L, -2, "fd");
+		}
+		lua_setmetatable(L, -2);
+
+		lua_newtable(L);
+		view_setuservalue(L, -2);
+	}
+
+	return ptAsync;
+}
+
+
+
+/** \brief starts an asynchronous measurement, for start_async in led_analyzer.i.
+
+The stack contains the measurement (1), the handle array (2), the sample buffer (3) and the time to wait for the conversion
+in ms (4). The measurement keeps the handle array and the buffer alive until it is completed.
+	@param L			Lua state
+	@param apHandles	array that stores ftdi2232h handles, converted from stack index 2
+
+	@return 			number of values pushed onto the stack: true or nil and an error message
+	*/
+int led_analyzer_start_async(lua_State* L, void** apHandles)
+{
+	ASYNC_MEASUREMENT_T* ptAsync;
+	SAMPLE_BUFFER_T* ptBuffer;
+	lua_Number dWaitTime;
+
+
+	ptAsync = check_async(L, 1);
+	ptBuffer = check_sample_buffer(L, 3);
+	dWaitTime = luaL_optnumber(L, 4, 0);
+	if( dWaitTime<0 || dWaitTime>60000 )
+	{
+		return luaL_error(L, "start_async: the wait time must be between 0 and 60000 ms");
+	}
+
+	if( async_measurement_start(ptAsync, apHandles, ptBuffer, (unsigned int)dWaitTime)!=0 )
+	{
+		lua_pushnil(L);
+		lua_pushstring(L, "the last measurement was not completed, another one is running or the thread could not be started");
+		return 2;
+	}
+
+	lua_createtable(L, 2, 0);
+	lua_pushvalue(L, 2);
+	lua_rawseti(L, -2, 1);
+	lua_pushvalue(L, 3);
+	lua_rawseti(L, -2, 2);
+	view_setuservalue(L, 1);
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+
+
+/*-------------------------------------------------------------------------*/
+/* Result frames                                                           */
+/*-------------------------------------------------------------------------*/
+
+#if LUA_VERSION_NUM >= 502
+#       define frame_rawlen(L,idx) lua_rawlen(L,idx)
+#else
+#       define frame_rawlen(L,idx) lua_objlen(L,idx)
+#endif
+
+/** \brief gets a number field of the table on top of the stack, missing fields are 0. */
+static float get_float(lua_State* L, const char* pcKey)
+{
+	float fValue;
+
+
+	lua_getfield(L, -1, pcKey);
+	fValue = (float)lua_tonumber(L, -1);
+	lua_pop(L, 1);
+
+	return fValue;
+}
+
+
+
+/** \brief gets an integer field of the table on top of the stack and limits it to 0..uiMax, missing fields are 0. */
+static unsigned int get_uint(lua_State* L, const char* pcKey, unsigned int uiMax)
+{
+	lua_Number dValue;
+	unsigned int uiValue;
+
+
+	lua_getfield(L, -1, pcKey);
+	dValue = lua_tonumber(L, -1);
+	lua_pop(L, 1);
+
+	if( dValue<=0 )
+	{
+		uiValue = 0;
+	}
+	else if( dValue>=uiMax )
+	{
+		uiValue = uiMax;
+	}
+	else
+	{
+		uiValue = (unsigned int)(dValue + 0.5);
+	}
+
+	return uiValue;
+}
+
+
+
+/** \brief pushes a subtable of the table on top of the stack, an empty table if it does not exist. */
+static void get_subtable(lua_State* L, const char* pcKey)
+{
+	lua_getfield(L, -1, pcKey);
+	if( lua_istable(L, -1)==0 )
+	{
+		lua_pop(L, 1);
+		lua_newtable(L);
+	}
+}
+
+
+
+/** \brief reads one lane of a color table (see Color_conversions:aus2colorTable) into a result frame lane.
+
+A lane is valid if its RGB_tsc table contains the normalized colors. The raw readings are taken from RGB_tsc as well,
+dark lanes have no raw readings in the color table.
+	@param L		Lua state
+	@param iIndex	stack index of the lane table
+	@param ptLane	returns the lane
+	*/
+void led_analyzer_check_lane(lua_State* L, int iIndex, RESULT_FRAME_LANE_T* ptLane)
+{
+	lua_pushvalue(L, iIndex);
+
+	get_subtable(L, "RGB_tsc");
+	lua_getfield(L, -1, "R_n");
+	ptLane->ucFlags = (lua_isnil(L, -1)!=0) ? 0 : RESULT_FRAME_LANE_VALID;
+	lua_pop(L, 1);
+	ptLane->fR_n = get_float(L, "R_n");
+	ptLane->fG_n = get_float(L, "G_n");
+	ptLane->fB_n = get_float(L, "B_n");
+	ptLane->usClear = (unsigned short)get_uint(L, "clear", 65535);
+	ptLane->usRed   = (unsigned short)get_uint(L, "red", 65535);
+	ptLane->usGreen = (unsigned short)get_uint(L, "green", 65535);
+	ptLane->usBlue  = (unsigned short)get_uint(L, "blue", 65535);
+	lua_pop(L, 1);
+
+	get_subtable(L, "Wavelength");
+	ptLane->usNm = (unsigned short)get_uint(L, "nm", 65535);
+	ptLane->fSat = get_float(L, "sat");
+	ptLane->fLux = get_float(L, "lux");
+	ptLane->fCCT = get_float(L, "cct");
+	ptLane->fClearRatio = get_float(L, "clear_ratio");
+	lua_pop(L, 1);
+
+	get_subtable(L, "XYZ");
+	ptLane->fX = get_float(L, "X");
+	ptLane->fY = get_float(L, "Y");
+	ptLane->fZ = get_float(L, "Z");
+	lua_pop(L, 1);
+
+	get_subtable(L, "Yxy");
+	ptLane->fx = get_float(L, "x");
+	ptLane->fy = get_float(L, "y");
+	lua_pop(L, 1);
+
+	get_subtable(L, "HSV");
+	ptLane->fH = get_float(L, "H");
+	ptLane->fS = get_float(L, "S");
+	ptLane->fV = get_float(L, "V");
+	lua_pop(L, 1);
+
+	get_subtable(L, "Settings");
+	ptLane->ucGain = (unsigned char)get_uint(L, "gain", 255);
+	ptLane->ucIntegrationtime = (unsigned char)get_uint(L, "intTime", 255);
+	lua_pop(L, 1);
+
+	lua_pop(L, 1);
+}
+
+
+
+/** \brief pushes one lane of a result frame as a color table entry onto the Lua stack.
+
+The entry has the same structure as an entry of Color_conversions:aus2colorTable. The raw readings are only set if the frame
+contains them (RESULT_FRAME_FLAG_RAW).
+	@param L		Lua state
+	@param ptLane	lane
+	@param ucFlags	frame flags (RESULT_FRAME_FLAG_*)
+	*/
+void led_analyzer_push_lane(lua_State* L, const RESULT_FRAME_LANE_T* ptLane, unsigned char ucFlags)
+{
+	int fValid;
+
+
+	fValid = ((ptLane->ucFlags & RESULT_FRAME_LANE_VALID)!=0);
+
+	lua_createtable(L, 0, 6);
+
+	lua_createtable(L, 0, 9);
+	set_number(L, "lux", ptLane->fLux);
+	set_number(L, "clear_ratio", ptLane->fClearRatio);
+	if( fValid==0 )
+	{
+		set_integer(L, "nm", 0);
+		set_integer(L, "sat", 0);
+		set_integer(L, "cct", 0);
+		set_integer(L, "r_estimate", 0);
+		set_integer(L, "g_estimate", 0);
+		set_integer(L, "b_estimate", 0);
+	}
+	else
+	{
+		set_integer(L, "nm", ptLane->usNm);
+		set_number(L, "sat", ptLane->fSat);
+		set_number(L, "cct", ptLane->fCCT);
+	}
+	lua_setfield(L, -2, "Wavelength");
+
+	lua_createtable(L, 0, 7);
+	if( fValid==0 )
+	{
+		set_integer(L, "clear_tsc", 0);
+		set_integer(L, "red_tsc", 0);
+		set_integer(L, "green_tsc", 0);
+		set_integer(L, "blue_tsc", 0);
+	}
+	else
+	{
+		if( (ucFlags & RESULT_FRAME_FLAG_RAW)!=0 )
+		{
+			set_number(L, "clear", ptLane->usClear);
+			set_number(L, "red", ptLane->usRed);
+			set_number(L, "green", ptLane->usGreen);
+			set_number(L, "blue", ptLane->usBlue);
+		}
+		set_number(L, "R_n", ptLane->fR_n);
+		set_number(L, "G_n", ptLane->fG_n);
+		set_number(L, "B_n", ptLane->fB_n);
+	}
+	lua_setfield(L, -2, "RGB_tsc");
+
+	/* XYZ, Yxy and HSV contain plain zeros for dark lanes. */
+	lua_createtable(L, 0, 3);
+	if( fValid==0 )
+	{
+		set_integer(L, "X", 0);
+		set_integer(L, "Y", 0);
+		set_integer(L, "Z", 0);
+	}
+	else
+	{
+		set_number(L, "X", ptLane->fX);
+		set_number(L, "Y", ptLane->fY);
+		set_number(L, "Z", ptLane->fZ);
+	}
+	lua_setfield(L, -2, "XYZ");
+
+	lua_createtable(L, 0, 3);
+	if( fValid==0 )
+	{
+		set_integer(L, "Y", 0);
+		set_integer(L, "x", 0);
+		set_integer(L, "y", 0);
+	}
+	else
+	{
+		set_number(L, "Y", ptLane->fY);
+		set_number(L, "x", ptLane->fx);
+		set_number(L, "y", ptLane->fy);
+	}
+	lua_setfield(L, -2, "Yxy");
+
+	lua_createtable(L, 0, 3);
+	if( fValid==0 )
+	{
+		set_integer(L, "H", 0);
+		set_integer(L, "S", 0);
+		set_integer(L, "V", 0);
+	}
+	else
+	{
+		set_number(L, "H", ptLane->fH);
+		set_number(L, "S", ptLane->fS);
+		set_number(L, "V", ptLane->fV);
+	}
+	lua_setfield(L, -2, "HSV");
+
+	lua_createtable(L, 0, 2);
+	set_number(L, "gain", ptLane->ucGain);
+	set_number(L, "intTime", ptLane->ucIntegrationtime);
+	lua_setfield(L, -2, "Settings");
+}
+
+
+
+/** \brief encodes color tables into a result frame and pushes it as a string onto the Lua stack.
+
+tColorTables has one entry per device, the key is the serial number and the value the color table of the device. tResults is
+optional (0 for no table), it contains the result of the measurement for each serial number. Devices without a result get 0.
+	@param L				Lua state
+	@param iColorTables		stack index of tColorTables
+	@param iResults			stack index of tResults or 0
+	@param ucFlags			frame flags (RESULT_FRAME_FLAG_*)
+
+	@return 				0 if the frame was pushed, otherwise an error message was pushed
+	*/
+int led_analyzer_push_result_frame(lua_State* L, int iColorTables, int iResults, unsigned char ucFlags)
+{
+	unsigned int uiDevices;
+	unsigned int uiSize;
+	unsigned int uiLanes;
+	unsigned int uiLane;
+	size_t sizSerial;
+	const char* pcSerial;
+	unsigned char* pucFrame;
+	unsigned char* pucPos;
+	int iResult;
+	RESULT_FRAME_LANE_T tLane;
+
+
+	/* The first pass checks all devices and gets the size of the frame. */
+	uiDevices = 0;
+	uiSize = RESULT_FRAME_HEADER_SIZE;
+	lua_pushnil(L);
+	while( lua_next(L, iColorTables)!=0 )
+	{
+		/* Do not convert the key itself, this would confuse lua_next. */
+		lua_pushvalue(L, -2);
+		pcSerial = lua_tolstring(L, -1, &sizSerial);
+		if( pcSerial==NULL || sizSerial>RESULT_FRAME_MAX_SERIAL || lua_istable(L, -2)==0 || frame_rawlen(L, -2)>255 )
+		{
+			lua_pop(L, 3);
+			lua_pushstring(L, "the color tables need a serial number (at most 255 characters) and at most 255 lanes per device");
+			return -1;
+		}
+		uiSize += result_frame_device_size((unsigned int)sizSerial, (unsigned int)frame_rawlen(L, -2), ucFlags);
+		uiDevices++;
+		lua_pop(L, 2);
+	}
+	if( uiDevices>65535 )
+	{
+		lua_pushstring(L, "too many devices for one frame");
+		return -1;
+	}
+
+	pucFrame = (unsigned char*)malloc(uiSize);
+	if( pucFrame==NULL )
+	{
+		lua_pushstring(L, "out of memory");
+		return -1;
+	}
+
+	pucPos = pucFrame + result_frame_put_header(pucFrame, uiDevices, ucFlags);
+	lua_pushnil(L);
+	while( lua_next(L, iColorTables)!=0 )
+	{
+		lua_pushvalue(L, -2);
+		pcSerial = lua_tolstring(L, -1, &sizSerial);
+
+		iResult = 0;
+		if( iResults!=0 )
+		{
+			lua_pushvalue(L, -1);
+			lua_gettable(L, iResults);
+			iResult = (int)lua_tonumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		uiLanes = (unsigned int)frame_rawlen(L, -2);
+		pucPos += result_frame_put_device(pucPos, pcSerial, (unsigned int)sizSerial, iResult, uiLanes);
+		for(uiLane=1; uiLane<=uiLanes; uiLane++)
+		{
+			lua_rawgeti(L, -2, (int)uiLane);
+			memset(&tLane, 0, sizeof(tLane));
+			if( lua_istable(L, -1) )
+			{
+				led_analyzer_check_lane(L, -1, &tLane);
+			}
+			lua_pop(L, 1);
+			pucPos += result_frame_put_lane(pucPos, &tLane, ucFlags);
+		}
+		lua_pop(L, 2);
+	}
+
+	lua_pushlstring(L, (const char*)pucFrame, uiSize);
+	free(pucFrame);
+
+	return 0;
+}
+
+
+
+/** \brief decodes a result frame and pushes the color tables and the results onto the Lua stack.
+
+This is the reverse of led_analyzer_push_result_frame. Two tables are pushed: the color tables and the results, both with the
+serial numbers as keys.
+	@param L			Lua state
+	@param pucFrame		frame
+	@param uiSize		size of the frame in bytes
+
+	@return 			0 if the tables were pushed, otherwise an error message was pushed
+	*/
+int led_analyzer_push_decoded_frame(lua_State* L, const unsigned char* pucFrame, unsigned int uiSize)
+{
+	unsigned int uiDevices;
+	unsigned int uiDevice;
+	unsigned char ucFlags;
+	const char* pcSerial;
+	unsigned int uiSerialLength;
+	unsigned int uiLanes;
+	unsigned int uiLane;
+	int iResult;
+	int iHeader;
+	RESULT_FRAME_LANE_T tLane;
+
+
+	iResult = result_frame_get_header(pucFrame, uiSize, &uiDevices, &ucFlags);
+	if( iResult!=0 )
+	{
+		lua_pushstring(L, (iResult==-3) ? "unsupported version of the result frame" : "this is not a result frame");
+		return -1;
+	}
+	pucFrame += RESULT_FRAME_HEADER_SIZE;
+	uiSize -= RESULT_FRAME_HEADER_SIZE;
+
+	lua_createtable(L, 0, (int)uiDevices);
+	lua_createtable(L, 0, (int)uiDevices);
+	for(uiDevice=0; uiDevice<uiDevices; uiDevice++)
+	{
+		iHeader = result_frame_get_device(pucFrame, uiSize, &pcSerial, &uiSerialLength, &iResult, &uiLanes);
+		if( iHeader<0 || uiSize<result_frame_device_size(uiSerialLength, uiLanes, ucFlags) )
+		{
+			lua_pop(L, 2);
+			lua_pushstring(L, "the result frame is truncated");
+			return -1;
+		}
+		pucFrame += iHeader;
+		uiSize -= result_frame_device_size(uiSerialLength, uiLanes, ucFlags);
+
+		lua_pushlstring(L, pcSerial, uiSerialLength);
+		lua_pushinteger(L, iResult);
+		lua_settable(L, -3);
+
+		lua_pushlstring(L, pcSerial, uiSerialLength);
+		lua_createtable(L, (int)uiLanes, 0);
+		for(uiLane=0; uiLane<uiLanes; uiLane++)
+		{
+			pucFrame += result_frame_get_lane(pucFrame, &tLane, ucFlags);
+			led_analyzer_push_lane(L, &tLane, ucFlags);
+			lua_rawseti(L, -2, (int)(uiLane + 1));
+		}
+		lua_settable(L, -4);
+	}
+
+	return 0;
+}
+
+
+
+/*-------------------------------------------------------------------------*/
+/* Test plans                                                              */
+/*-------------------------------------------------------------------------*/
+
+/** \brief gets the test plan at a stack index. */
+static TEST_PLAN_T* check_test_plan(lua_State* L, int iIndex)
+{
+	TEST_PLAN_T** pptPlan;
+
+
+	pptPlan = (TEST_PLAN_T**)luaL_checkudata(L, iIndex, TEST_PLAN_METATABLE);
+	if( *pptPlan==NULL )
+	{
+		luaL_error(L, "the test plan was already freed");
+	}
+
+	return *pptPlan;
+}
+
+
+
+/** \brief gets the test plan at a stack index, raises a Lua error if it is something else. */
+TEST_PLAN_T* led_analyzer_check_test_plan(lua_State* L, int iIndex)
+{
+	return check_test_plan(L, iIndex);
+}
+
+
+
+/** \brief plan:set(step, device, lane, tLane) - sets the test entry of a lane (all indices start at 0).
+
+tLane has the fields of a test set entry: nm, tol_nm, sat, tol_sat, lux, tol_lux and optionally gain and integration.
+A missing tLane removes the test entry.
+ */
+static int test_plan_set(lua_State* L)
+{
+	TEST_PLAN_T* ptPlan;
+	TEST_PLAN_LANE_T* ptLane;
+	lua_Number dStep;
+	lua_Number dDevice;
+	lua_Number dLane;
+
+
+	ptPlan = check_test_plan(L, 1);
+	dStep = luaL_checknumber(L, 2);
+	dDevice = luaL_checknumber(L, 3);
+	dLane = luaL_checknumber(L, 4);
+	ptLane = NULL;
+	if( dStep>=0 && dDevice>=0 && dLane>=0 )
+	{
+		ptLane = test_plan_get_lane(ptPlan, (unsigned int)dStep, (unsigned int)dDevice, (unsigned int)dLane);
+	}
+	if( ptLane==NULL )
+	{
+		return luaL_error(L, "step %d device %d lane %d is out of range", (int)dStep, (int)dDevice, (int)dLane);
+	}
+
+	memset(ptLane, 0, sizeof(TEST_PLAN_LANE_T));
+	if( lua_istable(L, 5) )
+	{
+		lua_settop(L, 5);
+		ptLane->fNm = get_float(L, "nm");
+		ptLane->fTolNm = get_float(L, "tol_nm");
+		ptLane->fSat = get_float(L, "sat");
+		ptLane->fTolSat = get_float(L, "tol_sat");
+		ptLane->fLux = get_float(L, "lux");
+		ptLane->fTolLux = get_float(L, "tol_lux");
+		ptLane->ucGain = (unsigned char)get_uint(L, "gain", 255);
+		ptLane->ucIntegrationtime = (unsigned char)get_uint(L, "integration", 255);
+		ptLane->ucFlags = TEST_PLAN_LANE_TESTED;
+	}
+
+	return 0;
+}
+
+
+
+/** \brief plan:size() - returns the number of steps and the number of devices of the plan. */
+static int test_plan_size(lua_State* L)
+{
+	TEST_PLAN_T* ptPlan;
+
+
+	ptPlan = check_test_plan(L, 1);
+	lua_pushnumber(L, ptPlan->uiSteps);
+	lua_pushnumber(L, ptPlan->uiDevices);
+
+	return 2;
+}
+
+
+
+/** \brief __gc and plan:free() - frees the memory of the plan. */
+static int test_plan_gc(lua_State* L)
+{
+	TEST_PLAN_T** pptPlan;
+
+
+	pptPlan = (TEST_PLAN_T**)luaL_checkudata(L, 1, TEST_PLAN_METATABLE);
+	test_plan_free(*pptPlan);
+	*pptPlan = NULL;
+
+	return 0;
+}
+
+
+
+/** \brief pushes a new test plan without any test entries onto the Lua stack.
+
+The plan is a userdata with the methods set, size and free, it is freed by the garbage collector.
+	@param L			Lua state
+	@param uiSteps		number of test steps
+	@param uiDevices	number of devices per step
+
+	@return 			pointer to the plan or NULL if no memory could be allocated, nothing is pushed then
+	*/
+TEST_PLAN_T* led_analyzer_push_test_plan(lua_State* L, unsigned int uiSteps, unsigned int uiDevices)
+{
+	TEST_PLAN_T* ptPlan;
+	TEST_PLAN_T** pptPlan;
+
+
+	ptPlan = test_plan_new(uiSteps, uiDevices);
+	if( ptPlan!=NULL )
+	{
+		pptPlan = (TEST_PLAN_T**)lua_newuserdata(L, sizeof(TEST_PLAN_T*));
+		*pptPlan = ptPlan;
+
+		if( luaL_newmetatable(L, TEST_PLAN_METATABLE)!=0 )
+		{
+			lua_pushvalue(L, -1);
+			lua_setfield(L, -2, "__index");
+			lua_pushcfunction(L, test_plan_gc);
+			lua_setfield(L, -2, "__gc");
+			lua_pushcfunction(L, test_plan_gc);
+			lua_setfield(L, -2, "free");
+			lua_pushcfunction(L, test_plan_set);
+			lua_setfield(L, -2, "set");
+			lua_pushcfunction(L, test_plan_size);
+			lua_setfield(L, -2, "size");
+		}
+		lua_setmetatable(L, -2);
+	}
+
+	return ptPlan;
+}
+
+
+
+/** \brief validates the converted colors of several devices and pushes a summary onto the Lua stack.
+
+The summary has the same structure as the one of Color_validation:summarizeCoCo in lua/color_validation.lua: one entry per
+device with uiTested, uiFailed and atLanes. atLanes contains nm, sat, lux and uiFailed of the failed lanes (or of all tested
+lanes if fAllValues is not 0), the lane numbers start at 1 and are strings.
+	@param L				Lua state
+	@param ptPlan			test plan
+	@param uiStep			test step, starting at 0
+	@param asSerials		serial numbers of the devices, they are the keys of the summary
+	@param iDevices			number of devices in ptColorSpaces
+	@param ptColorSpaces	converted colors of all devices, 16 lanes per device
+	@param iPlanDevices		stack index of a list with the device of the plan for each measured device (starting at 0),
+							devices without an entry are not validated
+	@param fLuxCheck		check the illumination as well
+	@param fAllValues		return the values of all tested lanes
+	*/
+void led_analyzer_push_validation(lua_State* L, const TEST_PLAN_T* ptPlan, unsigned int uiStep, char** asSerials, int iDevices,
+                                  const COLOR_SPACES_T* ptColorSpaces, int iPlanDevices, int fLuxCheck, int fAllValues)
+{
+	int devIndex;
+	unsigned int uiIndex;
+	unsigned int uiLane;
+	unsigned int uiFailed;
+	unsigned int uiTested;
+	unsigned char aucChecks[TEST_PLAN_LANES];
+	char acLane[4];
+	lua_Number dPlanDevice;
+
+
+	lua_createtable(L, 0, iDevices);
+	for(devIndex=0; devIndex<iDevices; devIndex++)
+	{
+		lua_rawgeti(L, iPlanDevices, devIndex + 1);
+		dPlanDevice = lua_isnumber(L, -1) ? lua_tonumber(L, -1) : -1;
+		lua_pop(L, 1);
+		if( dPlanDevice<0 )
+		{
+			continue;
+		}
+
+		uiFailed = test_plan_validate(ptPlan, uiStep, (unsigned int)dPlanDevice, ptColorSpaces, (unsigned int)devIndex * 16,
+		                              fLuxCheck, &uiTested, aucChecks);
+
+		push_serial(L, asSerials, devIndex);
+		lua_createtable(L, 0, 3);
+		set_integer(L, "uiTested", (long)uiTested);
+		set_integer(L, "uiFailed", (long)uiFailed);
+		lua_newtable(L);
+		for(uiLane=0; uiLane<TEST_PLAN_LANES; uiLane++)
+		{
+			if( (uiTested & (1U<<uiLane))!=0 && (aucChecks[uiLane]!=0 || fAllValues!=0) )
+			{
+				uiIndex = (unsigned int)devIndex * 16 + uiLane;
+				sprintf(acLane, "%u", uiLane + 1);
+				lua_createtable(L, 0, 4);
+				if( ptColorSpaces->aucValid[uiIndex]!=0 )
+				{
+					set_integer(L, "nm", (long)floor(ptColorSpaces->adWavelength[uiIndex] + 0.5));
+					set_number(L, "sat", ptColorSpaces->adSaturation[uiIndex] * 100);
+				}
+				else
+				{
+					set_integer(L, "nm", 0);
+					set_integer(L, "sat", 0);
+				}
+				set_number(L, "lux", ptColorSpaces->adLux[uiIndex]);
+				set_integer(L, "uiFailed", aucChecks[uiLane]);
+				lua_setfield(L, -2, acLane);
+			}
+		}
+		lua_setfield(L, -2, "atLanes");
+		lua_settable(L, -3);
+	}
+}
+
+
+
+/*-------------------------------------------------------------------------*/
+/* Sequential tests                                                        */
+/*-------------------------------------------------------------------------*/
+
+/** \brief gets the sequential test at a stack index. */
+static TEST_PLAN_SEQUENTIAL_T* check_sequential_test(lua_State* L, int iIndex)
+{
+	TEST_PLAN_SEQUENTIAL_T** pptSequential;
+
+
+	pptSequential = (TEST_PLAN_SEQUENTIAL_T**)luaL_checkudata(L, iIndex, SEQUENTIAL_TEST_METATABLE);
+	if( *pptSequential==NULL )
+	{
+		luaL_error(L, "the sequential test was already freed");
+	}
+
+	return *pptSequential;
+}
+
+
+
+/** \brief gets a sample buffer with at least the lanes of a sequential test. */
+static SAMPLE_BUFFER_T* check_sequential_buffer(lua_State* L, int iIndex, const TEST_PLAN_SEQUENTIAL_T* ptSequential)
+{
+	SAMPLE_BUFFER_T* ptBuffer;
+
+
+	ptBuffer = check_sample_buffer(L, iIndex);
+	if( ptBuffer->uiDevices * 16 < ptSequential->uiLanes )
+	{
+		luaL_error(L, "the sample buffer has only %d devices", (int)ptBuffer->uiDevices);
+	}
+
+	return ptBuffer;
+}
+
+
+
+/** \brief test:add(tBuffer) - adds the last reading of a sample buffer, returns the number of samples. */
+static int sequential_test_add(lua_State* L)
+{
+	TEST_PLAN_SEQUENTIAL_T* ptSequential;
+	SAMPLE_BUFFER_T* ptBuffer;
+
+
+	ptSequential = check_sequential_test(L, 1);
+	ptBuffer = check_sequential_buffer(L, 2, ptSequential);
+	test_plan_sequential_add(ptSequential, ptBuffer->ausClear, ptBuffer->ausRed, ptBuffer->ausGreen, ptBuffer->ausBlue,
+	                         ptBuffer->aucIntegrationtime, ptBuffer->aucGain);
+	lua_pushnumber(L, (lua_Number)ptSequential->ulSamples);
+
+	return 1;
+}
+
+
+
+/** \brief test:decide(tPlan, uiStep, auiPlanDevices, fLuxCheck, dZ) - returns the number of undecided and tested lanes.
+
+uiStep starts at 0, auiPlanDevices has the device of the plan (starting at 0) for each measured device like in
+buffer_validate, devices without an entry are skipped. dZ is the half width of the confidence intervals in standard
+errors.
+ */
+static int sequential_test_decide(lua_State* L)
+{
+	TEST_PLAN_SEQUENTIAL_T* ptSequential;
+	TEST_PLAN_T* ptPlan;
+	lua_Number dStep;
+	lua_Number dZ;
+	lua_Number dPlanDevice;
+	int fLuxCheck;
+	unsigned int uiDevice;
+	unsigned int uiUndecided;
+	unsigned int uiTested;
+	unsigned int uiUndecidedLanes;
+	unsigned int uiTestedLanes;
+
+
+	ptSequential = check_sequential_test(L, 1);
+	ptPlan = led_analyzer_check_test_plan(L, 2);
+	dStep = luaL_checknumber(L, 3);
+	luaL_checktype(L, 4, LUA_TTABLE);
+	fLuxCheck = lua_toboolean(L, 5);
+	dZ = luaL_checknumber(L, 6);
+	if( dStep<0 || dStep>=ptPlan->uiSteps )
+	{
+		return luaL_error(L, "the plan has no step %d", (int)dStep);
+	}
+
+	uiUndecidedLanes = 0;
+	uiTestedLanes = 0;
+	for(uiDevice=0; uiDevice<ptSequential->uiLanes/16; uiDevice++)
+	{
+		lua_rawgeti(L, 4, (int)uiDevice + 1);
+		dPlanDevice = lua_isnumber(L, -1) ? lua_tonumber(L, -1) : -1;
+		lua_pop(L, 1);
+		if( dPlanDevice>=0 )
+		{
+			uiUndecided = test_plan_sequential_decide(ptSequential, ptPlan, (unsigned int)dStep, (unsigned int)dPlanDevice,
+			                                          uiDevice * 16, fLuxCheck, dZ, &uiTested);
+			for(; uiUndecided!=0; uiUndecided&=uiUndecided-1)
+			{
+				uiUndecidedLanes++;
+			}
+			for(; uiTested!=0; uiTested&=uiTested-1)
+			{
+				uiTestedLanes++;
+			}
+		}
+	}
+	lua_pushnumber(L, uiUndecidedLanes);
+	lua_pushnumber(L, uiTestedLanes);
+
+	return 2;
+}
+
+
+
+/** \brief test:mean(tBuffer) - replaces the readings of the buffer with the mean of all samples. */
+static int sequential_test_mean(lua_State* L)
+{
+	TEST_PLAN_SEQUENTIAL_T* ptSequential;
+	SAMPLE_BUFFER_T* ptBuffer;
+
+
+	ptSequential = check_sequential_test(L, 1);
+	ptBuffer = check_sequential_buffer(L, 2, ptSequential);
+	test_plan_sequential_mean(ptSequential, ptBuffer->ausClear, ptBuffer->ausRed, ptBuffer->ausGreen, ptBuffer->ausBlue);
+
+	return 0;
+}
+
+
+
+/** \brief test:samples() - returns the number of samples. */
+static int sequential_test_samples(lua_State* L)
+{
+	lua_pushnumber(L, (lua_Number)check_sequential_test(L, 1)->ulSamples);
+
+	return 1;
+}
+
+
+
+/** \brief test:reset() - removes all samples. */
+static int sequential_test_reset(lua_State* L)
+{
+	test_plan_sequential_reset(check_sequential_test(L, 1));
+
+	return 0;
+}
+
+
+
+/** \brief __gc and test:free() - frees the memory of the sequential test. */
+static int sequential_test_gc(lua_State* L)
+{
+	TEST_PLAN_SEQUENTIAL_T** pptSequential;
+
+
+	pptSequential = (TEST_PLAN_SEQUENTIAL_T**)luaL_checkudata(L, 1, SEQUENTIAL_TEST_METATABLE);
+	test_plan_sequential_free(*pptSequential);
+	*pptSequential = NULL;
+
+	return 0;
+}
+
+
+
+/** \brief pushes a new sequential test for uiDevices devices onto the Lua stack.
+
+The test is a userdata with the methods add, decide, mean, samples, reset and free, it is freed by the garbage collector.
+	@param L			Lua state
+	@param uiDevices	number of devices
+
+	@return 			pointer to the test or NULL if no memory could be allocated, nothing is pushed then
+	*/
+TEST_PLAN_SEQUENTIAL_T* led_analyzer_push_sequential_test(lua_State* L, unsigned int uiDevices)
+{
+	TEST_PLAN_SEQUENTIAL_T* ptSequential;
+	TEST_PLAN_SEQUENTIAL_T** pptSequential;
+
+
+	ptSequential = test_plan_sequential_new(uiDevices * 16);
+	if( ptSequential!=NULL )
+	{
+		pptSequential = (TEST_PLAN_SEQUENTIAL_T**)lua_newuserdata(L, sizeof(TEST_PLAN_SEQUENTIAL_T*));
+		*pptSequential = ptSequential;
+
+		if( luaL_newmetatable(L, SEQUENTIAL_TEST_METATABLE)!=0 )
+		{
+			lua_pushvalue(L, -1);
+			lua_setfield(L, -2, "__index");
+			lua_pushcfunction(L, sequential_test_gc);
+			lua_setfield(L, -2, "__gc");
+			lua_pushcfunction(L, sequential_test_gc);
+			lua_setfield(L, -2, "free");
+			lua_pushcfunction(L, sequential_test_add);
+			lua_setfield(L, -2, "add");
+			lua_pushcfunction(L, sequential_test_decide);
+			lua_setfield(L, -2, "decide");
+			lua_pushcfunction(L, sequential_test_mean);
+			lua_setfield(L, -2, "mean");
+			lua_pushcfunction(L, sequential_test_samples);
+			lua_setfield(L, -2, "samples");
+			lua_pushcfunction(L, sequential_test_reset);
+			lua_setfield(L, -2, "reset");
+		}
+		lua_setmetatable(L, -2);
+	}
+
+	return ptSequential;
+}
+
+
+
+/*-------------------------------------------------------------------------*/
+/* Measurement logs                                                        */
+/*-------------------------------------------------------------------------*/
+
+/** \brief gets the measurement log at a stack index. */
+static MEASUREMENT_LOG_T* check_measurement_log(lua_State* L, int iIndex)
+{
+	MEASUREMENT_LOG_T** pptLog;
+
+
+	pptLog = (MEASUREMENT_LOG_T**)luaL_checkudata(L, iIndex, MEASUREMENT_LOG_METATABLE);
+	if( *pptLog==NULL )
+	{
+		luaL_error(L, "the measurement log was already closed");
+	}
+
+	return *pptLog;
+}
+
+
+
+/** \brief reads the validation of a device from a summary (see Color_validation:summarizeCoCo).
+
+The serial number of the device must be on top of the stack, it is popped.
+	@param L			Lua state
+	@param iSummary		stack index of the summary or 0 if there is none
+	@param puiTested	returns the mask of the tested lanes
+	@param aucChecks	returns the failed checks of the first 32 lanes
+	*/
+static void get_device_checks(lua_State* L, int iSummary, unsigned int* puiTested, unsigned char* aucChecks)
+{
+	unsigned int uiLane;
+	unsigned int uiFailed;
+	char acLane[4];
+
+
+	*puiTested = 0;
+	memset(aucChecks, 0, 32);
+
+	if( iSummary==0 )
+	{
+		lua_pop(L, 1);
+		return;
+	}
+
+	lua_gettable(L, iSummary);
+	if( lua_istable(L, -1) )
+	{
+		*puiTested = get_uint(L, "uiTested", 0xffffffffU);
+		uiFailed = get_uint(L, "uiFailed", 0xffffffffU);
+
+		get_subtable(L, "atLanes");
+		for(uiLane=0; uiLane<32; uiLane++)
+		{
+			if( (uiFailed & (1U<<uiLane))!=0 )
+			{
+				sprintf(acLane, "%u", uiLane + 1);
+				lua_getfield(L, -1, acLane);
+				if( lua_istable(L, -1) )
+				{
+					aucChecks[uiLane] = (unsigned char)get_uint(L, "uiFailed", 255);
+				}
+				/* The summary does not need the values of the failed lanes, the lane still failed. */
+				if( aucChecks[uiLane]==0 )
+				{
+					aucChecks[uiLane] = 0xff;
+				}
+				lua_pop(L, 1);
+			}
+		}
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+}
+
+
+
+/** \brief fills the record of a lane. */
+static void set_record(MEASUREMENT_LOG_RECORD_T* ptRecord, const RESULT_FRAME_LANE_T* ptLane, unsigned int uiLane,
+                       unsigned int uiTested, const unsigned char* aucChecks)
+{
+	ptRecord->ucLane = (unsigned char)uiLane;
+	ptRecord->ucFlags = ((ptLane->ucFlags & RESULT_FRAME_LANE_VALID)!=0) ? MEASUREMENT_LOG_FLAG_VALID : 0;
+	ptRecord->ucChecks = 0;
+	if( uiLane<32 && (uiTested & (1U<<uiLane))!=0 )
+	{
+		ptRecord->ucFlags |= MEASUREMENT_LOG_FLAG_TESTED;
+		if( aucChecks[uiLane]!=0 )
+		{
+			ptRecord->ucFlags |= MEASUREMENT_LOG_FLAG_FAILED;
+			/* 0xff only marks a failed lane without the checks. */
+			ptRecord->ucChecks = (aucChecks[uiLane]!=0xff) ? aucChecks[uiLane] : 0;
+		}
+	}
+	ptRecord->ucGain = ptLane->ucGain;
+	ptRecord->ucIntegrationtime = ptLane->ucIntegrationtime;
+	ptRecord->usClear = ptLane->usClear;
+	ptRecord->usRed = ptLane->usRed;
+	ptRecord->usGreen = ptLane->usGreen;
+	ptRecord->usBlue = ptLane->usBlue;
+	ptRecord->usNm = ptLane->usNm;
+	ptRecord->fSat = ptLane->fSat;
+	ptRecord->fLux = ptLane->fLux;
+}
+
+
+
+/** \brief copies a serial number into a record, it is cut after MEASUREMENT_LOG_SERIAL_SIZE characters. */
+static void set_record_serial(MEASUREMENT_LOG_RECORD_T* ptRecord, const char* pcSerial, size_t sizSerial)
+{
+	if( sizSerial>MEASUREMENT_LOG_SERIAL_SIZE )
+	{
+		sizSerial = MEASUREMENT_LOG_SERIAL_SIZE;
+	}
+	memcpy(ptRecord->acSerial, pcSerial, sizSerial);
+	ptRecord->acSerial[sizSerial] = 0;
+}
+
+
+
+/** \brief appends the lanes of a result frame, returns the number of records or -1 with an error message on the stack. */
+static int append_frame(lua_State* L, MEASUREMENT_LOG_T* ptLog, MEASUREMENT_LOG_RECORD_T* ptRecord, int iFrame, int iSummary)
+{
+	const unsigned char* pucFrame;
+	size_t sizFrame;
+	unsigned int uiDevices;
+	unsigned int uiDevice;
+	unsigned int uiLanes;
+	unsigned int uiLane;
+	unsigned int uiSerialLength;
+	unsigned int uiTested;
+	unsigned char ucFlags;
+	unsigned char aucChecks[32];
+	const char* pcSerial;
+	int iHeader;
+	int iRecords;
+	RESULT_FRAME_LANE_T tLane;
+
+
+	pucFrame = (const unsigned char*)lua_tolstring(L, iFrame, &sizFrame);
+	if( result_frame_get_header(pucFrame, (unsigned int)sizFrame, &uiDevices, &ucFlags)!=0 )
+	{
+		lua_pushstring(L, "this is not a result frame");
+		return -1;
+	}
+	pucFrame += RESULT_FRAME_HEADER_SIZE;
+	sizFrame -= RESULT_FRAME_HEADER_SIZE;
+
+	iRecords = 0;
+	for(uiDevice=0; uiDevice<uiDevices; uiDevice++)
+	{
+		iHeader = result_frame_get_device(pucFrame, (unsigned int)sizFrame, &pcSerial, &uiSerialLength, &ptRecord->iResult, &uiLanes);
+		if( iHeader<0 || sizFrame<result_frame_device_size(uiSerialLength, uiLanes, ucFlags) )
+		{
+			lua_pushstring(L, "the result frame is truncated");
+			return -1;
+		}
+		set_record_serial(ptRecord, pcSerial, uiSerialLength);
+		lua_pushlstring(L, pcSerial, uiSerialLength);
+		get_device_checks(L, iSummary, &uiTested, aucChecks);
+
+		sizFrame -= result_frame_device_size(uiSerialLength, uiLanes, ucFlags);
+		pucFrame += iHeader;
+		for(uiLane=0; uiLane<uiLanes; uiLane++)
+		{
+			pucFrame += result_frame_get_lane(pucFrame, &tLane, ucFlags);
+			set_record(ptRecord, &tLane, uiLane, uiTested, aucChecks);
+			if( measurement_log_append(ptLog, ptRecord)!=0 )
+			{
+				lua_pushstring(L, "failed to write the measurement log");
+				return -1;
+			}
+			iRecords++;
+		}
+	}
+
+	return iRecords;
+}
+
+
+
+/** \brief appends the lanes of color tables, returns the number of records or -1 with an error message on the stack. */
+static int append_color_tables(lua_State* L, MEASUREMENT_LOG_T* ptLog, MEASUREMENT_LOG_RECORD_T* ptRecord, int iColorTables, int iSummary)
+{
+	unsigned int uiLanes;
+	unsigned int uiLane;
+	unsigned int uiTested;
+	unsigned char aucChecks[32];
+	const char* pcSerial;
+	size_t sizSerial;
+	int iRecords;
+	RESULT_FRAME_LANE_T tLane;
+
+
+	iRecords = 0;
+	ptRecord->iResult = 0;
+	lua_pushnil(L);
+	while( lua_next(L, iColorTables)!=0 )
+	{
+		/* Do not convert the key itself, this would confuse lua_next. */
+		lua_pushvalue(L, -2);
+		pcSerial = lua_tolstring(L, -1, &sizSerial);
+		if( pcSerial!=NULL && lua_istable(L, -2) )
+		{
+			set_record_serial(ptRecord, pcSerial, sizSerial);
+			lua_pushvalue(L, -1);
+			get_device_checks(L, iSummary, &uiTested, aucChecks);
+
+			uiLanes = (unsigned int)frame_rawlen(L, -2);
+			for(uiLane=0; uiLane<uiLanes && uiLane<256; uiLane++)
+			{
+				lua_rawgeti(L, -2, (int)uiLane + 1);
+				memset(&tLane, 0, sizeof(tLane));
+				if( lua_istable(L, -1) )
+				{
+					led_analyzer_check_lane(L, -1, &tLane);
+				}
+				lua_pop(L, 1);
+				set_record(ptRecord, &tLane, uiLane, uiTested, aucChecks);
+				if( measurement_log_append(ptLog, ptRecord)!=0 )
+				{
+					lua_pop(L, 3);
+					lua_pushstring(L, "failed to write the measurement log");
+					return -1;
+				}
+				iRecords++;
+			}
+		}
+		lua_pop(L, 2);
+	}
+
+	return iRecords;
+}
+
+
+
+/** \brief log:append(tResults, tSummary, uiTime) - appends all lanes of one measurement.
+
+tResults is a result frame or color tables with the serial numbers as keys. tSummary is optional, it is a validation summary
+(see Color_validation:summarizeCoCo) for the pass/fail flags of the lanes. uiTime is optional, it is the time of the
+measurement in microseconds since 1970, the default is now.
+Returns the number of records or nil and an error message.
+ */
+static int measurement_log_lua_append(lua_State* L)
+{
+	MEASUREMENT_LOG_T* ptLog;
+	MEASUREMENT_LOG_RECORD_T tRecord;
+	int iSummary;
+	int iRecords;
+
+
+	ptLog = check_measurement_log(L, 1);
+	if( lua_isnoneornil(L, 3) )
+	{
+		iSummary = 0;
+	}
+	else
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		iSummary = 3;
+	}
+	memset(&tRecord, 0, sizeof(tRecord));
+	tRecord.ullTime = lua_isnumber(L, 4) ? (unsigned long long)lua_tonumber(L, 4) : measurement_log_time();
+	tRecord.ulMeasurement = measurement_log_next_measurement(ptLog);
+
+	if( lua_type(L, 2)==LUA_TSTRING )
+	{
+		iRecords = append_frame(L, ptLog, &tRecord, 2, iSummary);
+	}
+	else if( lua_istable(L, 2) )
+	{
+		iRecords = append_color_tables(L, ptLog, &tRecord, 2, iSummary);
+	}
+	else
+	{
+		return luaL_error(L, "append: expected a result frame or color tables");
+	}
+
+	if( iRecords<0 )
+	{
+		lua_pushnil(L);
+		lua_insert(L, -2);
+		return 2;
+	}
+	lua_pushnumber(L, iRecords);
+	return 1;
+}
+
+
+
+/** \brief log:flush() - writes the buffered records and the index, returns true or nil and an error message. */
+static int measurement_log_lua_flush(lua_State* L)
+{
+	if( measurement_log_flush(check_measurement_log(L, 1))!=0 )
+	{
+		lua_pushnil(L);
+		lua_pushstring(L, "failed to write the measurement log");
+		return 2;
+	}
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+
+
+/** \brief log:close() - closes the log, this is also the garbage collector of the log. */
+static int measurement_log_lua_close(lua_State* L)
+{
+	MEASUREMENT_LOG_T** pptLog;
+	int iResult;
+
+
+	pptLog = (MEASUREMENT_LOG_T**)luaL_checkudata(L, 1, MEASUREMENT_LOG_METATABLE);
+	iResult = 0;
+	if( *pptLog!=NULL )
+	{
+		iResult = measurement_log_close(*pptLog);
+		*pptLog = NULL;
+	}
+	lua_pushboolean(L, iResult==0);
+
+	return 1;
+}
+
+
+
+/** \brief opens a measurement log and pushes it onto the Lua stack.
+
+The log is a userdata with the methods append, flush and close, it is closed by the garbage collector.
+	@param L					Lua state
+	@param pcPrefix				path of the log files without the extension
+	@param ulSegmentRecords		a new segment file is started after this number of records
+
+	@return 					pointer to the log or NULL if it could not be opened, nothing is pushed then
+	*/
+MEASUREMENT_LOG_T* led_analyzer_push_measurement_log(lua_State* L, const char* pcPrefix, unsigned long ulSegmentRecords)
+{
+	MEASUREMENT_LOG_T* ptLog;
+	MEASUREMENT_LOG_T** pptLog;
+
+
+	ptLog = measurement_log_open(pcPrefix, ulSegmentRecords);
+	if( ptLog!=NULL )
+	{
+		pptLog = (MEASUREMENT_LOG_T**)lua_newuserdata(L, sizeof(MEASUREMENT_LOG_T*));
+		*pptLog = ptLog;
+
+		if( luaL_newmetatable(L, MEASUREMENT_LOG_METATABLE)!=0 )
+		{
+			lua_pushvalue(L, -1);
+			lua_setfield(L, -2, "__index");
+			lua_pushcfunction(L, measurement_log_lua_close);
+			lua_setfield(L, -2, "__gc");
+			lua_pushcfunction(L, measurement_log_lua_close);
+			lua_setfield(L, -2, "close");
+			lua_pushcfunction(L, measurement_log_lua_append);
+			lua_setfield(L, -2, "append");
+			lua_pushcfunction(L, measurement_log_lua_flush);
+			lua_setfield(L, -2, "flush");
+		}
+		lua_setmetatable(L, -2);
+	}
+
+	return ptLog;
+}
+
+
+
+/** \brief gets the mapped segment at a stack index. */
+static MEASUREMENT_LOG_SEGMENT_T* check_measurement_segment(lua_State* L, int iIndex)
+{
+	MEASUREMENT_LOG_SEGMENT_T** pptSegment;
+
+
+	pptSegment = (MEASUREMENT_LOG_SEGMENT_T**)luaL_checkudata(L, iIndex, MEASUREMENT_SEGMENT_METATABLE);
+	if( *pptSegment==NULL )
+	{
+		luaL_error(L, "the segment was already closed");
+	}
+
+	return *pptSegment;
+}
+
+
+
+/** \brief segment:count() - returns the number of complete records in the segment. */
+static int measurement_segment_count(lua_State* L)
+{
+	lua_pushnumber(L, check_measurement_segment(L, 1)->ulRecords);
+	return 1;
+}
+
+
+
+/** \brief segment:record(uiRecord) - returns the record with the index uiRecord (starting at 1) or nil.
+
+The record is a table with uiTime, strSerial, uiLane (starting at 1), uiFlags, gain, intTime, clear, red, green, blue, nm,
+sat, lux, uiFailed, iResult and uiMeasurement.
+ */
+static int measurement_segment_record(lua_State* L)
+{
+	MEASUREMENT_LOG_SEGMENT_T* ptSegment;
+	MEASUREMENT_LOG_RECORD_T tRecord;
+	lua_Number dRecord;
+
+
+	ptSegment = check_measurement_segment(L, 1);
+	dRecord = luaL_checknumber(L, 2);
+	if( dRecord<1 || dRecord>ptSegment->ulRecords )
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+	measurement_log_segment_get(ptSegment, (unsigned long)dRecord - 1, &tRecord);
+
+	lua_createtable(L, 0, 16);
+	/* A double holds the microseconds until the year 2255. */
+	set_number(L, "uiTime", (double)tRecord.ullTime);
+	lua_pushstring(L, tRecord.acSerial);
+	lua_setfield(L, -2, "strSerial");
+	set_integer(L, "uiLane", tRecord.ucLane + 1);
+	set_integer(L, "uiFlags", tRecord.ucFlags);
+	set_integer(L, "gain", tRecord.ucGain);
+	set_integer(L, "intTime", tRecord.ucIntegrationtime);
+	set_integer(L, "clear", tRecord.usClear);
+	set_integer(L, "red", tRecord.usRed);
+	set_integer(L, "green", tRecord.usGreen);
+	set_integer(L, "blue", tRecord.usBlue);
+	set_integer(L, "nm", tRecord.usNm);
+	set_number(L, "sat", tRecord.fSat);
+	set_number(L, "lux", tRecord.fLux);
+	set_integer(L, "uiFailed", tRecord.ucChecks);
+	set_integer(L, "iResult", tRecord.iResult);
+	set_number(L, "uiMeasurement", (double)tRecord.ulMeasurement);
+
+	return 1;
+}
+
+
+
+/** \brief segment:find(uiTime) - returns the index (starting at 1) of the first record at or after uiTime.
+
+The records of a segment are in the order of their time. The result is count() + 1 if all records are older.
+ */
+static int measurement_segment_find(lua_State* L)
+{
+	MEASUREMENT_LOG_SEGMENT_T* ptSegment;
+	lua_Number dTime;
+
+
+	ptSegment = check_measurement_segment(L, 1);
+	dTime = luaL_checknumber(L, 2);
+	lua_pushnumber(L, measurement_log_segment_find(ptSegment, (dTime<0) ? 0 : (unsigned long long)dTime) + 1);
+
+	return 1;
+}
+
+
+
+/** \brief segment:close() - unmaps the segment, this is also the garbage collector of the segment. */
+static int measurement_segment_gc(lua_State* L)
+{
+	MEASUREMENT_LOG_SEGMENT_T** pptSegment;
+
+
+	pptSegment = (MEASUREMENT_LOG_SEGMENT_T**)luaL_checkudata(L, 1, MEASUREMENT_SEGMENT_METATABLE);
+	if( *pptSegment!=NULL )
+	{
+		measurement_log_segment_close(*pptSegment);
+		*pptSegment = NULL;
+	}
+
+	return 0;
+}
+
+
+
+/** \brief maps a segment of a measurement log and pushes it onto the Lua stack.
+
+The segment is a userdata with the methods count, record, find and close, it is closed by the garbage collector.
+	@param L		Lua state
+	@param pcPath	path of the segment file
+
+	@return 		pointer to the segment or NULL if it could not be mapped, nothing is pushed then
+	*/
+MEASUREMENT_LOG_SEGMENT_T* led_analyzer_push_measurement_segment(lua_State* L, const char* pcPath)
+{
+	MEASUREMENT_LOG_SEGMENT_T* ptSegment;
+	MEASUREMENT_LOG_SEGMENT_T** pptSegment;
+
+
+	ptSegment = measurement_log_segment_open(pcPath);
+	if( ptSegment!=NULL )
+	{
+		pptSegment = (MEASUREMENT_LOG_SEGMENT_T**)lua_newuserdata(L, sizeof(MEASUREMENT_LOG_SEGMENT_T*));
+		*pptSegment = ptSegment;
+
+		if( luaL_newmetatable(L, MEASUREMENT_SEGMENT_METATABLE)!=0 )
+		{
+			lua_pushvalue(L, -1);
+			lua_setfield(L, -2, "__index");
+			lua_pushcfunction(L, measurement_segment_gc);
+			lua_setfield(L, -2, "__gc");
+			lua_pushcfunction(L, measurement_segment_gc);
+			lua_setfield(L, -2, "close");
+			lua_pushcfunction(L, measurement_segment_count);
+			lua_setfield(L, -2, "count");
+			lua_pushcfunction(L, measurement_segment_record);
+			lua_setfield(L, -2, "record");
+			lua_pushcfunction(L, measurement_segment_find);
+			lua_setfield(L, -2, "find");
+		}
+		lua_setmetatable(L, -2);
+	}
+
+	return ptSegment;
+}
+
+
+
+/** \brief reads the index of a measurement log and pushes it onto the Lua stack.
+
+The index is a list with one entry for each serial number in each segment: uiSegment, strSerial, uiFirst and uiLast
+(records in the segment, starting at 1), uiRecords, uiFirstTime and uiLastTime. A log without an index file has an empty list.
+	@param L			Lua state
+	@param pcPrefix		path of the log files without the extension
+
+	@retval 0			the index was pushed
+	@retval -1			the index is damaged, nothing is pushed
+	@retval -2			no memory could be allocated, nothing is pushed
+	*/
+int led_analyzer_push_measurement_index(lua_State* L, const char* pcPrefix)
+{
+	MEASUREMENT_LOG_INDEX_T* ptIndex;
+	unsigned int uiEntries;
+	unsigned int uiEntry;
+	int iResult;
+
+
+	iResult = measurement_log_read_index(pcPrefix, &ptIndex, &uiEntries);
+	if( iResult==0 )
+	{
+		lua_createtable(L, (int)uiEntries, 0);
+		for(uiEntry=0; uiEntry<uiEntries; uiEntry++)
+		{
+			lua_createtable(L, 0, 7);
+			set_number(L, "uiSegment", (double)ptIndex[uiEntry].ulSegment);
+			lua_pushstring(L, ptIndex[uiEntry].acSerial);
+			lua_setfield(L, -2, "strSerial");
+			set_number(L, "uiFirst", (double)ptIndex[uiEntry].ulFirst + 1);
+			set_number(L, "uiLast", (double)ptIndex[uiEntry].ulLast + 1);
+			set_number(L, "uiRecords", (double)ptIndex[uiEntry].ulRecords);
+			set_number(L, "uiFirstTime", (double)ptIndex[uiEntry].ullFirstTime);
+			set_number(L, "uiLastTime", (double)ptIndex[uiEntry].ullLastTime);
+			lua_rawseti(L, -2, (int)uiEntry + 1);
+		}
+		free(ptIndex);
+	}
+
+	return iResult;
+}
+
+
+
+/*-------------------------------------------------------------------------*/
+/* Dark offsets                                                            */
+/*-------------------------------------------------------------------------*/
+
+/** \brief gets the dark offsets at a stack index. */
+static DARK_OFFSET_T* check_dark_offset(lua_State* L, int iIndex)
+{
+	DARK_OFFSET_T** pptOffsets;
+
+
+	pptOffsets = (DARK_OFFSET_T**)luaL_checkudata(L, iIndex, DARK_OFFSET_METATABLE);
+	if( *pptOffsets==NULL )
+	{
+		luaL_error(L, "the dark offsets were already freed");
+	}
+
+	return *pptOffsets;
+}
+
+
+
+/** \brief gets the dark offsets at a stack index, raises an error if it is no dark offset userdata. */
+DARK_OFFSET_T* led_analyzer_check_dark_offset(lua_State* L, int iIndex)
+{
+	return check_dark_offset(L, iIndex);
+}
+
+
+
+/** \brief gets a gain and an integration time from the stack, raises an error for an invalid gain. */
+static void check_setting(lua_State* L, int iIndex, unsigned char* pucGain, unsigned char* pucIntegrationtime)
+{
+	lua_Number dGain;
+	lua_Number dIntegrationtime;
+
+
+	dGain = luaL_checknumber(L, iIndex);
+	dIntegrationtime = luaL_checknumber(L, iIndex + 1);
+	if( dGain<0 || dGain>=DARK_OFFSET_GAINS )
+	{
+		luaL_error(L, "invalid gain: %d", (int)dGain);
+	}
+	if( dIntegrationtime<0 || dIntegrationtime>255 )
+	{
+		luaL_error(L, "invalid integration time: %d", (int)dIntegrationtime);
+	}
+	*pucGain = (unsigned char)dGain;
+	*pucIntegrationtime = (unsigned char)dIntegrationtime;
+}
+
+
+
+/** \brief offsets:set(uiGain, uiIntegrationtime, auiOffsets) - sets the offsets of one gain and integration time.
+
+auiOffsets is a list of 64 offsets: 1-16 are the clear offsets of sensor 1-16, 17-32 red, 33-48 green and 49-64 blue.
+Returns true or nil and an error message if all DARK_OFFSET_MAX_SETTINGS entries are used.
+ */
+static int dark_offset_lua_set(lua_State* L)
+{
+	DARK_OFFSET_T* ptOffsets;
+	unsigned char ucGain;
+	unsigned char ucIntegrationtime;
+	unsigned short ausOffsets[64];
+	lua_Number dOffset;
+	int i;
+
+
+	ptOffsets = check_dark_offset(L, 1);
+	check_setting(L, 2, &ucGain, &ucIntegrationtime);
+	luaL_checktype(L, 4, LUA_TTABLE);
+	for(i=0; i<64; i++)
+	{
+		lua_rawgeti(L, 4, i + 1);
+		dOffset = lua_tonumber(L, -1);
+		lua_pop(L, 1);
+		ausOffsets[i] = (dOffset<=0) ? 0 : (dOffset>=65535) ? 65535 : (unsigned short)(dOffset + 0.5);
+	}
+
+	if( dark_offset_set(ptOffsets, ucGain, ucIntegrationtime, ausOffsets)!=0 )
+	{
+		lua_pushnil(L);
+		lua_pushfstring(L, "no more than %d settings can be calibrated", DARK_OFFSET_MAX_SETTINGS);
+		return 2;
+	}
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+
+
+/** \brief offsets:get(uiGain, uiIntegrationtime) - returns the list of 64 offsets or nil if the setting is not calibrated. */
+static int dark_offset_lua_get(lua_State* L)
+{
+	DARK_OFFSET_T* ptOffsets;
+	const unsigned short* ausOffsets;
+	unsigned char ucGain;
+	unsigned char ucIntegrationtime;
+	int i;
+
+
+	ptOffsets = check_dark_offset(L, 1);
+	check_setting(L, 2, &ucGain, &ucIntegrationtime);
+	ausOffsets = dark_offset_get(ptOffsets, ucGain, ucIntegrationtime);
+	if( ausOffsets==NULL )
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_createtable(L, 64, 0);
+	for(i=0; i<64; i++)
+	{
+		lua_pushnumber(L, ausOffsets[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 1;
+}
+
+
+
+/** \brief offsets:settings() - returns the list of the calibrated settings, each one is a table with gain and integration. */
+static int dark_offset_lua_settings(lua_State* L)
+{
+	DARK_OFFSET_T* ptOffsets;
+	unsigned int uiGain;
+	unsigned int uiIntegrationtime;
+	int iSettings;
+
+
+	ptOffsets = check_dark_offset(L, 1);
+	lua_createtable(L, (int)ptOffsets->uiSettings, 0);
+	iSettings = 0;
+	for(uiGain=0; uiGain<DARK_OFFSET_GAINS; uiGain++)
+	{
+		for(uiIntegrationtime=0; uiIntegrationtime<256; uiIntegrationtime++)
+		{
+			if( ptOffsets->aucIndex[uiGain][uiIntegrationtime]!=0 )
+			{
+				lua_createtable(L, 0, 2);
+				set_integer(L, "gain", (long)uiGain);
+				set_integer(L, "integration", (long)uiIntegrationtime);
+				iSettings++;
+				lua_rawseti(L, -2, iSettings);
+			}
+		}
+	}
+	return 1;
+}
+
+
+
+/** \brief offsets:free() - frees the offsets, this is also the garbage collector of the offsets. */
+static int dark_offset_gc(lua_State* L)
+{
+	DARK_OFFSET_T** pptOffsets;
+
+
+	pptOffsets = (DARK_OFFSET_T**)luaL_checkudata(L, 1, DARK_OFFSET_METATABLE);
+	dark_offset_free(*pptOffsets);
+	*pptOffsets = NULL;
+
+	return 0;
+}
+
+
+
+/** \brief pushes new dark offsets without any calibrated settings onto the Lua stack.
+
+The offsets are a userdata with the methods set, get, settings and free, they are freed by the garbage collector.
+	@param L			Lua state
+
+	@return 			pointer to the offsets or NULL if no memory could be allocated, nothing is pushed then
+	*/
+DARK_OFFSET_T* led_analyzer_push_dark_offset(lua_State* L)
+{
+	DARK_OFFSET_T* ptOffsets;
+	DARK_OFFSET_T** pptOffsets;
+
+
+	ptOffsets = dark_offset_new();
+	if( ptOffsets!=NULL )
+	{
+		pptOffsets = (DARK_OFFSET_T**)lua_newuserdata(L, sizeof(DARK_OFFSET_T*));
+		*pptOffsets = ptOffsets;
+
+		if( luaL_newmetatable(L, DARK_OFFSET_METATABLE)!=0 )
+		{
+			lua_pushvalue(L, -1);
+			lua_setfield(L, -2, "__index");
+			lua_pushcfunction(L, dark_offset_gc);
+			lua_setfield(L, -2, "__gc");
+			lua_pushcfunction(L, dark_offset_gc);
+			lua_setfield(L, -2, "free");
+			lua_pushcfunction(L, dark_offset_lua_set);
+			lua_setfield(L, -2, "set");
+			lua_pushcfunction(L, dark_offset_lua_get);
+			lua_setfield(L, -2, "get");
+			lua_pushcfunction(L, dark_offset_lua_settings);
+			lua_setfield(L, -2, "settings");
+		}
+		lua_setmetatable(L, -2);
+	}
+
+	return ptOffsets;
+}
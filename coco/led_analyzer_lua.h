@@ -0,0 +1,100 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+/** \file led_analyzer_lua.h
+
+	 \brief Lua specific functions of the led_analyzer (header)
+
+led_analyzer_lua contains the functions which build Lua tables and userdata directly in C. They are used by the native functions in
+led_analyzer.i, which unpack the SWIG arrays and pass them on as plain C pointers.
+
+ */
+
+#ifndef __LED_ANALYZER_LUA_H__
+#define __LED_ANALYZER_LUA_H__
+
+#include "lua.h"
+#include "color_conversions.h"
+#include "sample_buffer.h"
+#include "async_measurement.h"
+#include "result_frame.h"
+#include "test_plan.h"
+#include "measurement_log.h"
+#include "dark_offset.h"
+
+/** \brief element types of views on C arrays */
+typedef enum LED_ANALYZER_VIEW_TYPE_ENUM
+{
+	LED_ANALYZER_VIEW_USHORT = 0,
+	LED_ANALYZER_VIEW_UCHAR  = 1,
+	LED_ANALYZER_VIEW_INT    = 2,
+	LED_ANALYZER_VIEW_UINT   = 3,
+	LED_ANALYZER_VIEW_FLOAT  = 4,
+	LED_ANALYZER_VIEW_DOUBLE = 5
+} LED_ANALYZER_VIEW_TYPE_T;
+
+void led_analyzer_push_colorTable(lua_State* L, const COLOR_SPACES_T* ptColorSpaces, unsigned int uiFirstLane, unsigned int uiLanes,
+                                  const unsigned short* ausClear, const unsigned short* ausRed,
+                                  const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                  const unsigned char* aucIntegrationtime, const unsigned char* aucGain);
+
+void led_analyzer_push_readings(lua_State* L, char** asSerials, int iDevices,
+                                const unsigned short* ausClear, const unsigned short* ausRed,
+                                const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                const unsigned char* aucIntegrationtime, const unsigned char* aucGain, const int* aiResults);
+
+void led_analyzer_push_colorTables(lua_State* L, char** asSerials, int iDevices, const COLOR_SPACES_T* ptColorSpaces,
+                                   const unsigned short* ausClear, const unsigned short* ausRed,
+                                   const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                   const unsigned char* aucIntegrationtime, const unsigned char* aucGain);
+
+void led_analyzer_push_results(lua_State* L, char** asSerials, int iDevices, const int* aiResults);
+void led_analyzer_push_statistics(lua_State* L, const float* afMean, const float* afVariance, const unsigned short* ausMin,
+                                  const unsigned short* ausMax, const unsigned short* ausMedian);
+
+void             led_analyzer_push_view(lua_State* L, const void* pvData, unsigned int uiLength, LED_ANALYZER_VIEW_TYPE_T tType, int iOwner);
+SAMPLE_BUFFER_T* led_analyzer_push_sample_buffer(lua_State* L, unsigned int uiDevices);
+SAMPLE_BUFFER_T* led_analyzer_check_sample_buffer(lua_State* L, int iIndex);
+
+ASYNC_MEASUREMENT_T* led_analyzer_push_async (lua_State* L);
+int                  led_analyzer_start_async(lua_State* L, void** apHandles);
+
+void led_analyzer_check_lane        (lua_State* L, int iIndex, RESULT_FRAME_LANE_T* ptLane);
+void led_analyzer_push_lane         (lua_State* L, const RESULT_FRAME_LANE_T* ptLane, unsigned char ucFlags);
+int  led_analyzer_push_result_frame (lua_State* L, int iColorTables, int iResults, unsigned char ucFlags);
+int  led_analyzer_push_decoded_frame(lua_State* L, const unsigned char* pucFrame, unsigned int uiSize);
+
+TEST_PLAN_T* led_analyzer_push_test_plan (lua_State* L, unsigned int uiSteps, unsigned int uiDevices);
+TEST_PLAN_T* led_analyzer_check_test_plan(lua_State* L, int iIndex);
+void         led_analyzer_push_validation(lua_State* L, const TEST_PLAN_T* ptPlan, unsigned int uiStep, char** asSerials, int iDevices,
+                                          const COLOR_SPACES_T* ptColorSpaces, int iPlanDevices, int fLuxCheck, int fAllValues);
+
+TEST_PLAN_SEQUENTIAL_T* led_analyzer_push_sequential_test(lua_State* L, unsigned int uiDevices);
+
+MEASUREMENT_LOG_T*         led_analyzer_push_measurement_log    (lua_State* L, const char* pcPrefix, unsigned long ulSegmentRecords);
+MEASUREMENT_LOG_SEGMENT_T* led_analyzer_push_measurement_segment(lua_State* L, const char* pcPath);
+int                        led_analyzer_push_measurement_index  (lua_State* L, const char* pcPrefix);
+
+DARK_OFFSET_T* led_analyzer_push_dark_offset (lua_State* L);
+DARK_OFFSET_T* led_analyzer_check_dark_offset(lua_State* L, int iIndex);
+
+#endif	/* __LED_ANALYZER_LUA_H__ */
@@ -3,7 +3,8 @@ local class = require "pl.class"
 local CoCo_Client = class()
 
 --- init CoCo_Client
-function CoCo_Client:_init(host, port)
+-- strResultFormat selects the format of the results sent by the server: "binary" (default) or "json"
+function CoCo_Client:_init(host, port, strResultFormat)
 	local tLogWriter = require "log.writer.filter".new("info", require "log.writer.console.color".new())
 
 	host = host or "127.0.0.1"
@@ -11,6 +12,7 @@ function CoCo_Client:_init(host, port)
 
 	self.host = host
 	self.port = port
+	self.strResultFormat = strResultFormat or "binary"
 
 	-- local strLogDir = ".logs"
 	-- local strLogFilename = ".log_Data.log"
@@ -42,21 +44,520 @@ function CoCo_Client:_init(host, port)
 
 	self.json = require "dkjson"
 	-- self.lunajson = require "lunajson"
+	self.result_frame = require("result_frame")()
+	self.protocol = require("coco_protocol")()
+
+	-- the connection is kept open for the next requests
+	self.tcp = nil
+	self.uiSequence = 0
+	-- older servers answer only one plain JSON request per connection
+	self.fLegacyServer = false
 
 	self.color_validation = require("color_validation")()
 
+	-- the optional binary log of all measured lanes, see setMeasurementLog
+	self.tMeasurementLog = nil
+
 	self.tLog = tLog
 end
 
-function CoCo_Client:run(strFilenameResults, strFilenameTestSummary, tData, tTestSet, lux_check_enable)
-	local pl = self.pl
-	local socket = self.socket
+--- logs the results of run() in a binary measurement log, see measurement_log.lua
+-- This needs the led_analyzer module, a client without it can not write the log.
+-- strPrefix is the path of the log files without the extension, uiSegmentRecords is optional.
+-- returns true or nil and an error message
+function CoCo_Client:setMeasurementLog(strPrefix, uiSegmentRecords)
+	if self.tMeasurementLog ~= nil then
+		self.tMeasurementLog:close()
+		self.tMeasurementLog = nil
+	end
+	if strPrefix ~= nil then
+		local tMeasurementLog = require("measurement_log")(strPrefix, uiSegmentRecords)
+		local fOk, strError = tMeasurementLog:open()
+		if fOk ~= true then
+			return nil, strError
+		end
+		self.tMeasurementLog = tMeasurementLog
+	end
+	return true
+end
+
+--- connect to the server, an open connection is used again
+-- returns the socket or nil and an error message
+function CoCo_Client:connect()
+	if self.tcp ~= nil then
+		return self.tcp
+	end
+
 	local host = self.host
 	local port = self.port
+	local iResult
+
+	local tcp, err_msg = self.socket.tcp()
+	if tcp == nil then
+		return nil, string.format("Creating TCP master object failed. Error Message: %s", err_msg)
+	end
+
+	tcp:settimeout(10)
+
+	iResult, err_msg = tcp:connect(host, port)
+	if iResult ~= 1 then
+		tcp:close()
+		return nil, string.format("Connecting to %s:%d failed. Error Message: %s", host, port, err_msg)
+	end
+
+	self.tcp = tcp
+	return tcp
+end
+
+--- close the connection to the server
+function CoCo_Client:close()
+	if self.tcp ~= nil then
+		self.tcp:close()
+		self.tcp = nil
+	end
+end
+
+-- returns the request for the settings tData, without changing the settings of the caller
+function CoCo_Client:getRequest(tData)
+	local tRequest = {}
+	for strKey, tValue in pairs(tData) do
+		tRequest[strKey] = tValue
+	end
+	if tRequest.strResultFormat == nil then
+		tRequest.strResultFormat = self.strResultFormat
+	end
+
+	return self.json.encode(tRequest, {indent = true})
+end
+
+-- decodes the results of the server, binary result frames or JSON from older servers and clients
+function CoCo_Client:decodeResults(strResults)
+	local tMeasurement, pos, err_msg
+	if self.result_frame:isFrame(strResults) then
+		tMeasurement, err_msg = self.result_frame:decode(strResults)
+	else
+		tMeasurement, pos, err_msg = self.json.decode(strResults, 1, nil)
+	end
+	if tMeasurement == nil then
+		return nil, string.format("Failed to decode the CoCo results: %s", tostring(err_msg))
+	end
+	return tMeasurement
+end
+
+--- measure with several settings
+-- All requests are sent at once on the same connection, the server answers them in the same order.
+-- returns a list with the results of each request and a list with the error messages of the failed requests, or
+-- nil and an error message if the transmission failed
+function CoCo_Client:measure(atData)
+	local tProtocol = self.protocol
 	local tLog = self.tLog
-	local json = self.json
-	local color_validation = self.color_validation
+
+	if self.fLegacyServer == true then
+		return self:measureLegacy(atData)
+	end
+
+	local tcp, err_msg = self:connect()
+	if tcp == nil then
+		tLog.error(err_msg)
+		return nil, err_msg
+	end
+
+	local auiSequences = {}
+	local astrRequests = {}
+	for uiIndex, tData in ipairs(atData) do
+		self.uiSequence = (self.uiSequence + 1) % 65536
+		auiSequences[uiIndex] = self.uiSequence
+		astrRequests[uiIndex] = tProtocol:encodeRequest(self:getRequest(tData), self.uiSequence)
+	end
+
+	local iResult
+	iResult, err_msg = tcp:send(table.concat(astrRequests))
+	if iResult == nil then
+		err_msg = string.format("Sending data to %s:%d failed. Error Message: %s", self.host, self.port, err_msg)
+		tLog.error(err_msg)
+		self:close()
+		return nil, err_msg
+	end
+
+	local atMeasurements = {}
+	local astrErrors = {}
+	for uiIndex = 1, #atData do
+		local strHeader, partial
+		strHeader, err_msg, partial = tcp:receive(tProtocol.COCO_PROTOCOL_HEADER_SIZE)
+		strHeader = strHeader or partial or ""
+
+		if uiIndex == 1 and tProtocol:isFrame(strHeader) == false then
+			-- an older server did not understand the frame, it answered with a line and closed the connection
+			tLog.info("The server does not support frames, using one connection per request.")
+			self:close()
+			self.fLegacyServer = true
+			return self:measureLegacy(atData)
+		end
+
+		local tHeader
+		tHeader, err_msg = tProtocol:decodeHeader(strHeader)
+		local strPayload
+		if tHeader ~= nil then
+			strPayload, err_msg = tcp:receive(tHeader.uiSize)
+		end
+		if strPayload == nil then
+			err_msg = string.format("Transmission to %s:%d failed. Error Message: %s", self.host, self.port, err_msg)
+			tLog.error(err_msg)
+			self:close()
+			return nil, err_msg
+		end
+		if tHeader.uiSequence ~= auiSequences[uiIndex] then
+			err_msg = string.format("Received the results of request %d instead of %d", tHeader.uiSequence, auiSequences[uiIndex])
+			tLog.error(err_msg)
+			self:close()
+			return nil, err_msg
+		end
+
+		if tHeader.uiStatus ~= 0 then
+			astrErrors[uiIndex] = string.format("CoCo measurement error %d: %s", tHeader.uiStatus, strPayload)
+		else
+			tLog.info("CoCo measurement OK")
+			atMeasurements[uiIndex], astrErrors[uiIndex] = self:decodeResults(strPayload)
+		end
+	end
+
+	return atMeasurements, astrErrors
+end
+
+--- measure within a deadline
+-- The server plans the gain and integration time of each lane and the number of samples, so the measurement takes at
+-- most uiDeadline ms and each lane gets uiMinCounts clear counts over all samples if the deadline allows it. The plan
+-- uses the previous measurement of the same lanes on the server. The other settings of tData are the same as in measure,
+-- e.g. asSerials, atSettings for the first measurement and tTestSet or strTestPlan for the validation.
+-- returns the results like one request of measure or nil and an error message
+function CoCo_Client:measureWithin(tData, uiDeadline, uiMinCounts)
+	local tRequest = {}
+	for strKey, tValue in pairs(tData) do
+		tRequest[strKey] = tValue
+	end
+	tRequest.tDeadline = {uiDeadline = uiDeadline, uiMinCounts = uiMinCounts}
+
+	local atMeasurements, astrErrors = self:measure({tRequest})
+	if atMeasurements == nil then
+		return nil, astrErrors
+	end
+	if atMeasurements[1] == nil then
+		return nil, astrErrors[1]
+	end
+	return atMeasurements[1]
+end
+
+--- measure and validate on the server
+-- The server compares the measurement with tTestSet (the test sets of the devices with their serial numbers as keys)
+-- and returns only a summary, see Color_validation:summarizeCoCo. The values of the lanes which passed are left out
+-- unless fAllValues is true. An older server sends the color tables, they are validated here.
+-- returns the summary or nil and an error message
+function CoCo_Client:validate(tData, tTestSet, lux_check_enable, fAllValues)
+	local tRequest = {}
+	for strKey, tValue in pairs(tData) do
+		tRequest[strKey] = tValue
+	end
+	tRequest.tTestSet = tTestSet
+	tRequest.fLuxCheck = lux_check_enable
+	tRequest.fAllValues = fAllValues
+
+	local atMeasurements, astrErrors = self:measure({tRequest})
+	if atMeasurements == nil then
+		return nil, astrErrors
+	end
+	local tMeasurement = atMeasurements[1]
+	if tMeasurement == nil then
+		return nil, astrErrors[1]
+	end
+
+	if tMeasurement.tSummary ~= nil then
+		return tMeasurement.tSummary
+	end
+	return self.color_validation:summarizeCoCo(tMeasurement, tTestSet, lux_check_enable, fAllValues)
+end
+
+--- measure and validate against one step of a test plan on the server
+-- strTestPlan is the content of an INI file or a generated test script (see lua/test_plan.lua), the server compiles
+-- it once and keeps it as long as the same content is sent. uiTestStep starts at 1.
+-- With tData.tSequential = { uiMaxSamples, uiMinSamples, dZ } the server samples the devices until the result of every
+-- tested lane is certain and validates the mean (see Color_control:startMeasurementsSequential).
+-- returns the summary like validate and the number of samples of a sequential measurement or nil and an error message
+function CoCo_Client:validatePlan(tData, strTestPlan, uiTestStep, lux_check_enable, fAllValues)
+	local tRequest = {}
+	for strKey, tValue in pairs(tData) do
+		tRequest[strKey] = tValue
+	end
+	tRequest.strTestPlan = strTestPlan
+	tRequest.uiTestStep = uiTestStep
+	tRequest.fLuxCheck = lux_check_enable
+	tRequest.fAllValues = fAllValues
+
+	local atMeasurements, astrErrors = self:measure({tRequest})
+	if atMeasurements == nil then
+		return nil, astrErrors
+	end
+	local tMeasurement = atMeasurements[1]
+	if tMeasurement == nil then
+		return nil, astrErrors[1]
+	end
+	if tMeasurement.tSummary == nil then
+		return nil, "The server does not support test plans"
+	end
+	return tMeasurement.tSummary, tMeasurement.uiSamples
+end
+
+--- measure the dark offsets of the devices on the server, all LEDs in front of the sensors must be off
+-- atSettings is the list of the settings to calibrate: { gain = , integration = }. The server saves the offsets per
+-- serial number and subtracts them from the readings of all following measurements with these settings.
+-- tData selects the devices with asSerials like a measurement, uiSamples is the number of averaged conversions.
+-- returns the offsets with the serial numbers as keys (see lua/dark_offset.lua) or nil and an error message
+function CoCo_Client:calibrateDark(tData, atSettings, uiSamples)
+	local tRequest = {}
+	for strKey, tValue in pairs(tData) do
+		tRequest[strKey] = tValue
+	end
+	tRequest.tDarkCalibration = {atSettings = atSettings, uiSamples = uiSamples}
+
+	local atMeasurements, astrErrors = self:measure({tRequest})
+	if atMeasurements == nil then
+		return nil, astrErrors
+	end
+	local tMeasurement = atMeasurements[1]
+	if tMeasurement == nil then
+		return nil, astrErrors[1]
+	end
+	if tMeasurement.atDarkOffsets == nil then
+		return nil, "The server does not support the dark calibration"
+	end
+	return tMeasurement.atDarkOffsets
+end
+
+-- sends a frame of the type uiType which the server answers without a worker, e.g. a status frame
+-- returns the decoded JSON of the response or nil and an error message, strName is the answer for the messages
+function CoCo_Client:queryServer(uiType, strPayload, strName)
+	local tProtocol = self.protocol
+
+	local tcp, err_msg = self:connect()
+	if tcp == nil then
+		return nil, err_msg
+	end
+
+	self.uiSequence = (self.uiSequence + 1) % 65536
+	local iResult
+	iResult, err_msg = tcp:send(tProtocol:encode(uiType, strPayload, 0, self.uiSequence))
+	if iResult == nil then
+		self:close()
+		return nil, string.format("Sending data to %s:%d failed. Error Message: %s", self.host, self.port, err_msg)
+	end
+	local tFrame
+	tFrame, err_msg = self:receiveFrame()
+	if tFrame == nil then
+		return nil, err_msg
+	end
+	if tFrame.uiStatus ~= 0 or tFrame.uiSequence ~= self.uiSequence then
+		return nil, string.format("The server did not send its %s: %s", strName, tFrame.strPayload)
+	end
+
+	local tAnswer, pos
+	tAnswer, pos, err_msg = self.json.decode(tFrame.strPayload, 1, nil)
+	if tAnswer == nil then
+		return nil, string.format("Failed to decode the %s: %s", strName, tostring(err_msg))
+	end
+	return tAnswer
+end
+
+--- ask the server for its load, the server answers without waiting for a measurement
+-- returns a table with uiQueued, uiRunning and uiWorkers or nil and an error message
+function CoCo_Client:status()
+	return self:queryServer(self.protocol.COCO_PROTOCOL_TYPE_STATUS, "", "status")
+end
+
+--- ask the server for the running statistics of the lanes over all measured DUTs, see coco_statistics.lua
+-- strSerial selects one device, nil returns all devices
+-- returns the statistics with the serial numbers and the lane numbers as keys or nil and an error message
+function CoCo_Client:statistics(strSerial)
+	local strPayload = ""
+	if strSerial ~= nil then
+		strPayload = self.json.encode({strSerial = strSerial})
+	end
+	return self:queryServer(self.protocol.COCO_PROTOCOL_TYPE_STATISTICS, strPayload, "statistics")
+end
+
+-- receives the next frame, returns the header with the payload in strPayload or nil and an error message
+function CoCo_Client:receiveFrame()
+	local tProtocol = self.protocol
+	local tcp = self.tcp
+
+	local strHeader, err_msg = tcp:receive(tProtocol.COCO_PROTOCOL_HEADER_SIZE)
+	local tHeader
+	if strHeader ~= nil then
+		tHeader, err_msg = tProtocol:decodeHeader(strHeader)
+	end
+	if tHeader ~= nil then
+		tHeader.strPayload, err_msg = tcp:receive(tHeader.uiSize)
+		if tHeader.strPayload ~= nil then
+			return tHeader
+		end
+	end
+	self:close()
+	return nil, string.format("Transmission to %s:%d failed. Error Message: %s", self.host, self.port, tostring(err_msg))
+end
+
+--- subscribe to the measurements with the settings tData
+-- The server measures every uiInterval ms and sends the results of the lanes in auiLanes (a list of lane numbers, nil
+-- for all lanes). The lanes of each device are in the order of auiLanes.
+-- fnSample(tColorTables, tResults) is called for every sample or fnSample(nil, error message) for a failed
+-- measurement. The subscription ends when fnSample returns false.
+-- returns true or nil and an error message
+function CoCo_Client:subscribe(tData, uiInterval, auiLanes, fnSample)
+	local tProtocol = self.protocol
+
+	local tcp, err_msg = self:connect()
+	if tcp == nil then
+		return nil, err_msg
+	end
+
+	local tRequest = {}
+	for strKey, tValue in pairs(tData) do
+		tRequest[strKey] = tValue
+	end
+	tRequest.uiInterval = uiInterval
+	tRequest.auiLanes = auiLanes
+
+	self.uiSequence = (self.uiSequence + 1) % 65536
+	local uiSubscription = self.uiSequence
+	local iResult
+	iResult, err_msg = tcp:send(
+		tProtocol:encode(tProtocol.COCO_PROTOCOL_TYPE_SUBSCRIBE, self.json.encode(tRequest), 0, uiSubscription)
+	)
+	if iResult == nil then
+		self:close()
+		return nil, string.format("Sending data to %s:%d failed. Error Message: %s", self.host, self.port, err_msg)
+	end
+
+	local fSubscribed = true
+	while true do
+		local tFrame
+		tFrame, err_msg = self:receiveFrame()
+		if tFrame == nil then
+			return nil, err_msg
+		end
+
+		if tFrame.uiSequence ~= uiSubscription then
+			self:close()
+			return nil, string.format("Received a frame for request %d instead of %d", tFrame.uiSequence, uiSubscription)
+		elseif tFrame.uiType == tProtocol.COCO_PROTOCOL_TYPE_RESPONSE then
+			if tFrame.uiStatus ~= 0 then
+				return nil, string.format("The server refused the subscription: %s", tFrame.strPayload)
+			elseif fSubscribed ~= true then
+				-- the answer to the unsubscribe frame, no samples follow
+				return true
+			end
+		elseif tFrame.uiType == tProtocol.COCO_PROTOCOL_TYPE_SAMPLE and fSubscribed == true then
+			local tColorTables, tResults
+			if tFrame.uiStatus ~= 0 then
+				tColorTables, tResults = nil, string.format("CoCo measurement error %d: %s", tFrame.uiStatus, tFrame.strPayload)
+			else
+				tColorTables, tResults = self:decodeResults(tFrame.strPayload)
+			end
+			if fnSample(tColorTables, tResults) == false then
+				fSubscribed = false
+				iResult, err_msg =
+					tcp:send(tProtocol:encode(tProtocol.COCO_PROTOCOL_TYPE_UNSUBSCRIBE, "", 0, uiSubscription))
+				if iResult == nil then
+					self:close()
+					return nil, string.format("Sending data to %s:%d failed. Error Message: %s", self.host, self.port, err_msg)
+				end
+			end
+		end
+	end
+end
+
+--- measure with an older server which expects one plain JSON request per connection
+function CoCo_Client:measureLegacy(atData)
+	local atMeasurements = {}
+	local astrErrors = {}
+	for uiIndex, tData in ipairs(atData) do
+		local tMeasurement, strError = self:requestLegacy(tData)
+		if tMeasurement == nil and strError == nil then
+			return nil, "the transmission failed"
+		end
+		atMeasurements[uiIndex] = tMeasurement
+		astrErrors[uiIndex] = strError
+	end
+	return atMeasurements, astrErrors
+end
+
+-- sends one request to an older server
+-- returns the results, nil and an error message if the measurement failed or nil if the transmission failed
+function CoCo_Client:requestLegacy(tData)
+	local host = self.host
+	local port = self.port
+	local tLog = self.tLog
+
+	local tcp, err_msg = self:connect()
+	if tcp == nil then
+		tLog.error(err_msg)
+		return nil
+	end
+	-- the server closes the connection after the results
+	self.tcp = nil
+
 	local iResult
+	iResult, err_msg = tcp:send(self:getRequest(tData))
+	if iResult == nil then
+		tLog.error("Sending data to %s:%d failed. Error Message: %s", host, port, err_msg)
+		tcp:close()
+		return nil
+	end
+
+	-- one line for the transmission, the decoding and the measurement
+	local astrSteps = {"data transmission error", "data decoding error", "CoCo measurement error"}
+	local msg
+	for uiStep = 1, 3 do
+		msg, err_msg = tcp:receive()
+		if msg == nil then
+			tLog.error("Transmission to %s:%d failed. Error Message: %s", host, port, err_msg)
+			tcp:close()
+			return nil
+		end
+		if tonumber(msg) ~= 0 then
+			tLog.error(astrSteps[uiStep])
+			if uiStep < 3 then
+				tcp:close()
+				return nil
+			end
+			-- CoCo measurement error message
+			msg, err_msg = tcp:receive()
+			tcp:close()
+			if msg == nil then
+				tLog.error("Transmission to %s:%d failed. Error Message: %s", host, port, err_msg)
+				return nil
+			end
+			return nil, msg
+		end
+	end
+
+	-- binary results start with the size of the frame, older servers always send JSON
+	local strResults
+	strResults, err_msg = tcp:receive()
+	local uiFrameSize = tonumber(strResults)
+	if uiFrameSize ~= nil then
+		strResults, err_msg = tcp:receive(uiFrameSize)
+	end
+	tcp:close()
+	if strResults == nil then
+		tLog.error("Transmission to %s:%d failed. Error Message: %s", host, port, err_msg)
+		return nil
+	end
+
+	return self:decodeResults(strResults)
+end
+
+function CoCo_Client:run(strFilenameResults, strFilenameTestSummary, tData, tTestSet, lux_check_enable)
+	local pl = self.pl
+	local tLog = self.tLog
+	local color_validation = self.color_validation
 
 	-- in the case tData is a filename of a json file instead of a table
 	if tData == nil then
@@ -102,96 +603,16 @@ function CoCo_Client:run(strFilenameResults, strFilenameTestSummary, tData, tTes
 		end
 	end
 
-	local tcp, err_msg = socket.tcp()
-	if tcp == nil then
-		tLog.error("Creating TCP master object failed. Error Message: %s", err_msg)
+	local atMeasurements, astrErrors = self:measure({tData})
+	if atMeasurements == nil then
 		return -1
 	end
-
-	tcp:settimeout(10)
-
-	iResult, err_msg = tcp:connect(host, port)
-	if iResult ~= 1 then
-		tLog.error("Connecting to %s:%d failed. Error Message: %s", host, port, err_msg)
-		tcp:close()
-		return -1
-	end
-
-	local tData_encoded = self.json.encode(tData, {indent = true})
-	iResult, err_msg = tcp:send(tData_encoded)
-	if iResult == nil then
-		tLog.error("Sending data to %s:%d failed. Error Message: %s", host, port, err_msg)
-		tcp:close()
-		return -1
-	end
-
-	-- transmission tData
-	local msg, partial
-	msg, err_msg, partial = tcp:receive()
-	if msg == nil then
-		tLog.error("Transmission to %s:%d failed. Error Message: %s", host, port, err_msg)
-		tcp:close()
-		return -1
-	end
-
-	if tonumber(msg) ~= 0 then
-		tLog.error("data transmission error")
-		tcp:close()
+	local decoded_tMeasurement = atMeasurements[1]
+	if decoded_tMeasurement == nil then
+		tLog.error("%s", astrErrors[1])
 		return -1
 	else
-		tLog.info("data received")
-	end
-
-	-- decoding tData
-	msg, err_msg, partial = tcp:receive()
-	if msg == nil then
-		tLog.error("Transmission to %s:%d failed. Error Message: %s", host, port, err_msg)
-		tcp:close()
-		return -1
-	end
-
-	if tonumber(msg) ~= 0 then
-		tLog.error("data decoding error")
-		tcp:close()
-		return -1
-	else
-		tLog.info("data decoded")
-	end
-
-	-- CoCo results
-	msg, err_msg, partial = tcp:receive()
-	if msg == nil then
-		tLog.error("Transmission to %s:%d failed. Error Message: %s", host, port, err_msg)
-		tcp:close()
-		return -1
-	end
-
-	if tonumber(msg) ~= 0 then
-		tLog.error("CoCo measurement error")
-
-		-- CoCo measurement error message
-		msg, err_msg, partial = tcp:receive()
-		if msg == nil then
-			tLog.error("Transmission to %s:%d failed. Error Message: %s", host, port, err_msg)
-			tcp:close()
-			return -1
-		end
-		tLog.error(msg)
-		tcp:close()
-		return -1
-	else
-		tLog.info("CoCo measurement OK")
-
-		local tMeasurement
-		tMeasurement, err_msg, partial = tcp:receive()
-		if tMeasurement == nil then
-			tLog.error("Transmission to %s:%d failed. Error Message: %s", host, port, err_msg)
-			tcp:close()
-			return -1
-		end
-
-		-- output string should not be in a single line - decode + encode with indent
-		local decoded_tMeasurement, pos, err_msg = json.decode(tMeasurement, 1, nil)
+		-- the results file is always JSON, it should not be in a single line - encode with indent
 		local tMeasurement = self.json.encode(decoded_tMeasurement, {indent = true})
 
 		local tResult, strMsg = pl.utils.writefile(strFilenameResults, tMeasurement, true)
@@ -205,6 +626,16 @@ function CoCo_Client:run(strFilenameResults, strFilenameTestSummary, tData, tTes
 		-- validate measurement of CoCo with data of tTestSet
 		color_validation:validateCoCo(decoded_tMeasurement, tTestSet, lux_check_enable)
 
+		if self.tMeasurementLog ~= nil then
+			local tSummary = color_validation:summarizeCoCo(decoded_tMeasurement, tTestSet, lux_check_enable)
+			local uiRecords, strError = self.tMeasurementLog:append(decoded_tMeasurement, tSummary)
+			if uiRecords == nil then
+				tLog.error("Failed to write the measurement log: %s", tostring(strError))
+			else
+				self.tMeasurementLog:flush()
+			end
+		end
+
 		local tTestSummary = self.json.encode(color_validation.tTestSummary, {indent = true})
 
 		local tResult, strMsg = pl.utils.writefile(strFilenameTestSummary, tTestSummary, true)
@@ -216,8 +647,6 @@ function CoCo_Client:run(strFilenameResults, strFilenameTestSummary, tData, tTes
 		end
 	end
 
-	tcp:close()
-
 	return 0
 end
 
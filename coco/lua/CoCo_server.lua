@@ -1,91 +1,680 @@
 local host, port = "127.0.0.1", 5555
+-- number of worker processes, each one measures one request at a time
+local uiWorkers = 4
+-- requests which wait for a worker or a device, the server stops reading requests while the queue is full
+local uiMaxQueued = 64
+-- requests of one connection which are not answered yet, the server stops reading from the connection at this limit
+local uiMaxPending = 16
+-- the running statistics of the lanes are kept in this file, they are saved every uiStatisticsInterval ms after changes
+local strStatisticsFile = "coco_statistics.json"
+local uiStatisticsInterval = 10000
+
 local uv = require "lluv"
 
 local class = require "pl.class"
 local CoCo_Server = class()
 
---- init CoCo_Server
-function CoCo_Server:_init(host, port, tData)
-	local tLogWriter
-	tLogWriter = require "log.writer.filter".new("info", require "log.writer.console.color".new())
-
-	local strLogDir = ".logs"
-	local strLogFilename = ".log_Data.log"
-
-	local tLog =
-		require "log".new(
-		-- maximum log level
-		"trace",
-		-- writer
-		require "log.writer.prefix".new("[COCO SERVER] ", tLogWriter),
-		-- formatter
-		require "log.formatter.format".new()
-	)
+local tLogWriter = require "log.writer.filter".new("info", require "log.writer.console.color".new())
+local tLog =
+	require "log".new(
+	-- maximum log level
+	"trace",
+	-- writer
+	require "log.writer.prefix".new("[COCO SERVER] ", tLogWriter),
+	-- formatter
+	require "log.formatter.format".new()
+)
+
+local tProtocol = require("coco_protocol")()
+-- the scheduler and the workers are shared by all connections
+local tScheduler
+local atWorkers = {}
+-- connections which stopped reading because the queue of the scheduler was full
+local atStalled = {}
+-- the statistics of all lanes over all measurements
+local tStatistics = require("coco_statistics")()
+
+---------------------------------------------------------------------------------------------------------------------
+-- Subscriptions. The server measures the request of a subscription repeatedly and pushes the results to the
+-- subscribers. All subscriptions with the same settings share one stream, so the devices are measured once for all of
+-- them. A stream runs at the interval of its fastest subscriber, slower subscribers get only some of the samples.
+
+-- the shortest interval of a subscription in ms
+local uiMinInterval = 50
+-- sample frames of a connection which are not sent yet, a slow subscriber skips the samples above this limit
+local uiMaxSampleWrites = 4
+
+local json = require "dkjson"
+local tResultFrame = require("result_frame")(false)
+-- the streams with the key of their settings
+local atStreams = {}
+
+-- returns a string which is the same for equal tables, independent of the order of their keys
+local function get_key(tValue)
+	if type(tValue) ~= "table" then
+		return type(tValue) .. ":" .. tostring(tValue)
+	end
+	local astrEntries = {}
+	for tKey, tEntry in pairs(tValue) do
+		table.insert(astrEntries, get_key(tKey) .. "=" .. get_key(tEntry))
+	end
+	table.sort(astrEntries)
+	return "{" .. table.concat(astrEntries, ",") .. "}"
+end
+
+local Stream = class()
+
+function Stream:_init(strKey, tRequest)
+	self.strKey = strKey
+	self.strRequest = json.encode(tRequest)
+	self.asDevices = tScheduler:getDevices(tRequest)
+	self.atSubscribers = {}
+	self.uiInterval = nil
+	self.tTimer = uv.timer()
+	-- the stream has a job in the scheduler
+	self.fMeasuring = false
+end
+
+-- starts a measurement, the timer skips a measurement while the last one did not finish
+function Stream:tick()
+	if self.fMeasuring ~= true then
+		self.fMeasuring = tScheduler:submit({
+			tOwner = self,
+			uiSequence = 0,
+			strRequest = self.strRequest,
+			asDevices = self.asDevices
+		})
+	end
+end
+
+-- a worker finished a measurement of the stream, send it to all subscribers which wait for a sample
+function Stream:complete(tJob, uiStatus, strResults)
+	self.fMeasuring = false
+	local uiNow = uv.now()
+	-- the selected lanes are the same for many subscribers
+	local astrSelected = {}
+	for _, tSubscriber in ipairs(self.atSubscribers) do
+		-- the timer of the stream may be a bit early, half of its interval is the tolerance
+		if uiNow - tSubscriber.uiLast + self.uiInterval / 2 >= tSubscriber.uiInterval then
+			tSubscriber.uiLast = uiNow
+			local strPayload = strResults
+			if uiStatus == tProtocol.auiTRANSMISSION_RESULT["TRANSMISSION_OK"] and tSubscriber.auiLanes ~= nil then
+				strPayload = astrSelected[tSubscriber.strLanes]
+				if strPayload == nil then
+					strPayload = tResultFrame:select(strResults, tSubscriber.auiLanes) or strResults
+					astrSelected[tSubscriber.strLanes] = strPayload
+				end
+			end
+			tSubscriber.tConnection:pushSample(
+				tProtocol:encode(tProtocol.COCO_PROTOCOL_TYPE_SAMPLE, strPayload, uiStatus, tSubscriber.uiSequence)
+			)
+		end
+	end
+end
 
+-- sets the interval of the timer to the one of the fastest subscriber, a stream without subscribers is removed
+function Stream:update()
+	local uiInterval = nil
+	for _, tSubscriber in ipairs(self.atSubscribers) do
+		if uiInterval == nil or tSubscriber.uiInterval < uiInterval then
+			uiInterval = tSubscriber.uiInterval
+		end
+	end
+
+	if uiInterval == nil then
+		self.tTimer:close()
+		atStreams[self.strKey] = nil
+		tScheduler:cancel(self)
+	elseif uiInterval ~= self.uiInterval then
+		self.uiInterval = uiInterval
+		self.tTimer:stop()
+		self.tTimer:start(
+			0,
+			uiInterval,
+			function()
+				self:tick()
+			end
+		)
+	end
+end
+
+function Stream:add(tSubscriber)
+	table.insert(self.atSubscribers, tSubscriber)
+	self:update()
+end
+
+function Stream:remove(tSubscriber)
+	for uiIndex, tEntry in ipairs(self.atSubscribers) do
+		if tEntry == tSubscriber then
+			table.remove(self.atSubscribers, uiIndex)
+			break
+		end
+	end
+	self:update()
+end
+
+-- returns the load of the server for a status frame
+local function get_status()
+	local uiQueued, uiRunning = tScheduler:getLoad()
+	local uiWorkers = 0
+	for _, tWorker in pairs(atWorkers) do
+		if tWorker.fRunning == true then
+			uiWorkers = uiWorkers + 1
+		end
+	end
+	local uiStreams = 0
+	for _ in pairs(atStreams) do
+		uiStreams = uiStreams + 1
+	end
+	return {
+		uiQueued = uiQueued,
+		uiRunning = uiRunning,
+		uiWorkers = uiWorkers,
+		uiStreams = uiStreams
+	}
+end
+
+--- init CoCo_Server, there is one server object for each connection
+function CoCo_Server:_init(cli)
 	self.tLog = tLog
 
 	self.pl = require "pl.import_into"()
 	self.json = require "dkjson"
 	-- self.lunajson = require "lunajson"
+	self.protocol = tProtocol
+	self.tReader = tProtocol:reader()
 
-	self.auiTRANSMISSION_RESULT = {
-		TRANSMISSION_OK = 0,
-		TRANSMISSION_FAIL = 1,
-		TRANSMISSION_DECODING_ERROR = 2,
-		TRANSMISSION_COCO_ERROR = 3
-	}
+	self.auiTRANSMISSION_RESULT = tProtocol.auiTRANSMISSION_RESULT
+
+	self.cli = cli
+	-- the requests of this connection which are not answered yet, in the order they were received
+	self.atPending = {}
+	self.fReading = false
+	self.fClosed = false
+	-- older clients send one plain JSON request and expect the results as lines
+	self.fLegacy = false
+	-- the subscriptions of this connection with the sequence number of their subscribe frame
+	self.atSubscriptions = {}
+	self.uiSampleWrites = 0
 end
 
-local function on_coco(cli, err, data)
-	local color_control = require("color_control")()
-	local tCoCo_Server = CoCo_Server()
+--- start reading requests from the connection
+function CoCo_Server:start()
+	if self.fClosed == true or self.fReading == true or self.fLegacy == true then
+		return
+	end
+	self.fReading = true
+	self.cli:start_read(
+		function(cli, err, data)
+			-- the client closes the connection after its last request
+			if err then
+				return self:close()
+			end
+			self:onData(data)
+		end
+	)
 
-	local auiTRANSMISSION_RESULT = tCoCo_Server.auiTRANSMISSION_RESULT
-	local json = tCoCo_Server.json
-	local lunajson = tCoCo_Server.lunajson
-	local tLog = tCoCo_Server.tLog
+	-- there can be requests in the buffer which were received before the server stopped reading
+	self:process()
+end
 
-	if err then
-		cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_FAIL"] .. "\n")
-		return cli:close()
+--- stop reading requests, the client has to wait with further requests
+function CoCo_Server:stop()
+	if self.fReading == true then
+		self.fReading = false
+		self.cli:stop_read()
 	end
+end
 
-	cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_OK"] .. "\n")
-	tLog.info('data received')
+function CoCo_Server:close()
+	if self.fClosed ~= true then
+		self.fClosed = true
+		self.fReading = false
+		atStalled[self] = nil
+		tScheduler:cancel(self)
+		for _, tSubscriber in pairs(self.atSubscriptions) do
+			tSubscriber.tStream:remove(tSubscriber)
+		end
+		self.atSubscriptions = {}
+		self.cli:close()
+	end
+end
 
-	local decoded_data, pos, err_msg = json.decode(data, 1, nil)
-	
+--- queue a request
+-- Requests with errors are not queued, they are answered in the order of the requests.
+function CoCo_Server:addJob(uiSequence, strRequest)
+	local auiTRANSMISSION_RESULT = self.auiTRANSMISSION_RESULT
+	local tJob = {
+		tOwner = self,
+		uiSequence = uiSequence,
+		strRequest = strRequest
+	}
+	table.insert(self.atPending, tJob)
+
+	local decoded_data, pos, err_msg = self.json.decode(strRequest, 1, nil)
 	if err_msg then
-		cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_DECODING_ERROR"] .. "\n")
 		tLog.error("Errormessage:", err_msg)
-		return cli:close()
+		tJob.uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_DECODING_ERROR"]
+		tJob.strResults = tostring(err_msg)
+		return tJob
+	end
+	tJob.asDevices = tScheduler:getDevices(decoded_data)
+	tJob.strResultFormat = decoded_data.strResultFormat
+
+	local fOk, strError = tScheduler:submit(tJob)
+	if fOk ~= true then
+		tJob.uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_FAIL"]
+		tJob.strResults = strError
+	end
+
+	return tJob
+end
+
+-- returns nil if auiLanes is a list of up to 16 lane numbers, or an error message
+local function check_lanes(auiLanes)
+	if type(auiLanes) ~= "table" or #auiLanes == 0 or #auiLanes > 16 then
+		return "auiLanes must be a list of 1 to 16 lane numbers"
+	end
+	for _, uiLane in ipairs(auiLanes) do
+		if type(uiLane) ~= "number" or uiLane < 1 or uiLane > 16 or uiLane ~= math.floor(uiLane) then
+			return string.format("invalid lane number: %s", tostring(uiLane))
+		end
+	end
+	return nil
+end
+
+--- subscribe to a request, the subscription has the sequence number of the subscribe frame
+-- returns the response for the subscribe frame
+function CoCo_Server:subscribe(uiSequence, strRequest)
+	local auiTRANSMISSION_RESULT = self.auiTRANSMISSION_RESULT
+	local tResponse = {
+		uiSequence = uiSequence,
+		uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_OK"],
+		strResults = ""
+	}
+
+	local tRequest, pos, err_msg = self.json.decode(strRequest, 1, nil)
+	if err_msg or type(tRequest) ~= "table" then
+		tLog.error("Errormessage:", err_msg)
+		tResponse.uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_DECODING_ERROR"]
+		tResponse.strResults = tostring(err_msg)
+		return tResponse
+	end
+
+	local uiInterval = tonumber(tRequest.uiInterval)
+	local auiLanes = tRequest.auiLanes
+	local strError
+	if uiInterval == nil or uiInterval < uiMinInterval then
+		strError = string.format("the interval must be at least %d ms", uiMinInterval)
+	elseif auiLanes ~= nil then
+		strError = check_lanes(auiLanes)
+	end
+	if strError == nil and self.atSubscriptions[uiSequence] ~= nil then
+		strError = string.format("the subscription %d exists already", uiSequence)
+	end
+	if strError ~= nil then
+		tResponse.uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_FAIL"]
+		tResponse.strResults = strError
+		return tResponse
+	end
+
+	-- the stream measures all lanes with the raw values, the subscribers select their lanes from the frames
+	tRequest.uiInterval = nil
+	tRequest.auiLanes = nil
+	tRequest.strResultFormat = "binary"
+	tRequest.fResultRaw = nil
+	-- the repeated measurements of the same DUTs would distort the statistics of the lanes
+	tRequest.fStatistics = false
+	local strKey = get_key(tRequest)
+	local tStream = atStreams[strKey]
+	if tStream == nil then
+		tStream = Stream(strKey, tRequest)
+		atStreams[strKey] = tStream
+	end
+
+	local tSubscriber = {
+		tConnection = self,
+		tStream = tStream,
+		uiSequence = uiSequence,
+		uiInterval = uiInterval,
+		auiLanes = auiLanes,
+		strLanes = auiLanes and table.concat(auiLanes, ","),
+		uiLast = -math.huge
+	}
+	self.atSubscriptions[uiSequence] = tSubscriber
+	tStream:add(tSubscriber)
+	tLog.info("subscription %d with an interval of %d ms", uiSequence, uiInterval)
+
+	return tResponse
+end
+
+--- end the subscription with the sequence number of its subscribe frame
+-- returns the response for the unsubscribe frame
+function CoCo_Server:unsubscribe(uiSequence)
+	local auiTRANSMISSION_RESULT = self.auiTRANSMISSION_RESULT
+	local tResponse = {
+		uiSequence = uiSequence,
+		uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_OK"],
+		strResults = ""
+	}
+
+	local tSubscriber = self.atSubscriptions[uiSequence]
+	if tSubscriber == nil then
+		tResponse.uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_FAIL"]
+		tResponse.strResults = string.format("there is no subscription %d", uiSequence)
 	else
-		cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_OK"] .. "\n")
-		tLog.info('received data decoded')
-		local iResult
-		iResult, err_msg = color_control:test(decoded_data)
-		if iResult ~= 0 then
-			cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_COCO_ERROR"] .. "\n")
-			cli:write("CoCo failed: " .. err_msg .. "\n")
-			return cli:close()
-		else
-			tLog.info('CoCo test successful')
+		self.atSubscriptions[uiSequence] = nil
+		tSubscriber.tStream:remove(tSubscriber)
+	end
+
+	return tResponse
+end
+
+--- returns the response for a statistics frame with the statistics of all devices or of the device strSerial
+function CoCo_Server:statistics(uiSequence, strRequest)
+	local auiTRANSMISSION_RESULT = self.auiTRANSMISSION_RESULT
+	local strSerial = nil
+	if strRequest ~= "" then
+		local tRequest, pos, err_msg = self.json.decode(strRequest, 1, nil)
+		if err_msg or type(tRequest) ~= "table" then
+			return {
+				uiSequence = uiSequence,
+				uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_DECODING_ERROR"],
+				strResults = tostring(err_msg)
+			}
+		end
+		strSerial = tRequest.strSerial
+	end
+
+	return {
+		uiSequence = uiSequence,
+		uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_OK"],
+		strResults = self.json.encode(tStatistics:get(strSerial))
+	}
+end
+
+--- send a sample frame of a subscription, the frame is dropped if the client does not read the previous ones
+function CoCo_Server:pushSample(strFrame)
+	if self.fClosed == true or self.uiSampleWrites >= uiMaxSampleWrites then
+		return
+	end
+	self.uiSampleWrites = self.uiSampleWrites + 1
+	self.cli:write(
+		strFrame,
+		function()
+			self.uiSampleWrites = self.uiSampleWrites - 1
+		end
+	)
+end
+
+--- a worker finished a request of this connection
+function CoCo_Server:complete(tJob, uiStatus, strResults)
+	tJob.uiStatus = uiStatus
+	tJob.strResults = strResults
+	if self.fClosed ~= true then
+		self:flush()
+		self:start()
+	end
+end
+
+--- send the results of all finished requests up to the first one which is still running
+function CoCo_Server:flush()
+	local auiTRANSMISSION_RESULT = self.auiTRANSMISSION_RESULT
+	local cli = self.cli
+
+	while self.atPending[1] ~= nil and self.atPending[1].uiStatus ~= nil do
+		local tJob = table.remove(self.atPending, 1)
+
+		if self.fLegacy == true then
+			cli:write(tJob.uiStatus .. "\n")
+			if tJob.uiStatus ~= auiTRANSMISSION_RESULT["TRANSMISSION_OK"] then
+				cli:write(tJob.strResults .. "\n")
+			elseif tJob.strResultFormat == "binary" then
+				-- binary results are sent as a line with the size of the frame, followed by the frame
+				cli:write(string.format("%d\n", string.len(tJob.strResults)) .. tJob.strResults)
+			else
+				cli:write(tJob.strResults .. "\n")
+			end
+			-- an older client sends only one request
+			return self:close()
+		end
+
+		cli:write(self.protocol:encodeResponse(tJob.strResults, tJob.uiStatus, tJob.uiSequence))
+	end
+end
+
+--- collect the data of the connection
+function CoCo_Server:onData(data)
+	self.tReader:push(data)
+	self:process()
+end
+
+--- queue all complete requests in the buffer
+-- The server stops reading from the connection if it has too many pending requests or if the queue is full.
+function CoCo_Server:process()
+	local auiTRANSMISSION_RESULT = self.auiTRANSMISSION_RESULT
+	local tReader = self.tReader
+	local cli = self.cli
+
+	while self.fClosed ~= true do
+		if #self.atPending >= uiMaxPending then
+			return self:stop()
+		elseif tScheduler:isFull() then
+			atStalled[self] = true
+			return self:stop()
+		end
+
+		if tReader:isFramed() == false then
+			local strRequest, strError = tReader:nextJson()
+			if strRequest == nil then
+				if strError ~= nil then
+					tLog.error("Failed to receive the request: %s", strError)
+					cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_FAIL"] .. "\n")
+					self:close()
+				end
+				return
+			end
+
+			-- the old protocol has a line for the received and one for the decoded request
+			self:stop()
+			self.fLegacy = true
 			cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_OK"] .. "\n")
+			tLog.info('data received')
+			local tJob = self:addJob(0, strRequest)
+			if tJob.uiStatus == auiTRANSMISSION_RESULT["TRANSMISSION_DECODING_ERROR"] then
+				cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_DECODING_ERROR"] .. "\n")
+				return self:close()
+			end
+			cli:write(auiTRANSMISSION_RESULT["TRANSMISSION_OK"] .. "\n")
+			tLog.info('received data decoded')
+			return self:flush()
+		end
+
+		-- a read can contain several pipelined requests
+		local tFrame, strError = tReader:next()
+		if tFrame == nil then
+			if strError ~= nil then
+				tLog.error("Failed to receive a request: %s", strError)
+				self:close()
+			end
+			return
+		end
 
-			local strColorTable_encoded = json.encode(color_control.tColorTable)
-			cli:write(strColorTable_encoded .. "\n")
-			color_control:free()
+		if tFrame.uiType == tProtocol.COCO_PROTOCOL_TYPE_STATUS then
+			-- a health check does not need a worker, it is answered in the order of the requests of the connection
+			table.insert(self.atPending, {
+				uiSequence = tFrame.uiSequence,
+				uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_OK"],
+				strResults = self.json.encode(get_status())
+			})
+		elseif tFrame.uiType == tProtocol.COCO_PROTOCOL_TYPE_STATISTICS then
+			-- the statistics are answered without a worker like the status
+			table.insert(self.atPending, self:statistics(tFrame.uiSequence, tFrame.strPayload))
+		elseif tFrame.uiType == tProtocol.COCO_PROTOCOL_TYPE_SUBSCRIBE then
+			table.insert(self.atPending, self:subscribe(tFrame.uiSequence, tFrame.strPayload))
+		elseif tFrame.uiType == tProtocol.COCO_PROTOCOL_TYPE_UNSUBSCRIBE then
+			table.insert(self.atPending, self:unsubscribe(tFrame.uiSequence))
+		elseif tFrame.uiType ~= tProtocol.COCO_PROTOCOL_TYPE_REQUEST then
+			tLog.error("Unexpected frame type: %d", tFrame.uiType)
+			table.insert(self.atPending, {
+				uiSequence = tFrame.uiSequence,
+				uiStatus = auiTRANSMISSION_RESULT["TRANSMISSION_FAIL"],
+				strResults = "unexpected frame type"
+			})
+		else
+			tLog.info('request %d received', tFrame.uiSequence)
+			self:addJob(tFrame.uiSequence, tFrame.strPayload)
+		end
+		self:flush()
+	end
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- The workers are separate processes running coco_worker.lua. They get the requests and send the results on a pipe
+-- at their file descriptor 3.
+
+local strWorkerScript = package.searchpath("coco_worker", package.path)
+local strInterpreter = (uv.exepath ~= nil) and uv.exepath() or arg[-1]
+
+local start_worker
+
+-- the scheduler starts a job on a worker
+local function on_start_job(tJob, uiWorker)
+	atWorkers[uiWorker].tPipe:write(tProtocol:encodeRequest(tJob.strRequest, tJob.uiSequence))
+end
+
+-- a worker finished its job
+local function on_job_done(uiWorker, uiStatus, strResults)
+	local tJob = tScheduler:finished(uiWorker)
+	if tJob ~= nil then
+		tJob.tOwner:complete(tJob, uiStatus, strResults)
+	end
+
+	-- there is space in the queue again
+	local atConnections = atStalled
+	atStalled = {}
+	for tConnection in pairs(atConnections) do
+		tConnection:start()
+	end
+end
+
+local function on_worker_exit(uiWorker)
+	local tWorker = atWorkers[uiWorker]
+	if tWorker.fRunning ~= true then
+		return
+	end
+	tWorker.fRunning = false
+	tLog.error("Worker %d stopped, restarting it.", uiWorker)
+
+	tScheduler:setOnline(uiWorker, false)
+	tWorker.tPipe:close()
+	if tWorker.tProcess ~= nil then
+		-- the process is still running if only the pipe failed
+		pcall(tWorker.tProcess.kill, tWorker.tProcess)
+	end
+	on_job_done(uiWorker, tProtocol.auiTRANSMISSION_RESULT["TRANSMISSION_FAIL"], "the worker stopped")
+
+	uv.timer():start(
+		1000,
+		function(timer)
+			timer:close()
+			start_worker(uiWorker)
 		end
+	)
+end
+
+start_worker = function(uiWorker)
+	local tPipe = uv.pipe()
+	local tReader = tProtocol:reader()
+	local tWorker = {
+		tPipe = tPipe,
+		fRunning = true
+	}
+	atWorkers[uiWorker] = tWorker
+
+	local fOk, tProcess =
+		pcall(
+		uv.spawn,
+		{
+			file = strInterpreter,
+			args = {strWorkerScript},
+			stdio = {
+				{},
+				{fd = 1, flags = uv.INHERIT_FD},
+				{fd = 2, flags = uv.INHERIT_FD},
+				{stream = tPipe, flags = uv.CREATE_PIPE + uv.READABLE_PIPE + uv.WRITABLE_PIPE}
+			}
+		},
+		function(handle, err, exit_status, term_signal)
+			handle:close()
+			on_worker_exit(uiWorker)
+		end
+	)
+	if fOk ~= true then
+		tLog.error("Failed to start worker %d: %s", uiWorker, tostring(tProcess))
+		return on_worker_exit(uiWorker)
 	end
+	tWorker.tProcess = tProcess
+
+	tPipe:start_read(
+		function(pipe, err, data)
+			if err then
+				return on_worker_exit(uiWorker)
+			end
 
-	cli:close()
+			tReader:push(data)
+			while true do
+				local tFrame, strError = tReader:next()
+				if tFrame == nil then
+					if strError ~= nil then
+						tLog.error("Invalid data from worker %d: %s", uiWorker, strError)
+						on_worker_exit(uiWorker)
+					end
+					return
+				end
+				if tFrame.uiType == tProtocol.COCO_PROTOCOL_TYPE_STATISTICS then
+					local tSample = json.decode(tFrame.strPayload, 1, nil)
+					if type(tSample) == "table" then
+						tStatistics:add(tSample)
+					end
+				else
+					on_job_done(uiWorker, tFrame.uiStatus, tFrame.strPayload)
+				end
+			end
+		end
+	)
+
+	tScheduler:setOnline(uiWorker, true)
+end
+
+local fStatisticsOk, strStatisticsError = tStatistics:load(strStatisticsFile)
+if fStatisticsOk ~= true then
+	tLog.error("%s", strStatisticsError)
+end
+uv.timer():start(
+	uiStatisticsInterval,
+	uiStatisticsInterval,
+	function()
+		if tStatistics.fDirty == true then
+			local fOk, strError = tStatistics:save(strStatisticsFile)
+			if fOk ~= true then
+				tLog.error("Failed to save the statistics to %s: %s", strStatisticsFile, tostring(strError))
+			end
+		end
+	end
+)
+
+tScheduler = require("coco_scheduler")(uiWorkers, uiMaxQueued, on_start_job)
+for uiWorker = 1, uiWorkers do
+	start_worker(uiWorker)
 end
 
 local function on_connection(server, err)
 	if err then
 		return server:close()
 	end
-	server:accept():start_read(on_coco)
+
+	CoCo_Server(server:accept()):start()
 end
 
 local function on_bind(server, err, host, port)
@@ -105,4 +694,3 @@ end
 
 uv.tcp():bind(host, port, on_bind)
 uv.run(debug.traceback)
-
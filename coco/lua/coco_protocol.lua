@@ -0,0 +1,291 @@
+-- Create the coco_protocol class.
+-- The CoCo client and server exchange length-prefixed frames over a TCP connection. A frame consists of a header and
+-- a payload:
+--
+--   offset  size  content
+--   0       4     magic "CoCM"
+--   4       1     type of the frame (COCO_PROTOCOL_TYPE_*)
+--   5       1     status, the transmission result of a response (0 for requests)
+--   6       2     sequence number, a response has the same sequence number as its request
+--   8       4     size of the payload in bytes
+--   12      n     payload
+--
+-- All numbers are little endian. The payload of a request is the JSON encoded settings of CoCo. The payload of a
+-- response is a result frame or JSON (selected with strResultFormat in the request), or an error message if the
+-- status is not TRANSMISSION_OK.
+-- A status frame asks for the load of the server (JSON with uiQueued, uiRunning and uiWorkers in the response). The
+-- server answers it without waiting for a worker, it can be used as a health check.
+-- A subscribe frame has the settings of a request with the interval in ms (uiInterval) and optionally the lanes
+-- (auiLanes, a list of lane numbers) in its JSON payload. The server answers it with a response and then measures
+-- the request repeatedly. The results are pushed as sample frames with the sequence number of the subscribe frame,
+-- their payload is a result frame with the selected lanes or an error message. An unsubscribe frame with the same
+-- sequence number ends the subscription, the server answers it with a response.
+-- A statistics frame asks for the running statistics of the lanes over all measurements (see coco_statistics.lua), its
+-- optional JSON payload can select one device with strSerial. The server answers it without waiting for a worker. A
+-- worker sends statistics frames to the server as well, with the sample of each measurement as JSON payload.
+-- A connection carries any number of requests. The client can send several requests without waiting for the
+-- results, the server answers them in the same order.
+local class = require "pl.class"
+
+---
+-- @type coco_protocol
+local CoCo_protocol = class()
+
+local COCO_PROTOCOL_MAGIC = "CoCM"
+local COCO_PROTOCOL_HEADER_SIZE = 12
+local COCO_PROTOCOL_TYPE_REQUEST = 1
+local COCO_PROTOCOL_TYPE_RESPONSE = 2
+local COCO_PROTOCOL_TYPE_STATUS = 3
+local COCO_PROTOCOL_TYPE_SUBSCRIBE = 4
+local COCO_PROTOCOL_TYPE_UNSUBSCRIBE = 5
+local COCO_PROTOCOL_TYPE_SAMPLE = 6
+local COCO_PROTOCOL_TYPE_STATISTICS = 7
+-- larger frames are rejected, a request should never come close to this
+local COCO_PROTOCOL_MAX_PAYLOAD = 16 * 1024 * 1024
+
+--- init coco_protocol
+function CoCo_protocol:_init()
+	self.COCO_PROTOCOL_MAGIC = COCO_PROTOCOL_MAGIC
+	self.COCO_PROTOCOL_HEADER_SIZE = COCO_PROTOCOL_HEADER_SIZE
+	self.COCO_PROTOCOL_TYPE_REQUEST = COCO_PROTOCOL_TYPE_REQUEST
+	self.COCO_PROTOCOL_TYPE_RESPONSE = COCO_PROTOCOL_TYPE_RESPONSE
+	self.COCO_PROTOCOL_TYPE_STATUS = COCO_PROTOCOL_TYPE_STATUS
+	self.COCO_PROTOCOL_TYPE_SUBSCRIBE = COCO_PROTOCOL_TYPE_SUBSCRIBE
+	self.COCO_PROTOCOL_TYPE_UNSUBSCRIBE = COCO_PROTOCOL_TYPE_UNSUBSCRIBE
+	self.COCO_PROTOCOL_TYPE_SAMPLE = COCO_PROTOCOL_TYPE_SAMPLE
+	self.COCO_PROTOCOL_TYPE_STATISTICS = COCO_PROTOCOL_TYPE_STATISTICS
+	self.COCO_PROTOCOL_MAX_PAYLOAD = COCO_PROTOCOL_MAX_PAYLOAD
+
+	-- the status of a response
+	self.auiTRANSMISSION_RESULT = {
+		TRANSMISSION_OK = 0,
+		TRANSMISSION_FAIL = 1,
+		TRANSMISSION_DECODING_ERROR = 2,
+		TRANSMISSION_COCO_ERROR = 3
+	}
+end
+
+local function pack_u16(uiValue)
+	return string.char(uiValue % 256, math.floor(uiValue / 256) % 256)
+end
+
+local function pack_u32(uiValue)
+	return string.char(
+		uiValue % 256,
+		math.floor(uiValue / 256) % 256,
+		math.floor(uiValue / 65536) % 256,
+		math.floor(uiValue / 16777216) % 256
+	)
+end
+
+-- encodes a frame, uiStatus and uiSequence are optional
+function CoCo_protocol:encode(uiType, strPayload, uiStatus, uiSequence)
+	return COCO_PROTOCOL_MAGIC .. string.char(uiType, uiStatus or 0) .. pack_u16((uiSequence or 0) % 65536) ..
+		pack_u32(string.len(strPayload)) .. strPayload
+end
+
+function CoCo_protocol:encodeRequest(strPayload, uiSequence)
+	return self:encode(COCO_PROTOCOL_TYPE_REQUEST, strPayload, 0, uiSequence)
+end
+
+function CoCo_protocol:encodeResponse(strPayload, uiStatus, uiSequence)
+	return self:encode(COCO_PROTOCOL_TYPE_RESPONSE, strPayload, uiStatus, uiSequence)
+end
+
+-- decodes the header at uiPos (default is 1) of strData
+-- returns a table with uiType, uiStatus, uiSequence and uiSize or nil and an error message
+function CoCo_protocol:decodeHeader(strData, uiPos)
+	uiPos = uiPos or 1
+	if string.len(strData) < uiPos + COCO_PROTOCOL_HEADER_SIZE - 1 then
+		return nil, "the frame header is truncated"
+	end
+	if string.sub(strData, uiPos, uiPos + 3) ~= COCO_PROTOCOL_MAGIC then
+		return nil, "this is not a CoCo frame"
+	end
+
+	local uiType, uiStatus, s0, s1, l0, l1, l2, l3 = string.byte(strData, uiPos + 4, uiPos + 11)
+	local uiSize = l0 + l1 * 256 + l2 * 65536 + l3 * 16777216
+	if uiSize > COCO_PROTOCOL_MAX_PAYLOAD then
+		return nil, string.format("the frame is too large (%d bytes)", uiSize)
+	end
+
+	return {
+		uiType = uiType,
+		uiStatus = uiStatus,
+		uiSequence = s0 + s1 * 256,
+		uiSize = uiSize
+	}
+end
+
+-- returns true if strData starts like a frame, false if it does not and nil if there is not enough data to decide
+function CoCo_protocol:isFrame(strData)
+	local uiLength = math.min(string.len(strData), 4)
+	if uiLength == 0 then
+		return nil
+	elseif string.sub(strData, 1, uiLength) ~= string.sub(COCO_PROTOCOL_MAGIC, 1, uiLength) then
+		return false
+	elseif uiLength < 4 then
+		return nil
+	end
+	return true
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- The reader collects the data of a stream connection and returns complete frames. TCP does not keep the borders of
+-- the writes, a frame can arrive in several pieces and one piece can contain several frames.
+--
+-- Older clients send a plain JSON request without a frame. The reader recognizes them by the first byte (a frame
+-- starts with "C", JSON with "{" or white space) and returns the JSON document as soon as its closing brace arrived.
+
+local Reader = class()
+
+function Reader:_init(tProtocol)
+	self.tProtocol = tProtocol
+	-- the data which was not returned yet starts at uiPos in strBuffer and continues with the strings in astrPending
+	self.strBuffer = ""
+	self.uiPos = 1
+	self.astrPending = {}
+	self.uiAvailable = 0
+	-- header of the frame which is currently received
+	self.tHeader = nil
+	-- nil until the first byte arrived, then true for frames or false for plain JSON
+	self.fFramed = nil
+	-- the JSON scanner: nesting depth, in a string, after a backslash, scan position in the buffer
+	self.uiDepth = 0
+	self.fString = false
+	self.fEscape = false
+	self.uiScanPos = 1
+	self.strError = nil
+end
+
+-- combines the pending strings with the rest of the buffer, this copies each byte only once per frame
+function Reader:join()
+	if #self.astrPending ~= 0 then
+		table.insert(self.astrPending, 1, string.sub(self.strBuffer, self.uiPos))
+		self.uiScanPos = self.uiScanPos - self.uiPos + 1
+		self.strBuffer = table.concat(self.astrPending)
+		self.uiPos = 1
+		self.astrPending = {}
+	end
+end
+
+-- removes uiSize bytes from the buffer and returns them
+function Reader:take(uiSize)
+	if string.len(self.strBuffer) - self.uiPos + 1 < uiSize then
+		self:join()
+	end
+	local strData = string.sub(self.strBuffer, self.uiPos, self.uiPos + uiSize - 1)
+	self.uiPos = self.uiPos + uiSize
+	self.uiAvailable = self.uiAvailable - uiSize
+	if self.uiPos > string.len(self.strBuffer) and #self.astrPending == 0 then
+		self.strBuffer = ""
+		self.uiPos = 1
+		self.uiScanPos = 1
+	end
+	return strData
+end
+
+-- adds received data
+function Reader:push(strData)
+	if strData ~= nil and string.len(strData) ~= 0 then
+		table.insert(self.astrPending, strData)
+		self.uiAvailable = self.uiAvailable + string.len(strData)
+		if self.fFramed == nil then
+			self.fFramed = (string.sub(strData, 1, 1) == string.sub(COCO_PROTOCOL_MAGIC, 1, 1))
+		end
+	end
+end
+
+-- returns true for a framed connection, false for an older client and nil if nothing arrived yet
+function Reader:isFramed()
+	return self.fFramed
+end
+
+-- returns the size of the data which was not returned yet
+function Reader:available()
+	return self.uiAvailable
+end
+
+-- returns the next complete frame (a header table with the payload in strPayload), nil if more data is needed or
+-- nil and an error message if the stream is broken
+function Reader:next()
+	if self.strError ~= nil then
+		return nil, self.strError
+	end
+
+	if self.tHeader == nil then
+		if self.uiAvailable < COCO_PROTOCOL_HEADER_SIZE then
+			return nil
+		end
+		local tHeader, strError = self.tProtocol:decodeHeader(self:take(COCO_PROTOCOL_HEADER_SIZE))
+		if tHeader == nil then
+			self.strError = strError
+			return nil, strError
+		end
+		self.tHeader = tHeader
+	end
+
+	local tFrame = self.tHeader
+	if self.uiAvailable < tFrame.uiSize then
+		return nil
+	end
+	tFrame.strPayload = self:take(tFrame.uiSize)
+	self.tHeader = nil
+
+	return tFrame
+end
+
+-- returns the next complete JSON document of an older client, nil if more data is needed or nil and an error message
+function Reader:nextJson()
+	if self.strError ~= nil then
+		return nil, self.strError
+	end
+	if self.uiAvailable > COCO_PROTOCOL_MAX_PAYLOAD then
+		self.strError = "the request is too large"
+		return nil, self.strError
+	end
+
+	self:join()
+	local strBuffer = self.strBuffer
+	local uiPos = self.uiScanPos
+	while true do
+		if self.fEscape then
+			-- skip the character after a backslash
+			if uiPos > string.len(strBuffer) then
+				self.uiScanPos = uiPos
+				return nil
+			end
+			self.fEscape = false
+			uiPos = uiPos + 1
+		end
+		local uiFound = string.find(strBuffer, self.fString and '["\\]' or '[{}"]', uiPos)
+		if uiFound == nil then
+			self.uiScanPos = string.len(strBuffer) + 1
+			return nil
+		end
+
+		local strChar = string.sub(strBuffer, uiFound, uiFound)
+		uiPos = uiFound + 1
+		if strChar == "\\" then
+			self.fEscape = true
+		elseif strChar == '"' then
+			self.fString = not self.fString
+		elseif strChar == "{" then
+			self.uiDepth = self.uiDepth + 1
+		else
+			self.uiDepth = self.uiDepth - 1
+			if self.uiDepth <= 0 then
+				self.uiDepth = 0
+				self.uiScanPos = uiPos
+				return self:take(uiPos - self.uiPos)
+			end
+		end
+	end
+end
+
+-- returns a new reader for one connection
+function CoCo_protocol:reader()
+	return Reader(self)
+end
+
+return CoCo_protocol
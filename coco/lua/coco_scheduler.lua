@@ -0,0 +1,177 @@
+-- Create the coco_scheduler class.
+-- The scheduler distributes the measurement requests of all clients to a number of workers. Each request locks the
+-- devices it measures (the serial numbers in asSerials), a request without serial numbers locks all devices. Requests
+-- for different devices run at the same time, requests for the same device run one after the other in the order they
+-- were submitted.
+-- The queue is bounded. If it is full, submit fails and the server stops reading new requests until a worker is done.
+local class = require "pl.class"
+
+---
+-- @type coco_scheduler
+local CoCo_scheduler = class()
+
+--- init coco_scheduler
+-- uiWorkers is the number of workers, uiMaxQueued the maximum number of requests which wait for a worker or a device
+-- fnStart(tJob, uiWorker) starts a job on a worker, the worker calls finished when it is done
+function CoCo_scheduler:_init(uiWorkers, uiMaxQueued, fnStart)
+	self.uiMaxQueued = uiMaxQueued
+	self.fnStart = fnStart
+
+	-- waiting jobs in the order they were submitted
+	self.atQueue = {}
+	-- the job of each worker or false for an idle worker
+	self.atWorkers = {}
+	-- workers which are not running get no jobs
+	self.afOnline = {}
+	for uiWorker = 1, uiWorkers do
+		self.atWorkers[uiWorker] = false
+		self.afOnline[uiWorker] = true
+	end
+	-- the devices which are in use, the serial number is the key, the job the value
+	self.tLocked = {}
+	-- number of running jobs and number of running jobs which lock all devices
+	self.uiRunning = 0
+	self.uiRunningAll = 0
+end
+
+-- returns the serial numbers of the devices in the settings of a request, or nil if the request needs all devices
+function CoCo_scheduler:getDevices(tRequest)
+	local asSerials = nil
+	if type(tRequest) == "table" and type(tRequest.asSerials) == "table" and #tRequest.asSerials ~= 0 then
+		asSerials = {}
+		for _, tSerial in ipairs(tRequest.asSerials) do
+			table.insert(asSerials, tostring(tSerial))
+		end
+	end
+	return asSerials
+end
+
+function CoCo_scheduler:isFull()
+	return #self.atQueue >= self.uiMaxQueued
+end
+
+-- returns the number of waiting and the number of running jobs
+function CoCo_scheduler:getLoad()
+	return #self.atQueue, self.uiRunning
+end
+
+--- queue a job
+-- tJob.asDevices contains the serial numbers of the devices or is nil for all devices
+-- returns true or false and an error message if the queue is full
+function CoCo_scheduler:submit(tJob)
+	if self:isFull() then
+		return false, "the queue of the server is full"
+	end
+	table.insert(self.atQueue, tJob)
+	self:dispatch()
+	return true
+end
+
+--- remove all waiting jobs of an owner, e.g. if the client closed the connection
+-- running jobs are not stopped
+function CoCo_scheduler:cancel(tOwner)
+	local atQueue = {}
+	for _, tJob in ipairs(self.atQueue) do
+		if tJob.tOwner ~= tOwner then
+			table.insert(atQueue, tJob)
+		end
+	end
+	self.atQueue = atQueue
+end
+
+-- returns true if the devices of the job are not locked by a running job and not wanted by an older waiting job
+local function is_free(self, tJob, tWanted, fWantedAll)
+	if tJob.asDevices == nil then
+		return self.uiRunning == 0 and next(tWanted) == nil and fWantedAll == false
+	end
+	if self.uiRunningAll ~= 0 or fWantedAll == true then
+		return false
+	end
+	for _, strSerial in ipairs(tJob.asDevices) do
+		if self.tLocked[strSerial] ~= nil or tWanted[strSerial] ~= nil then
+			return false
+		end
+	end
+	return true
+end
+
+local function get_idle_worker(self)
+	for uiWorker, tJob in ipairs(self.atWorkers) do
+		if tJob == false and self.afOnline[uiWorker] == true then
+			return uiWorker
+		end
+	end
+	return nil
+end
+
+--- start all waiting jobs which can run now
+-- A job must not overtake an older job for the same device, so the devices of the skipped jobs are blocked for
+-- the rest of the queue.
+function CoCo_scheduler:dispatch()
+	local tWanted = {}
+	local fWantedAll = false
+	local uiIndex = 1
+
+	local uiWorker = get_idle_worker(self)
+	while uiWorker ~= nil and uiIndex <= #self.atQueue do
+		local tJob = self.atQueue[uiIndex]
+		if is_free(self, tJob, tWanted, fWantedAll) then
+			table.remove(self.atQueue, uiIndex)
+
+			if tJob.asDevices == nil then
+				self.uiRunningAll = self.uiRunningAll + 1
+			else
+				for _, strSerial in ipairs(tJob.asDevices) do
+					self.tLocked[strSerial] = tJob
+				end
+			end
+			self.uiRunning = self.uiRunning + 1
+			self.atWorkers[uiWorker] = tJob
+
+			self.fnStart(tJob, uiWorker)
+			uiWorker = get_idle_worker(self)
+		else
+			if tJob.asDevices == nil then
+				fWantedAll = true
+			else
+				for _, strSerial in ipairs(tJob.asDevices) do
+					tWanted[strSerial] = true
+				end
+			end
+			uiIndex = uiIndex + 1
+		end
+	end
+end
+
+--- start or stop giving jobs to a worker, e.g. while it is restarted
+function CoCo_scheduler:setOnline(uiWorker, fOnline)
+	self.afOnline[uiWorker] = fOnline
+	if fOnline == true then
+		self:dispatch()
+	end
+end
+
+--- a worker finished its job, this releases the devices and starts the next jobs
+-- returns the job of the worker
+function CoCo_scheduler:finished(uiWorker)
+	local tJob = self.atWorkers[uiWorker]
+	if tJob ~= false and tJob ~= nil then
+		if tJob.asDevices == nil then
+			self.uiRunningAll = self.uiRunningAll - 1
+		else
+			for _, strSerial in ipairs(tJob.asDevices) do
+				self.tLocked[strSerial] = nil
+			end
+		end
+		self.uiRunning = self.uiRunning - 1
+		self.atWorkers[uiWorker] = false
+	else
+		tJob = nil
+	end
+
+	self:dispatch()
+
+	return tJob
+end
+
+return CoCo_scheduler
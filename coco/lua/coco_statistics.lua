@@ -0,0 +1,244 @@
+-- Create the coco_statistics class.
+-- The server keeps running statistics for every lane of every CoCo device over all measured DUTs. They show a drift of
+-- the optics of a fixture long before the lanes fail: the mean and the variance of nm, sat and lux (Welford's
+-- algorithm), an exponentially weighted moving average (EWMA) of them and the counts of the failed checks.
+-- A result updates each of its lanes in constant time, the statistics are saved as JSON and loaded again after a restart.
+--
+-- The workers send the results as samples, which have the same structure as the summary of
+-- Color_validation:summarizeCoCo: one entry per device with uiTested, uiFailed and atLanes. atLanes has an entry for
+-- all bright lanes and for all tested lanes. It contains nm, sat and lux, which are left out for a dark lane, and
+-- uiFailed with the failed checks of a failed lane.
+local class = require "pl.class"
+
+---
+-- @type coco_statistics
+local CoCo_statistics = class()
+
+-- the weight of a new value in the EWMA
+local dDEFAULT_LAMBDA = 0.2
+
+-- the statistics of these values are kept for each lane
+local astrValues = {"nm", "sat", "lux"}
+
+-- the names of the check flags in the counts of the failed checks, see Color_validation.VALIDATION_*
+local atChecks = {
+	{1, "nm"},
+	{2, "sat"},
+	{4, "lux_low"},
+	{8, "lux_high"}
+}
+
+--- init coco_statistics
+-- dLambda is the weight of a new value in the EWMA, a smaller value is less noisy but slower, default is 0.2
+function CoCo_statistics:_init(dLambda)
+	self.json = require "dkjson"
+	self.dLambda = dLambda or dDEFAULT_LAMBDA
+	-- the statistics of the lanes with the serial number and the lane number (a string) as keys
+	self.atDevices = {}
+	-- there are updates which are not saved yet
+	self.fDirty = false
+end
+
+-- returns true if the bit for uiLane (starting at 1) is set in uiMask
+local function has_lane(uiMask, uiLane)
+	return math.floor((tonumber(uiMask) or 0) / 2 ^ (uiLane - 1)) % 2 == 1
+end
+
+--- builds a sample from the color tables of a measurement and the summary of its validation (optional)
+-- returns the sample, it can be encoded as JSON
+function CoCo_statistics:collect(tColorTables, tSummary)
+	local tSample = {}
+	tSummary = tSummary or {}
+	for strSerial, tColorTable in pairs(tColorTables) do
+		local tDevice = tSummary[strSerial] or {}
+		local uiTested = tDevice.uiTested or 0
+		local uiFailed = tDevice.uiFailed or 0
+		local atSummaryLanes = tDevice.atLanes or {}
+		local atLanes = {}
+		for uiLane, tLane in ipairs(tColorTable) do
+			local strLane = tostring(uiLane)
+			local tEntry = nil
+			-- a dark lane has no normalized colors
+			if tLane.RGB_tsc ~= nil and tLane.RGB_tsc.R_n ~= nil then
+				local tWavelength = tLane.Wavelength or {}
+				tEntry = {
+					nm = tWavelength.nm,
+					sat = tWavelength.sat,
+					lux = tWavelength.lux
+				}
+			end
+			if has_lane(uiTested, uiLane) == true then
+				tEntry = tEntry or {}
+				local tFailed = atSummaryLanes[strLane]
+				if has_lane(uiFailed, uiLane) == true and tFailed ~= nil then
+					tEntry.uiFailed = tFailed.uiFailed
+				end
+			end
+			atLanes[strLane] = tEntry
+		end
+		tSample[strSerial] = {
+			uiTested = uiTested,
+			uiFailed = uiFailed,
+			atLanes = atLanes
+		}
+	end
+	return tSample
+end
+
+-- updates the statistics of one value with Welford's algorithm and the EWMA
+local function update_value(tValue, dValue, uiCount, dLambda)
+	local dDelta = dValue - tValue.mean
+	tValue.mean = tValue.mean + dDelta / uiCount
+	tValue.m2 = tValue.m2 + dDelta * (dValue - tValue.mean)
+	if uiCount == 1 then
+		tValue.ewma = dValue
+		tValue.min = dValue
+		tValue.max = dValue
+	else
+		tValue.ewma = tValue.ewma + dLambda * (dValue - tValue.ewma)
+		tValue.min = math.min(tValue.min, dValue)
+		tValue.max = math.max(tValue.max, dValue)
+	end
+end
+
+-- returns the statistics of a lane, a new lane is created
+function CoCo_statistics:getLane(strSerial, strLane)
+	local atLanes = self.atDevices[strSerial]
+	if atLanes == nil then
+		atLanes = {}
+		self.atDevices[strSerial] = atLanes
+	end
+	local tLane = atLanes[strLane]
+	if tLane == nil then
+		tLane = {
+			uiCount = 0,
+			uiTested = 0,
+			uiFailed = 0,
+			atChecks = {}
+		}
+		for _, strValue in ipairs(astrValues) do
+			tLane[strValue] = {mean = 0, m2 = 0}
+		end
+		for _, tCheck in ipairs(atChecks) do
+			tLane.atChecks[tCheck[2]] = 0
+		end
+		atLanes[strLane] = tLane
+	end
+	return tLane
+end
+
+--- adds the lanes of a sample (see collect) to the statistics
+function CoCo_statistics:add(tSample)
+	local dLambda = self.dLambda
+	for strSerial, tDevice in pairs(tSample) do
+		for strLane, tEntry in pairs(tDevice.atLanes or {}) do
+			local uiLane = tonumber(strLane) or 0
+			local tLane = self:getLane(strSerial, tostring(strLane))
+			if tonumber(tEntry.nm) ~= nil and tonumber(tEntry.sat) ~= nil and tonumber(tEntry.lux) ~= nil then
+				local uiCount = tLane.uiCount + 1
+				tLane.uiCount = uiCount
+				for _, strValue in ipairs(astrValues) do
+					update_value(tLane[strValue], tonumber(tEntry[strValue]), uiCount, dLambda)
+				end
+			end
+			if has_lane(tDevice.uiTested, uiLane) == true then
+				tLane.uiTested = tLane.uiTested + 1
+				if has_lane(tDevice.uiFailed, uiLane) == true then
+					tLane.uiFailed = tLane.uiFailed + 1
+					local uiChecks = tonumber(tEntry.uiFailed) or 0
+					for _, tCheck in ipairs(atChecks) do
+						if math.floor(uiChecks / tCheck[1]) % 2 == 1 then
+							tLane.atChecks[tCheck[2]] = tLane.atChecks[tCheck[2]] + 1
+						end
+					end
+				end
+			end
+			tLane.uiUpdated = os.time()
+		end
+	end
+	self.fDirty = true
+end
+
+--- returns the statistics of one device (strSerial) or of all devices (strSerial is nil)
+-- The result has one entry per device with the lane numbers as keys. A lane has uiCount (number of bright lanes),
+-- uiTested, uiFailed, atChecks (number of failed checks: nm, sat, lux_low and lux_high), uiUpdated (time of the last
+-- update in seconds since 1970) and nm, sat and lux with mean, stddev, ewma, min and max.
+function CoCo_statistics:get(strSerial)
+	local tResult = {}
+	for strDevice, atLanes in pairs(self.atDevices) do
+		if strSerial == nil or strSerial == strDevice then
+			local atResultLanes = {}
+			for strLane, tLane in pairs(atLanes) do
+				local tResultLane = {
+					uiCount = tLane.uiCount,
+					uiTested = tLane.uiTested,
+					uiFailed = tLane.uiFailed,
+					atChecks = tLane.atChecks,
+					uiUpdated = tLane.uiUpdated
+				}
+				if tLane.uiCount > 0 then
+					for _, strValue in ipairs(astrValues) do
+						local tValue = tLane[strValue]
+						tResultLane[strValue] = {
+							mean = tValue.mean,
+							stddev = (tLane.uiCount > 1) and math.sqrt(tValue.m2 / (tLane.uiCount - 1)) or 0,
+							ewma = tValue.ewma,
+							min = tValue.min,
+							max = tValue.max
+						}
+					end
+				end
+				atResultLanes[strLane] = tResultLane
+			end
+			tResult[strDevice] = atResultLanes
+		end
+	end
+	return tResult
+end
+
+--- writes the statistics to the file strPath, the old file is replaced only if the new one was written completely
+-- returns true or nil and an error message
+function CoCo_statistics:save(strPath)
+	local strTemp = strPath .. ".tmp"
+	local tFile, strError = io.open(strTemp, "wb")
+	if tFile == nil then
+		return nil, strError
+	end
+	local fOk
+	fOk, strError = tFile:write(self.json.encode({atDevices = self.atDevices}))
+	tFile:close()
+	if fOk ~= nil then
+		-- os.rename does not replace an existing file on Windows
+		if package.config:sub(1, 1) == "\\" then
+			os.remove(strPath)
+		end
+		fOk, strError = os.rename(strTemp, strPath)
+	end
+	if fOk == nil then
+		os.remove(strTemp)
+		return nil, strError
+	end
+	self.fDirty = false
+	return true
+end
+
+--- reads the statistics from the file strPath, a missing file is not an error
+-- returns true or nil and an error message
+function CoCo_statistics:load(strPath)
+	local tFile = io.open(strPath, "rb")
+	if tFile == nil then
+		return true
+	end
+	local strData = tFile:read("*a")
+	tFile:close()
+
+	local tData, pos, strError = self.json.decode(strData, 1, nil)
+	if type(tData) ~= "table" or type(tData.atDevices) ~= "table" then
+		return nil, string.format("Failed to load the statistics from %s: %s", strPath, tostring(strError))
+	end
+	self.atDevices = tData.atDevices
+	self.fDirty = false
+	return true
+end
+
+return CoCo_statistics
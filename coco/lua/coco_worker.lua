@@ -0,0 +1,260 @@
+-- The CoCo worker process.
+-- The server starts several workers and sends them the measurement requests of its clients. The requests and the
+-- results are frames of coco_protocol on the pipe at file descriptor 3, stdout and stderr are the ones of the server
+-- for the log messages.
+-- A worker measures one request at a time. The scheduler of the server makes sure that two workers never use the
+-- same device.
+-- The measurement runs in a coroutine. The led_analyzer module reads the devices in a thread and the worker waits
+-- for it in the event loop, so the pipe to the server is served during long integration times.
+local uv = require "lluv"
+
+local tLogWriter = require "log.writer.filter".new("info", require "log.writer.console.color".new())
+local tLog =
+	require "log".new(
+	-- maximum log level
+	"trace",
+	-- writer
+	require "log.writer.prefix".new("[COCO WORKER] ", tLogWriter),
+	-- formatter
+	require "log.formatter.format".new()
+)
+
+local json = require "dkjson"
+local tResultFrame = require("result_frame")()
+local tColorValidation = require("color_validation")()
+-- the test plans are compiled once and stay in its cache for the next requests
+local tTestPlan = require("test_plan")()
+local tProtocol = require("coco_protocol")()
+local tStatistics = require("coco_statistics")()
+-- the dark offsets of the devices, all workers share the files
+local tDarkOffset = require("dark_offset")()
+-- the brightness of the lanes and the read time of the devices for the measurements with a deadline
+local tExposurePlan = require("exposure_plan")()
+local auiTRANSMISSION_RESULT = tProtocol.auiTRANSMISSION_RESULT
+
+-- interval for polling a measurement if its file descriptor can not be watched, e.g. on Windows
+local uiPollInterval = 5
+
+-- waits in the event loop until the asynchronous measurement tAsync is done, this must run in a coroutine
+local function wait_async(tAsync)
+	local tCoroutine = coroutine.running()
+	local tHandle
+
+	local function on_done(handle)
+		if tHandle ~= nil and tAsync:poll() ~= false then
+			tHandle:close()
+			tHandle = nil
+			assert(coroutine.resume(tCoroutine))
+		end
+	end
+
+	local iFd = tAsync:fd()
+	if iFd ~= nil and uv.poll_fd ~= nil then
+		-- the module writes to the file descriptor when the measurement is done
+		tHandle = uv.poll_fd(iFd)
+		tHandle:start(uv.READABLE, on_done)
+	else
+		tHandle = uv.timer()
+		tHandle:start(uiPollInterval, uiPollInterval, on_done)
+	end
+	coroutine.yield()
+end
+
+-- returns the sample of a successful measurement for the statistics of the server as JSON
+-- A request with fStatistics = false is not added to the statistics, e.g. the repeated measurements of a subscription.
+local function get_statistics(tRequest, color_control, tSummary)
+	if tRequest.fStatistics == false or color_control.tColorTable == nil then
+		return nil
+	end
+	return json.encode(tStatistics:collect(color_control.tColorTable, tSummary))
+end
+
+-- returns the transmission result and the results in the format selected by the request or an error message
+-- The sample for the statistics of the server is returned as a third value after a successful measurement.
+-- The color_control object is stored in tSession, so the devices can be freed if the measurement raises an error.
+local function measure(strRequest, tSession)
+	local tRequest, pos, err_msg = json.decode(strRequest, 1, nil)
+	if err_msg then
+		return auiTRANSMISSION_RESULT["TRANSMISSION_DECODING_ERROR"], tostring(err_msg)
+	end
+
+	local color_control = require("color_control")()
+	tSession.color_control = color_control
+	color_control:setWait(wait_async)
+	color_control:setDarkOffset(tDarkOffset)
+	local iResult
+
+	if tRequest.tDarkCalibration ~= nil then
+		-- measure the dark offsets of the devices with all LEDs off, the response has the new offsets
+		iResult, err_msg = color_control:open(tRequest.asSerials, tRequest.atSettings, tRequest.atLanes)
+		if err_msg ~= nil then
+			return auiTRANSMISSION_RESULT["TRANSMISSION_COCO_ERROR"], "CoCo failed: " .. tostring(err_msg)
+		end
+		local atOffsets
+		atOffsets, err_msg =
+			tDarkOffset:calibrate(color_control, tRequest.tDarkCalibration.atSettings or {}, tRequest.tDarkCalibration.uiSamples)
+		color_control:free()
+		if atOffsets == nil then
+			return auiTRANSMISSION_RESULT["TRANSMISSION_COCO_ERROR"], "CoCo dark calibration failed: " .. tostring(err_msg)
+		end
+		return auiTRANSMISSION_RESULT["TRANSMISSION_OK"], json.encode({atDarkOffsets = atOffsets})
+	end
+
+	if tRequest.tSequential ~= nil and tRequest.strTestPlan ~= nil then
+		-- sample until every lane of the test plan step is decided, the response has the summary of the mean
+		iResult, err_msg = color_control:open(tRequest.asSerials, tRequest.atSettings, tRequest.atLanes)
+		if err_msg ~= nil then
+			return auiTRANSMISSION_RESULT["TRANSMISSION_COCO_ERROR"], "CoCo failed: " .. tostring(err_msg)
+		end
+		local tSummary, uiSamples
+		local tPlan
+		tPlan, err_msg = tTestPlan:load(tRequest.strTestPlan)
+		if tPlan ~= nil then
+			tSummary, uiSamples =
+				tTestPlan:measureSequential(
+				tPlan,
+				tRequest.uiTestStep or 1,
+				color_control,
+				tRequest.tSequential,
+				tRequest.fLuxCheck,
+				tRequest.fAllValues
+			)
+			err_msg = uiSamples
+		end
+		local strStatistics = (tSummary ~= nil) and get_statistics(tRequest, color_control, tSummary) or nil
+		color_control:free()
+		if tSummary == nil then
+			return auiTRANSMISSION_RESULT["TRANSMISSION_COCO_ERROR"], "CoCo validation failed: " .. tostring(err_msg)
+		end
+		return auiTRANSMISSION_RESULT["TRANSMISSION_OK"], json.encode({tSummary = tSummary, uiSamples = uiSamples}), strStatistics
+	end
+
+	if tRequest.tDeadline ~= nil then
+		-- plan the settings and the samples to finish within the deadline of the client
+		iResult, err_msg = color_control:open(tRequest.asSerials, tRequest.atSettings, tRequest.atLanes)
+		if err_msg == nil then
+			iResult, err_msg =
+				color_control:measureWithin(tRequest.tDeadline.uiDeadline, tRequest.tDeadline.uiMinCounts, tExposurePlan)
+			if iResult ~= 0 then
+				color_control:free()
+			end
+		end
+	else
+		iResult, err_msg = color_control:test(tRequest)
+	end
+	if iResult ~= 0 then
+		return auiTRANSMISSION_RESULT["TRANSMISSION_COCO_ERROR"], "CoCo failed: " .. tostring(err_msg)
+	end
+	tLog.info('CoCo test successful')
+
+	-- the client selects the format of the results, JSON is the default for older clients
+	local strResults
+	if tRequest.strTestPlan ~= nil then
+		-- a request with a test plan gets the summary of one step of the plan, it is always JSON
+		local tSummary, strError
+		local tPlan
+		tPlan, strError = tTestPlan:load(tRequest.strTestPlan)
+		if tPlan ~= nil then
+			tSummary, strError =
+				tTestPlan:validateCoCo(tPlan, tRequest.uiTestStep or 1, color_control, tRequest.fLuxCheck, tRequest.fAllValues)
+		end
+		local strStatistics = (tSummary ~= nil) and get_statistics(tRequest, color_control, tSummary) or nil
+		color_control:free()
+		if tSummary == nil then
+			return auiTRANSMISSION_RESULT["TRANSMISSION_COCO_ERROR"], "CoCo validation failed: " .. tostring(strError)
+		end
+		return auiTRANSMISSION_RESULT["TRANSMISSION_OK"], json.encode({tSummary = tSummary}), strStatistics
+	elseif tRequest.tTestSet ~= nil then
+		-- a request with a test set gets only the summary of the validation, it is always JSON
+		local tSummary, strError =
+			tColorValidation:summarizeCoCo(color_control.tColorTable, tRequest.tTestSet, tRequest.fLuxCheck, tRequest.fAllValues)
+		tSummary = tColorValidation:maskSummary(tSummary, color_control.atLanes)
+		local strStatistics = (tSummary ~= nil) and get_statistics(tRequest, color_control, tSummary) or nil
+		color_control:free()
+		if tSummary == nil then
+			return auiTRANSMISSION_RESULT["TRANSMISSION_COCO_ERROR"], "CoCo validation failed: " .. tostring(strError)
+		end
+		return auiTRANSMISSION_RESULT["TRANSMISSION_OK"], json.encode({tSummary = tSummary}), strStatistics
+	elseif tRequest.strResultFormat == "binary" then
+		local strError
+		strResults, strError = tResultFrame:encode(color_control.tColorTable, tRequest.fResultRaw ~= false)
+		if strResults == nil then
+			tLog.error("Failed to encode the results: %s", strError)
+			strResults = ""
+		end
+	else
+		strResults = json.encode(color_control.tColorTable)
+	end
+	local strStatistics = get_statistics(tRequest, color_control, nil)
+	color_control:free()
+
+	return auiTRANSMISSION_RESULT["TRANSMISSION_OK"], strResults, strStatistics
+end
+
+local tPipe = uv.pipe()
+tPipe:open(3)
+
+-- requests which arrived while a measurement is running
+local atRequests = {}
+local fBusy = false
+
+-- measures the waiting requests one after the other, each one in a coroutine which yields while the devices convert
+local function process()
+	if fBusy == true then
+		return
+	end
+	fBusy = true
+	coroutine.wrap(
+		function()
+			while #atRequests ~= 0 do
+				local tFrame = table.remove(atRequests, 1)
+				local tSession = {}
+				local fOk, uiStatus, strResults, strStatistics = pcall(measure, tFrame.strPayload, tSession)
+				if fOk ~= true then
+					tLog.error("The measurement failed: %s", tostring(uiStatus))
+					-- the devices of the request would stay open and block all later requests for them in every worker
+					local color_control = tSession.color_control
+					if color_control ~= nil and color_control.apHandles ~= nil then
+						local fFreed, strError = pcall(color_control.free, color_control)
+						if fFreed ~= true then
+							tLog.error("Failed to free the devices: %s", tostring(strError))
+						end
+					end
+					uiStatus, strResults, strStatistics = auiTRANSMISSION_RESULT["TRANSMISSION_FAIL"], tostring(uiStatus), nil
+				end
+				-- the sample goes to the server before the response, so it is counted when the client gets the results
+				if strStatistics ~= nil then
+					tPipe:write(tProtocol:encode(tProtocol.COCO_PROTOCOL_TYPE_STATISTICS, strStatistics))
+				end
+				tPipe:write(tProtocol:encodeResponse(strResults, uiStatus, tFrame.uiSequence))
+			end
+			fBusy = false
+		end
+	)()
+end
+
+local tReader = tProtocol:reader()
+tPipe:start_read(
+	function(pipe, err, data)
+		-- the server closed the pipe, stop the worker
+		if err then
+			return pipe:close()
+		end
+
+		tReader:push(data)
+		while true do
+			local tFrame, strError = tReader:next()
+			if tFrame == nil then
+				if strError ~= nil then
+					tLog.error("Failed to receive a request: %s", strError)
+					pipe:close()
+				end
+				break
+			end
+			table.insert(atRequests, tFrame)
+		end
+		process()
+	end
+)
+
+uv.run(debug.traceback)
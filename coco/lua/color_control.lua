@@ -36,11 +36,24 @@ function Color_control:_init()
 
 	self.tLog = tLog
 
-	local led_analyzer = require("led_analyzer")
+	-- under LuaJIT the library is called through the FFI, the SWIG module is the fallback for all other interpreters
+	local led_analyzer
+	if jit ~= nil then
+		local fOk, tModule = pcall(require, "led_analyzer_ffi")
+		if fOk == true then
+			led_analyzer = tModule
+		else
+			tLog.debug("The FFI binding is not available, using the SWIG module: %s", tostring(tModule))
+		end
+	end
+	if led_analyzer == nil then
+		led_analyzer = require("led_analyzer")
+	end
 	self.led_analyzer = led_analyzer
 
 	-- handles conversion between color spaces and array to table (or vice versa) handling
-	local color_conversions = require("color_conversions")()
+	-- it must use the same binding, the arrays of the FFI binding and the SWIG module are not compatible
+	local color_conversions = require("color_conversions")(led_analyzer)
 	self.color_conversions = color_conversions
 
 	local pl = require "pl.import_into"()
@@ -122,6 +135,8 @@ function Color_control:_init()
 	self.apHandles = apHandles
 	self.tColorTable = tColorTable
 	self.numberOfDevices = numberOfDevices
+	-- the gain and integration time of each sensor as they were written to the devices, see applySettings
+	self.atShadow = {}
 end
 
 
@@ -172,34 +187,40 @@ end
 -- connects to color controller devices with serial numbers given in table tStrSerials
 -- if tOptionalSerials doesn't exist, function will connect to all color controller devices
 -- taking the order of their serial numbers into account (serial number 20000 will have a smaller index than 20004)
-function Color_control:connectDevices(tOptionalSerials)
+-- atLanes is optional, it has the bit mask of the populated sensors of a device (bit 0 is sensor 1) with its serial
+-- number as key. A channel of the device without populated sensors is not opened (see connect_to_devices_lanes), e.g.
+-- channel B of a fixture with the mask 0x00ff. Devices without a mask are connected with both channels.
+function Color_control:connectDevices(tOptionalSerials, atLanes)
 	local tLog = self.tLog
 	local iResult
 	local aString
 	local err_msg = nil
+	local astrSerials = tOptionalSerials or self.tStrSerials
 
 	-- be pessimistic
 	iResult = -1
 
-	if (tOptionalSerials == nil) then
-		iResult = self.color_conversions:table2astring(self.tStrSerials, self.asSerials, self.MAXSERIALS)
-
-		if iResult < 0 then
-			err_msg = "converse table to string failed!"
-			tLog.error(err_msg)
-			return iResult, err_msg
-		end
+	iResult = self.color_conversions:table2astring(astrSerials, self.asSerials, self.MAXSERIALS)
 
-		iResult = self.led_analyzer.connect_to_devices(self.apHandles, self.MAXHANDLES, self.asSerials)
-	else
-		iResult = self.color_conversions:table2astring(tOptionalSerials, self.asSerials, self.MAXSERIALS)
+	if iResult < 0 then
+		err_msg = "converse table to string failed!"
+		tLog.error(err_msg)
+		return iResult, err_msg
+	end
 
-		if iResult < 0 then
-			err_msg = "converse table to string failed!"
+	if atLanes ~= nil then
+		if self.led_analyzer.connect_to_devices_lanes == nil then
+			err_msg = "the led_analyzer module can not connect single channels of a device"
 			tLog.error(err_msg)
-			return iResult, err_msg
+			return -1, err_msg
 		end
-
+		local ausLanes = self.led_analyzer.new_ushort(self.MAXSERIALS)
+		for uiIndex, strSerial in ipairs(astrSerials) do
+			self.led_analyzer.ushort_setitem(ausLanes, uiIndex - 1, atLanes[strSerial] or self.led_analyzer.LANES_ALL)
+		end
+		iResult = self.led_analyzer.connect_to_devices_lanes(self.apHandles, self.MAXHANDLES, self.asSerials, ausLanes)
+		self.led_analyzer.delete_ushort(ausLanes)
+	else
 		iResult = self.led_analyzer.connect_to_devices(self.apHandles, self.MAXHANDLES, self.asSerials)
 	end
 
@@ -212,21 +233,64 @@ function Color_control:connectDevices(tOptionalSerials)
 	end
 	-- numb of connected devices (all detected or specified by tOptionalSerials)
 	self.numberOfDevices = iResult
+	self.atLanes = atLanes
 	return iResult, err_msg
 end
 
+-- returns the bit mask of the populated sensors of a device (bit 0 is sensor 1), see connectDevices
+function Color_control:getLanes(strSerial)
+	local atLanes = self.atLanes
+	if atLanes ~= nil and atLanes[strSerial] ~= nil then
+		return atLanes[strSerial]
+	end
+	return 0xffff
+end
+
 -- Initializes the devices, by turning them on, clearing flags and identifying them
+-- The populated sensors are probed first, the initialization fails at once if one of them does not answer.
 function Color_control:initDevices(atSettings)
 	-- iterate over all devices and perform initialization --
 	local devIndex = 0
 	local iResult
 	local tLog = self.tLog
 	local err_msg = nil
+	local bit = self.bit
 
 	-- be optimistic
 	iResult = 0
 
+	local tStrSerials = self.color_conversions:astring2table(self.asSerials, self.numberOfDevices)
+
 	while (devIndex < self.numberOfDevices) do
+		-- the populated sensors must acknowledge their address, a missing one fails before any register is accessed
+		local uiLanes = self:getLanes(tStrSerials[devIndex + 1])
+		if self.led_analyzer.probe_sensors ~= nil then
+			iResult = self.led_analyzer.probe_sensors(self.apHandles, devIndex)
+			if iResult < 0 then
+				err_msg =
+					string.format(
+					"probe sensors failed! Device: %d - Error Code: %d - Error Message: %s",
+					devIndex,
+					iResult,
+					self:decodingErrorcode(iResult)
+				)
+				tLog.error(err_msg)
+				return iResult, err_msg
+			end
+			local uiMissing = bit.band(uiLanes, bit.bnot(iResult), 0xffff)
+			if uiMissing ~= 0 then
+				err_msg =
+					string.format(
+					"sensors are missing! Device: %d - Serial: %s - Missing sensors: 0x%04x",
+					devIndex,
+					tStrSerials[devIndex + 1],
+					uiMissing
+				)
+				tLog.error(err_msg)
+				return -1, err_msg
+			end
+		end
+
 		--if atsettings is provided --
 		if atSettings ~= nil then
 			for i = 1, self.MAXSENSORS do
@@ -310,6 +374,15 @@ function Color_control:initDevices(atSettings)
 			return iResult, err_msg
 		end
 
+		local atShadow = {}
+		for i = 1, self.MAXSENSORS do
+			atShadow[i] = {
+				gain = self.led_analyzer.puchar_getitem(self.aucGains, i - 1),
+				integration = self.led_analyzer.puchar_getitem(self.aucIntTimes, i - 1)
+			}
+		end
+		self.atShadow[devIndex] = atShadow
+
 		devIndex = devIndex + 1
 	end
 
@@ -320,6 +393,16 @@ end
 -- starts the measurements on each opened color controller device
 -- having read and checked all raw color data, these will be converted into the needed color spaces and stored in a color table
 function Color_control:startMeasurements()
+	self.tMeasuredBuffer = nil
+	-- let the caller wait for the conversion if it set a wait function and the led_analyzer module supports it
+	if self.fnWait ~= nil and self.led_analyzer.new_async ~= nil then
+		return self:startMeasurementsAsync()
+	end
+	-- read and convert all devices in one call if the led_analyzer module supports it
+	if self.led_analyzer.read_all_colorTables ~= nil then
+		return self:startMeasurementsBatch()
+	end
+
 	local devIndex
 	local iResult
 	local tLog = self.tLog
@@ -403,6 +486,657 @@ function Color_control:startMeasurements()
 	return iResult, err_msg
 end
 
+-- starts the measurements on all opened color controller devices with one call into the led_analyzer module
+-- the raw readings of all devices are read and converted into the color spaces in C
+-- devices with an incomplete conversion are read again one by one, the readings of the complete devices are kept
+function Color_control:startMeasurementsBatch()
+	local tLog = self.tLog
+	local err_msg = nil
+	local bit = self.bit
+	local auiError_msg = self.auiError_msg
+	local iResult
+	local uiConversion_count
+	local tColorTables
+	local tResults
+
+	-- be optimistic
+	iResult = 0
+
+	local tStrSerials = self.color_conversions:astring2table(self.asSerials, self.numberOfDevices)
+
+	self.led_analyzer.wait4Conversion(200)
+	tColorTables, tResults = self.led_analyzer.read_all_colorTables(self.apHandles, self.asSerials)
+	if tColorTables == nil then
+		err_msg = "read colors failed! Could not allocate memory for the color tables."
+		tLog.error(err_msg)
+		return -1, err_msg
+	end
+
+	uiConversion_count = 0
+	repeat
+		local atIncomplete = {}
+		for devIndex = 0, self.numberOfDevices - 1 do
+			local strSerial = tStrSerials[devIndex + 1]
+			iResult = tResults[strSerial]
+			if iResult ~= 0 then
+				if bit.band(iResult, auiError_msg["INCOMPLETE_CONVERSION_ERROR"]) ~= 0 and uiConversion_count <= 5 then
+					table.insert(atIncomplete, devIndex)
+				else
+					err_msg =
+						string.format("read colors failed! Device: %d - Serial: %s - Error Code: %d", devIndex, strSerial, iResult)
+					tLog.error(err_msg)
+					return iResult, err_msg
+				end
+			end
+		end
+
+		if #atIncomplete ~= 0 then
+			self.led_analyzer.wait4Conversion(200)
+			for _, devIndex in ipairs(atIncomplete) do
+				local strSerial = tStrSerials[devIndex + 1]
+				tResults[strSerial] =
+					self.led_analyzer.read_colors(
+					self.apHandles,
+					devIndex,
+					self.ausClear,
+					self.ausRed,
+					self.ausGreen,
+					self.ausBlue,
+					self.aucIntTimes,
+					self.aucGains
+				)
+				tColorTables[strSerial] =
+					self.color_conversions:aus2colorTable(
+					self.ausClear,
+					self.ausRed,
+					self.ausGreen,
+					self.ausBlue,
+					self.aucIntTimes,
+					self.aucGains,
+					self.MAXSENSORS
+				)
+			end
+		end
+		uiConversion_count = uiConversion_count + 1
+	until #atIncomplete == 0
+
+	for strSerial, tColorTable in pairs(tColorTables) do
+		self.tColorTable[strSerial] = tColorTable
+	end
+
+	return iResult, err_msg
+end
+
+-- sets the function which waits for an asynchronous measurement, nil waits in the led_analyzer module
+-- fnWait(tAsync) is called after the measurement was started, it must return when tAsync:poll() returns true, e.g.
+-- by waiting for tAsync:fd() in an event loop and resuming a coroutine. tAsync:fd() is nil on Windows.
+function Color_control:setWait(fnWait)
+	self.fnWait = fnWait
+end
+
+-- sets the dark offsets (see Dark_offset) which open attaches to the devices, nil reads raw values
+function Color_control:setDarkOffset(tDarkOffset)
+	self.tDarkOffset = tDarkOffset
+end
+
+-- starts the measurements on all opened color controller devices in a thread of the led_analyzer module
+-- the conversion time and the reading of the devices do not block the caller, it waits with the function of setWait
+function Color_control:startMeasurementsAsync()
+	local tLog = self.tLog
+	local err_msg = nil
+	local bit = self.bit
+	local auiError_msg = self.auiError_msg
+	local led_analyzer = self.led_analyzer
+	local iResult
+	local uiConversion_count
+	local fConversion
+	local tColorTables
+	local tResults
+
+	-- be optimistic
+	iResult = 0
+
+	local tStrSerials = self.color_conversions:astring2table(self.asSerials, self.numberOfDevices)
+	local tBuffer = self:getSampleBuffer()
+	local tAsync = self.tAsync
+	if tAsync == nil then
+		tAsync = led_analyzer.new_async()
+		self.tAsync = tAsync
+	end
+
+	uiConversion_count = 0
+	repeat
+		local fStarted
+		fStarted, err_msg = led_analyzer.start_async(tAsync, self.apHandles, tBuffer, 200)
+		if fStarted ~= true then
+			err_msg = string.format("read colors failed! Could not start the measurement: %s", tostring(err_msg))
+			tLog.error(err_msg)
+			return -1, err_msg
+		end
+		self.fnWait(tAsync)
+		tAsync:complete()
+
+		tColorTables, tResults = led_analyzer.buffer_colorTables(tBuffer, self.asSerials)
+		if tColorTables == nil then
+			err_msg = "read colors failed! Could not allocate memory for the color tables."
+			tLog.error(err_msg)
+			return -1, err_msg
+		end
+
+		fConversion = 0
+		for devIndex = 0, self.numberOfDevices - 1 do
+			local strSerial = tStrSerials[devIndex + 1]
+			iResult = tResults[strSerial]
+			if iResult ~= 0 then
+				if bit.band(iResult, auiError_msg["INCOMPLETE_CONVERSION_ERROR"]) ~= 0 and uiConversion_count <= 5 then
+					fConversion = 1
+				else
+					err_msg =
+						string.format("read colors failed! Device: %d - Serial: %s - Error Code: %d", devIndex, strSerial, iResult)
+					tLog.error(err_msg)
+					return iResult, err_msg
+				end
+			end
+		end
+		uiConversion_count = uiConversion_count + 1
+	until (fConversion == 0)
+
+	for strSerial, tColorTable in pairs(tColorTables) do
+		self.tColorTable[strSerial] = tColorTable
+	end
+	-- the buffer keeps the readings until the next measurement, a test plan can validate them without the color tables
+	self.tMeasuredBuffer = tBuffer
+
+	return iResult, err_msg
+end
+
+-- reads the raw colors of all opened color controller devices with one call into the led_analyzer module
+-- returns a table with one entry per serial: { result, lanes = { [1..16] = { clear, red, green, blue, gain, intTime, status } } }
+function Color_control:readAll()
+	local tReadings = self.led_analyzer.read_all(self.apHandles, self.asSerials)
+	return tReadings
+end
+
+-- returns the sample buffer for all opened color controller devices
+-- the buffer is created on the first call and reused as long as it is large enough
+function Color_control:getSampleBuffer()
+	local tBuffer = self.tSampleBuffer
+	if tBuffer == nil or select(2, tBuffer:devices()) < self.numberOfDevices then
+		tBuffer = self.led_analyzer.new_sample_buffer(math.max(self.numberOfDevices, 1))
+		self.tSampleBuffer = tBuffer
+	end
+	return tBuffer
+end
+
+-- reads the raw colors of all opened color controller devices into a sample buffer, without creating any tables
+-- the buffer is created on the first call and reused afterwards, its values are read through views:
+-- tBuffer.clear[devIndex*16 + sensor + 1], tBuffer.red, .green, .blue, .gain, .intTime, tBuffer.results[devIndex + 1]
+-- or with tBuffer:lane(devIndex, sensor) which returns clear, red, green, blue, gain, intTime
+-- returns the buffer and the number of devices which were read
+function Color_control:readAllBuffer()
+	local tBuffer = self:getSampleBuffer()
+	local iDevices = self.led_analyzer.read_all_buffer(self.apHandles, tBuffer)
+	return tBuffer, iDevices
+end
+
+-- starts a measurement with two exposures on each opened color controller device (HDR mode)
+-- tHDR contains the settings of both exposures in named fields:
+--   { intTimeShort = <integration time register>, gainShort = <gain register>,
+--     intTimeLong = <integration time register>, gainLong = <gain register> }
+-- the reading of each sensor is taken from the exposure which fits best, the settings of that exposure are stored
+-- with the colors, so the conversion into the color spaces uses the settings the reading was taken with
+function Color_control:startMeasurementsHDR(tHDR)
+	self.tMeasuredBuffer = nil
+	local devIndex
+	local iResult
+	local tLog = self.tLog
+	local err_msg = nil
+
+	-- be optimistic
+	iResult = 0
+
+	local tStrSerials = self.color_conversions:astring2table(self.asSerials, self.numberOfDevices)
+
+	devIndex = 0
+	while (devIndex < self.numberOfDevices) do
+		iResult =
+			self.led_analyzer.read_colors_hdr(
+			self.apHandles,
+			devIndex,
+			tHDR.intTimeShort,
+			tHDR.gainShort,
+			tHDR.intTimeLong,
+			tHDR.gainLong,
+			self.ausClear,
+			self.ausRed,
+			self.ausGreen,
+			self.ausBlue,
+			self.aucIntTimes,
+			self.aucGains
+		)
+
+		if iResult ~= 0 then
+			err_msg =
+				string.format(
+				"read colors (HDR) failed! Device: %d - Serial: %s - Error Code: %d",
+				devIndex,
+				tStrSerials[devIndex + 1],
+				iResult
+			)
+			tLog.error(err_msg)
+			return iResult, err_msg
+		end
+
+		self.tColorTable[tStrSerials[devIndex + 1]] =
+			self.color_conversions:aus2colorTable(
+			self.ausClear,
+			self.ausRed,
+			self.ausGreen,
+			self.ausBlue,
+			self.aucIntTimes,
+			self.aucGains,
+			self.MAXSENSORS
+		)
+
+		devIndex = devIndex + 1
+	end
+
+	return iResult, err_msg
+end
+
+-- starts an oversampled measurement on each opened color controller device
+-- every device takes uiSamples conversions, the statistics are calculated in C
+-- the mean values are converted into the color spaces and stored in the color table,
+-- the statistics of each channel are stored in self.tStatistics[serial][sensor][channel] = { mean, stddev, min, max, median }
+function Color_control:startMeasurementsOversampled(uiSamples)
+	local tLog = self.tLog
+	local led_analyzer = self.led_analyzer
+	local err_msg = nil
+	local iResult
+	local devIndex
+
+	-- be optimistic
+	iResult = 0
+
+	local tStrSerials = self.color_conversions:astring2table(self.asSerials, self.numberOfDevices)
+
+	self.tStatistics = {}
+
+	devIndex = 0
+	while (devIndex < self.numberOfDevices) do
+		-- the statistics table is built in C, the means are stored in the reading arrays
+		local tDeviceStatistics
+		iResult, tDeviceStatistics =
+			led_analyzer.read_oversampled(
+			self.apHandles,
+			devIndex,
+			uiSamples,
+			self.ausClear,
+			self.ausRed,
+			self.ausGreen,
+			self.ausBlue,
+			self.aucIntTimes,
+			self.aucGains
+		)
+
+		if iResult ~= 0 then
+			err_msg =
+				string.format(
+				"read colors (oversampled) failed! Device: %d - Serial: %s - Error Code: %d",
+				devIndex,
+				tStrSerials[devIndex + 1],
+				iResult
+			)
+			tLog.error(err_msg)
+			break
+		end
+		self.tStatistics[tStrSerials[devIndex + 1]] = tDeviceStatistics
+
+		self.tColorTable[tStrSerials[devIndex + 1]] =
+			self.color_conversions:aus2colorTable(
+			self.ausClear,
+			self.ausRed,
+			self.ausGreen,
+			self.ausBlue,
+			self.aucIntTimes,
+			self.aucGains,
+			self.MAXSENSORS
+		)
+
+		devIndex = devIndex + 1
+	end
+
+	return iResult, err_msg
+end
+
+-- reads a new sample of all opened color controller devices into the sample buffer after uiWait ms
+-- the wait function of setWait is used if it is set, readings with an incomplete conversion are repeated
+-- the time of the last reading without the wait is stored in self.uiReadTime (microseconds)
+-- returns the buffer or nil, an error code and an error message
+function Color_control:readSampleBuffer(uiWait)
+	local tLog = self.tLog
+	local bit = self.bit
+	local led_analyzer = self.led_analyzer
+	local uiINCOMPLETE = self.auiError_msg["INCOMPLETE_CONVERSION_ERROR"]
+	local tBuffer = self:getSampleBuffer()
+
+	for uiConversion_count = 0, 5 do
+		if self.fnWait ~= nil and led_analyzer.new_async ~= nil then
+			local tAsync = self.tAsync
+			if tAsync == nil then
+				tAsync = led_analyzer.new_async()
+				self.tAsync = tAsync
+			end
+			local fStarted, err_msg = led_analyzer.start_async(tAsync, self.apHandles, tBuffer, uiWait)
+			if fStarted ~= true then
+				err_msg = string.format("read colors failed! Could not start the measurement: %s", tostring(err_msg))
+				tLog.error(err_msg)
+				return nil, -1, err_msg
+			end
+			self.fnWait(tAsync)
+			local _, uiReadTime = tAsync:complete()
+			self.uiReadTime = uiReadTime
+		else
+			led_analyzer.wait4Conversion(uiWait)
+			local _, uiReadTime = led_analyzer.read_all_buffer(self.apHandles, tBuffer)
+			self.uiReadTime = uiReadTime
+		end
+
+		local fIncomplete = false
+		for devIndex = 0, self.numberOfDevices - 1 do
+			local iResult = tBuffer.results[devIndex + 1]
+			if iResult ~= 0 then
+				if bit.band(iResult, uiINCOMPLETE) ~= 0 and uiConversion_count < 5 then
+					fIncomplete = true
+				else
+					local err_msg =
+						string.format(
+						"read colors failed! Device: %d - Serial: %s - Error Code: %d",
+						devIndex,
+						tostring(self.tStrSerials[devIndex + 1]),
+						iResult
+					)
+					tLog.error(err_msg)
+					return nil, iResult, err_msg
+				end
+			end
+		end
+		if fIncomplete == false then
+			break
+		end
+	end
+
+	return tBuffer
+end
+
+-- starts a sequential measurement on each opened color controller device: it samples all devices until the result of
+-- every tested lane of a test plan step is certain, or until a maximum number of samples
+-- tNativePlan is the compiled plan (tPlan.tNative of Test_plan), uiStep starts at 0, auiPlanDevices has the device of the
+-- plan for each opened device (see Test_plan:measureSequential). tSequential has the optional fields
+--   uiMaxSamples: the maximum number of samples, default 32
+--   uiMinSamples: the minimum number of samples, at least 2, default 3
+--   dZ:           the half width of the confidence intervals in standard errors, default 2.576 (99%)
+-- Between two samples the devices get the conversion time of their slowest sensor. The color tables and the sample buffer
+-- get the mean of all samples, so the plan validates the mean like an oversampled measurement.
+-- tNativePlan must come from the same binding as self.led_analyzer, the plans of the FFI binding and the SWIG module are
+-- not compatible.
+-- returns the error code, the error message and the number of samples
+function Color_control:startMeasurementsSequential(tNativePlan, uiStep, auiPlanDevices, tSequential, fLuxCheck)
+	local tLog = self.tLog
+	local led_analyzer = self.led_analyzer
+	tSequential = tSequential or {}
+	local uiMaxSamples = tSequential.uiMaxSamples or 32
+	local uiMinSamples = math.max(tSequential.uiMinSamples or 3, 2)
+	local dZ = tSequential.dZ or 2.576
+	self.tMeasuredBuffer = nil
+
+	local tTest = led_analyzer.new_sequential_test(math.max(self.numberOfDevices, 1))
+	-- the sensors are converting since the initialization, the first sample waits like the other measurements
+	local uiWait = 200
+	local uiSamples = 0
+	local uiUndecided
+	local tBuffer
+	repeat
+		local iResult, err_msg
+		tBuffer, iResult, err_msg = self:readSampleBuffer(uiWait)
+		if tBuffer == nil then
+			tTest:free()
+			return iResult, err_msg, uiSamples
+		end
+		uiSamples = tTest:add(tBuffer)
+
+		if uiSamples == 1 then
+			-- every following sample must be a new conversion of all sensors
+			local tIntTime = tBuffer.intTime
+			local uiMinIntTime = 255
+			for uiIndex = 1, 16 * self.numberOfDevices do
+				uiMinIntTime = math.min(uiMinIntTime, tIntTime[uiIndex])
+			end
+			uiWait = math.ceil((256 - uiMinIntTime) * 2.4) + 1
+		end
+
+		uiUndecided = nil
+		if uiSamples >= uiMinSamples then
+			uiUndecided = tTest:decide(tNativePlan, uiStep, auiPlanDevices, fLuxCheck == true, dZ)
+		end
+	until uiUndecided == 0 or uiSamples >= uiMaxSamples
+	tLog.info("sequential measurement: %d samples, %d undecided lanes", uiSamples, uiUndecided or 0)
+
+	local iResult, err_msg = self:storeMean(tTest, tBuffer)
+	return iResult, err_msg, uiSamples
+end
+
+-- replaces the readings in the sample buffer with the mean of the samples of a sequential test and converts them into
+-- the color tables, the test is freed
+-- returns the error code and the error message
+function Color_control:storeMean(tTest, tBuffer)
+	tTest:mean(tBuffer)
+	tTest:free()
+
+	local tColorTables = self.led_analyzer.buffer_colorTables(tBuffer, self.asSerials)
+	if tColorTables == nil then
+		local err_msg = "read colors failed! Could not allocate memory for the color tables."
+		self.tLog.error(err_msg)
+		return -1, err_msg
+	end
+	for strSerial, tColorTable in pairs(tColorTables) do
+		self.tColorTable[strSerial] = tColorTable
+	end
+	self.tMeasuredBuffer = tBuffer
+
+	return 0, nil
+end
+
+-- measures the opened color controller devices within uiDeadline ms
+-- The gain and integration time of each lane and the number of samples are planned to reach uiMinCounts clear counts
+-- per lane over all samples in the shortest time (see Exposure_plan). The plan uses the previous measurement of the lanes
+-- and the measured read time, which are kept in tExposurePlan for the next call. Without a previous measurement the lanes
+-- keep their gain and get the longest integration time which fits. The color tables get the mean of the samples.
+-- returns the error code, the error message and the plan
+function Color_control:measureWithin(uiDeadline, uiMinCounts, tExposurePlan)
+	local tLog = self.tLog
+	local led_analyzer = self.led_analyzer
+	tExposurePlan = tExposurePlan or self.tExposurePlan
+	if tExposurePlan == nil then
+		tExposurePlan = require("exposure_plan")()
+		self.tExposurePlan = tExposurePlan
+	end
+	self.tMeasuredBuffer = nil
+
+	local tPlan, err_msg = tExposurePlan:plan(self, uiDeadline, uiMinCounts or 10000)
+	if tPlan == nil then
+		tLog.error(err_msg)
+		return -1, err_msg, nil
+	end
+	tLog.info(
+		"measurement within %d ms: %d samples of %d ms, %d writes, estimated %d ms, quality %.2f",
+		uiDeadline,
+		tPlan.uiSamples,
+		tPlan.uiConversion,
+		tPlan.uiWrites,
+		tPlan.dEstimatedTime,
+		tPlan.dQuality
+	)
+
+	local iResult
+	iResult, err_msg = self:applySettings(tPlan.atSettings)
+	if iResult < 0 then
+		return iResult, err_msg, tPlan
+	end
+
+	local tTest = led_analyzer.new_sequential_test(math.max(self.numberOfDevices, 1))
+	local tBuffer
+	for uiSample = 1, tPlan.uiSamples do
+		tBuffer, iResult, err_msg = self:readSampleBuffer((uiSample == 1) and tPlan.uiFirstWait or tPlan.uiConversion)
+		if tBuffer == nil then
+			tTest:free()
+			return iResult, err_msg, tPlan
+		end
+		if self.uiReadTime ~= nil then
+			tExposurePlan:addReadTime(self.uiReadTime / 1000, self.numberOfDevices)
+		end
+		tTest:add(tBuffer)
+	end
+
+	iResult, err_msg = self:storeMean(tTest, tBuffer)
+	if iResult == 0 then
+		tExposurePlan:update(tBuffer, self.color_conversions:astring2table(self.asSerials, self.numberOfDevices))
+	end
+	return iResult, err_msg, tPlan
+end
+
+-- samples the clear channel of all sensors of one device with the shortest integration time (burst mode)
+-- and analyzes the samples for blinking LEDs
+-- returns a table with one entry per sensor: { period_ms, frequency, duty_cycle, on_level, off_level, blinking }
+function Color_control:measureBlink(devIndex, uiSamples)
+	local tLog = self.tLog
+	local led_analyzer = self.led_analyzer
+	local bit = self.bit
+	local err_msg = nil
+	local iResult
+	local tBlink = nil
+
+	local ausBurstClear = led_analyzer.new_ushort(uiSamples * self.MAXSENSORS)
+	local auiTimestamps = led_analyzer.new_uint(uiSamples)
+	local afPeriod = led_analyzer.new_afloat(self.MAXSENSORS)
+	local afDutyCycle = led_analyzer.new_afloat(self.MAXSENSORS)
+	local ausOnLevel = led_analyzer.new_ushort(self.MAXSENSORS)
+	local ausOffLevel = led_analyzer.new_ushort(self.MAXSENSORS)
+
+	iResult = led_analyzer.read_clear_burst(self.apHandles, devIndex, uiSamples, ausBurstClear, auiTimestamps)
+	if iResult ~= 0 then
+		err_msg =
+			string.format(
+			"read clear burst failed! Device: %d - Error Code: %d - Error Message: %s",
+			devIndex,
+			iResult,
+			self:decodingErrorcode(iResult)
+		)
+		tLog.error(err_msg)
+	else
+		-- a result > 0 only marks the sensors without a periodic signal
+		local uiSteady =
+			led_analyzer.analyze_blink(
+			ausBurstClear,
+			auiTimestamps,
+			uiSamples,
+			afPeriod,
+			afDutyCycle,
+			ausOnLevel,
+			ausOffLevel
+		)
+
+		tBlink = {}
+		for i = 0, self.MAXSENSORS - 1 do
+			local fPeriod = led_analyzer.afloat_getitem(afPeriod, i)
+			local fFrequency = 0
+			if fPeriod > 0 then
+				fFrequency = 1000 / fPeriod
+			end
+			tBlink[i + 1] = {
+				period_ms = fPeriod,
+				frequency = fFrequency,
+				duty_cycle = led_analyzer.afloat_getitem(afDutyCycle, i),
+				on_level = led_analyzer.ushort_getitem(ausOnLevel, i),
+				off_level = led_analyzer.ushort_getitem(ausOffLevel, i),
+				blinking = bit.band(uiSteady, bit.lshift(1, i)) == 0
+			}
+		end
+	end
+
+	led_analyzer.delete_ushort(ausBurstClear)
+	led_analyzer.delete_uint(auiTimestamps)
+	led_analyzer.delete_afloat(afPeriod)
+	led_analyzer.delete_afloat(afDutyCycle)
+	led_analyzer.delete_ushort(ausOnLevel)
+	led_analyzer.delete_ushort(ausOffLevel)
+
+	return iResult, tBlink, err_msg
+end
+
+-- reads only the status register and the clear channel of all sensors of one device, e.g. for a presence or brightness
+-- check. The frame on the i2c bus is a third of a complete reading. If the shadow knows the gain and integration time of
+-- all sensors, they are not read from the device again.
+-- returns the result code, a table with the 16 clear values and an error message. A saturated sensor is not an error,
+-- its bit is set in the third return value instead of the error message.
+function Color_control:readClear(devIndex)
+	local tLog = self.tLog
+	local led_analyzer = self.led_analyzer
+	local bit = self.bit
+	local auiError_msg = self.auiError_msg
+
+	local uiWindow = led_analyzer.READ_WINDOW_STATUS_CLEAR
+	local atShadow = self.atShadow[devIndex]
+	local fKnown = atShadow ~= nil
+	for i = 1, self.MAXSENSORS do
+		local tSensor = fKnown and atShadow[i] or nil
+		if tSensor == nil or tSensor.gain == nil or tSensor.integration == nil then
+			fKnown = false
+			break
+		end
+		led_analyzer.puchar_setitem(self.aucGains, i - 1, tSensor.gain)
+		led_analyzer.puchar_setitem(self.aucIntTimes, i - 1, tSensor.integration)
+	end
+	if fKnown == true then
+		uiWindow = uiWindow + led_analyzer.READ_WINDOW_KEEP_SETTINGS
+	end
+
+	local iResult =
+		led_analyzer.read_colors_window(
+		self.apHandles,
+		devIndex,
+		uiWindow,
+		self.ausClear,
+		nil,
+		nil,
+		nil,
+		self.aucIntTimes,
+		self.aucGains
+	)
+	local uiSaturated = 0
+	if iResult > 0 and bit.band(iResult, auiError_msg["EXCEEDED_CLEAR_ERROR"]) ~= 0 then
+		uiSaturated = bit.band(iResult, 0xffff)
+		iResult = 0
+	end
+	if iResult ~= 0 then
+		local err_msg =
+			string.format(
+			"read clear failed! Device: %d - Error Code: %d - Error Message: %s",
+			devIndex,
+			iResult,
+			self:decodingErrorcode(iResult)
+		)
+		tLog.error(err_msg)
+		return iResult, nil, err_msg
+	end
+
+	local atClear = {}
+	for i = 1, self.MAXSENSORS do
+		atClear[i] = led_analyzer.ushort_getitem(self.ausClear, i - 1)
+	end
+	return iResult, atClear, uiSaturated
+end
+
 function Color_control:swapUp(sCurSerial)
 	self.led_analyzer.swap_up(self.asSerials, sCurSerial)
 	self.tStrSerials = self.color_conversions:astring2table(self.asSerials, self.numberOfDevices)
@@ -414,11 +1148,15 @@ function Color_control:swapDown(sCurSerial)
 end
 
 function Color_control:setGainX(iDeviceIndex, iSensorIndex, gain)
-	return self.led_analyzer.set_gain_x(self.apHandles, iDeviceIndex, iSensorIndex, gain)
+	local iResult = self.led_analyzer.set_gain_x(self.apHandles, iDeviceIndex, iSensorIndex, gain)
+	self:updateShadow(iDeviceIndex, iSensorIndex + 1, "gain", iResult >= 0 and gain or nil)
+	return iResult
 end
 
 function Color_control:setIntTimeX(iDeviceIndex, iSensorIndex, intTime)
-	return self.led_analyzer.set_intTime_x(self.apHandles, iDeviceIndex, iSensorIndex, intTime)
+	local iResult = self.led_analyzer.set_intTime_x(self.apHandles, iDeviceIndex, iSensorIndex, intTime)
+	self:updateShadow(iDeviceIndex, iSensorIndex + 1, "integration", iResult >= 0 and intTime or nil)
+	return iResult
 end
 
 function Color_control:setSettings(intTime, gain)
@@ -427,18 +1165,192 @@ function Color_control:setSettings(intTime, gain)
 	while (devIndex < self.numberOfDevices) do
 		if gain ~= nil then
 			ret = self.led_analyzer.set_gain(self.apHandles, devIndex, gain)
+			self:updateShadow(devIndex, nil, "gain", ret >= 0 and gain or nil)
 		end
 		if intTime ~= nil then
 			ret = self.led_analyzer.set_intTime(self.apHandles, devIndex, intTime)
+			self:updateShadow(devIndex, nil, "integration", ret >= 0 and intTime or nil)
 		end
 		devIndex = devIndex + 1
 	end
 	return ret
 end
 
+-- sets a value of the shadow for one sensor (starting at 1) or all sensors (uiSensor is nil) of a device
+-- a value of nil marks the register as unknown after a failed write, the next applySettings writes it again
+function Color_control:updateShadow(devIndex, uiSensor, strKey, tValue)
+	local atShadow = self.atShadow[devIndex]
+	if atShadow == nil then
+		atShadow = {}
+		self.atShadow[devIndex] = atShadow
+	end
+	for i = uiSensor or 1, uiSensor or self.MAXSENSORS do
+		local tSensor = atShadow[i]
+		if tSensor == nil then
+			tSensor = {}
+			atShadow[i] = tSensor
+		end
+		tSensor[strKey] = tValue
+	end
+end
+
+-- the setters for both registers: one sensor, all sensors of a device
+local atSettingsRegisters = {
+	{"gain", "set_gain_x", "set_gain"},
+	{"integration", "set_intTime_x", "set_intTime"}
+}
+
+-- writes the gain and integration time of the sensors like initDevices, but only the registers which differ from the
+-- shadow. atSettings has the same format as in initDevices, sensors and values which are missing are not changed.
+-- If all sensors of a device get the same new value, it is written to all of them at once.
+-- returns the number of writes or a negative error code and an error message
+function Color_control:applySettings(atSettings)
+	local led_analyzer = self.led_analyzer
+	local tLog = self.tLog
+	local uiWrites = 0
+
+	for devIndex = 0, self.numberOfDevices - 1 do
+		local tDeviceSettings = atSettings[tostring(devIndex)] or atSettings[devIndex]
+		if tDeviceSettings ~= nil then
+			local atShadow = self.atShadow[devIndex] or {}
+			for _, tRegister in ipairs(atSettingsRegisters) do
+				local strKey = tRegister[1]
+				-- collect the sensors which need a write
+				local atChanged = {}
+				local tCommon = nil
+				local fCommon = true
+				for i = 1, self.MAXSENSORS do
+					local tSensorSettings = tDeviceSettings[tostring(i)] or tDeviceSettings[i]
+					local tValue = tSensorSettings ~= nil and tSensorSettings[strKey] or nil
+					if tValue ~= nil and (atShadow[i] == nil or atShadow[i][strKey] ~= tValue) then
+						table.insert(atChanged, {i, tValue})
+						if tCommon == nil then
+							tCommon = tValue
+						elseif tCommon ~= tValue then
+							fCommon = false
+						end
+					end
+				end
+
+				local iResult = 0
+				if #atChanged == self.MAXSENSORS and fCommon == true then
+					iResult = led_analyzer[tRegister[3]](self.apHandles, devIndex, tCommon)
+					self:updateShadow(devIndex, nil, strKey, iResult >= 0 and tCommon or nil)
+					uiWrites = uiWrites + 1
+				else
+					for _, tChanged in ipairs(atChanged) do
+						iResult = led_analyzer[tRegister[2]](self.apHandles, devIndex, tChanged[1] - 1, tChanged[2])
+						self:updateShadow(devIndex, tChanged[1], strKey, iResult >= 0 and tChanged[2] or nil)
+						uiWrites = uiWrites + 1
+						if iResult < 0 then
+							break
+						end
+					end
+				end
+				if iResult < 0 then
+					local err_msg =
+						string.format(
+						"set %s failed! Device: %d - Error Code: %d - Error Message: %s",
+						strKey,
+						devIndex,
+						iResult,
+						self:decodingErrorcode(iResult)
+					)
+					tLog.error(err_msg)
+					return iResult, err_msg
+				end
+			end
+		end
+	end
+
+	return uiWrites
+end
+
+-- runs a sequence of steps on the opened devices (see open) and returns the results of all steps together
+-- A step is a table with the optional fields
+--   atSettings:        gain and integration time like in initDevices, only the changed registers are written
+--   uiWait:            time in ms to wait before the measurement, e.g. until the LEDs of the device under test are stable
+--   fMeasure:          false skips the measurement, e.g. for a step which only changes the settings
+--   tTestSet:          validate the measurement against this test set (see Color_validation:summarizeCoCo)
+--   tPlan, uiTestStep: or validate it against a step of a compiled test plan (see Test_plan:validateCoCo)
+--   lux_check_enable, fAllValues: the options of the validation
+-- fnHook(uiStep, tStep, self) is called before each step, it switches the LEDs of the device under test. If it returns
+-- false and an error message, the sequence stops.
+-- returns the list of the step results { tColorTable, tSummary, uiWrites } and 0, or the results of the finished steps
+-- with the error code and error message of the failed step
+function Color_control:runSequence(atSteps, fnHook)
+	local tLog = self.tLog
+	local atResults = {}
+
+	for uiStep, tStep in ipairs(atSteps) do
+		if fnHook ~= nil then
+			local fOk, strError = fnHook(uiStep, tStep, self)
+			if fOk == false then
+				local err_msg = string.format("step %d stopped by the hook: %s", uiStep, tostring(strError))
+				tLog.error(err_msg)
+				return atResults, -1, err_msg
+			end
+		end
+
+		local tResult = {uiWrites = 0}
+		if tStep.atSettings ~= nil then
+			local iWrites, err_msg = self:applySettings(tStep.atSettings)
+			if iWrites < 0 then
+				return atResults, iWrites, string.format("step %d: %s", uiStep, err_msg)
+			end
+			tResult.uiWrites = iWrites
+		end
+
+		if tStep.uiWait ~= nil and tStep.uiWait > 0 then
+			self.led_analyzer.wait4Conversion(tStep.uiWait)
+		end
+
+		if tStep.fMeasure ~= false then
+			local iResult, err_msg = self:startMeasurements()
+			if iResult ~= 0 then
+				return atResults, iResult, string.format("step %d: %s", uiStep, tostring(err_msg))
+			end
+			-- the measurement replaces the color tables of the devices, the tables of this step stay unchanged
+			local tColorTable = {}
+			for strSerial, tColorTableDevice in pairs(self.tColorTable) do
+				tColorTable[strSerial] = tColorTableDevice
+			end
+			tResult.tColorTable = tColorTable
+
+			local tSummary, strError
+			if tStep.tPlan ~= nil then
+				if self.tTestPlan == nil then
+					self.tTestPlan = require("test_plan")()
+				end
+				tSummary, strError =
+					self.tTestPlan:validateCoCo(tStep.tPlan, tStep.uiTestStep, self, tStep.lux_check_enable, tStep.fAllValues)
+			elseif tStep.tTestSet ~= nil then
+				if self.tColorValidation == nil then
+					self.tColorValidation = require("color_validation")()
+				end
+				tSummary, strError =
+					self.tColorValidation:summarizeCoCo(tColorTable, tStep.tTestSet, tStep.lux_check_enable, tStep.fAllValues)
+			end
+			if strError ~= nil then
+				return atResults, -1, string.format("step %d: %s", uiStep, strError)
+			end
+			tResult.tSummary = tSummary
+		end
+
+		atResults[uiStep] = tResult
+	end
+
+	return atResults, 0
+end
+
 -- don't forget to clean up after every test --
 function Color_control:free()
 	-- CLEAN UP --
+	-- a running measurement uses the handles and the buffer, freeing it waits for the measurement
+	if self.tAsync ~= nil then
+		self.tAsync:free()
+		self.tAsync = nil
+	end
 	self.led_analyzer.free_devices(self.apHandles)
 	self.led_analyzer.delete_ushort(self.ausClear)
 	self.led_analyzer.delete_ushort(self.ausRed)
@@ -450,6 +1362,11 @@ function Color_control:free()
 	self.led_analyzer.delete_puchar(self.aucIntTimes)
 	self.led_analyzer.delete_apvoid(self.apHandles)
 	self.led_analyzer.delete_astring(self.asSerials)
+	if self.tSampleBuffer ~= nil then
+		self.tSampleBuffer:free()
+		self.tSampleBuffer = nil
+	end
+	self.tMeasuredBuffer = nil
 
 	self.ausClear = nil
 	self.ausRed = nil
@@ -469,6 +1386,55 @@ function Color_control:free()
 	self.tColorTable = {}
 	-- number of 1 scanned / 2 connected devices
 	self.numberOfDevices = 0
+	self.atLanes = nil
+end
+
+-- scans and connects the devices (all or the ones in asSerials) and initializes them with atSettings
+-- atLanes is optional, it has the populated sensors of the devices (see connectDevices).
+-- The devices stay open for any number of measurements or sequences (see runSequence) until free is called. If the
+-- devices could not be opened, everything is freed.
+-- returns the result of the initialization or the result of the failed step and an error message
+function Color_control:open(asSerials, atSettings, atLanes)
+	local tLog = self.tLog
+	local iResult
+	local err_msg = nil
+
+	tLog.info("start to scan CoCo devices")
+	iResult, err_msg = self:scanDevices()
+
+	if iResult <= 0 then
+		self:free()
+		return iResult, err_msg
+	end
+	tLog.info("scan CoCo devices finished")
+	tLog.info(
+		"detected number of devices: %d - with serials of: %s",
+		self.numberOfDevices,
+		table.concat(self.tStrSerials, ",")
+	)
+
+	tLog.info("initialize connection to devices: ")
+	iResult, err_msg = self:connectDevices(asSerials, atLanes)
+
+	if iResult <= 0 then
+		self:free()
+		return iResult, err_msg
+	end
+	tLog.info("established connection to devices: ")
+
+	tLog.info("start of the initialization")
+	iResult, err_msg = self:initDevices(atSettings)
+	if iResult < 0 then
+		self:free()
+		return iResult, err_msg
+	end
+	tLog.info("initialization finished")
+
+	if self.tDarkOffset ~= nil then
+		tLog.info("attached dark offsets to %d devices", self.tDarkOffset:attach(self))
+	end
+
+	return iResult, err_msg
 end
 
 function Color_control:test(tData)
@@ -504,42 +1470,23 @@ function Color_control:test(tData)
 		tLog.info("No opional data of CoCo serials available.")
 	end
 
-	tLog.info("start to scan CoCo devices")
-	iResult, err_msg = self:scanDevices()
-
-	if iResult <= 0 then
-		self:free()
-		return iResult, err_msg
-	end
-	tLog.info("scan CoCo devices finished")
-	tLog.info(
-		"detected number of devices: %d - with serials of: %s",
-		self.numberOfDevices,
-		table.concat(self.tStrSerials, ",")
-	)
-
-	tLog.info("initialize connection to devices: ")
-	iResult, err_msg = self:connectDevices(asSerials)
+	-- optional, measure with two exposures (HDR) if available
+	local tHDR = tData.tHDR
 
-	if iResult <= 0 then
-		self:free()
+	iResult, err_msg = self:open(asSerials, atSettings, tData.atLanes)
+	if err_msg ~= nil then
 		return iResult, err_msg
 	end
-	tLog.info("established connection to devices: ")
-
-	tLog.info("start of the initialization")
-	iResult, err_msg = self:initDevices(atSettings)
-	if iResult < 0 then
-		self:free()
-		return iResult, err_msg
-	end
-	tLog.info("initialization finished")
 
 	-- tLog.info("conversion time: %d", uiConversationTime)
 	-- self.led_analyzer.wait4Conversion(uiConversationTime)
 
 	tLog.info("start of the measurement")
-	iResult, err_msg = self:startMeasurements()
+	if tHDR ~= nil then
+		iResult, err_msg = self:startMeasurementsHDR(tHDR)
+	else
+		iResult, err_msg = self:startMeasurements()
+	end
 	if iResult ~= 0 then
 		self:free()
 		return iResult, err_msg
@@ -5,7 +5,7 @@ local class = require "pl.class"
 -- @type color_control
 local Color_conversions = class()
 
-function Color_conversions:_init()
+function Color_conversions:_init(led_analyzer)
 	local tLogWriter = require "log.writer.filter".new("info", require "log.writer.console.color".new())
 
 	-- local strLogDir = ".logs"
@@ -35,8 +35,8 @@ function Color_conversions:_init()
 
 	self.tLog = tLog
 	
-	local led_analyzer = require("led_analyzer")
-	self.led_analyzer = led_analyzer
+	-- the led_analyzer binding can be passed by the caller (e.g. the FFI binding), default is the SWIG module
+	self.led_analyzer = led_analyzer or require("led_analyzer")
 
 	local pl = require "pl.import_into"()
 	self.pl = pl
@@ -71,6 +71,39 @@ function Color_conversions:_init()
 	}
 	self.auiTCS3472_GAIN = auiTCS3472_GAIN
 
+	-- sRGB gamma decoding table, the same as in color_conversions.c (see color_srgb_decode there for the error bound)
+	local GAMMA_LUT_SIZE = 4096
+	local GAMMA_LUT_MAX = 2.0
+	local afGammaLut = nil
+	if jit ~= nil then
+		afGammaLut = {}
+		for i = 0, GAMMA_LUT_SIZE do
+			afGammaLut[i + 1] = math.pow((0.04045 + i * ((GAMMA_LUT_MAX - 0.04045) / GAMMA_LUT_SIZE) + 0.055) / 1.055, 2.4)
+		end
+	end
+	self.GAMMA_LUT_SIZE = GAMMA_LUT_SIZE
+	self.GAMMA_LUT_MAX = GAMMA_LUT_MAX
+	self.afGammaLut = afGammaLut
+
+end
+
+-- gamma decoding of one sRGB component
+-- between 0.04045 and GAMMA_LUT_MAX the decoding is interpolated linearly in afGammaLut,
+-- the absolute error is below 1.2e-7 compared to math.pow
+-- the table only pays off with LuaJIT, the plain Lua interpreter is faster with math.pow
+function Color_conversions:srgbDecode(value)
+	if value <= 0.04045 then
+		return value / 12.92
+	elseif value >= self.GAMMA_LUT_MAX or self.afGammaLut == nil then
+		return math.pow((value + 0.055) / 1.055, 2.4)
+	end
+
+	local afGammaLut = self.afGammaLut
+	local position = (value - 0.04045) * (self.GAMMA_LUT_SIZE / (self.GAMMA_LUT_MAX - 0.04045))
+	local index = math.floor(position)
+	local low = afGammaLut[index + 1]
+
+	return low + (position - index) * (afGammaLut[index + 2] - low)
 end
 
 -- Gets the maximum clear level corresponding to a given integration time of the tcs3472 sensor
@@ -107,23 +140,9 @@ function Color_conversions:RGB2XYZ(r, g, b, rgb_workingspace)
 
 
 	-- gamma decoding of SRGB space
-	if r_n>0.04045 then
-		r_n = math.pow((r_n + 0.055) / 1.055, 2.4)
-	else
-		r_n = r_n / 12.92
-	end
-
-	if g_n > 0.04045 then
-		g_n = math.pow((g_n + 0.055) / 1.055, 2.4)
-	else
-		g_n = g_n / 12.92
-	end
-
-	if b_n > 0.04045 then
-		b_n = math.pow((b_n + 0.055) / 1.055, 2.4)
-	else
-		b_n = b_n / 12.92
-	end
+	r_n = self:srgbDecode(r_n)
+	g_n = self:srgbDecode(g_n)
+	b_n = self:srgbDecode(b_n)
 
 
 	local tXYZ = {}
@@ -317,7 +336,18 @@ end
 --Returns the dominant wavelength of input parameters x,y
 --instead of using the idealized CIE1931 2° Observer Curver we use the spectral sensitivity data
 --of our sensor and thus achieve a much better accuracy
+--the led_analyzer module provides an indexed search over the hue angles (color_conversions.c),
+--Yxy2wavelength_lua is the linear search over all entries
 function Color_conversions:Yxy2wavelength(x, y)
+	local fnNative = self.led_analyzer.Yxy2wavelength
+	if fnNative ~= nil then
+		return fnNative(x, y)
+	end
+
+	return self:Yxy2wavelength_lua(x, y)
+end
+
+function Color_conversions:Yxy2wavelength_lua(x, y)
 	-- if too dark return zeros --
 	if ((x == 0) and (y == 0)) then
 		return 0, 0
@@ -477,7 +507,18 @@ end
 
 -- Convert the Colors given as parameters into various color spaces (RGB, HSV, XYZ, Yxy, Wavelength)
 -- and save the values of the color spaces into tables
-function Color_conversions:aus2colorTable(clear, red, green, blue, intTimes, gain, length) 
+-- the conversion is done in C (color_conversions.c) if the led_analyzer module provides it,
+-- aus2colorTable_lua is the reference implementation with the same results
+function Color_conversions:aus2colorTable(clear, red, green, blue, intTimes, gain, length)
+	local fnNative = self.led_analyzer.aus2colorTable
+	if fnNative ~= nil then
+		return fnNative(clear, red, green, blue, intTimes, gain, length)
+	end
+
+	return self:aus2colorTable_lua(clear, red, green, blue, intTimes, gain, length)
+end
+
+function Color_conversions:aus2colorTable_lua(clear, red, green, blue, intTimes, gain, length)
 	-- tables containing colors in different color spaces
 	local tRGB = {}
 	local tXYZ = {}
@@ -161,5 +161,128 @@ function Color_validation:validateCoCo(tMeasurementResults, tTestSet, lux_check_
 	return iResult, err_msg
 end
 
+-- the checks of a lane in the summary, the flags of the failed checks are added
+local VALIDATION_NM = 1
+local VALIDATION_SAT = 2
+local VALIDATION_LUX_LOW = 4
+local VALIDATION_LUX_HIGH = 8
+Color_validation.VALIDATION_NM = VALIDATION_NM
+Color_validation.VALIDATION_SAT = VALIDATION_SAT
+Color_validation.VALIDATION_LUX_LOW = VALIDATION_LUX_LOW
+Color_validation.VALIDATION_LUX_HIGH = VALIDATION_LUX_HIGH
+
+-- returns the failed checks of a lane with the same limits as validateSensor
+local function get_failed_checks(tWavelength, tTestSetSensor, lux_check_enable)
+	local uiFailed = 0
+	local nm = tonumber(tWavelength.nm) or 0
+	local sat = tonumber(tWavelength.sat) or 0
+	local lux = tonumber(tWavelength.lux) or 0
+
+	if nm < (tTestSetSensor.nm - tTestSetSensor.tol_nm) or nm > (tTestSetSensor.nm + tTestSetSensor.tol_nm) then
+		uiFailed = uiFailed + VALIDATION_NM
+	end
+	if sat < (tTestSetSensor.sat - tTestSetSensor.tol_sat) or sat > (tTestSetSensor.sat + tTestSetSensor.tol_sat) then
+		uiFailed = uiFailed + VALIDATION_SAT
+	end
+	if lux_check_enable ~= nil then
+		if lux < (tTestSetSensor.lux - tTestSetSensor.tol_lux) then
+			uiFailed = uiFailed + VALIDATION_LUX_LOW
+		elseif lux > (tTestSetSensor.lux + tTestSetSensor.tol_lux) then
+			uiFailed = uiFailed + VALIDATION_LUX_HIGH
+		end
+	end
+
+	return uiFailed
+end
+
+-- validates the measurement like validateCoCo, but returns a compact summary instead of the status strings
+-- The summary has one entry per device with a test set:
+--   uiTested: bitmask of the lanes with a test entry (bit 0 is lane 1)
+--   uiFailed: bitmask of the lanes which failed
+--   atLanes:  the values of the failed lanes (or of all tested lanes if fAllValues is true) with the lane number as
+--             key: { nm, sat, lux, uiFailed = VALIDATION_* flags of the failed checks }
+-- The lanes of a test set can have numbers or strings (from JSON objects) as keys.
+-- returns the summary or nil and an error message
+function Color_validation:summarizeCoCo(tMeasurementResults, tTestSet, lux_check_enable, fAllValues)
+	if type(tTestSet) ~= "table" then
+		return nil, "No test set(s) available"
+	end
+	if type(tMeasurementResults) ~= "table" then
+		return nil, "No measurement results of CoCo available"
+	end
+
+	local tSummary = {}
+	for strDeviceSerial, tColorTable in pairs(tMeasurementResults) do
+		local tTestSetDevice = tTestSet[strDeviceSerial]
+		if type(tTestSetDevice) == "table" then
+			local uiTested = 0
+			local uiFailed = 0
+			local atLanes = {}
+
+			for uiSensor, tColorTableSensor in ipairs(tColorTable) do
+				local tTestSetSensor = tTestSetDevice[uiSensor] or tTestSetDevice[tostring(uiSensor)]
+				if type(tTestSetSensor) == "table" then
+					local uiBit = 2 ^ (uiSensor - 1)
+					local tWavelength = tColorTableSensor.Wavelength or {}
+					local uiFailedChecks = get_failed_checks(tWavelength, tTestSetSensor, lux_check_enable)
+
+					uiTested = uiTested + uiBit
+					if uiFailedChecks ~= 0 then
+						uiFailed = uiFailed + uiBit
+					end
+					if uiFailedChecks ~= 0 or fAllValues == true then
+						atLanes[tostring(uiSensor)] = {
+							nm = tWavelength.nm,
+							sat = tWavelength.sat,
+							lux = tWavelength.lux,
+							uiFailed = uiFailedChecks
+						}
+					end
+				end
+			end
+
+			tSummary[strDeviceSerial] = {
+				uiTested = math.floor(uiTested),
+				uiFailed = math.floor(uiFailed),
+				atLanes = atLanes
+			}
+		end
+	end
+
+	return tSummary
+end
+
+-- removes the lanes which are not populated from a summary of summarizeCoCo, e.g. the lanes on a channel which was not
+-- opened (see Color_control:connectDevices)
+-- atLanes has the bit mask of the populated lanes (bit 0 is lane 1) with the serial numbers as keys, the devices
+-- without a mask keep all lanes
+-- returns the summary
+function Color_validation:maskSummary(tSummary, atLanes)
+	if type(tSummary) ~= "table" or type(atLanes) ~= "table" then
+		return tSummary
+	end
+
+	for strDeviceSerial, tDevice in pairs(tSummary) do
+		local uiLanes = tonumber(atLanes[strDeviceSerial])
+		if uiLanes ~= nil then
+			for uiSensor = 1, 16 do
+				local uiBit = 2 ^ (uiSensor - 1)
+				if math.floor(uiLanes / uiBit) % 2 == 0 then
+					if math.floor(tDevice.uiTested / uiBit) % 2 == 1 then
+						tDevice.uiTested = math.floor(tDevice.uiTested - uiBit)
+					end
+					if math.floor(tDevice.uiFailed / uiBit) % 2 == 1 then
+						tDevice.uiFailed = math.floor(tDevice.uiFailed - uiBit)
+					end
+					if tDevice.atLanes ~= nil then
+						tDevice.atLanes[tostring(uiSensor)] = nil
+					end
+				end
+			end
+		end
+	end
+
+	return tSummary
+end
 
 return Color_validation
@@ -0,0 +1,254 @@
+-- Create the dark_offset class.
+-- The dark readings of a sensor depend on its gain and integration time. They are measured once per CoCo device with
+-- all LEDs off (calibrate), saved as JSON per serial number and subtracted in read_colors and read_colors_hdr of the
+-- led_analyzer module from all following readings of the device (attach). The offsets are created with the binding of the
+-- Color_control, this is the SWIG module or led_analyzer_ffi. With the offsets removed, a short
+-- integration time gives usable values for dim LEDs, which would be buried in the dark level without them.
+-- A file has the serial number, the time of the calibration and the list atSettings with gain, integration and
+-- auiOffsets, the 64 offsets of one setting with the channels first: clear of sensor 1 to 16, red, green and blue.
+local class = require "pl.class"
+
+---
+-- @type dark_offset
+local Dark_offset = class()
+
+-- the default number of conversions which are averaged for each setting
+local uiDEFAULT_SAMPLES = 8
+
+-- the number of sensors of a device and the number of offsets of a setting
+local uiSENSORS = 16
+local uiOFFSETS = 4 * uiSENSORS
+
+--- init dark_offset
+-- strPrefix is the path of the files without the serial number, e.g. "calibration/dark", the default is "dark_offset"
+function Dark_offset:_init(strPrefix)
+	self.strPrefix = strPrefix or "dark_offset"
+	self.json = require "dkjson"
+	-- the offsets of the devices with the serial number as key: the file contents, the binding and its offsets
+	self.atCache = {}
+end
+
+-- returns the binding of a Color_control or nil if it has no dark offsets
+local function get_led_analyzer(tColorControl)
+	local led_analyzer = tColorControl.led_analyzer
+	if led_analyzer == nil or led_analyzer.new_dark_offset == nil or led_analyzer.set_dark_offsets == nil then
+		return nil
+	end
+	return led_analyzer
+end
+
+-- returns the path of the file of one device, characters which are not allowed in a file name are replaced
+function Dark_offset:getPath(strSerial)
+	return string.format("%s_%s.json", self.strPrefix, string.gsub(strSerial, "[^%w%-_]", "_"))
+end
+
+-- converts the list of settings into offsets of the binding led_analyzer
+-- returns the offsets or nil and an error message
+function Dark_offset:toNative(atSettings, led_analyzer)
+	local tOffsets = led_analyzer.new_dark_offset()
+	for _, tSetting in ipairs(atSettings) do
+		local fOk, strError = tOffsets:set(tSetting.gain, tSetting.integration, tSetting.auiOffsets)
+		if fOk ~= true then
+			tOffsets:free()
+			return nil, strError
+		end
+	end
+	return tOffsets
+end
+
+--- returns the offsets of one device for the binding led_analyzer, or nil if the device has no calibration
+-- The file is read each time, but only decoded again if it or the binding changed. So the calibration of another process
+-- is used by the next measurement.
+-- The second return value is an error message if the file is not valid.
+function Dark_offset:load(strSerial, led_analyzer)
+	local strPath = self:getPath(strSerial)
+	local tFile = io.open(strPath, "rb")
+	if tFile == nil then
+		self.atCache[strSerial] = nil
+		return nil
+	end
+	local strData = tFile:read("*a")
+	tFile:close()
+
+	local tCached = self.atCache[strSerial]
+	if tCached ~= nil and tCached.strData == strData and tCached.led_analyzer == led_analyzer then
+		return tCached.tOffsets
+	end
+
+	local tData, pos, strError = self.json.decode(strData, 1, nil)
+	if type(tData) ~= "table" or type(tData.atSettings) ~= "table" then
+		return nil, string.format("Failed to load the dark offsets from %s: %s", strPath, tostring(strError))
+	end
+	local tOffsets
+	tOffsets, strError = self:toNative(tData.atSettings, led_analyzer)
+	if tOffsets == nil then
+		return nil, string.format("Invalid dark offsets in %s: %s", strPath, tostring(strError))
+	end
+	self.atCache[strSerial] = {strData = strData, led_analyzer = led_analyzer, tOffsets = tOffsets}
+	return tOffsets
+end
+
+--- writes the offsets of one device, the old file is replaced only if the new one was written completely
+-- returns true or nil and an error message
+function Dark_offset:save(strSerial, atSettings)
+	local strPath = self:getPath(strSerial)
+	local strTemp = strPath .. ".tmp"
+	local tFile, strError = io.open(strTemp, "wb")
+	if tFile == nil then
+		return nil, strError
+	end
+	local fOk
+	fOk, strError =
+		tFile:write(self.json.encode({strSerial = strSerial, uiTime = os.time(), atSettings = atSettings}))
+	tFile:close()
+	if fOk ~= nil then
+		-- os.rename does not replace an existing file on Windows
+		if package.config:sub(1, 1) == "\\" then
+			os.remove(strPath)
+		end
+		fOk, strError = os.rename(strTemp, strPath)
+	end
+	if fOk == nil then
+		os.remove(strTemp)
+		return nil, strError
+	end
+	return true
+end
+
+--- attaches the offsets to all opened devices of a Color_control, a device without a calibration reads raw values
+-- returns the number of devices with offsets, this is 0 if the binding of the Color_control has no dark offsets
+function Dark_offset:attach(tColorControl)
+	local tLog = tColorControl.tLog
+	local uiAttached = 0
+	local led_analyzer = get_led_analyzer(tColorControl)
+	if led_analyzer == nil then
+		tLog.warning("The led_analyzer binding has no dark offsets, the devices read raw values.")
+		return uiAttached
+	end
+	for devIndex = 0, tColorControl.numberOfDevices - 1 do
+		local strSerial = tColorControl.tStrSerials[devIndex + 1]
+		local tOffsets, strError = self:load(strSerial, led_analyzer)
+		if tOffsets == nil and strError ~= nil then
+			tLog.error(strError)
+		end
+		-- no offsets detach the ones of an earlier calibration
+		local fOk
+		fOk, strError = led_analyzer.set_dark_offsets(tColorControl.apHandles, devIndex, tOffsets)
+		if fOk ~= true then
+			tLog.error("Failed to set the dark offsets of %s: %s", tostring(strSerial), tostring(strError))
+		elseif tOffsets ~= nil then
+			uiAttached = uiAttached + 1
+		end
+	end
+	return uiAttached
+end
+
+--- measures the dark offsets of all opened devices of a Color_control, all LEDs in front of the sensors must be off
+-- atSettings is the list of the settings to calibrate: { gain = , integration = }, the values of the tcs3472 registers.
+-- Each setting is written to all sensors, after one conversion with the new setting the mean of uiSamples conversions
+-- is the offset. The offsets are saved and attached to the devices. The settings of the sensors are changed.
+-- returns the offsets with the serial numbers as keys (see the file format) or nil and an error message
+function Dark_offset:calibrate(tColorControl, atSettings, uiSamples)
+	local led_analyzer = get_led_analyzer(tColorControl)
+	if led_analyzer == nil then
+		return nil, "the led_analyzer binding has no dark offsets"
+	end
+	uiSamples = uiSamples or uiDEFAULT_SAMPLES
+
+	local atResults = {}
+	local afMean = led_analyzer.new_afloat(uiOFFSETS)
+	local afVariance = led_analyzer.new_afloat(uiOFFSETS)
+	local ausMin = led_analyzer.new_ushort(uiOFFSETS)
+	local ausMax = led_analyzer.new_ushort(uiOFFSETS)
+	local ausMedian = led_analyzer.new_ushort(uiOFFSETS)
+
+	local strError = nil
+	for _, tSetting in ipairs(atSettings) do
+		local tSensorSettings = {gain = tSetting.gain, integration = tSetting.integration}
+		local atDeviceSettings = {}
+		for devIndex = 0, tColorControl.numberOfDevices - 1 do
+			local atSensors = {}
+			for uiSensor = 1, uiSENSORS do
+				atSensors[tostring(uiSensor)] = tSensorSettings
+			end
+			atDeviceSettings[tostring(devIndex)] = atSensors
+		end
+		local iResult
+		iResult, strError = tColorControl:applySettings(atDeviceSettings)
+		if iResult < 0 then
+			break
+		end
+		-- the conversion which was running during the write has a mixed integration, it is skipped
+		-- (the integration time is (256 - ATIME) * 2.4 ms)
+		led_analyzer.wait4Conversion(math.ceil((256 - tSetting.integration) * 2.4) + 3)
+
+		for devIndex = 0, tColorControl.numberOfDevices - 1 do
+			local strSerial = tColorControl.tStrSerials[devIndex + 1]
+			iResult =
+				led_analyzer.read_colors_oversampled(
+				tColorControl.apHandles,
+				devIndex,
+				uiSamples,
+				afMean,
+				afVariance,
+				ausMin,
+				ausMax,
+				ausMedian,
+				tColorControl.aucIntTimes,
+				tColorControl.aucGains
+			)
+			if iResult ~= 0 then
+				strError =
+					string.format(
+					"read colors (oversampled) failed! Device: %d - Serial: %s - Error Code: %d",
+					devIndex,
+					tostring(strSerial),
+					iResult
+				)
+				break
+			end
+
+			local auiOffsets = {}
+			for uiIndex = 1, uiOFFSETS do
+				auiOffsets[uiIndex] = math.floor(led_analyzer.afloat_getitem(afMean, uiIndex - 1) + 0.5)
+			end
+			local atDeviceResults = atResults[strSerial]
+			if atDeviceResults == nil then
+				atDeviceResults = {}
+				atResults[strSerial] = atDeviceResults
+			end
+			table.insert(
+				atDeviceResults,
+				{gain = tSetting.gain, integration = tSetting.integration, auiOffsets = auiOffsets}
+			)
+		end
+		if iResult ~= 0 then
+			break
+		end
+		strError = nil
+	end
+
+	led_analyzer.delete_afloat(afMean)
+	led_analyzer.delete_afloat(afVariance)
+	led_analyzer.delete_ushort(ausMin)
+	led_analyzer.delete_ushort(ausMax)
+	led_analyzer.delete_ushort(ausMedian)
+
+	if strError ~= nil then
+		tColorControl.tLog.error(strError)
+		return nil, strError
+	end
+
+	for strSerial, atDeviceResults in pairs(atResults) do
+		local fOk
+		fOk, strError = self:save(strSerial, atDeviceResults)
+		if fOk ~= true then
+			return nil, string.format("Failed to save the dark offsets of %s: %s", strSerial, tostring(strError))
+		end
+	end
+	self:attach(tColorControl)
+
+	return atResults
+end
+
+return Dark_offset
@@ -0,0 +1,278 @@
+-- Create the exposure_plan class.
+-- A measurement with a deadline needs settings which fit into the time budget of the caller: the gain and integration
+-- time of each lane and the number of samples. The plan is made from three things:
+--   * the conversion time of the sensors, 2.4 ms for each step of the integration time register (256 - ATIME steps),
+--   * the time of the USB and I2C round trip, measured with each reading of the devices,
+--   * the previous measurement of the same lanes, which gives the brightness of each lane in counts per step and gain.
+-- The quality of a measurement is the sum of the clear counts of a lane over all samples. A plan reaches the minimum
+-- quality in all lanes with the shortest measurement time, or the best quality possible if the deadline is too short.
+local class = require "pl.class"
+
+---
+-- @type exposure_plan
+local Exposure_plan = class()
+
+-- the factors of the gain register values 0 to 3
+local auiGAIN_FACTORS = {1, 4, 16, 60}
+
+-- the counts of an ADC for each integration step and the maximum of the 16 bit registers
+local uiCOUNTS_PER_STEP = 1024
+local uiMAX_COUNTS = 65535
+
+-- the plan keeps the predicted clear counts of a lane below this part of the maximum to leave room for the noise
+local dHEADROOM = 0.8
+
+-- a lane darker than this (counts per step at gain 1) has no LED, its settings are not planned
+local dDARK_BRIGHTNESS = 0.02
+
+-- the estimate of the read time of one device before the first measurement, in ms
+local dDEFAULT_READ_TIME = 10
+
+-- the weight of a new read time in the moving average
+local dREAD_TIME_LAMBDA = 0.3
+
+--- init exposure_plan
+-- uiMaxSamples is the maximum number of samples of a plan, the default is 16
+function Exposure_plan:_init(uiMaxSamples)
+	self.uiMaxSamples = uiMaxSamples or 16
+	-- the brightness of the lanes of the last measurement with the serial number as key, one list of 16 per device
+	self.atDevices = {}
+	-- the moving average of the read time of one device in ms
+	self.dReadTime = nil
+end
+
+-- returns the conversion time in ms for a number of integration steps, like tcs_getConversionTime_ms
+local function get_conversion_time(uiSteps)
+	return math.floor((24 * uiSteps + 9) / 10)
+end
+
+-- returns the maximum clear count for a number of integration steps, like tcs_getMaxClear
+local function get_max_clear(uiSteps)
+	return math.min(uiCOUNTS_PER_STEP * uiSteps, uiMAX_COUNTS)
+end
+
+--- adds the time of one reading of uiDevices devices in ms to the estimate of the round trip
+function Exposure_plan:addReadTime(dTime, uiDevices)
+	local dDeviceTime = dTime / math.max(uiDevices, 1)
+	if self.dReadTime == nil then
+		self.dReadTime = dDeviceTime
+	else
+		self.dReadTime = self.dReadTime + dREAD_TIME_LAMBDA * (dDeviceTime - self.dReadTime)
+	end
+end
+
+-- returns the estimated read time of one device in ms
+function Exposure_plan:getReadTime()
+	return self.dReadTime or dDEFAULT_READ_TIME
+end
+
+--- keeps the brightness of all lanes of a measurement in a sample buffer for the next plan
+-- astrSerials are the serial numbers of the devices in the buffer
+function Exposure_plan:update(tBuffer, astrSerials)
+	for devIndex, strSerial in ipairs(astrSerials) do
+		local atLanes = {}
+		for uiLane = 1, 16 do
+			local usClear, _, _, _, ucGain, ucIntTime = tBuffer:lane(devIndex - 1, uiLane - 1)
+			local uiSteps = 256 - ucIntTime
+			local dBrightness = usClear / (uiSteps * auiGAIN_FACTORS[ucGain + 1])
+			atLanes[uiLane] = {
+				dBrightness = dBrightness,
+				-- a saturated lane is brighter than its reading, it is planned with a shorter exposure next time
+				fSaturated = usClear >= get_max_clear(uiSteps) * 0.98
+			}
+		end
+		self.atDevices[strSerial] = atLanes
+	end
+end
+
+-- plans the exposure of one lane for a maximum number of integration steps and the number of needed counts per sample
+-- returns gain register value, integration steps and the predicted clear counts (nil for a lane without a brightness)
+local function plan_lane(tLane, uiMaxSteps, dNeeded)
+	if tLane == nil or tLane.dBrightness < dDARK_BRIGHTNESS then
+		return nil
+	end
+	local dBrightness = tLane.dBrightness
+	if tLane.fSaturated == true then
+		dBrightness = dBrightness * 4
+	end
+
+	-- the highest gain which does not saturate the ADC in any integration time
+	local ucGain = 0
+	for uiGain = #auiGAIN_FACTORS, 1, -1 do
+		if dBrightness * auiGAIN_FACTORS[uiGain] <= dHEADROOM * uiCOUNTS_PER_STEP then
+			ucGain = uiGain - 1
+			break
+		end
+	end
+	local dCountsPerStep = dBrightness * auiGAIN_FACTORS[ucGain + 1]
+
+	-- the shortest integration time with the needed counts, but not more than the budget and the 16 bit registers allow
+	local uiSteps = math.max(math.ceil(dNeeded / dCountsPerStep), 1)
+	uiSteps = math.min(uiSteps, uiMaxSteps, math.max(math.floor(dHEADROOM * uiMAX_COUNTS / dCountsPerStep), 1))
+
+	return ucGain, uiSteps, dCountsPerStep * uiSteps
+end
+
+-- plans all lanes for a number of samples and a maximum number of integration steps
+-- With fCommon all sensors of a device get the gain of the brightest lane and one integration time, this needs only
+-- one write per register and device instead of one write per changed sensor.
+-- returns the plan with the settings, the estimated time in ms and the quality (the lowest part of the minimum counts)
+-- uiSteps of the plan are the integration steps of the slowest lane
+function Exposure_plan:planSamples(tColorControl, uiSamples, uiMaxSteps, uiMinCounts, fCommon)
+	local atSettings = {}
+	local uiConversionSteps = 1
+	local uiWrites = 0
+	local dQuality = math.huge
+	local dNeeded = uiMinCounts / uiSamples
+
+	for devIndex = 0, tColorControl.numberOfDevices - 1 do
+		local atLanes = self.atDevices[tColorControl.tStrSerials[devIndex + 1]] or {}
+		local atShadow = tColorControl.atShadow[devIndex] or {}
+		local atPlanned = {}
+		for uiLane = 1, 16 do
+			local ucGain, uiSteps, dCounts = plan_lane(atLanes[uiLane], uiMaxSteps, dNeeded)
+			if ucGain ~= nil then
+				atPlanned[uiLane] = {ucGain = ucGain, uiSteps = uiSteps, dCounts = dCounts}
+			end
+		end
+
+		if fCommon == true then
+			-- the lowest gain of all lanes, then the longest integration which none of the lanes saturates
+			local ucGain = nil
+			for _, tPlanned in pairs(atPlanned) do
+				ucGain = math.min(ucGain or tPlanned.ucGain, tPlanned.ucGain)
+			end
+			if ucGain ~= nil then
+				local uiSteps = 1
+				local uiLimit = uiMaxSteps
+				for _, tPlanned in pairs(atPlanned) do
+					local dCountsPerStep = tPlanned.dCounts / tPlanned.uiSteps / auiGAIN_FACTORS[tPlanned.ucGain + 1]
+					dCountsPerStep = dCountsPerStep * auiGAIN_FACTORS[ucGain + 1]
+					uiSteps = math.max(uiSteps, math.ceil(dNeeded / dCountsPerStep))
+					uiLimit = math.min(uiLimit, math.max(math.floor(dHEADROOM * uiMAX_COUNTS / dCountsPerStep), 1))
+					tPlanned.dCountsPerStep = dCountsPerStep
+				end
+				uiSteps = math.min(uiSteps, uiLimit)
+				for uiLane = 1, 16 do
+					local tPlanned = atPlanned[uiLane]
+					if tPlanned == nil then
+						atPlanned[uiLane] = {ucGain = ucGain, uiSteps = uiSteps}
+					else
+						atPlanned[uiLane] = {ucGain = ucGain, uiSteps = uiSteps, dCounts = tPlanned.dCountsPerStep * uiSteps}
+					end
+				end
+			end
+		end
+
+		local atDeviceSettings = {}
+		local atChanged = {gain = {}, integration = {}}
+		for uiLane = 1, 16 do
+			local tShadow = atShadow[uiLane] or {}
+			local tPlanned = atPlanned[uiLane]
+			local ucGain, uiSteps
+			if tPlanned == nil then
+				-- a dark or unknown lane keeps its gain, only its integration time is limited by the budget
+				ucGain = tShadow.gain
+				uiSteps = math.min(256 - (tShadow.integration or 0), uiMaxSteps)
+			else
+				ucGain = tPlanned.ucGain
+				uiSteps = tPlanned.uiSteps
+				if tPlanned.dCounts ~= nil then
+					dQuality = math.min(dQuality, tPlanned.dCounts * uiSamples / uiMinCounts)
+				end
+			end
+			local tSettings = {gain = ucGain, integration = 256 - uiSteps}
+			atDeviceSettings[tostring(uiLane)] = tSettings
+			uiConversionSteps = math.max(uiConversionSteps, uiSteps)
+			for strKey in pairs(atChanged) do
+				if tSettings[strKey] ~= nil and tSettings[strKey] ~= tShadow[strKey] then
+					atChanged[strKey][tSettings[strKey]] = (atChanged[strKey][tSettings[strKey]] or 0) + 1
+				end
+			end
+		end
+		atSettings[tostring(devIndex)] = atDeviceSettings
+
+		-- applySettings writes a value common to all sensors at once, other changes sensor by sensor
+		for _, atValues in pairs(atChanged) do
+			local uiValues = 0
+			local uiChanged = 0
+			for _, uiCount in pairs(atValues) do
+				uiValues = uiValues + 1
+				uiChanged = uiChanged + uiCount
+			end
+			if uiValues == 1 and uiChanged == 16 then
+				uiWrites = uiWrites + 1
+			else
+				uiWrites = uiWrites + uiChanged
+			end
+		end
+	end
+
+	-- a write costs about one round trip, after it the conversion which is running has mixed settings and is skipped
+	local dReadTime = self:getReadTime() * tColorControl.numberOfDevices
+	local uiConversion = get_conversion_time(uiConversionSteps) + 1
+	local uiConversions = uiSamples + ((uiWrites > 0) and 1 or 0)
+	local dTime = uiWrites * self:getReadTime() + uiConversions * uiConversion + uiSamples * dReadTime
+
+	return {
+		atSettings = atSettings,
+		uiSamples = uiSamples,
+		uiSteps = uiConversionSteps,
+		uiWrites = uiWrites,
+		uiConversion = uiConversion,
+		uiFirstWait = uiConversion * (uiConversions - uiSamples + 1),
+		dEstimatedTime = dTime,
+		-- lanes without a brightness do not limit the quality
+		dQuality = (dQuality == math.huge) and 1 or dQuality
+	}
+end
+
+-- returns the better one of two plans: the faster one if both reach the minimum quality, else the one with the better
+-- quality
+local function select_plan(tBest, tPlan)
+	if tPlan == nil then
+		return tBest
+	elseif tBest == nil then
+		return tPlan
+	elseif tPlan.dQuality >= 1 and tBest.dQuality >= 1 then
+		return (tPlan.dEstimatedTime < tBest.dEstimatedTime) and tPlan or tBest
+	end
+	return (tPlan.dQuality > tBest.dQuality) and tPlan or tBest
+end
+
+--- plans a measurement of the opened devices of a Color_control which takes at most uiDeadline ms
+-- uiMinCounts is the minimum sum of the clear counts of each lane over all samples.
+-- returns the plan or nil and an error message if even one sample with the shortest integration does not fit. The plan
+-- has atSettings (see Color_control:applySettings), uiSamples, uiConversion (wait between two samples in ms), uiFirstWait
+-- (wait before the first sample in ms), uiWrites, dEstimatedTime (ms) and dQuality (at least 1 if the minimum was reached).
+function Exposure_plan:plan(tColorControl, uiDeadline, uiMinCounts)
+	local tBest = nil
+	for uiSamples = 1, self.uiMaxSamples do
+		-- the longest integration which fits, recalculated if the writes of the plan need a part of the budget
+		local dBudget = uiDeadline - uiSamples * self:getReadTime() * tColorControl.numberOfDevices
+		-- the settings of each lane or the fewer writes of common settings
+		for _, fCommon in ipairs({false, true}) do
+			local uiMaxSteps = math.min(math.floor(dBudget / uiSamples / 2.4) - 1, 256)
+			local tPlan = nil
+			while uiMaxSteps >= 1 do
+				tPlan = self:planSamples(tColorControl, uiSamples, uiMaxSteps, uiMinCounts, fCommon)
+				if tPlan.dEstimatedTime <= uiDeadline then
+					break
+				end
+				-- shorten the slowest lane by the missing time, each step is 2.4 ms for each conversion
+				local dMissing = tPlan.dEstimatedTime - uiDeadline
+				local uiConversions = uiSamples + ((tPlan.uiWrites > 0) and 1 or 0)
+				uiMaxSteps = tPlan.uiSteps - math.max(math.ceil(dMissing / (2.4 * uiConversions)), 1)
+				tPlan = nil
+			end
+			tBest = select_plan(tBest, tPlan)
+		end
+	end
+
+	if tBest == nil then
+		return nil, string.format("A measurement does not fit into %d ms", uiDeadline)
+	end
+	return tBest
+end
+
+return Exposure_plan
@@ -0,0 +1,1016 @@
+-- LuaJIT FFI binding of the led_analyzer library.
+-- The binding calls the plain C interface of the led_analyzer module (led_analyzer_api.h) without SWIG. It provides the
+-- same functions as the SWIG module, so color_control and color_conversions can use either of them. Arrays are FFI
+-- cdata (0-based like the SWIG arrays), they are freed by the garbage collector and delete_* does nothing.
+--
+-- The module raises an error if it is not running under LuaJIT or if the library does not provide the expected
+-- interface version. Load it with pcall and fall back to the SWIG module in this case.
+
+local ffi = require "ffi"
+local bit = require "bit"
+
+-- This must be the same as in led_analyzer_api.h.
+local LED_ANALYZER_API_VERSION = 8
+
+ffi.cdef [[
+	typedef struct COLOR_SPACES_STRUCT
+	{
+		unsigned int uiLanes;
+		unsigned char* aucValid;
+		double* adLux;
+		double* adCCT;
+		double* adClearRatio;
+		double* adR_n;
+		double* adG_n;
+		double* adB_n;
+		double* adX;
+		double* adY;
+		double* adZ;
+		double* adx;
+		double* ady;
+		double* adWavelength;
+		double* adSaturation;
+		double* adH;
+		double* adS;
+		double* adV;
+	} COLOR_SPACES_T;
+
+	typedef struct SAMPLE_BUFFER_STRUCT
+	{
+		unsigned int uiDevices;
+		unsigned int uiValidDevices;
+		unsigned long ulSequence;
+		unsigned short* ausClear;
+		unsigned short* ausRed;
+		unsigned short* ausGreen;
+		unsigned short* ausBlue;
+		unsigned char* aucIntegrationtime;
+		unsigned char* aucGain;
+		int* aiResults;
+	} SAMPLE_BUFFER_T;
+
+	int  led_analyzer_api_version(void);
+
+	int  scan_devices(char** asSerial, unsigned int uiLength);
+	int  connect_to_devices(void** apHandles, int apHlength, char** asLength);
+	int  init_sensors(void** apHandles, int devIndex);
+	int  get_number_of_handles(void ** apHandles);
+	int  get_number_of_serials(char** asSerial);
+	int  swap_up(char** asSerial, char* curSerial);
+	int  swap_down(char** asSerial, char* curSerial);
+	void free_devices(void** apHandles);
+	void wait4Conversion(unsigned int uiWaitTime);
+
+	int  set_gain(void** apHandles, int devIndex, unsigned char gain);
+	int  set_gain_x(void** apHandles, int devIndex, unsigned int uiX, unsigned char gain);
+	int  get_gain(void** apHandles, int devIndex, unsigned char* aucGains);
+	int  set_intTime(void** apHandles, int devIndex, unsigned char integrationtime);
+	int  set_intTime_x(void** apHandles, int devIndex, unsigned int uiX, unsigned char integrationtime);
+	int  get_intTime(void** apHandles, int devIndex, unsigned char* aucIntTimeSettings);
+
+	int  read_colors(void** apHandles, int devIndex, unsigned short *ausClear, unsigned short* ausRed,
+	     unsigned short *ausGreen, unsigned short* ausBlue,
+	     unsigned char *aucIntegrationtime, unsigned char* aucGain);
+	int  read_colors_all(void** apHandles, unsigned short* ausClear, unsigned short* ausRed,
+	     unsigned short* ausGreen, unsigned short* ausBlue,
+	     unsigned char* aucIntegrationtime, unsigned char* aucGain, int* aiResults);
+	int  read_colors_hdr(void** apHandles, int devIndex, unsigned char ucIntTimeShort, unsigned char ucGainShort,
+	     unsigned char ucIntTimeLong, unsigned char ucGainLong,
+	     unsigned short *ausClear, unsigned short* ausRed, unsigned short *ausGreen, unsigned short* ausBlue,
+	     unsigned char *aucIntegrationtime, unsigned char* aucGain);
+	int  read_colors_oversampled(void** apHandles, int devIndex, unsigned int uiSamples,
+	     float* afMean, float* afVariance, unsigned short* ausMin, unsigned short* ausMax, unsigned short* ausMedian,
+	     unsigned char* aucIntegrationtime, unsigned char* aucGain);
+	int  read_clear_burst(void** apHandles, int devIndex, unsigned int uiSamples, unsigned short* ausClear, unsigned int* auiTimestamps);
+	int  analyze_blink(unsigned short* ausClear, unsigned int* auiTimestamps, unsigned int uiSamples,
+	     float* afPeriod_ms, float* afDutyCycle, unsigned short* ausOnLevel, unsigned short* ausOffLevel);
+
+	int  read_colors_window(void** apHandles, int devIndex, unsigned int uiWindow, unsigned short* ausClear, unsigned short* ausRed,
+	     unsigned short* ausGreen, unsigned short* ausBlue,
+	     unsigned char* aucIntegrationtime, unsigned char* aucGain);
+
+	int  connect_to_devices_lanes(void** apHandles, int apHlength, char** asSerial, const unsigned short* ausLanes);
+
+	int  probe_sensors(void** apHandles, int devIndex);
+
+	SAMPLE_BUFFER_T* sample_buffer_new (unsigned int uiDevices);
+	void             sample_buffer_free(SAMPLE_BUFFER_T* ptBuffer);
+	int              sample_buffer_read(void** apHandles, SAMPLE_BUFFER_T* ptBuffer);
+	int              sample_buffer_read_timed(void** apHandles, SAMPLE_BUFFER_T* ptBuffer, unsigned long* pulTime_us);
+
+	typedef struct ASYNC_MEASUREMENT_STRUCT ASYNC_MEASUREMENT_T;
+	ASYNC_MEASUREMENT_T* async_measurement_new     (void);
+	void                 async_measurement_free    (ASYNC_MEASUREMENT_T* ptAsync);
+	int                  async_measurement_start   (ASYNC_MEASUREMENT_T* ptAsync, void** apHandles, SAMPLE_BUFFER_T* ptBuffer, unsigned int uiWaitTime);
+	int                  async_measurement_poll    (ASYNC_MEASUREMENT_T* ptAsync);
+	int                  async_measurement_complete(ASYNC_MEASUREMENT_T* ptAsync);
+	int                  async_measurement_get_fd  (ASYNC_MEASUREMENT_T* ptAsync);
+
+	unsigned long        async_measurement_get_read_time(ASYNC_MEASUREMENT_T* ptAsync);
+
+	typedef struct DARK_OFFSET_STRUCT
+	{
+		unsigned int uiSettings;
+		unsigned char aucIndex[4][256];
+		unsigned short ausOffsets[64][64];
+	} DARK_OFFSET_T;
+	DARK_OFFSET_T*        dark_offset_new   (void);
+	void                  dark_offset_free  (DARK_OFFSET_T* ptOffsets);
+	int                   dark_offset_set   (DARK_OFFSET_T* ptOffsets, unsigned char ucGain, unsigned char ucIntegrationtime,
+	                                         const unsigned short* ausOffsets);
+	const unsigned short* dark_offset_get   (const DARK_OFFSET_T* ptOffsets, unsigned char ucGain, unsigned char ucIntegrationtime);
+	int                   dark_offset_attach(const void* pvDevice, const DARK_OFFSET_T* ptOffsets);
+
+	typedef struct TEST_PLAN_LANE_STRUCT
+	{
+		float fNm;
+		float fTolNm;
+		float fSat;
+		float fTolSat;
+		float fLux;
+		float fTolLux;
+		unsigned char ucFlags;
+		unsigned char ucGain;
+		unsigned char ucIntegrationtime;
+		unsigned char ucReserved;
+	} TEST_PLAN_LANE_T;
+	typedef struct TEST_PLAN_STRUCT
+	{
+		unsigned int uiSteps;
+		unsigned int uiDevices;
+		TEST_PLAN_LANE_T* atLanes;
+	} TEST_PLAN_T;
+	typedef struct TEST_PLAN_ESTIMATE_STRUCT TEST_PLAN_ESTIMATE_T;
+	typedef struct TEST_PLAN_SEQUENTIAL_STRUCT
+	{
+		unsigned int uiLanes;
+		unsigned long ulSamples;
+		TEST_PLAN_ESTIMATE_T* atEstimates;
+		COLOR_SPACES_T* ptColorSpaces;
+	} TEST_PLAN_SEQUENTIAL_T;
+	TEST_PLAN_T*            test_plan_new              (unsigned int uiSteps, unsigned int uiDevices);
+	void                    test_plan_free             (TEST_PLAN_T* ptPlan);
+	TEST_PLAN_LANE_T*       test_plan_get_lane         (TEST_PLAN_T* ptPlan, unsigned int uiStep, unsigned int uiDevice, unsigned int uiLane);
+	TEST_PLAN_SEQUENTIAL_T* test_plan_sequential_new   (unsigned int uiLanes);
+	void                    test_plan_sequential_free  (TEST_PLAN_SEQUENTIAL_T* ptSequential);
+	void                    test_plan_sequential_reset (TEST_PLAN_SEQUENTIAL_T* ptSequential);
+	void                    test_plan_sequential_add   (TEST_PLAN_SEQUENTIAL_T* ptSequential, const unsigned short* ausClear,
+	                                                    const unsigned short* ausRed, const unsigned short* ausGreen,
+	                                                    const unsigned short* ausBlue, const unsigned char* aucIntegrationtime,
+	                                                    const unsigned char* aucGain);
+	unsigned int            test_plan_sequential_decide(const TEST_PLAN_SEQUENTIAL_T* ptSequential, const TEST_PLAN_T* ptPlan,
+	                                                    unsigned int uiStep, unsigned int uiDevice, unsigned int uiFirstLane,
+	                                                    int fLuxCheck, double dZ, unsigned int* puiTested);
+	void                    test_plan_sequential_mean  (const TEST_PLAN_SEQUENTIAL_T* ptSequential, unsigned short* ausClear,
+	                                                    unsigned short* ausRed, unsigned short* ausGreen, unsigned short* ausBlue);
+
+	COLOR_SPACES_T* color_spaces_new      (unsigned int uiLanes);
+	void            color_spaces_free     (COLOR_SPACES_T* ptColorSpaces);
+	void            color_spaces_calculate(COLOR_SPACES_T* ptColorSpaces, const unsigned short* ausClear, const unsigned short* ausRed,
+	                                       const unsigned short* ausGreen, const unsigned short* ausBlue,
+	                                       const unsigned char* aucIntegrationtime, const unsigned char* aucGain);
+	int             color_Yxy2wavelength  (double dx, double dy, double* pdWavelength, double* pdSaturation);
+	int             color_Yxy2wavelength_interpolated(double dx, double dy, double* pdWavelength, double* pdSaturation);
+]]
+
+-- The FFI binding uses the same library as the SWIG module.
+local strPath = package.searchpath("led_analyzer", package.cpath)
+if strPath == nil then
+	error("led_analyzer_ffi: the led_analyzer library was not found in package.cpath")
+end
+local C = ffi.load(strPath)
+
+local iVersion = C.led_analyzer_api_version()
+if iVersion ~= LED_ANALYZER_API_VERSION then
+	error(
+		string.format(
+			"led_analyzer_ffi: the library has interface version %d, but version %d is needed",
+			iVersion,
+			LED_ANALYZER_API_VERSION
+		)
+	)
+end
+
+local led_analyzer = {}
+led_analyzer.C = C
+led_analyzer.ffi = true
+
+---------------------------------------------------------------------------------------------------------------------
+-- Arrays, they have the same names as the carrays of the SWIG module.
+
+-- serial numbers written from Lua must stay alive as long as the array, they are anchored here
+local atStringAnchors = setmetatable({}, {__mode = "k"})
+
+local function add_array(strName, strType)
+	local tVla = ffi.typeof(strType .. "[?]")
+
+	led_analyzer["new_" .. strName] = function(uiLength)
+		return tVla(uiLength)
+	end
+	led_analyzer["delete_" .. strName] = function()
+	end
+	led_analyzer[strName .. "_getitem"] = function(aArray, uiIndex)
+		return aArray[uiIndex]
+	end
+	led_analyzer[strName .. "_setitem"] = function(aArray, uiIndex, tValue)
+		aArray[uiIndex] = tValue
+	end
+end
+
+add_array("ushort", "unsigned short")
+add_array("ulong", "unsigned long")
+add_array("uint", "unsigned int")
+add_array("integer", "int")
+add_array("apvoid", "void*")
+add_array("puchar", "unsigned char")
+add_array("afloat", "float")
+add_array("astring", "char*")
+
+function led_analyzer.astring_getitem(asArray, uiIndex)
+	local pcString = asArray[uiIndex]
+	if pcString == nil then
+		return nil
+	end
+	return ffi.string(pcString)
+end
+
+function led_analyzer.astring_setitem(asArray, uiIndex, strValue)
+	local atAnchors = atStringAnchors[asArray]
+	if atAnchors == nil then
+		atAnchors = {}
+		atStringAnchors[asArray] = atAnchors
+	end
+
+	if strValue == nil then
+		asArray[uiIndex] = nil
+		atAnchors[uiIndex] = nil
+	else
+		local pcString = ffi.new("char[?]", #strValue + 1, strValue)
+		asArray[uiIndex] = pcString
+		atAnchors[uiIndex] = pcString
+	end
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Plain functions, they are called directly.
+
+local astrFunctions = {
+	"scan_devices",
+	"connect_to_devices",
+	"connect_to_devices_lanes",
+	"init_sensors",
+	"probe_sensors",
+	"get_number_of_handles",
+	"get_number_of_serials",
+	"free_devices",
+	"wait4Conversion",
+	"set_gain",
+	"set_gain_x",
+	"get_gain",
+	"set_intTime",
+	"set_intTime_x",
+	"get_intTime",
+	"read_colors",
+	"read_colors_all",
+	"read_colors_hdr",
+	"read_colors_oversampled",
+	"read_clear_burst",
+	"read_colors_window",
+	"analyze_blink"
+}
+for _, strName in ipairs(astrFunctions) do
+	led_analyzer[strName] = C[strName]
+end
+
+-- the register windows of read_colors_window, the SWIG module has them from led_analyzer.h
+led_analyzer.READ_WINDOW_CLEAR = 0
+led_analyzer.READ_WINDOW_STATUS_CLEAR = 1
+led_analyzer.READ_WINDOW_RGB = 2
+led_analyzer.READ_WINDOW_FULL = 3
+led_analyzer.READ_WINDOW_KEEP_SETTINGS = 0x100
+
+-- the populated sensors of connect_to_devices_lanes
+led_analyzer.LANES_ALL = 0xffff
+led_analyzer.LANES_CHANNEL_A = 0x00ff
+led_analyzer.LANES_CHANNEL_B = 0xff00
+
+-- the serial is passed as a Lua string, the C functions only read it
+function led_analyzer.swap_up(asSerials, strSerial)
+	return C.swap_up(asSerials, ffi.cast("char*", strSerial))
+end
+
+function led_analyzer.swap_down(asSerials, strSerial)
+	return C.swap_down(asSerials, ffi.cast("char*", strSerial))
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Views, they have the same interface as the views of the SWIG module: 1-based, read-only, #view is the length.
+-- A view is a userdata, LuaJIT uses __len only for userdata and cdata. The metamethods of a view keep the array alive.
+-- If the array belongs to a sample buffer, they keep the buffer alive and raise an error after the buffer was freed.
+
+local function add_view(strType)
+	local fnType = function()
+		return strType
+	end
+
+	-- p is the array, tBuffer is the sample buffer which owns the memory of p or nil
+	return function(p, uiLength, tBuffer)
+		local function check()
+			if tBuffer ~= nil and tBuffer.ptBuffer == nil then
+				error("the buffer of the view was already freed", 3)
+			end
+		end
+
+		local atMethods = {}
+		atMethods.get = function(_, uiIndex)
+			check()
+			if uiIndex >= 1 and uiIndex <= uiLength and uiIndex % 1 == 0 then
+				return p[uiIndex - 1]
+			end
+			return nil
+		end
+		atMethods.length = function()
+			check()
+			return uiLength
+		end
+		atMethods.type = fnType
+		atMethods.totable = function()
+			check()
+			local atValues = {}
+			for uiIndex = 1, uiLength do
+				atValues[uiIndex] = p[uiIndex - 1]
+			end
+			return atValues
+		end
+
+		local tView = newproxy(true)
+		local tMetatable = getmetatable(tView)
+		tMetatable.__index = function(_, tKey)
+			if type(tKey) == "number" then
+				return atMethods.get(nil, tKey)
+			end
+			return atMethods[tKey]
+		end
+		tMetatable.__newindex = function()
+			error("views on led_analyzer buffers are read-only")
+		end
+		tMetatable.__len = atMethods.length
+		return tView
+	end
+end
+
+local tViewUshort = add_view("ushort")
+local tViewUchar = add_view("uchar")
+local tViewInt = add_view("int")
+local tViewUint = add_view("uint")
+local tViewFloat = add_view("float")
+
+function led_analyzer.view_ushort(ausArray, uiLength)
+	return tViewUshort(ausArray, uiLength)
+end
+
+function led_analyzer.view_puchar(aucArray, uiLength)
+	return tViewUchar(aucArray, uiLength)
+end
+
+function led_analyzer.view_uint(auiArray, uiLength)
+	return tViewUint(auiArray, uiLength)
+end
+
+function led_analyzer.view_afloat(afArray, uiLength)
+	return tViewFloat(afArray, uiLength)
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Sample buffers. The views point into the C buffer and keep the buffer alive, they raise an error after free.
+
+local Sample_buffer = {}
+Sample_buffer.__index = Sample_buffer
+
+-- gets the C buffer of a sample buffer, like the SWIG module this raises an error after free
+local function check_sample_buffer(tBuffer)
+	local ptBuffer = tBuffer.ptBuffer
+	if ptBuffer == nil then
+		error("the sample buffer was already freed", 3)
+	end
+	return ptBuffer
+end
+
+function Sample_buffer:devices()
+	local ptBuffer = check_sample_buffer(self)
+	return ptBuffer.uiValidDevices, ptBuffer.uiDevices
+end
+
+function Sample_buffer:sequence()
+	return tonumber(check_sample_buffer(self).ulSequence)
+end
+
+function Sample_buffer:lane(devIndex, uiLane)
+	local ptBuffer = check_sample_buffer(self)
+	if devIndex < 0 or devIndex >= ptBuffer.uiDevices or uiLane < 0 or uiLane >= 16 then
+		error(string.format("device %d lane %d is out of range", devIndex, uiLane))
+	end
+
+	local uiIndex = devIndex * 16 + uiLane
+	return ptBuffer.ausClear[uiIndex], ptBuffer.ausRed[uiIndex], ptBuffer.ausGreen[uiIndex], ptBuffer.ausBlue[uiIndex],
+		ptBuffer.aucGain[uiIndex], ptBuffer.aucIntegrationtime[uiIndex]
+end
+
+function Sample_buffer:result(devIndex)
+	local ptBuffer = check_sample_buffer(self)
+	if devIndex < 0 or devIndex >= ptBuffer.uiDevices then
+		error(string.format("device %d is out of range", devIndex))
+	end
+	return ptBuffer.aiResults[devIndex]
+end
+
+function Sample_buffer:free()
+	if self.ptBuffer ~= nil then
+		C.sample_buffer_free(ffi.gc(self.ptBuffer, nil))
+		self.ptBuffer = nil
+	end
+end
+
+function led_analyzer.new_sample_buffer(uiDevices)
+	if uiDevices < 1 or uiDevices > 128 then
+		error("new_sample_buffer: the number of devices must be between 1 and 128")
+	end
+
+	local ptBuffer = C.sample_buffer_new(uiDevices)
+	if ptBuffer == nil then
+		error("new_sample_buffer: out of memory")
+	end
+	ptBuffer = ffi.gc(ptBuffer, C.sample_buffer_free)
+
+	local uiLanes = uiDevices * 16
+	local tBuffer = setmetatable({ ptBuffer = ptBuffer }, Sample_buffer)
+	tBuffer.clear = tViewUshort(ptBuffer.ausClear, uiLanes, tBuffer)
+	tBuffer.red = tViewUshort(ptBuffer.ausRed, uiLanes, tBuffer)
+	tBuffer.green = tViewUshort(ptBuffer.ausGreen, uiLanes, tBuffer)
+	tBuffer.blue = tViewUshort(ptBuffer.ausBlue, uiLanes, tBuffer)
+	tBuffer.gain = tViewUchar(ptBuffer.aucGain, uiLanes, tBuffer)
+	tBuffer.intTime = tViewUchar(ptBuffer.aucIntegrationtime, uiLanes, tBuffer)
+	tBuffer.results = tViewInt(ptBuffer.aiResults, uiDevices, tBuffer)
+	return tBuffer
+end
+
+-- the second result is the time of the reading in microseconds
+local aulReadTime = ffi.new("unsigned long[1]")
+function led_analyzer.read_all_buffer(apHandles, tBuffer)
+	local iDevices = C.sample_buffer_read_timed(apHandles, check_sample_buffer(tBuffer), aulReadTime)
+	return iDevices, tonumber(aulReadTime[0])
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Asynchronous measurements. The measurement keeps the handles and the buffer until it is completed.
+-- Only one measurement can run at a time, the functions which access the devices wait for it in the library.
+
+-- must be the same as ASYNC_MEASUREMENT_STATE_T in async_measurement.h
+local ASYNC_MEASUREMENT_IDLE = 0
+local ASYNC_MEASUREMENT_DONE = 2
+
+local Async = {}
+Async.__index = Async
+
+function Async:poll()
+	local iState = C.async_measurement_poll(self.ptAsync)
+	if iState == ASYNC_MEASUREMENT_IDLE then
+		return nil
+	end
+	return iState == ASYNC_MEASUREMENT_DONE
+end
+
+function Async:complete()
+	local iDevices = C.async_measurement_complete(self.ptAsync)
+	self.apHandles = nil
+	self.tBuffer = nil
+	if iDevices < 0 then
+		return nil, "no measurement was started"
+	end
+	return iDevices, tonumber(C.async_measurement_get_read_time(self.ptAsync))
+end
+
+function Async:fd()
+	local iFd = C.async_measurement_get_fd(self.ptAsync)
+	if iFd < 0 then
+		return nil
+	end
+	return iFd
+end
+
+function Async:free()
+	if self.ptAsync ~= nil then
+		C.async_measurement_free(ffi.gc(self.ptAsync, nil))
+		self.ptAsync = nil
+		self.apHandles = nil
+		self.tBuffer = nil
+	end
+end
+
+function led_analyzer.new_async()
+	local ptAsync = C.async_measurement_new()
+	if ptAsync == nil then
+		error("new_async: out of memory")
+	end
+	return setmetatable({ptAsync = ffi.gc(ptAsync, C.async_measurement_free)}, Async)
+end
+
+function led_analyzer.start_async(tAsync, apHandles, tBuffer, uiWaitTime)
+	uiWaitTime = uiWaitTime or 0
+	if uiWaitTime < 0 or uiWaitTime > 60000 then
+		error("start_async: the wait time must be between 0 and 60000 ms")
+	end
+	if C.async_measurement_start(tAsync.ptAsync, apHandles, check_sample_buffer(tBuffer), uiWaitTime) ~= 0 then
+		return nil, "the last measurement was not completed, another one is running or the thread could not be started"
+	end
+	tAsync.apHandles = apHandles
+	tAsync.tBuffer = tBuffer
+	return true
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Dark offsets, see lua/dark_offset.lua. They have the same methods as the offsets of the SWIG module.
+
+-- must be the same as in dark_offset.h
+local DARK_OFFSET_GAINS = 4
+local DARK_OFFSET_MAX_SETTINGS = 64
+
+local Dark_offset = {}
+Dark_offset.__index = Dark_offset
+
+-- gets the C offsets, like the SWIG module this raises an error after free
+local function check_dark_offset(tOffsets)
+	local ptOffsets = tOffsets.ptOffsets
+	if ptOffsets == nil then
+		error("the dark offsets were already freed", 3)
+	end
+	return ptOffsets
+end
+
+local function check_setting(uiGain, uiIntegrationtime)
+	if uiGain < 0 or uiGain >= DARK_OFFSET_GAINS then
+		error(string.format("invalid gain: %d", uiGain), 3)
+	end
+	if uiIntegrationtime < 0 or uiIntegrationtime > 255 then
+		error(string.format("invalid integration time: %d", uiIntegrationtime), 3)
+	end
+end
+
+function Dark_offset:set(uiGain, uiIntegrationtime, auiOffsets)
+	local ptOffsets = check_dark_offset(self)
+	check_setting(uiGain, uiIntegrationtime)
+	local ausOffsets = ffi.new("unsigned short[64]")
+	for i = 0, 63 do
+		local dOffset = tonumber(auiOffsets[i + 1]) or 0
+		ausOffsets[i] = (dOffset <= 0) and 0 or (dOffset >= 65535) and 65535 or math.floor(dOffset + 0.5)
+	end
+
+	if C.dark_offset_set(ptOffsets, uiGain, uiIntegrationtime, ausOffsets) ~= 0 then
+		return nil, string.format("no more than %d settings can be calibrated", DARK_OFFSET_MAX_SETTINGS)
+	end
+	return true
+end
+
+function Dark_offset:get(uiGain, uiIntegrationtime)
+	local ptOffsets = check_dark_offset(self)
+	check_setting(uiGain, uiIntegrationtime)
+	local ausOffsets = C.dark_offset_get(ptOffsets, uiGain, uiIntegrationtime)
+	if ausOffsets == nil then
+		return nil
+	end
+
+	local auiOffsets = {}
+	for i = 0, 63 do
+		auiOffsets[i + 1] = ausOffsets[i]
+	end
+	return auiOffsets
+end
+
+function Dark_offset:settings()
+	local ptOffsets = check_dark_offset(self)
+	local atSettings = {}
+	for uiGain = 0, DARK_OFFSET_GAINS - 1 do
+		for uiIntegrationtime = 0, 255 do
+			if ptOffsets.aucIndex[uiGain][uiIntegrationtime] ~= 0 then
+				table.insert(atSettings, {gain = uiGain, integration = uiIntegrationtime})
+			end
+		end
+	end
+	return atSettings
+end
+
+function Dark_offset:free()
+	if self.ptOffsets ~= nil then
+		C.dark_offset_free(ffi.gc(self.ptOffsets, nil))
+		self.ptOffsets = nil
+	end
+end
+
+function led_analyzer.new_dark_offset()
+	local ptOffsets = C.dark_offset_new()
+	if ptOffsets == nil then
+		error("new_dark_offset: out of memory")
+	end
+	return setmetatable({ptOffsets = ffi.gc(ptOffsets, C.dark_offset_free)}, Dark_offset)
+end
+
+-- the library attaches a copy of the offsets to the first handle of the device, tOffsets = nil removes them
+function led_analyzer.set_dark_offsets(apHandles, devIndex, tOffsets)
+	if devIndex < 0 or 2 * devIndex >= C.get_number_of_handles(apHandles) then
+		error(string.format("set_dark_offsets: there is no device %d", devIndex))
+	end
+
+	local ptOffsets = nil
+	if tOffsets ~= nil then
+		ptOffsets = check_dark_offset(tOffsets)
+	end
+	local iResult = C.dark_offset_attach(apHandles[2 * devIndex], ptOffsets)
+	if iResult ~= 0 then
+		return nil, (iResult == -2) and "out of memory" or "too many devices with dark offsets"
+	end
+	return true
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Test plans and sequential tests, see lua/test_plan.lua and Color_control:startMeasurementsSequential. They have the
+-- same methods as the plans and tests of the SWIG module, but they can only be used with each other.
+
+-- must be the same as TEST_PLAN_LANE_TESTED in test_plan.h
+local TEST_PLAN_LANE_TESTED = 0x01
+
+local Test_plan = {}
+Test_plan.__index = Test_plan
+
+-- gets the C plan, like the SWIG module this raises an error after free
+local function check_test_plan(tPlan)
+	local ptPlan = type(tPlan) == "table" and getmetatable(tPlan) == Test_plan and tPlan.ptPlan or nil
+	if ptPlan == nil then
+		error("the test plan was already freed or is no test plan of the FFI binding", 3)
+	end
+	return ptPlan
+end
+
+-- gets a field of a test entry, limited to 0..uiMax like get_uint in led_analyzer_lua.c
+local function get_uint(tLane, strKey, uiMax)
+	local dValue = tonumber(tLane[strKey]) or 0
+	return (dValue <= 0) and 0 or (dValue >= uiMax) and uiMax or math.floor(dValue + 0.5)
+end
+
+function Test_plan:set(uiStep, uiDevice, uiLane, tLane)
+	local ptPlan = check_test_plan(self)
+	local ptLane = nil
+	if uiStep >= 0 and uiDevice >= 0 and uiLane >= 0 then
+		ptLane = C.test_plan_get_lane(ptPlan, uiStep, uiDevice, uiLane)
+	end
+	if ptLane == nil then
+		error(string.format("step %d device %d lane %d is out of range", uiStep, uiDevice, uiLane))
+	end
+
+	ffi.fill(ptLane, ffi.sizeof("TEST_PLAN_LANE_T"))
+	if type(tLane) == "table" then
+		ptLane.fNm = tonumber(tLane.nm) or 0
+		ptLane.fTolNm = tonumber(tLane.tol_nm) or 0
+		ptLane.fSat = tonumber(tLane.sat) or 0
+		ptLane.fTolSat = tonumber(tLane.tol_sat) or 0
+		ptLane.fLux = tonumber(tLane.lux) or 0
+		ptLane.fTolLux = tonumber(tLane.tol_lux) or 0
+		ptLane.ucGain = get_uint(tLane, "gain", 255)
+		ptLane.ucIntegrationtime = get_uint(tLane, "integration", 255)
+		ptLane.ucFlags = TEST_PLAN_LANE_TESTED
+	end
+end
+
+function Test_plan:size()
+	local ptPlan = check_test_plan(self)
+	return ptPlan.uiSteps, ptPlan.uiDevices
+end
+
+function Test_plan:free()
+	if self.ptPlan ~= nil then
+		C.test_plan_free(ffi.gc(self.ptPlan, nil))
+		self.ptPlan = nil
+	end
+end
+
+function led_analyzer.new_test_plan(uiSteps, uiDevices)
+	if uiSteps < 1 or uiDevices < 1 then
+		error("new_test_plan: a plan needs at least one step and one device")
+	end
+
+	local ptPlan = C.test_plan_new(uiSteps, uiDevices)
+	if ptPlan == nil then
+		error("new_test_plan: out of memory")
+	end
+	return setmetatable({ptPlan = ffi.gc(ptPlan, C.test_plan_free)}, Test_plan)
+end
+
+local Sequential_test = {}
+Sequential_test.__index = Sequential_test
+
+-- gets the C test, like the SWIG module this raises an error after free
+local function check_sequential_test(tTest)
+	local ptSequential = tTest.ptSequential
+	if ptSequential == nil then
+		error("the sequential test was already freed", 3)
+	end
+	return ptSequential
+end
+
+-- gets the C buffer of a sample buffer with at least the lanes of the test
+local function check_sequential_buffer(tBuffer, ptSequential)
+	local ptBuffer = tBuffer.ptBuffer
+	if ptBuffer == nil then
+		error("the sample buffer was already freed", 3)
+	end
+	if ptBuffer.uiDevices * 16 < ptSequential.uiLanes then
+		error(string.format("the sample buffer has only %d devices", ptBuffer.uiDevices), 3)
+	end
+	return ptBuffer
+end
+
+-- returns the number of set bits
+local function count_bits(uiBits)
+	local uiCount = 0
+	while uiBits ~= 0 do
+		uiBits = bit.band(uiBits, uiBits - 1)
+		uiCount = uiCount + 1
+	end
+	return uiCount
+end
+
+function Sequential_test:add(tBuffer)
+	local ptSequential = check_sequential_test(self)
+	local ptBuffer = check_sequential_buffer(tBuffer, ptSequential)
+	C.test_plan_sequential_add(ptSequential, ptBuffer.ausClear, ptBuffer.ausRed, ptBuffer.ausGreen, ptBuffer.ausBlue,
+		ptBuffer.aucIntegrationtime, ptBuffer.aucGain)
+	return tonumber(ptSequential.ulSamples)
+end
+
+-- returns the number of undecided and tested lanes, the arguments are the same as in the SWIG module
+local auiTested = ffi.new("unsigned int[1]")
+function Sequential_test:decide(tPlan, uiStep, auiPlanDevices, fLuxCheck, dZ)
+	local ptSequential = check_sequential_test(self)
+	local ptPlan = check_test_plan(tPlan)
+	if uiStep < 0 or uiStep >= ptPlan.uiSteps then
+		error(string.format("the plan has no step %d", uiStep))
+	end
+
+	local uiUndecidedLanes = 0
+	local uiTestedLanes = 0
+	for uiDevice = 0, ptSequential.uiLanes / 16 - 1 do
+		local uiPlanDevice = tonumber(auiPlanDevices[uiDevice + 1]) or -1
+		if uiPlanDevice >= 0 then
+			local uiUndecided = C.test_plan_sequential_decide(ptSequential, ptPlan, uiStep, uiPlanDevice, uiDevice * 16,
+				fLuxCheck and 1 or 0, dZ, auiTested)
+			uiUndecidedLanes = uiUndecidedLanes + count_bits(uiUndecided)
+			uiTestedLanes = uiTestedLanes + count_bits(auiTested[0])
+		end
+	end
+	return uiUndecidedLanes, uiTestedLanes
+end
+
+function Sequential_test:mean(tBuffer)
+	local ptSequential = check_sequential_test(self)
+	local ptBuffer = check_sequential_buffer(tBuffer, ptSequential)
+	C.test_plan_sequential_mean(ptSequential, ptBuffer.ausClear, ptBuffer.ausRed, ptBuffer.ausGreen, ptBuffer.ausBlue)
+end
+
+function Sequential_test:samples()
+	return tonumber(check_sequential_test(self).ulSamples)
+end
+
+function Sequential_test:reset()
+	C.test_plan_sequential_reset(check_sequential_test(self))
+end
+
+function Sequential_test:free()
+	if self.ptSequential ~= nil then
+		C.test_plan_sequential_free(ffi.gc(self.ptSequential, nil))
+		self.ptSequential = nil
+	end
+end
+
+function led_analyzer.new_sequential_test(uiDevices)
+	if uiDevices < 1 or uiDevices > 65536 then
+		error(string.format("new_sequential_test: invalid number of devices: %d", uiDevices))
+	end
+
+	local ptSequential = C.test_plan_sequential_new(uiDevices * 16)
+	if ptSequential == nil then
+		error("new_sequential_test: out of memory")
+	end
+	return setmetatable({ptSequential = ffi.gc(ptSequential, C.test_plan_sequential_free)}, Sequential_test)
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Tables, they have the same structure as the tables of the native functions in led_analyzer.i.
+
+-- devices without a serial number get their device index as key
+local function get_serial(asSerials, devIndex)
+	for i = 0, devIndex do
+		if asSerials[i] == nil then
+			return tostring(devIndex)
+		end
+	end
+	return ffi.string(asSerials[devIndex])
+end
+
+-- the status of a lane contains the error flags of the device result, if the lane is marked as failing
+local function lane_status(iResult, uiLane)
+	if iResult < 0 then
+		return iResult
+	elseif bit.band(iResult, bit.lshift(1, uiLane)) ~= 0 then
+		return bit.band(iResult, 0x7fff0000)
+	end
+	return 0
+end
+
+local function color_table(ptColorSpaces, uiFirstLane, uiLanes, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains)
+	local tColorTable = {}
+	for i = 0, uiLanes - 1 do
+		local uiLane = uiFirstLane + i
+		local tLane
+
+		if ptColorSpaces.aucValid[uiLane] == 0 then
+			tLane = {
+				Wavelength = {
+					lux = ptColorSpaces.adLux[uiLane],
+					clear_ratio = ptColorSpaces.adClearRatio[uiLane],
+					nm = 0,
+					sat = 0,
+					cct = 0,
+					r_estimate = 0,
+					g_estimate = 0,
+					b_estimate = 0
+				},
+				RGB_tsc = {clear_tsc = 0, red_tsc = 0, green_tsc = 0, blue_tsc = 0},
+				XYZ = {X = 0, Y = 0, Z = 0},
+				Yxy = {Y = 0, x = 0, y = 0},
+				HSV = {H = 0, S = 0, V = 0}
+			}
+		else
+			tLane = {
+				Wavelength = {
+					lux = ptColorSpaces.adLux[uiLane],
+					clear_ratio = ptColorSpaces.adClearRatio[uiLane],
+					nm = math.floor(ptColorSpaces.adWavelength[uiLane] + 0.5),
+					sat = ptColorSpaces.adSaturation[uiLane] * 100,
+					cct = ptColorSpaces.adCCT[uiLane]
+				},
+				RGB_tsc = {
+					clear = ausClear[uiLane],
+					red = ausRed[uiLane],
+					green = ausGreen[uiLane],
+					blue = ausBlue[uiLane],
+					R_n = ptColorSpaces.adR_n[uiLane],
+					G_n = ptColorSpaces.adG_n[uiLane],
+					B_n = ptColorSpaces.adB_n[uiLane]
+				},
+				XYZ = {X = ptColorSpaces.adX[uiLane], Y = ptColorSpaces.adY[uiLane], Z = ptColorSpaces.adZ[uiLane]},
+				Yxy = {Y = ptColorSpaces.adY[uiLane], x = ptColorSpaces.adx[uiLane], y = ptColorSpaces.ady[uiLane]},
+				HSV = {H = ptColorSpaces.adH[uiLane], S = ptColorSpaces.adS[uiLane], V = ptColorSpaces.adV[uiLane]}
+			}
+		end
+		tLane.Settings = {gain = aucGains[uiLane], intTime = aucIntTimes[uiLane]}
+
+		tColorTable[i + 1] = tLane
+	end
+	return tColorTable
+end
+
+local function new_color_spaces(uiLanes)
+	local ptColorSpaces = C.color_spaces_new(uiLanes)
+	if ptColorSpaces == nil then
+		error("led_analyzer_ffi: out of memory")
+	end
+	return ffi.gc(ptColorSpaces, C.color_spaces_free)
+end
+
+function led_analyzer.aus2colorTable(ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains, uiLength)
+	local ptColorSpaces = new_color_spaces(uiLength)
+	C.color_spaces_calculate(ptColorSpaces, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains)
+	return color_table(ptColorSpaces, 0, uiLength, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains)
+end
+
+local adWavelength = ffi.new("double[2]")
+function led_analyzer.Yxy2wavelength(x, y, fInterpolate)
+	if fInterpolate then
+		C.color_Yxy2wavelength_interpolated(x, y, adWavelength, adWavelength + 1)
+	else
+		C.color_Yxy2wavelength(x, y, adWavelength, adWavelength + 1)
+	end
+	return adWavelength[0], adWavelength[1]
+end
+
+local function read_all(apHandles, asSerials, fColorTables)
+	local iDevices = math.floor(C.get_number_of_handles(apHandles) / 2)
+	local uiLanes = 16 * iDevices
+	local ausReadings = ffi.new("unsigned short[?]", 4 * uiLanes + 1)
+	local aucSettings = ffi.new("unsigned char[?]", 2 * uiLanes + 1)
+	local aiResults = ffi.new("int[?]", iDevices + 1)
+	local ausClear, ausRed, ausGreen, ausBlue = ausReadings, ausReadings + uiLanes, ausReadings + 2 * uiLanes, ausReadings + 3 * uiLanes
+	local aucIntTimes, aucGains = aucSettings, aucSettings + uiLanes
+
+	iDevices = C.read_colors_all(apHandles, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains, aiResults)
+
+	local tData = {}
+	local tResults = {}
+	local ptColorSpaces
+	if fColorTables then
+		ptColorSpaces = new_color_spaces(16 * iDevices)
+		C.color_spaces_calculate(ptColorSpaces, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains)
+	end
+
+	for devIndex = 0, iDevices - 1 do
+		local strSerial = get_serial(asSerials, devIndex)
+		local iResult = aiResults[devIndex]
+		tResults[strSerial] = iResult
+
+		if fColorTables then
+			tData[strSerial] =
+				color_table(ptColorSpaces, devIndex * 16, 16, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains)
+		else
+			local atLanes = {}
+			for i = 0, 15 do
+				local uiLane = devIndex * 16 + i
+				atLanes[i + 1] = {
+					clear = ausClear[uiLane],
+					red = ausRed[uiLane],
+					green = ausGreen[uiLane],
+					blue = ausBlue[uiLane],
+					gain = aucGains[uiLane],
+					intTime = aucIntTimes[uiLane],
+					status = lane_status(iResult, i)
+				}
+			end
+			tData[strSerial] = {result = iResult, lanes = atLanes}
+		end
+	end
+
+	return tData, tResults
+end
+
+function led_analyzer.read_all(apHandles, asSerials)
+	return read_all(apHandles, asSerials, false)
+end
+
+function led_analyzer.read_all_colorTables(apHandles, asSerials)
+	return read_all(apHandles, asSerials, true)
+end
+
+local astrStatisticChannels = {"clear", "red", "green", "blue"}
+local afMean = ffi.new("float[64]")
+local afVariance = ffi.new("float[64]")
+local ausStatistics = ffi.new("unsigned short[192]")
+
+function led_analyzer.read_oversampled(apHandles, devIndex, uiSamples, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains)
+	local ausMin, ausMax, ausMedian = ausStatistics, ausStatistics + 64, ausStatistics + 128
+	local iResult =
+		C.read_colors_oversampled(apHandles, devIndex, uiSamples, afMean, afVariance, ausMin, ausMax, ausMedian, aucIntTimes, aucGains)
+	if iResult ~= 0 then
+		return iResult, nil
+	end
+
+	local atChannels = {ausClear, ausRed, ausGreen, ausBlue}
+	local tStatistics = {}
+	for uiSensor = 0, 15 do
+		local tSensorStatistics = {}
+		for uiChannel = 0, 3 do
+			local uiIndex = uiChannel * 16 + uiSensor
+			local fMean = afMean[uiIndex]
+			tSensorStatistics[astrStatisticChannels[uiChannel + 1]] = {
+				mean = fMean,
+				stddev = math.sqrt(afVariance[uiIndex]),
+				min = ausMin[uiIndex],
+				max = ausMax[uiIndex],
+				median = ausMedian[uiIndex]
+			}
+			atChannels[uiChannel + 1][uiSensor] = math.floor(fMean + 0.5)
+		end
+		tStatistics[uiSensor + 1] = tSensorStatistics
+	end
+	return iResult, tStatistics
+end
+
+function led_analyzer.buffer_colorTables(tBuffer, asSerials)
+	local ptBuffer = check_sample_buffer(tBuffer)
+	local iDevices = ptBuffer.uiValidDevices
+	local ausClear, ausRed, ausGreen, ausBlue = ptBuffer.ausClear, ptBuffer.ausRed, ptBuffer.ausGreen, ptBuffer.ausBlue
+	local aucIntTimes, aucGains = ptBuffer.aucIntegrationtime, ptBuffer.aucGain
+
+	local ptColorSpaces = new_color_spaces(16 * iDevices)
+	C.color_spaces_calculate(ptColorSpaces, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains)
+
+	local tColorTables = {}
+	local tResults = {}
+	for devIndex = 0, iDevices - 1 do
+		local strSerial = get_serial(asSerials, devIndex)
+		tResults[strSerial] = ptBuffer.aiResults[devIndex]
+		tColorTables[strSerial] =
+			color_table(ptColorSpaces, devIndex * 16, 16, ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains)
+	end
+
+	return tColorTables, tResults
+end
+
+return led_analyzer
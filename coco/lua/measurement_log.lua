@@ -0,0 +1,141 @@
+-- Create the measurement_log class.
+-- The log keeps every measured lane in a compact binary form: fixed size records in segment files and a small index
+-- with the range of records and times of each serial number in each segment, see measurement_log.h for the layout.
+-- Writing and reading the log needs the led_analyzer module, the segments are mapped into the memory for the queries.
+local class = require "pl.class"
+
+---
+-- @type measurement_log
+local Measurement_log = class()
+
+-- the default number of records in a segment, this is 4 MiB per segment
+local uiDEFAULT_SEGMENT_RECORDS = 65536
+
+--- init measurement_log
+-- strPrefix is the path of the log files without the extension, e.g. "logs/coco"
+-- uiSegmentRecords is the number of records after which a new segment file is started
+function Measurement_log:_init(strPrefix, uiSegmentRecords)
+	self.strPrefix = strPrefix
+	self.uiSegmentRecords = uiSegmentRecords or uiDEFAULT_SEGMENT_RECORDS
+	self.tLog = nil
+
+	self.led_analyzer = nil
+	local fOk, tModule = pcall(require, "led_analyzer")
+	if fOk == true and tModule.open_measurement_log ~= nil then
+		self.led_analyzer = tModule
+	end
+end
+
+-- returns the path of a segment file, this must be the same as measurement_log_segment_path in measurement_log.c
+function Measurement_log:segmentPath(uiSegment)
+	return string.format("%s_%06d.ccl", self.strPrefix, uiSegment)
+end
+
+--- opens the log for appending, the new records go to a new segment after the existing ones
+-- returns true or nil and an error message
+function Measurement_log:open()
+	if self.led_analyzer == nil then
+		return nil, "the measurement log needs the led_analyzer module"
+	end
+	if self.tLog == nil then
+		local tLog, strError = self.led_analyzer.open_measurement_log(self.strPrefix, self.uiSegmentRecords)
+		if tLog == nil then
+			return nil, strError
+		end
+		self.tLog = tLog
+	end
+	return true
+end
+
+--- appends all lanes of one measurement
+-- tResults are the color tables with the serial numbers as keys or a result frame, tSummary is the optional summary of
+-- the validation (see Color_validation:summarizeCoCo) for the pass/fail flags and the failed checks of the lanes.
+-- uiTime is the time of the measurement in microseconds since 1970, the default is now.
+-- returns the number of records or nil and an error message
+function Measurement_log:append(tResults, tSummary, uiTime)
+	if self.tLog == nil then
+		return nil, "the measurement log is not open"
+	end
+	return self.tLog:append(tResults, tSummary, uiTime)
+end
+
+--- writes the buffered records and the index, returns true or nil and an error message
+function Measurement_log:flush()
+	if self.tLog == nil then
+		return true
+	end
+	return self.tLog:flush()
+end
+
+--- closes the log, returns true if all records and the index were written
+function Measurement_log:close()
+	local fResult = true
+	if self.tLog ~= nil then
+		fResult = self.tLog:close()
+		self.tLog = nil
+	end
+	return fResult
+end
+
+--- returns the records of one serial number from uiFrom to uiTo (microseconds since 1970, both are optional)
+-- The records are tables with uiTime, strSerial, uiLane, uiFlags, gain, intTime, clear, red, green, blue, nm, sat, lux,
+-- uiFailed, iResult and uiMeasurement in the order of their time. Only the segments with matching index entries are
+-- mapped, in them the first record is found with a binary search on the time.
+-- returns the list of records or nil and an error message
+function Measurement_log:query(strSerial, uiFrom, uiTo)
+	if self.led_analyzer == nil then
+		return nil, "the measurement log needs the led_analyzer module"
+	end
+	uiFrom = uiFrom or 0
+	uiTo = uiTo or math.huge
+
+	-- the index on the disk must contain the records which are still buffered
+	if self.tLog ~= nil then
+		self.tLog:flush()
+	end
+	local atIndex, strError = self.led_analyzer.read_measurement_index(self.strPrefix)
+	if atIndex == nil then
+		return nil, strError
+	end
+
+	-- the records in the index are cut after 16 characters
+	local strKey = string.sub(strSerial, 1, 16)
+	local atEntries = {}
+	for _, tEntry in ipairs(atIndex) do
+		if tEntry.strSerial == strKey and tEntry.uiLastTime >= uiFrom and tEntry.uiFirstTime <= uiTo then
+			table.insert(atEntries, tEntry)
+		end
+	end
+	table.sort(
+		atEntries,
+		function(tA, tB)
+			return tA.uiSegment < tB.uiSegment
+		end
+	)
+
+	local atRecords = {}
+	for _, tEntry in ipairs(atEntries) do
+		local tSegment
+		tSegment, strError = self.led_analyzer.open_measurement_segment(self:segmentPath(tEntry.uiSegment))
+		if tSegment == nil then
+			return nil, strError
+		end
+		local uiRecord = math.max(tEntry.uiFirst, tSegment:find(uiFrom))
+		local uiLast = math.min(tEntry.uiLast, tSegment:count())
+		while uiRecord <= uiLast do
+			local tRecord = tSegment:record(uiRecord)
+			if tRecord.uiTime > uiTo then
+				break
+			end
+			if tRecord.strSerial == strKey then
+				table.insert(atRecords, tRecord)
+			end
+			uiRecord = uiRecord + 1
+		end
+		tSegment:close()
+	end
+
+	return atRecords
+end
+
+return Measurement_log
@@ -0,0 +1,425 @@
+-- Create the result_frame class.
+-- A result frame is the binary encoding of the color tables of several devices, see result_frame.h for the layout.
+-- The frames are encoded and decoded in C if the led_analyzer module is available (e.g. on the server). The client
+-- does not need the module, it uses the Lua implementation below (string.pack on Lua 5.3 and later).
+local class = require "pl.class"
+
+local unpack = unpack or table.unpack
+
+---
+-- @type result_frame
+local Result_frame = class()
+
+-- These must be the same as in result_frame.h.
+local RESULT_FRAME_MAGIC = "CoCR"
+local RESULT_FRAME_VERSION = 1
+local RESULT_FRAME_HEADER_SIZE = 8
+local RESULT_FRAME_LANE_SIZE = 68
+local RESULT_FRAME_RAW_SIZE = 8
+local RESULT_FRAME_FLAG_RAW = 0x01
+local RESULT_FRAME_LANE_VALID = 0x01
+
+-- the floats of a lane record in their order
+local astrFloats = {
+	{"Wavelength", "sat"},
+	{"Wavelength", "lux"},
+	{"Wavelength", "cct"},
+	{"Wavelength", "clear_ratio"},
+	{"RGB_tsc", "R_n"},
+	{"RGB_tsc", "G_n"},
+	{"RGB_tsc", "B_n"},
+	{"XYZ", "X"},
+	{"XYZ", "Y"},
+	{"XYZ", "Z"},
+	{"Yxy", "x"},
+	{"Yxy", "y"},
+	{"HSV", "H"},
+	{"HSV", "S"},
+	{"HSV", "V"}
+}
+
+--- init result_frame
+-- fNative selects the C implementation if the led_analyzer module is available, default is true
+function Result_frame:_init(fNative)
+	self.led_analyzer = nil
+	if fNative ~= false then
+		local fOk, tModule = pcall(require, "led_analyzer")
+		if fOk == true and tModule.encode_result_frame ~= nil then
+			self.led_analyzer = tModule
+		end
+	end
+
+	self.RESULT_FRAME_MAGIC = RESULT_FRAME_MAGIC
+	self.RESULT_FRAME_VERSION = RESULT_FRAME_VERSION
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Little endian values. Lua 5.3 and later use string.pack, Lua 5.1 and 5.2 build the bytes with arithmetics.
+
+local pack_u8, pack_u16, pack_u32, pack_f32
+local unpack_u16, unpack_u32, unpack_f32
+
+if string.pack ~= nil then
+	pack_u8 = function(uiValue)
+		return string.pack("<I1", uiValue)
+	end
+	pack_u16 = function(uiValue)
+		return string.pack("<I2", uiValue)
+	end
+	pack_u32 = function(iValue)
+		return string.pack("<i4", iValue)
+	end
+	pack_f32 = function(fValue)
+		return string.pack("<f", fValue)
+	end
+	unpack_u16 = function(strData, uiPos)
+		return (string.unpack("<I2", strData, uiPos))
+	end
+	unpack_u32 = function(strData, uiPos)
+		return (string.unpack("<i4", strData, uiPos))
+	end
+	unpack_f32 = function(strData, uiPos)
+		return (string.unpack("<f", strData, uiPos))
+	end
+else
+	pack_u8 = function(uiValue)
+		return string.char(uiValue)
+	end
+	pack_u16 = function(uiValue)
+		return string.char(uiValue % 256, math.floor(uiValue / 256) % 256)
+	end
+	pack_u32 = function(iValue)
+		if iValue < 0 then
+			iValue = iValue + 4294967296
+		end
+		return string.char(
+			iValue % 256,
+			math.floor(iValue / 256) % 256,
+			math.floor(iValue / 65536) % 256,
+			math.floor(iValue / 16777216) % 256
+		)
+	end
+	-- rounds to the nearest integer, ties to even like the conversion from double to float in C
+	local function round_even(fValue)
+		local fFloor = math.floor(fValue)
+		local fRest = fValue - fFloor
+		if fRest > 0.5 or (fRest == 0.5 and fFloor % 2 == 1) then
+			fFloor = fFloor + 1
+		end
+		return fFloor
+	end
+	-- IEEE 754 single precision
+	pack_f32 = function(fValue)
+		local uiSign = 0
+		local uiExponent, uiMantissa
+
+		if fValue < 0 or (fValue == 0 and 1 / fValue < 0) then
+			uiSign = 0x80
+			fValue = -fValue
+		end
+
+		if fValue ~= fValue then
+			return string.char(0, 0, 0xc0, 0x7f)
+		elseif fValue == 0 then
+			uiExponent, uiMantissa = 0, 0
+		elseif fValue == math.huge then
+			uiExponent, uiMantissa = 0xff, 0
+		else
+			local fFraction, iExponent = math.frexp(fValue)
+			uiExponent = iExponent + 126
+			if uiExponent <= 0 then
+				-- subnormal, a carry into the exponent is still the correct encoding
+				uiMantissa = round_even(fFraction * 2 ^ (23 + uiExponent))
+				uiExponent = 0
+			elseif uiExponent >= 0xff then
+				uiExponent, uiMantissa = 0xff, 0
+			else
+				uiMantissa = round_even((fFraction * 2 - 1) * 8388608)
+				if uiMantissa == 8388608 then
+					uiMantissa = 0
+					uiExponent = uiExponent + 1
+				end
+			end
+		end
+
+		return string.char(
+			uiMantissa % 256,
+			math.floor(uiMantissa / 256) % 256,
+			math.floor(uiMantissa / 65536) + (uiExponent % 2) * 128,
+			uiSign + math.floor(uiExponent / 2)
+		)
+	end
+	unpack_u16 = function(strData, uiPos)
+		local b0, b1 = string.byte(strData, uiPos, uiPos + 1)
+		return b0 + b1 * 256
+	end
+	unpack_u32 = function(strData, uiPos)
+		local b0, b1, b2, b3 = string.byte(strData, uiPos, uiPos + 3)
+		local iValue = b0 + b1 * 256 + b2 * 65536 + b3 * 16777216
+		if iValue >= 2147483648 then
+			iValue = iValue - 4294967296
+		end
+		return iValue
+	end
+	unpack_f32 = function(strData, uiPos)
+		local b0, b1, b2, b3 = string.byte(strData, uiPos, uiPos + 3)
+		local fSign = (b3 >= 128) and -1 or 1
+		local uiExponent = (b3 % 128) * 2 + math.floor(b2 / 128)
+		local uiMantissa = ((b2 % 128) * 256 + b1) * 256 + b0
+
+		if uiExponent == 0 then
+			return fSign * uiMantissa * 2 ^ -149
+		elseif uiExponent == 0xff then
+			if uiMantissa == 0 then
+				return fSign * math.huge
+			end
+			return 0 / 0
+		end
+		return fSign * (1 + uiMantissa / 8388608) * 2 ^ (uiExponent - 127)
+	end
+end
+
+---------------------------------------------------------------------------------------------------------------------
+
+-- returns true if strData starts like a result frame (JSON results start with '{' or '[')
+function Result_frame:isFrame(strData)
+	return type(strData) == "string" and string.sub(strData, 1, 4) == RESULT_FRAME_MAGIC
+end
+
+-- encodes the color tables of several devices (tColorTables[serial] = color table of Color_conversions:aus2colorTable)
+-- the raw readings are included if fRaw is true, tResults[serial] is optional and contains the result of each device
+-- returns the frame as a string or nil and an error message
+function Result_frame:encode(tColorTables, fRaw, tResults)
+	if self.led_analyzer ~= nil then
+		return self.led_analyzer.encode_result_frame(tColorTables, fRaw, tResults)
+	end
+	return self:encode_lua(tColorTables, fRaw, tResults)
+end
+
+-- Lua implementation of encode, it gives the same frame as the C implementation
+function Result_frame:encode_lua(tColorTables, fRaw, tResults)
+	local uiFlags = fRaw and RESULT_FRAME_FLAG_RAW or 0
+	local astrParts = {}
+	local uiDevices = 0
+
+	for tSerial, tColorTable in pairs(tColorTables) do
+		local strSerial = tostring(tSerial)
+		if #strSerial > 255 or type(tColorTable) ~= "table" or #tColorTable > 255 then
+			return nil, "the color tables need a serial number (at most 255 characters) and at most 255 lanes per device"
+		end
+
+		local iResult = 0
+		if type(tResults) == "table" then
+			iResult = tonumber(tResults[tSerial]) or 0
+		end
+
+		astrParts[#astrParts + 1] = pack_u8(#strSerial) .. strSerial .. pack_u32(iResult) .. pack_u8(#tColorTable)
+
+		for uiLane = 1, #tColorTable do
+			local tLane = tColorTable[uiLane]
+			if type(tLane) ~= "table" then
+				tLane = {}
+			end
+			astrParts[#astrParts + 1] = self:encodeLane(tLane, uiFlags)
+		end
+
+		uiDevices = uiDevices + 1
+	end
+	if uiDevices > 65535 then
+		return nil, "too many devices for one frame"
+	end
+
+	return RESULT_FRAME_MAGIC .. pack_u8(RESULT_FRAME_VERSION) .. pack_u8(uiFlags) .. pack_u16(uiDevices) ..
+		table.concat(astrParts)
+end
+
+-- limits a value to 0..uiMax and rounds it, missing values are 0
+local function get_uint(tValue, uiMax)
+	tValue = tonumber(tValue) or 0
+	if tValue <= 0 then
+		return 0
+	elseif tValue >= uiMax then
+		return uiMax
+	end
+	return math.floor(tValue + 0.5)
+end
+
+function Result_frame:encodeLane(tLane, uiFlags)
+	local tRGB = tLane.RGB_tsc or {}
+	local tWavelength = tLane.Wavelength or {}
+	local tSettings = tLane.Settings or {}
+	local uiLaneFlags = (tRGB.R_n ~= nil) and RESULT_FRAME_LANE_VALID or 0
+
+	local astrRecord = {
+		pack_u8(uiLaneFlags),
+		pack_u8(get_uint(tSettings.gain, 255)),
+		pack_u8(get_uint(tSettings.intTime, 255)),
+		pack_u8(0),
+		pack_u16(get_uint(tWavelength.nm, 65535)),
+		pack_u16(0)
+	}
+	for _, tField in ipairs(astrFloats) do
+		local tSub = tLane[tField[1]] or {}
+		astrRecord[#astrRecord + 1] = pack_f32(tonumber(tSub[tField[2]]) or 0)
+	end
+
+	if uiFlags % 2 == RESULT_FRAME_FLAG_RAW then
+		astrRecord[#astrRecord + 1] = pack_u16(get_uint(tRGB.clear, 65535))
+		astrRecord[#astrRecord + 1] = pack_u16(get_uint(tRGB.red, 65535))
+		astrRecord[#astrRecord + 1] = pack_u16(get_uint(tRGB.green, 65535))
+		astrRecord[#astrRecord + 1] = pack_u16(get_uint(tRGB.blue, 65535))
+	end
+
+	return table.concat(astrRecord)
+end
+
+-- decodes a result frame
+-- returns the color tables and the results (both with the serial numbers as keys) or nil and an error message
+function Result_frame:decode(strFrame)
+	if self.led_analyzer ~= nil then
+		return self.led_analyzer.decode_result_frame(strFrame)
+	end
+	return self:decode_lua(strFrame)
+end
+
+-- Lua implementation of decode, it gives the same tables as the C implementation
+function Result_frame:decode_lua(strFrame)
+	if #strFrame < RESULT_FRAME_HEADER_SIZE or self:isFrame(strFrame) ~= true then
+		return nil, "this is not a result frame"
+	end
+	if string.byte(strFrame, 5) ~= RESULT_FRAME_VERSION then
+		return nil, "unsupported version of the result frame"
+	end
+
+	local uiFlags = string.byte(strFrame, 6)
+	local uiDevices = unpack_u16(strFrame, 7)
+	local fRaw = (uiFlags % 2 == RESULT_FRAME_FLAG_RAW)
+	local uiLaneSize = RESULT_FRAME_LANE_SIZE + (fRaw and RESULT_FRAME_RAW_SIZE or 0)
+	local uiPos = RESULT_FRAME_HEADER_SIZE + 1
+
+	local tColorTables = {}
+	local tResults = {}
+	for _ = 1, uiDevices do
+		local uiSerialLength = string.byte(strFrame, uiPos)
+		if uiSerialLength == nil or #strFrame < uiPos + 5 + uiSerialLength then
+			return nil, "the result frame is truncated"
+		end
+		local strSerial = string.sub(strFrame, uiPos + 1, uiPos + uiSerialLength)
+		local iResult = unpack_u32(strFrame, uiPos + 1 + uiSerialLength)
+		local uiLanes = string.byte(strFrame, uiPos + 5 + uiSerialLength)
+		uiPos = uiPos + 6 + uiSerialLength
+		if #strFrame < uiPos - 1 + uiLanes * uiLaneSize then
+			return nil, "the result frame is truncated"
+		end
+
+		local tColorTable = {}
+		for uiLane = 1, uiLanes do
+			tColorTable[uiLane] = self:decodeLane(strFrame, uiPos, fRaw)
+			uiPos = uiPos + uiLaneSize
+		end
+
+		tColorTables[strSerial] = tColorTable
+		tResults[strSerial] = iResult
+	end
+
+	return tColorTables, tResults
+end
+
+function Result_frame:decodeLane(strFrame, uiPos, fRaw)
+	local uiLaneFlags, uiGain, uiIntTime = string.byte(strFrame, uiPos, uiPos + 2)
+	local afValues = {}
+	for uiIndex = 1, #astrFloats do
+		afValues[uiIndex] = unpack_f32(strFrame, uiPos + 4 + uiIndex * 4)
+	end
+	local fSat, fLux, fCCT, fClearRatio, fR_n, fG_n, fB_n, fX, fY, fZ, fx, fy, fH, fS, fV = unpack(afValues)
+
+	local tLane = {
+		Settings = {gain = uiGain, intTime = uiIntTime}
+	}
+
+	if uiLaneFlags % 2 ~= RESULT_FRAME_LANE_VALID then
+		-- dark lanes have plain zeros like the tables of Color_conversions:aus2colorTable
+		tLane.XYZ = {X = 0, Y = 0, Z = 0}
+		tLane.Yxy = {Y = 0, x = 0, y = 0}
+		tLane.HSV = {H = 0, S = 0, V = 0}
+		tLane.Wavelength = {
+			lux = fLux,
+			clear_ratio = fClearRatio,
+			nm = 0,
+			sat = 0,
+			cct = 0,
+			r_estimate = 0,
+			g_estimate = 0,
+			b_estimate = 0
+		}
+		tLane.RGB_tsc = {clear_tsc = 0, red_tsc = 0, green_tsc = 0, blue_tsc = 0}
+	else
+		tLane.Wavelength = {
+			lux = fLux,
+			clear_ratio = fClearRatio,
+			nm = unpack_u16(strFrame, uiPos + 4),
+			sat = fSat,
+			cct = fCCT
+		}
+		tLane.RGB_tsc = {R_n = fR_n, G_n = fG_n, B_n = fB_n}
+		tLane.XYZ = {X = fX, Y = fY, Z = fZ}
+		tLane.Yxy = {Y = fY, x = fx, y = fy}
+		tLane.HSV = {H = fH, S = fS, V = fV}
+		if fRaw then
+			local uiRawPos = uiPos + RESULT_FRAME_LANE_SIZE
+			tLane.RGB_tsc.clear = unpack_u16(strFrame, uiRawPos)
+			tLane.RGB_tsc.red = unpack_u16(strFrame, uiRawPos + 2)
+			tLane.RGB_tsc.green = unpack_u16(strFrame, uiRawPos + 4)
+			tLane.RGB_tsc.blue = unpack_u16(strFrame, uiRawPos + 6)
+		end
+	end
+
+	return tLane
+end
+
+-- returns a frame with only some lanes of each device, the lane records are copied without decoding them
+-- auiLanes is a list of lane numbers (1 for the first lane), the lanes of each device are in the order of the list
+-- and lane numbers which a device does not have are left out
+-- returns the new frame or nil and an error message
+function Result_frame:select(strFrame, auiLanes)
+	if #strFrame < RESULT_FRAME_HEADER_SIZE or self:isFrame(strFrame) ~= true then
+		return nil, "this is not a result frame"
+	end
+	if string.byte(strFrame, 5) ~= RESULT_FRAME_VERSION then
+		return nil, "unsupported version of the result frame"
+	end
+
+	local uiFlags = string.byte(strFrame, 6)
+	local uiDevices = unpack_u16(strFrame, 7)
+	local uiLaneSize = RESULT_FRAME_LANE_SIZE + ((uiFlags % 2 == RESULT_FRAME_FLAG_RAW) and RESULT_FRAME_RAW_SIZE or 0)
+	local uiPos = RESULT_FRAME_HEADER_SIZE + 1
+
+	local astrParts = {string.sub(strFrame, 1, RESULT_FRAME_HEADER_SIZE)}
+	for _ = 1, uiDevices do
+		local uiSerialLength = string.byte(strFrame, uiPos)
+		if uiSerialLength == nil or #strFrame < uiPos + 5 + uiSerialLength then
+			return nil, "the result frame is truncated"
+		end
+		local uiLanes = string.byte(strFrame, uiPos + 5 + uiSerialLength)
+		local uiFirstLane = uiPos + 6 + uiSerialLength
+		if #strFrame < uiFirstLane - 1 + uiLanes * uiLaneSize then
+			return nil, "the result frame is truncated"
+		end
+
+		local astrLanes = {}
+		for _, uiLane in ipairs(auiLanes) do
+			if uiLane >= 1 and uiLane <= uiLanes then
+				local uiLanePos = uiFirstLane + (uiLane - 1) * uiLaneSize
+				astrLanes[#astrLanes + 1] = string.sub(strFrame, uiLanePos, uiLanePos + uiLaneSize - 1)
+			end
+		end
+		-- serial number and result are copied, the number of lanes changes
+		astrParts[#astrParts + 1] = string.sub(strFrame, uiPos, uiFirstLane - 2) .. pack_u8(#astrLanes) ..
+			table.concat(astrLanes)
+		uiPos = uiFirstLane + uiLanes * uiLaneSize
+	end
+
+	return table.concat(astrParts)
+end
+
+return Result_frame
@@ -0,0 +1,538 @@
+-- Create the test_plan class.
+-- A test plan is the compiled form of the test sets of a test session: the set points and tolerances of all lanes of
+-- all devices for every test step. Compiling resolves the device keys and lane numbers once, a measurement is then
+-- validated without searching the nested test set tables. If the led_analyzer module is available, the plan is also
+-- stored as a flat C array (see test_plan.h) and the measurement is validated directly on the sample buffer.
+--
+-- The test sets can come from
+--   * a list of test sets like atTestSets in the generated test scripts:
+--       { [step] = { [device] = { [lane] = { name, nm, tol_nm, sat, tol_sat, lux, tol_lux } } } }
+--     the device is a serial number or a device index starting at 0, the lanes are 1 to 16
+--   * the generated test scripts themselves, see example_device/netx56_generated.lua
+--   * the INI files of the test session editor, see example_device/netx56_saved.ini (each test row is a step, the
+--     lanes keep the pin states of the row in pintype, pinnumber, pinvalue and pindefvalue)
+-- A plan which is loaded from a string is cached with the string as the key, so a server compiles each test script
+-- only once.
+local class = require "pl.class"
+
+---
+-- @type test_plan
+local Test_plan = class()
+
+-- the number of lanes of a device, the same as TEST_PLAN_LANES in test_plan.h
+local TEST_PLAN_LANES = 16
+-- the number of loaded plans which are kept in the cache
+local uiCacheSize = 16
+
+--- init test_plan
+-- fNative selects the C implementation if the led_analyzer module is available, default is true
+function Test_plan:_init(fNative)
+	self.led_analyzer = nil
+	if fNative ~= false then
+		-- the same binding as color_control, the plans of the FFI binding can only be used with its sample buffers
+		local fOk, tModule = false, nil
+		if jit ~= nil then
+			fOk, tModule = pcall(require, "led_analyzer_ffi")
+		end
+		if fOk ~= true then
+			fOk, tModule = pcall(require, "led_analyzer")
+		end
+		if fOk == true and tModule.new_test_plan ~= nil then
+			self.led_analyzer = tModule
+		end
+	end
+
+	self.tColorValidation = require("color_validation")()
+
+	-- loaded plans by their source and the sources in the order they were loaded
+	self.atCache = {}
+	self.astrCache = {}
+end
+
+-- returns the entry of a table with a number key, which can also be a string (from JSON) or the other way round
+local function get_entry(tTable, tKey)
+	local tEntry = tTable[tKey]
+	if tEntry == nil then
+		tEntry = tTable[tostring(tKey)]
+	end
+	if tEntry == nil and type(tKey) == "string" and tonumber(tKey) ~= nil then
+		tEntry = tTable[tonumber(tKey)]
+	end
+	return tEntry
+end
+
+-- device indices first, then the serial numbers
+local function compare_keys(tKeyA, tKeyB)
+	if type(tKeyA) ~= type(tKeyB) then
+		return type(tKeyA) == "number"
+	end
+	return tKeyA < tKeyB
+end
+
+local astrValues = {"nm", "tol_nm", "sat", "tol_sat", "lux", "tol_lux"}
+-- the state of the pin which switches the LED of a lane, it is optional and only kept for the sequences
+local astrPinValues = {"pintype", "pinnumber", "pinvalue", "pindefvalue"}
+
+--- compiles a list of test sets into a plan
+-- atTestSets has one test set per step, see above
+-- atSettings optionally has the gain and integration time for each lane of a device like the generated test scripts:
+-- { [device] = { [lane] = { gain, integration } } }, they are stored in the lanes of all steps
+-- returns the plan or nil and an error message, the plan has the fields
+--   uiSteps, uiDevices: the number of steps and devices
+--   atDevices:          the device keys, the index in this list is the device of the plan
+--   tDevices:           the device of the plan (starting at 0) for each key as a string
+--   atSteps:            the lanes for each step and device, atSteps[step][device][lane] like the test sets
+--   tNative:            the plan of the led_analyzer module or nil
+function Test_plan:compile(atTestSets, atSettings)
+	if type(atTestSets) ~= "table" or #atTestSets == 0 then
+		return nil, "No test set(s) available"
+	end
+
+	-- collect the devices of all steps
+	local atDevices = {}
+	local tDevices = {}
+	for uiStep, tTestSet in ipairs(atTestSets) do
+		if type(tTestSet) ~= "table" then
+			return nil, string.format("The test set of step %d is not a table", uiStep)
+		end
+		for tKey, tDevice in pairs(tTestSet) do
+			if type(tDevice) == "table" and tDevices[tostring(tKey)] == nil then
+				tDevices[tostring(tKey)] = true
+				table.insert(atDevices, tKey)
+			end
+		end
+	end
+	if #atDevices == 0 then
+		return nil, "The test sets have no devices"
+	end
+	table.sort(atDevices, compare_keys)
+	for uiDevice, tKey in ipairs(atDevices) do
+		tDevices[tostring(tKey)] = uiDevice - 1
+	end
+
+	local tNative = nil
+	if self.led_analyzer ~= nil then
+		tNative = self.led_analyzer.new_test_plan(#atTestSets, #atDevices)
+	end
+
+	local atSteps = {}
+	for uiStep, tTestSet in ipairs(atTestSets) do
+		local atStep = {}
+		for uiDevice, tKey in ipairs(atDevices) do
+			local atLanes = {}
+			local tDevice = get_entry(tTestSet, tKey)
+			if type(tDevice) == "table" then
+				local tSettings = type(atSettings) == "table" and get_entry(atSettings, tKey) or nil
+				for uiLane = 1, TEST_PLAN_LANES do
+					local tLane = get_entry(tDevice, uiLane)
+					if type(tLane) == "table" then
+						local tEntry = {name = tLane.name}
+						for _, strValue in ipairs(astrValues) do
+							local dValue = tonumber(tLane[strValue])
+							if dValue == nil then
+								return nil, string.format(
+									"Step %d, device %s, lane %d: %s is missing",
+									uiStep,
+									tostring(tKey),
+									uiLane,
+									strValue
+								)
+							end
+							tEntry[strValue] = dValue
+						end
+						for _, strValue in ipairs(astrPinValues) do
+							tEntry[strValue] = tonumber(tLane[strValue])
+						end
+						local tLaneSettings = type(tSettings) == "table" and get_entry(tSettings, uiLane) or nil
+						if type(tLaneSettings) == "table" then
+							tEntry.gain = tonumber(tLaneSettings.gain)
+							tEntry.integration = tonumber(tLaneSettings.integration)
+						end
+
+						atLanes[uiLane] = tEntry
+						if tNative ~= nil then
+							tNative:set(uiStep - 1, uiDevice - 1, uiLane - 1, tEntry)
+						end
+					end
+				end
+			end
+			atStep[uiDevice] = atLanes
+		end
+		atSteps[uiStep] = atStep
+	end
+
+	return {
+		uiSteps = #atTestSets,
+		uiDevices = #atDevices,
+		atDevices = atDevices,
+		tDevices = tDevices,
+		atSteps = atSteps,
+		tNative = tNative
+	}
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Sources of the test sets.
+
+-- the values of a test row in the INI file and their names in a test set
+local atIniValues = {
+	{"wavelength", "nm"},
+	{"tolnm", "tol_nm"},
+	{"saturation", "sat"},
+	{"tolsat", "tol_sat"},
+	{"illumination", "lux"},
+	{"tolillu", "tol_lux"}
+}
+
+--- parses the INI file of a test session
+-- The file describes one device, each sensor section has numberOfTestrows rows. Row k of all sensors is step k.
+-- returns the list of test sets (with device 0) or nil and an error message
+function Test_plan:parseIni(strContent)
+	local atSections = {}
+	local tSection = nil
+	for strLine in string.gmatch(strContent, "[^\r\n]+") do
+		local strName = string.match(strLine, "^%s*%[([^%]]+)%]")
+		if strName ~= nil then
+			tSection = {}
+			atSections[strName] = tSection
+		elseif tSection ~= nil then
+			local strKey, strValue = string.match(strLine, "^%s*([^=;#%s]+)%s*=%s*(.-)%s*$")
+			if strKey ~= nil then
+				tSection[strKey] = strValue
+			end
+		end
+	end
+
+	local tSession = atSections["Testsession"]
+	if tSession == nil then
+		return nil, "This is not a test session, the section Testsession is missing"
+	end
+	local uiSensors = tonumber(tSession.numberOfSensors) or TEST_PLAN_LANES
+	if uiSensors > TEST_PLAN_LANES then
+		return nil, string.format("The test session has %d sensors, a device has only %d", uiSensors, TEST_PLAN_LANES)
+	end
+
+	local atTestSets = {}
+	for uiLane = 1, uiSensors do
+		local tSensor = atSections["Sensor" .. uiLane]
+		if tSensor ~= nil then
+			for uiRow = 1, tonumber(tSensor.numberOfTestrows) or 0 do
+				local strPrefix = "row" .. uiRow .. "_"
+				local tLane = {name = tSensor[strPrefix .. "name"]}
+				for _, tValue in ipairs(atIniValues) do
+					local dValue = tonumber(tSensor[strPrefix .. tValue[1]])
+					if dValue == nil then
+						return nil, string.format("Sensor %d, row %d: %s is missing", uiLane, uiRow, tValue[1])
+					end
+					tLane[tValue[2]] = dValue
+				end
+				for _, strValue in ipairs(astrPinValues) do
+					tLane[strValue] = tonumber(tSensor[strPrefix .. strValue])
+				end
+
+				local tTestSet = atTestSets[uiRow]
+				if tTestSet == nil then
+					tTestSet = {[0] = {}}
+					atTestSets[uiRow] = tTestSet
+				end
+				tTestSet[0][uiLane] = tLane
+			end
+		end
+	end
+
+	return atTestSets
+end
+
+-- evaluates a table constructor without access to any globals
+local function load_table(strConstructor, strName)
+	local strChunk = "return " .. strConstructor
+	local fnChunk, strError
+	if setfenv ~= nil then
+		fnChunk, strError = loadstring(strChunk, strName)
+		if fnChunk ~= nil then
+			setfenv(fnChunk, {})
+		end
+	else
+		fnChunk, strError = load(strChunk, strName, "t", {})
+	end
+	if fnChunk == nil then
+		return nil, strError
+	end
+
+	local fOk, tTable = pcall(fnChunk)
+	if fOk ~= true or type(tTable) ~= "table" then
+		return nil, string.format("%s is not a table: %s", strName, tostring(tTable))
+	end
+	return tTable
+end
+
+--- parses a generated test script
+-- Only the tables atTestSets, the test sets it lists and atSettings are evaluated, the script itself is not run.
+-- returns the list of test sets and the settings or nil and an error message
+function Test_plan:parseGenerated(strContent)
+	local strList = string.match(strContent, "local%s+atTestSets%s*=%s*(%b{})")
+	if strList == nil then
+		return nil, "The script has no atTestSets"
+	end
+
+	local atTestSets = {}
+	for strName in string.gmatch(strList, "[%a_][%w_]*") do
+		local strTestSet = string.match(strContent, "local%s+" .. strName .. "%s*=%s*(%b{})")
+		if strTestSet == nil then
+			return nil, string.format("The script has no test set %s", strName)
+		end
+		local tTestSet, strError = load_table(strTestSet, strName)
+		if tTestSet == nil then
+			return nil, strError
+		end
+		table.insert(atTestSets, tTestSet)
+	end
+
+	local atSettings = nil
+	local strSettings = string.match(strContent, "atSettings%s*=%s*(%b{})")
+	if strSettings ~= nil then
+		local strError
+		atSettings, strError = load_table(strSettings, "atSettings")
+		if atSettings == nil then
+			return nil, strError
+		end
+	end
+
+	return atTestSets, atSettings
+end
+
+--- compiles an INI file or a generated test script
+-- The plan is taken from the cache if the same content was loaded before.
+-- returns the plan or nil and an error message
+function Test_plan:load(strContent)
+	if type(strContent) ~= "string" then
+		return nil, "The test plan is not a string"
+	end
+
+	local tPlan = self.atCache[strContent]
+	if tPlan ~= nil then
+		return tPlan
+	end
+
+	local atTestSets, atSettings
+	if string.match(strContent, "%[Testsession%]") ~= nil then
+		atTestSets, atSettings = self:parseIni(strContent)
+	else
+		atTestSets, atSettings = self:parseGenerated(strContent)
+	end
+	if atTestSets == nil then
+		return nil, atSettings
+	end
+
+	local strError
+	tPlan, strError = self:compile(atTestSets, atSettings)
+	if tPlan == nil then
+		return nil, strError
+	end
+
+	-- drop the oldest plan if the cache is full
+	if #self.astrCache >= uiCacheSize then
+		self.atCache[table.remove(self.astrCache, 1)] = nil
+	end
+	self.atCache[strContent] = tPlan
+	table.insert(self.astrCache, strContent)
+
+	return tPlan
+end
+
+--- returns a sequence which measures and validates all steps of a plan, see Color_control:runSequence
+-- Each step of the sequence has
+--   atSettings: the gain and integration time of the lanes which have them in the plan
+--   atPins:     the lanes with a pin state { uiDevice, uiLane, name, pintype, pinnumber, pinvalue, pindefvalue }, the
+--               hook of the sequence switches the LEDs of the device under test with them
+-- The devices of the sequence are the device indices of the plan. A plan with serial numbers needs astrSerials, the
+-- list of the serial numbers in the order of the opened devices.
+function Test_plan:sequence(tPlan, astrSerials, lux_check_enable, fAllValues)
+	-- the device index for each device of the plan
+	local tDeviceIndices = {}
+	for uiIndex, strSerial in ipairs(astrSerials or {}) do
+		tDeviceIndices[strSerial] = uiIndex - 1
+	end
+	local auiDevIndex = {}
+	for uiDevice, tKey in ipairs(tPlan.atDevices) do
+		auiDevIndex[uiDevice] = tDeviceIndices[tostring(tKey)] or tonumber(tKey)
+	end
+
+	local atSequence = {}
+	for uiStep, atStep in ipairs(tPlan.atSteps) do
+		local atSettings = nil
+		local atPins = {}
+		for uiDevice, atLanes in ipairs(atStep) do
+			local devIndex = auiDevIndex[uiDevice]
+			for uiLane = 1, TEST_PLAN_LANES do
+				local tLane = atLanes[uiLane]
+				if tLane ~= nil then
+					if devIndex ~= nil and (tLane.gain ~= nil or tLane.integration ~= nil) then
+						atSettings = atSettings or {}
+						local tDevice = atSettings[tostring(devIndex)]
+						if tDevice == nil then
+							tDevice = {}
+							atSettings[tostring(devIndex)] = tDevice
+						end
+						tDevice[tostring(uiLane)] = {gain = tLane.gain, integration = tLane.integration}
+					end
+					if tLane.pinnumber ~= nil then
+						table.insert(
+							atPins,
+							{
+								uiDevice = devIndex,
+								uiLane = uiLane,
+								name = tLane.name,
+								pintype = tLane.pintype,
+								pinnumber = tLane.pinnumber,
+								pinvalue = tLane.pinvalue,
+								pindefvalue = tLane.pindefvalue
+							}
+						)
+					end
+				end
+			end
+		end
+
+		atSequence[uiStep] = {
+			atSettings = atSettings,
+			atPins = atPins,
+			tPlan = tPlan,
+			uiTestStep = uiStep,
+			lux_check_enable = lux_check_enable,
+			fAllValues = fAllValues
+		}
+	end
+
+	return atSequence
+end
+
+---------------------------------------------------------------------------------------------------------------------
+-- Validation, the summaries have the format of Color_validation:summarizeCoCo.
+
+-- returns the device of the plan for a serial number or a device index, nil if the plan has no such device
+local function get_plan_device(tPlan, strSerial, uiDeviceIndex)
+	local uiDevice = tPlan.tDevices[strSerial]
+	if uiDevice == nil and uiDeviceIndex ~= nil then
+		uiDevice = tPlan.tDevices[tostring(uiDeviceIndex)]
+	end
+	return uiDevice
+end
+
+-- returns the device of the plan (starting at 0) for each serial number in astrSerials, false if it is not in the plan
+local function get_plan_devices(tPlan, astrSerials)
+	local auiPlanDevices = {}
+	for uiIndex, strSerial in ipairs(astrSerials) do
+		auiPlanDevices[uiIndex] = get_plan_device(tPlan, strSerial, uiIndex - 1) or false
+	end
+	return auiPlanDevices
+end
+
+local function check_step(tPlan, uiStep)
+	if type(tPlan) ~= "table" or tPlan.atSteps == nil then
+		return "No test plan available"
+	end
+	if type(uiStep) ~= "number" or tPlan.atSteps[uiStep] == nil then
+		return string.format("The test plan has no step %s", tostring(uiStep))
+	end
+end
+
+--- validates color tables against a step of the plan (starting at 1)
+-- tColorTables has the color tables of the devices with their serial numbers as keys, astrSerials is the list of the
+-- serial numbers in the order of the devices, it is only needed if the plan has device indices instead of serials
+-- returns the summary or nil and an error message
+function Test_plan:validate(tPlan, uiStep, tColorTables, astrSerials, lux_check_enable, fAllValues)
+	local strError = check_step(tPlan, uiStep)
+	if strError ~= nil then
+		return nil, strError
+	end
+
+	local tDeviceIndices = {}
+	for uiIndex, strSerial in ipairs(astrSerials or {}) do
+		tDeviceIndices[strSerial] = uiIndex - 1
+	end
+
+	local atStep = tPlan.atSteps[uiStep]
+	local tTestSet = {}
+	for strSerial in pairs(tColorTables or {}) do
+		local uiDevice = get_plan_device(tPlan, strSerial, tDeviceIndices[strSerial])
+		if uiDevice ~= nil then
+			tTestSet[strSerial] = atStep[uiDevice + 1]
+		end
+	end
+
+	return self.tColorValidation:summarizeCoCo(tColorTables, tTestSet, lux_check_enable, fAllValues)
+end
+
+--- validates the last measurement of a color_control object against a step of the plan (starting at 1)
+-- The sample buffer of the measurement is validated in C if the plan and the measurement support it, otherwise the
+-- color tables are validated in Lua. The buffer must come from the same binding as the plan, under LuaJIT both use the
+-- FFI binding, which validates in Lua.
+-- The lanes which are not populated on the devices are not in the summary.
+-- returns the summary or nil and an error message
+function Test_plan:validateCoCo(tPlan, uiStep, tColorControl, lux_check_enable, fAllValues)
+	local strError = check_step(tPlan, uiStep)
+	if strError ~= nil then
+		return nil, strError
+	end
+
+	local astrSerials = tColorControl.color_conversions:astring2table(tColorControl.asSerials, tColorControl.numberOfDevices)
+	local tBuffer = tColorControl.tMeasuredBuffer
+	local tSummary
+	local fNative = tPlan.tNative ~= nil and tBuffer ~= nil and tColorControl.led_analyzer == self.led_analyzer
+	if fNative == true and self.led_analyzer.buffer_validate ~= nil then
+		tSummary =
+			self.led_analyzer.buffer_validate(
+			tBuffer,
+			tColorControl.asSerials,
+			tPlan.tNative,
+			uiStep - 1,
+			get_plan_devices(tPlan, astrSerials),
+			lux_check_enable ~= nil,
+			fAllValues == true
+		)
+	else
+		tSummary, strError = self:validate(tPlan, uiStep, tColorControl.tColorTable, astrSerials, lux_check_enable, fAllValues)
+	end
+
+	return self.tColorValidation:maskSummary(tSummary, tColorControl.atLanes), strError
+end
+
+--- measures the opened devices of a color_control object sequentially and validates the mean against a step of the plan
+-- The devices are sampled until the result of every tested lane of the step is certain, at most tSequential.uiMaxSamples
+-- times (see Color_control:startMeasurementsSequential). The plan must be compiled with the led_analyzer binding of the
+-- color_control object, otherwise an error is returned.
+-- returns the summary and the number of samples or nil and an error message
+function Test_plan:measureSequential(tPlan, uiStep, tColorControl, tSequential, lux_check_enable, fAllValues)
+	local strError = check_step(tPlan, uiStep)
+	if strError ~= nil then
+		return nil, strError
+	end
+
+	if tPlan.tNative == nil or tColorControl.led_analyzer ~= self.led_analyzer then
+		return nil, "sequential measurements are not supported: the plan was not compiled with the led_analyzer binding of the measurement"
+	end
+
+	local astrSerials = tColorControl.color_conversions:astring2table(tColorControl.asSerials, tColorControl.numberOfDevices)
+	local iResult, uiSamples
+	iResult, strError, uiSamples =
+		tColorControl:startMeasurementsSequential(
+		tPlan.tNative,
+		uiStep - 1,
+		get_plan_devices(tPlan, astrSerials),
+		tSequential,
+		lux_check_enable ~= nil
+	)
+	if iResult ~= 0 then
+		return nil, strError
+	end
+
+	local tSummary
+	tSummary, strError = self:validateCoCo(tPlan, uiStep, tColorControl, lux_check_enable, fAllValues)
+	if tSummary == nil then
+		return nil, strError
+	end
+	return tSummary, uiSamples
+end
+
+return Test_plan
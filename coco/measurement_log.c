@@ -0,0 +1,846 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+ 
+
+
+
+/** \file measurement_log.c
+
+	 \brief Append-only binary log of the measured lanes
+
+The records are written and read byte by byte like the result frames, so the files do not depend on the byte order or the
+structure packing of the compiler. See measurement_log.h for the layout. Readers map the segments into the memory and
+read the records in place.
+
+ */
+
+#include "measurement_log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#       include <fcntl.h>
+#       include <sys/mman.h>
+#       include <sys/stat.h>
+#       include <sys/time.h>
+#       include <unistd.h>
+#endif
+
+
+/** magic bytes at the start of every segment */
+#define MEASUREMENT_LOG_SEGMENT_MAGIC "CoCL"
+/** magic bytes at the start of the index */
+#define MEASUREMENT_LOG_INDEX_MAGIC "CoCI"
+
+
+
+static void put_u16(unsigned char* pucData, unsigned int uiValue)
+{
+	pucData[0] = (unsigned char)( uiValue       & 0xffU);
+	pucData[1] = (unsigned char)((uiValue >> 8) & 0xffU);
+}
+
+
+
+static void put_u32(unsigned char* pucData, unsigned long ulValue)
+{
+	pucData[0] = (unsigned char)( ulValue        & 0xffU);
+	pucData[1] = (unsigned char)((ulValue >>  8) & 0xffU);
+	pucData[2] = (unsigned char)((ulValue >> 16) & 0xffU);
+	pucData[3] = (unsigned char)((ulValue >> 24) & 0xffU);
+}
+
+
+
+static void put_u64(unsigned char* pucData, unsigned long long ullValue)
+{
+	put_u32(pucData, (unsigned long)(ullValue & 0xffffffffUL));
+	put_u32(pucData + 4, (unsigned long)(ullValue >> 32));
+}
+
+
+
+static void put_f32(unsigned char* pucData, float fValue)
+{
+	unsigned int uiBits;
+
+
+	memcpy(&uiBits, &fValue, sizeof(uiBits));
+	put_u32(pucData, uiBits);
+}
+
+
+
+static unsigned int get_u16(const unsigned char* pucData)
+{
+	return (unsigned int)pucData[0] | ((unsigned int)pucData[1] << 8);
+}
+
+
+
+static unsigned long get_u32(const unsigned char* pucData)
+{
+	return (unsigned long)pucData[0] | ((unsigned long)pucData[1] << 8) | ((unsigned long)pucData[2] << 16) | ((unsigned long)pucData[3] << 24);
+}
+
+
+
+static unsigned long long get_u64(const unsigned char* pucData)
+{
+	return (unsigned long long)get_u32(pucData) | ((unsigned long long)get_u32(pucData + 4) << 32);
+}
+
+
+
+static float get_f32(const unsigned char* pucData)
+{
+	unsigned int uiBits;
+	float fValue;
+
+
+	uiBits = (unsigned int)get_u32(pucData);
+	memcpy(&fValue, &uiBits, sizeof(fValue));
+	return fValue;
+}
+
+
+
+/* Copies a serial number into a field of MEASUREMENT_LOG_SERIAL_SIZE bytes which is padded with 0. */
+static void put_serial(unsigned char* pucData, const char* pcSerial)
+{
+	size_t sizSerial;
+
+
+	sizSerial = strlen(pcSerial);
+	if( sizSerial>MEASUREMENT_LOG_SERIAL_SIZE )
+	{
+		sizSerial = MEASUREMENT_LOG_SERIAL_SIZE;
+	}
+	memset(pucData, 0, MEASUREMENT_LOG_SERIAL_SIZE);
+	memcpy(pucData, pcSerial, sizSerial);
+}
+
+
+
+static void get_serial(const unsigned char* pucData, char* pcSerial)
+{
+	memcpy(pcSerial, pucData, MEASUREMENT_LOG_SERIAL_SIZE);
+	pcSerial[MEASUREMENT_LOG_SERIAL_SIZE] = 0;
+}
+
+
+
+static char* make_path(const char* pcPrefix, const char* pcFormat, unsigned long ulSegment)
+{
+	char* pcPath;
+
+
+	/* The prefix, "_", 10 digits and the extension. */
+	pcPath = (char*)malloc(strlen(pcPrefix) + 24);
+	if( pcPath!=NULL )
+	{
+		sprintf(pcPath, pcFormat, pcPrefix, ulSegment);
+	}
+
+	return pcPath;
+}
+
+
+
+/** \brief returns the current time in microseconds since 1970-01-01 UTC. */
+unsigned long long measurement_log_time(void)
+{
+#if defined(_WIN32)
+	FILETIME tFileTime;
+	unsigned long long ullTime;
+
+
+	/* The file time counts 100 ns since 1601-01-01. */
+	GetSystemTimeAsFileTime(&tFileTime);
+	ullTime = ((unsigned long long)tFileTime.dwHighDateTime << 32) | tFileTime.dwLowDateTime;
+	return (ullTime - 116444736000000000ULL) / 10U;
+#else
+	struct timeval tNow;
+
+
+	gettimeofday(&tNow, NULL);
+	return (unsigned long long)tNow.tv_sec * 1000000ULL + (unsigned long long)tNow.tv_usec;
+#endif
+}
+
+
+
+/** \brief returns the path of a segment file.
+	@param pcPrefix		path of the log files without the extension
+	@param ulSegment	number of the segment
+
+	@return 			the path, the caller must free it, or NULL if no memory could be allocated
+	*/
+char* measurement_log_segment_path(const char* pcPrefix, unsigned long ulSegment)
+{
+	return make_path(pcPrefix, "%s_%06lu.ccl", ulSegment);
+}
+
+
+
+static int file_exists(const char* pcPath)
+{
+	FILE* ptFile;
+
+
+	ptFile = fopen(pcPath, "rb");
+	if( ptFile!=NULL )
+	{
+		fclose(ptFile);
+		return 1;
+	}
+	return 0;
+}
+
+
+
+/** \brief reads the index of a log.
+	@param pcPrefix		path of the log files without the extension
+	@param pptIndex		returns the entries, the caller must free them (NULL if there are no entries)
+	@param puiEntries	returns the number of entries
+
+	@retval 0			the index was read, a log without an index file has no entries
+	@retval -1			the index file is damaged
+	@retval -2			no memory could be allocated
+	*/
+int measurement_log_read_index(const char* pcPrefix, MEASUREMENT_LOG_INDEX_T** pptIndex, unsigned int* puiEntries)
+{
+	char* pcPath;
+	FILE* ptFile;
+	/* The buffer takes the header and one entry. */
+	unsigned char aucBuffer[MEASUREMENT_LOG_INDEX_SIZE];
+	MEASUREMENT_LOG_INDEX_T* ptIndex;
+	unsigned long ulEntries;
+	unsigned long ulEntry;
+	int iResult;
+
+
+	*pptIndex = NULL;
+	*puiEntries = 0;
+
+	pcPath = make_path(pcPrefix, "%s.cci", 0);
+	if( pcPath==NULL )
+	{
+		return -2;
+	}
+	ptFile = fopen(pcPath, "rb");
+	free(pcPath);
+	if( ptFile==NULL )
+	{
+		return 0;
+	}
+
+	iResult = -1;
+	ptIndex = NULL;
+	if( fread(aucBuffer, 1, MEASUREMENT_LOG_HEADER_SIZE, ptFile)==MEASUREMENT_LOG_HEADER_SIZE &&
+	    memcmp(aucBuffer, MEASUREMENT_LOG_INDEX_MAGIC, 4)==0 &&
+	    aucBuffer[4]==MEASUREMENT_LOG_VERSION &&
+	    get_u16(aucBuffer + 6)==MEASUREMENT_LOG_INDEX_SIZE )
+	{
+		ulEntries = get_u32(aucBuffer + 8);
+		iResult = 0;
+		if( ulEntries!=0 )
+		{
+			ptIndex = (MEASUREMENT_LOG_INDEX_T*)malloc(ulEntries * sizeof(MEASUREMENT_LOG_INDEX_T));
+			if( ptIndex==NULL )
+			{
+				iResult = -2;
+			}
+			for(ulEntry=0; ulEntry<ulEntries && iResult==0; ulEntry++)
+			{
+				if( fread(aucBuffer, 1, MEASUREMENT_LOG_INDEX_SIZE, ptFile)!=MEASUREMENT_LOG_INDEX_SIZE )
+				{
+					iResult = -1;
+				}
+				else
+				{
+					ptIndex[ulEntry].ulSegment = get_u32(aucBuffer);
+					ptIndex[ulEntry].ulFirst = get_u32(aucBuffer + 4);
+					ptIndex[ulEntry].ulLast = get_u32(aucBuffer + 8);
+					ptIndex[ulEntry].ulRecords = get_u32(aucBuffer + 12);
+					get_serial(aucBuffer + 16, ptIndex[ulEntry].acSerial);
+					ptIndex[ulEntry].ullFirstTime = get_u64(aucBuffer + 32);
+					ptIndex[ulEntry].ullLastTime = get_u64(aucBuffer + 40);
+				}
+			}
+			if( iResult!=0 )
+			{
+				free(ptIndex);
+				ptIndex = NULL;
+			}
+			else
+			{
+				*puiEntries = (unsigned int)ulEntries;
+			}
+		}
+	}
+	fclose(ptFile);
+
+	*pptIndex = ptIndex;
+	return iResult;
+}
+
+
+
+/* Writes the complete index file, it is small enough to be replaced on every flush. */
+static int write_index(MEASUREMENT_LOG_T* ptLog)
+{
+	char* pcPath;
+	FILE* ptFile;
+	unsigned char aucBuffer[MEASUREMENT_LOG_HEADER_SIZE + MEASUREMENT_LOG_INDEX_SIZE];
+	const MEASUREMENT_LOG_INDEX_T* ptEntry;
+	unsigned int uiEntry;
+	int iResult;
+
+
+	pcPath = make_path(ptLog->pcPrefix, "%s.cci", 0);
+	if( pcPath==NULL )
+	{
+		return -1;
+	}
+	ptFile = fopen(pcPath, "wb");
+	free(pcPath);
+	if( ptFile==NULL )
+	{
+		return -1;
+	}
+
+	memset(aucBuffer, 0, MEASUREMENT_LOG_HEADER_SIZE);
+	memcpy(aucBuffer, MEASUREMENT_LOG_INDEX_MAGIC, 4);
+	aucBuffer[4] = MEASUREMENT_LOG_VERSION;
+	put_u16(aucBuffer + 6, MEASUREMENT_LOG_INDEX_SIZE);
+	put_u32(aucBuffer + 8, ptLog->uiIndexEntries);
+	iResult = (fwrite(aucBuffer, 1, MEASUREMENT_LOG_HEADER_SIZE, ptFile)==MEASUREMENT_LOG_HEADER_SIZE) ? 0 : -1;
+
+	ptEntry = ptLog->ptIndex;
+	for(uiEntry=0; uiEntry<ptLog->uiIndexEntries && iResult==0; uiEntry++)
+	{
+		put_u32(aucBuffer, ptEntry->ulSegment);
+		put_u32(aucBuffer + 4, ptEntry->ulFirst);
+		put_u32(aucBuffer + 8, ptEntry->ulLast);
+		put_u32(aucBuffer + 12, ptEntry->ulRecords);
+		put_serial(aucBuffer + 16, ptEntry->acSerial);
+		put_u64(aucBuffer + 32, ptEntry->ullFirstTime);
+		put_u64(aucBuffer + 40, ptEntry->ullLastTime);
+		if( fwrite(aucBuffer, 1, MEASUREMENT_LOG_INDEX_SIZE, ptFile)!=MEASUREMENT_LOG_INDEX_SIZE )
+		{
+			iResult = -1;
+		}
+		++ptEntry;
+	}
+
+	if( fclose(ptFile)!=0 )
+	{
+		iResult = -1;
+	}
+	if( iResult==0 )
+	{
+		ptLog->fIndexDirty = 0;
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief opens a log for appending records.
+
+The records are appended to a new segment after the segments which already exist. The numbers of the measurements continue
+after the last record of the log.
+	@param pcPrefix			path of the log files without the extension, e.g. "logs/coco"
+	@param ulSegmentRecords	maximum number of records in a segment
+
+	@return 				the log or NULL if the index is damaged or no memory could be allocated
+	*/
+MEASUREMENT_LOG_T* measurement_log_open(const char* pcPrefix, unsigned long ulSegmentRecords)
+{
+	MEASUREMENT_LOG_T* ptLog;
+	MEASUREMENT_LOG_SEGMENT_T* ptSegment;
+	MEASUREMENT_LOG_RECORD_T tRecord;
+	char* pcPath;
+	unsigned int uiEntry;
+	size_t sizPrefix;
+	int fLastSegment;
+
+
+	ptLog = (MEASUREMENT_LOG_T*)calloc(1, sizeof(MEASUREMENT_LOG_T));
+	if( ptLog==NULL )
+	{
+		return NULL;
+	}
+	sizPrefix = strlen(pcPrefix);
+	ptLog->pcPrefix = (char*)malloc(sizPrefix + 1);
+	if( ptLog->pcPrefix==NULL || measurement_log_read_index(pcPrefix, &ptLog->ptIndex, &ptLog->uiIndexEntries)!=0 )
+	{
+		free(ptLog->pcPrefix);
+		free(ptLog);
+		return NULL;
+	}
+	memcpy(ptLog->pcPrefix, pcPrefix, sizPrefix + 1);
+	ptLog->uiIndexSize = ptLog->uiIndexEntries;
+	ptLog->ulSegmentRecords = (ulSegmentRecords!=0) ? ulSegmentRecords : 1;
+
+	/* Start after the last segment in the index and after all segment files, the last one might not be in the index. */
+	fLastSegment = 0;
+	for(uiEntry=0; uiEntry<ptLog->uiIndexEntries; uiEntry++)
+	{
+		if( ptLog->ptIndex[uiEntry].ulSegment>=ptLog->ulSegment )
+		{
+			ptLog->ulSegment = ptLog->ptIndex[uiEntry].ulSegment;
+			fLastSegment = 1;
+		}
+	}
+	for(;;)
+	{
+		pcPath = measurement_log_segment_path(pcPrefix, ptLog->ulSegment);
+		if( pcPath==NULL || file_exists(pcPath)==0 )
+		{
+			free(pcPath);
+			break;
+		}
+		/* Continue the numbers of the measurements after the last record. */
+		ptSegment = measurement_log_segment_open(pcPath);
+		if( ptSegment!=NULL )
+		{
+			if( ptSegment->ulRecords!=0 )
+			{
+				measurement_log_segment_get(ptSegment, ptSegment->ulRecords - 1, &tRecord);
+				ptLog->ulMeasurement = tRecord.ulMeasurement + 1;
+			}
+			measurement_log_segment_close(ptSegment);
+		}
+		free(pcPath);
+		ptLog->ulSegment++;
+		fLastSegment = 0;
+	}
+	if( fLastSegment!=0 )
+	{
+		/* The last segment of the index has no file any more. */
+		ptLog->ulSegment++;
+	}
+	ptLog->uiSegmentIndex = ptLog->uiIndexEntries;
+
+	return ptLog;
+}
+
+
+
+/* Closes the current segment and starts the next one. */
+static int start_segment(MEASUREMENT_LOG_T* ptLog)
+{
+	char* pcPath;
+	unsigned char aucHeader[MEASUREMENT_LOG_HEADER_SIZE];
+
+
+	if( ptLog->ptSegment!=NULL )
+	{
+		fclose(ptLog->ptSegment);
+		ptLog->ptSegment = NULL;
+		ptLog->ulSegment++;
+		if( write_index(ptLog)!=0 )
+		{
+			return -1;
+		}
+	}
+
+	pcPath = measurement_log_segment_path(ptLog->pcPrefix, ptLog->ulSegment);
+	if( pcPath==NULL )
+	{
+		return -1;
+	}
+	ptLog->ptSegment = fopen(pcPath, "wb");
+	free(pcPath);
+	if( ptLog->ptSegment==NULL )
+	{
+		return -1;
+	}
+
+	memset(aucHeader, 0, sizeof(aucHeader));
+	memcpy(aucHeader, MEASUREMENT_LOG_SEGMENT_MAGIC, 4);
+	aucHeader[4] = MEASUREMENT_LOG_VERSION;
+	put_u16(aucHeader + 6, MEASUREMENT_LOG_RECORD_SIZE);
+	put_u32(aucHeader + 8, ptLog->ulSegment);
+	put_u64(aucHeader + 12, measurement_log_time());
+	if( fwrite(aucHeader, 1, sizeof(aucHeader), ptLog->ptSegment)!=sizeof(aucHeader) )
+	{
+		return -1;
+	}
+
+	ptLog->ulRecords = 0;
+	ptLog->uiSegmentIndex = ptLog->uiIndexEntries;
+
+	return 0;
+}
+
+
+
+/* Adds a record to the index entry of its serial number in the current segment. */
+static int index_record(MEASUREMENT_LOG_T* ptLog, const MEASUREMENT_LOG_RECORD_T* ptRecord)
+{
+	MEASUREMENT_LOG_INDEX_T* ptEntry;
+	MEASUREMENT_LOG_INDEX_T* ptNewIndex;
+	unsigned int uiEntry;
+	unsigned int uiSize;
+
+
+	/* A segment has only a few serial numbers, the entries of the current segment are at the end. */
+	ptEntry = NULL;
+	for(uiEntry=ptLog->uiSegmentIndex; uiEntry<ptLog->uiIndexEntries; uiEntry++)
+	{
+		if( strncmp(ptLog->ptIndex[uiEntry].acSerial, ptRecord->acSerial, MEASUREMENT_LOG_SERIAL_SIZE)==0 )
+		{
+			ptEntry = ptLog->ptIndex + uiEntry;
+			break;
+		}
+	}
+
+	if( ptEntry==NULL )
+	{
+		if( ptLog->uiIndexEntries==ptLog->uiIndexSize )
+		{
+			uiSize = (ptLog->uiIndexSize!=0) ? 2 * ptLog->uiIndexSize : 16;
+			ptNewIndex = (MEASUREMENT_LOG_INDEX_T*)realloc(ptLog->ptIndex, uiSize * sizeof(MEASUREMENT_LOG_INDEX_T));
+			if( ptNewIndex==NULL )
+			{
+				return -1;
+			}
+			ptLog->ptIndex = ptNewIndex;
+			ptLog->uiIndexSize = uiSize;
+		}
+		ptEntry = ptLog->ptIndex + ptLog->uiIndexEntries;
+		ptLog->uiIndexEntries++;
+
+		ptEntry->ulSegment = ptLog->ulSegment;
+		ptEntry->ulFirst = ptLog->ulRecords;
+		ptEntry->ulRecords = 0;
+		memcpy(ptEntry->acSerial, ptRecord->acSerial, sizeof(ptEntry->acSerial));
+		ptEntry->ullFirstTime = ptRecord->ullTime;
+	}
+
+	ptEntry->ulLast = ptLog->ulRecords;
+	ptEntry->ulRecords++;
+	ptEntry->ullLastTime = ptRecord->ullTime;
+	ptLog->fIndexDirty = 1;
+
+	return 0;
+}
+
+
+
+/** \brief appends one record to the log.
+
+A new segment is started if the current one is full. The record is buffered, call measurement_log_flush to write it and the
+index to the files.
+	@param ptLog		the log
+	@param ptRecord		the record, the serial number is cut after MEASUREMENT_LOG_SERIAL_SIZE characters
+
+	@retval 0			the record was appended
+	@retval -1			writing the segment or the index failed or no memory could be allocated
+	*/
+int measurement_log_append(MEASUREMENT_LOG_T* ptLog, const MEASUREMENT_LOG_RECORD_T* ptRecord)
+{
+	unsigned char aucRecord[MEASUREMENT_LOG_RECORD_SIZE];
+	MEASUREMENT_LOG_RECORD_T tRecord;
+
+
+	if( ptLog->ptSegment==NULL || ptLog->ulRecords>=ptLog->ulSegmentRecords )
+	{
+		if( start_segment(ptLog)!=0 )
+		{
+			return -1;
+		}
+	}
+
+	/* The index compares the serial number as it is stored in the record. */
+	tRecord = *ptRecord;
+	tRecord.acSerial[MEASUREMENT_LOG_SERIAL_SIZE] = 0;
+
+	memset(aucRecord, 0, sizeof(aucRecord));
+	put_u64(aucRecord, tRecord.ullTime);
+	put_serial(aucRecord + 8, tRecord.acSerial);
+	aucRecord[24] = tRecord.ucLane;
+	aucRecord[25] = tRecord.ucFlags;
+	aucRecord[26] = tRecord.ucGain;
+	aucRecord[27] = tRecord.ucIntegrationtime;
+	put_u16(aucRecord + 28, tRecord.usClear);
+	put_u16(aucRecord + 30, tRecord.usRed);
+	put_u16(aucRecord + 32, tRecord.usGreen);
+	put_u16(aucRecord + 34, tRecord.usBlue);
+	put_u16(aucRecord + 36, tRecord.usNm);
+	aucRecord[38] = tRecord.ucChecks;
+	put_f32(aucRecord + 40, tRecord.fSat);
+	put_f32(aucRecord + 44, tRecord.fLux);
+	put_u32(aucRecord + 48, (unsigned long)(unsigned int)tRecord.iResult);
+	put_u32(aucRecord + 52, tRecord.ulMeasurement);
+	if( fwrite(aucRecord, 1, sizeof(aucRecord), ptLog->ptSegment)!=sizeof(aucRecord) )
+	{
+		return -1;
+	}
+
+	if( index_record(ptLog, &tRecord)!=0 )
+	{
+		return -1;
+	}
+	ptLog->ulRecords++;
+
+	return 0;
+}
+
+
+
+/** \brief returns the number for the records of the next measurement. */
+unsigned long measurement_log_next_measurement(MEASUREMENT_LOG_T* ptLog)
+{
+	return ptLog->ulMeasurement++;
+}
+
+
+
+/** \brief writes the buffered records and the index to the files.
+	@retval 0			all records and the index were written
+	@retval -1			writing failed
+	*/
+int measurement_log_flush(MEASUREMENT_LOG_T* ptLog)
+{
+	int iResult;
+
+
+	iResult = 0;
+	if( ptLog->ptSegment!=NULL && fflush(ptLog->ptSegment)!=0 )
+	{
+		iResult = -1;
+	}
+	if( ptLog->fIndexDirty!=0 && write_index(ptLog)!=0 )
+	{
+		iResult = -1;
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief writes all records and the index and frees the log.
+	@retval 0			all records and the index were written
+	@retval -1			writing failed, the log is freed anyway
+	*/
+int measurement_log_close(MEASUREMENT_LOG_T* ptLog)
+{
+	int iResult;
+
+
+	iResult = measurement_log_flush(ptLog);
+	if( ptLog->ptSegment!=NULL && fclose(ptLog->ptSegment)!=0 )
+	{
+		iResult = -1;
+	}
+	free(ptLog->ptIndex);
+	free(ptLog->pcPrefix);
+	free(ptLog);
+
+	return iResult;
+}
+
+
+
+/** \brief maps a segment into the memory.
+
+A segment which is still written can be opened as well, only the complete records are read.
+	@param pcPath		path of the segment file
+
+	@return 			the segment or NULL if it could not be opened or is not a segment
+	*/
+MEASUREMENT_LOG_SEGMENT_T* measurement_log_segment_open(const char* pcPath)
+{
+	MEASUREMENT_LOG_SEGMENT_T* ptSegment;
+	const unsigned char* pucData;
+	size_t sizData;
+
+
+	ptSegment = (MEASUREMENT_LOG_SEGMENT_T*)calloc(1, sizeof(MEASUREMENT_LOG_SEGMENT_T));
+	if( ptSegment==NULL )
+	{
+		return NULL;
+	}
+
+	pucData = NULL;
+	sizData = 0;
+#if defined(_WIN32)
+	{
+		LARGE_INTEGER tSize;
+
+
+		ptSegment->hMapping = NULL;
+		ptSegment->hFile = CreateFileA(pcPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if( ptSegment->hFile!=INVALID_HANDLE_VALUE && GetFileSizeEx(ptSegment->hFile, &tSize)!=0 &&
+		    tSize.QuadPart>=MEASUREMENT_LOG_HEADER_SIZE )
+		{
+			sizData = (size_t)tSize.QuadPart;
+			ptSegment->hMapping = CreateFileMappingA(ptSegment->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+			if( ptSegment->hMapping!=NULL )
+			{
+				pucData = (const unsigned char*)MapViewOfFile(ptSegment->hMapping, FILE_MAP_READ, 0, 0, sizData);
+			}
+		}
+	}
+#else
+	{
+		int iFd;
+		struct stat tStat;
+		void* pvData;
+
+
+		iFd = open(pcPath, O_RDONLY);
+		if( iFd>=0 )
+		{
+			if( fstat(iFd, &tStat)==0 && tStat.st_size>=MEASUREMENT_LOG_HEADER_SIZE )
+			{
+				sizData = (size_t)tStat.st_size;
+				pvData = mmap(NULL, sizData, PROT_READ, MAP_SHARED, iFd, 0);
+				if( pvData!=MAP_FAILED )
+				{
+					pucData = (const unsigned char*)pvData;
+				}
+			}
+			/* The mapping stays valid without the file descriptor. */
+			close(iFd);
+		}
+	}
+#endif
+	ptSegment->pucData = pucData;
+	ptSegment->sizData = sizData;
+
+	if( pucData==NULL ||
+	    memcmp(pucData, MEASUREMENT_LOG_SEGMENT_MAGIC, 4)!=0 ||
+	    pucData[4]!=MEASUREMENT_LOG_VERSION ||
+	    get_u16(pucData + 6)!=MEASUREMENT_LOG_RECORD_SIZE )
+	{
+		measurement_log_segment_close(ptSegment);
+		return NULL;
+	}
+	ptSegment->ulSegment = get_u32(pucData + 8);
+	ptSegment->ulRecords = (unsigned long)((sizData - MEASUREMENT_LOG_HEADER_SIZE) / MEASUREMENT_LOG_RECORD_SIZE);
+
+	return ptSegment;
+}
+
+
+
+/** \brief unmaps a segment and frees it. */
+void measurement_log_segment_close(MEASUREMENT_LOG_SEGMENT_T* ptSegment)
+{
+	if( ptSegment!=NULL )
+	{
+#if defined(_WIN32)
+		if( ptSegment->pucData!=NULL )
+		{
+			UnmapViewOfFile(ptSegment->pucData);
+		}
+		if( ptSegment->hMapping!=NULL )
+		{
+			CloseHandle(ptSegment->hMapping);
+		}
+		if( ptSegment->hFile!=INVALID_HANDLE_VALUE && ptSegment->hFile!=NULL )
+		{
+			CloseHandle(ptSegment->hFile);
+		}
+#else
+		if( ptSegment->pucData!=NULL )
+		{
+			munmap((void*)ptSegment->pucData, ptSegment->sizData);
+		}
+#endif
+		free(ptSegment);
+	}
+}
+
+
+
+/** \brief reads a record of a segment.
+	@param ptSegment	the segment
+	@param ulRecord		index of the record, starting at 0, it must be less than ptSegment->ulRecords
+	@param ptRecord		returns the record
+	*/
+void measurement_log_segment_get(const MEASUREMENT_LOG_SEGMENT_T* ptSegment, unsigned long ulRecord, MEASUREMENT_LOG_RECORD_T* ptRecord)
+{
+	const unsigned char* pucRecord;
+
+
+	pucRecord = ptSegment->pucData + MEASUREMENT_LOG_HEADER_SIZE + (size_t)ulRecord * MEASUREMENT_LOG_RECORD_SIZE;
+
+	ptRecord->ullTime = get_u64(pucRecord);
+	get_serial(pucRecord + 8, ptRecord->acSerial);
+	ptRecord->ucLane = pucRecord[24];
+	ptRecord->ucFlags = pucRecord[25];
+	ptRecord->ucGain = pucRecord[26];
+	ptRecord->ucIntegrationtime = pucRecord[27];
+	ptRecord->usClear = (unsigned short)get_u16(pucRecord + 28);
+	ptRecord->usRed = (unsigned short)get_u16(pucRecord + 30);
+	ptRecord->usGreen = (unsigned short)get_u16(pucRecord + 32);
+	ptRecord->usBlue = (unsigned short)get_u16(pucRecord + 34);
+	ptRecord->usNm = (unsigned short)get_u16(pucRecord + 36);
+	ptRecord->ucChecks = pucRecord[38];
+	ptRecord->fSat = get_f32(pucRecord + 40);
+	ptRecord->fLux = get_f32(pucRecord + 44);
+	ptRecord->iResult = (int)(unsigned int)get_u32(pucRecord + 48);
+	ptRecord->ulMeasurement = get_u32(pucRecord + 52);
+}
+
+
+
+/** \brief finds the first record of a segment which is not older than a time.
+
+The records of a segment are sorted by their time, the search is binary.
+	@param ptSegment	the segment
+	@param ullTime		time in microseconds since 1970-01-01 UTC
+
+	@return 			index of the record or ptSegment->ulRecords if all records are older
+	*/
+unsigned long measurement_log_segment_find(const MEASUREMENT_LOG_SEGMENT_T* ptSegment, unsigned long long ullTime)
+{
+	unsigned long ulLow;
+	unsigned long ulHigh;
+	unsigned long ulMiddle;
+
+
+	ulLow = 0;
+	ulHigh = ptSegment->ulRecords;
+	while( ulLow<ulHigh )
+	{
+		ulMiddle = ulLow + (ulHigh - ulLow) / 2;
+		if( get_u64(ptSegment->pucData + MEASUREMENT_LOG_HEADER_SIZE + (size_t)ulMiddle * MEASUREMENT_LOG_RECORD_SIZE)<ullTime )
+		{
+			ulLow = ulMiddle + 1;
+		}
+		else
+		{
+			ulHigh = ulMiddle;
+		}
+	}
+
+	return ulLow;
+}
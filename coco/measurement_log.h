@@ -0,0 +1,173 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+ 
+
+
+
+/** \file measurement_log.h
+
+	 \brief Append-only binary log of the measured lanes (header)
+
+The measurement log stores every measured lane in a fixed-size record. The records are appended to segment files, a new
+segment is started when the current one has reached its maximum number of records. A small index file lists for every
+segment and serial number the range of records and the time of the first and the last record, so a reader opens only the
+segments it needs. The records of a segment are in the order they were appended, i.e. sorted by their time. All values
+are little endian.
+
+Segment file "<prefix>_<segment>.ccl" (segment with 6 digits):
+	- header, MEASUREMENT_LOG_HEADER_SIZE bytes: magic "CoCL", version (u8), reserved (u8), record size (u16), segment (u32),
+	  time of the creation (u64), reserved (12 bytes)
+	- records, MEASUREMENT_LOG_RECORD_SIZE bytes each
+
+Record:
+	time (u64, microseconds since 1970-01-01 UTC), serial number (16 bytes, padded with 0, longer serial numbers are cut),
+	lane (u8, starting at 0), flags (u8, MEASUREMENT_LOG_FLAG_*), gain (u8), integration time (u8),
+	clear, red, green, blue (u16 each), nm (u16), failed checks (u8, TEST_PLAN_CHECK_*), reserved (u8), sat, lux (f32 each),
+	result of the device (i32), number of the measurement (u32), reserved (8 bytes)
+
+Index file "<prefix>.cci":
+	- header, MEASUREMENT_LOG_HEADER_SIZE bytes: magic "CoCI", version (u8), reserved (u8), entry size (u16), entries (u32),
+	  reserved (20 bytes)
+	- entries, MEASUREMENT_LOG_INDEX_SIZE bytes each: segment (u32), first record (u32), last record (u32), records (u32),
+	  serial number (16 bytes), time of the first record (u64), time of the last record (u64)
+
+ */
+
+#ifndef __MEASUREMENT_LOG_H__
+#define __MEASUREMENT_LOG_H__
+
+#include <stdio.h>
+#include <stddef.h>
+
+#if defined(_WIN32)
+#       include <windows.h>
+#endif
+
+/** version of the segment and index format */
+#define MEASUREMENT_LOG_VERSION 1
+/** size of the segment and index headers in bytes */
+#define MEASUREMENT_LOG_HEADER_SIZE 32
+/** size of a record in bytes */
+#define MEASUREMENT_LOG_RECORD_SIZE 64
+/** size of an index entry in bytes */
+#define MEASUREMENT_LOG_INDEX_SIZE 48
+/** size of the serial number in a record */
+#define MEASUREMENT_LOG_SERIAL_SIZE 16
+
+/** record flag - the lane was bright enough for the color calculations */
+#define MEASUREMENT_LOG_FLAG_VALID  0x01
+/** record flag - the lane was validated */
+#define MEASUREMENT_LOG_FLAG_TESTED 0x02
+/** record flag - the validation of the lane failed */
+#define MEASUREMENT_LOG_FLAG_FAILED 0x04
+
+/** \brief one record of the log */
+typedef struct MEASUREMENT_LOG_RECORD_STRUCT
+{
+	/** microseconds since 1970-01-01 UTC */
+	unsigned long long ullTime;
+	/** serial number, terminated with 0 */
+	char acSerial[MEASUREMENT_LOG_SERIAL_SIZE + 1];
+	unsigned char ucLane;
+	/** MEASUREMENT_LOG_FLAG_* */
+	unsigned char ucFlags;
+	unsigned char ucGain;
+	unsigned char ucIntegrationtime;
+	unsigned short usClear;
+	unsigned short usRed;
+	unsigned short usGreen;
+	unsigned short usBlue;
+	unsigned short usNm;
+	/** TEST_PLAN_CHECK_* flags of the failed checks */
+	unsigned char ucChecks;
+	float fSat;
+	float fLux;
+	int iResult;
+	unsigned long ulMeasurement;
+} MEASUREMENT_LOG_RECORD_T;
+
+/** \brief the records of one serial number in one segment */
+typedef struct MEASUREMENT_LOG_INDEX_STRUCT
+{
+	unsigned long ulSegment;
+	unsigned long ulFirst;
+	unsigned long ulLast;
+	unsigned long ulRecords;
+	char acSerial[MEASUREMENT_LOG_SERIAL_SIZE + 1];
+	unsigned long long ullFirstTime;
+	unsigned long long ullLastTime;
+} MEASUREMENT_LOG_INDEX_T;
+
+/** \brief a log which is open for appending records */
+typedef struct MEASUREMENT_LOG_STRUCT
+{
+	/** path of the files without the extension */
+	char* pcPrefix;
+	/** the current segment or NULL if it is not open yet */
+	FILE* ptSegment;
+	unsigned long ulSegment;
+	/** records in the current segment */
+	unsigned long ulRecords;
+	/** a new segment is started after this number of records */
+	unsigned long ulSegmentRecords;
+	/** number of the next measurement */
+	unsigned long ulMeasurement;
+	/** the index, uiIndexEntries of uiIndexSize entries are used */
+	MEASUREMENT_LOG_INDEX_T* ptIndex;
+	unsigned int uiIndexEntries;
+	unsigned int uiIndexSize;
+	/** the first index entry of the current segment */
+	unsigned int uiSegmentIndex;
+	/** the index file is not up to date */
+	int fIndexDirty;
+} MEASUREMENT_LOG_T;
+
+/** \brief a segment which is mapped into the memory for reading */
+typedef struct MEASUREMENT_LOG_SEGMENT_STRUCT
+{
+	const unsigned char* pucData;
+	size_t sizData;
+	unsigned long ulSegment;
+	/** number of complete records */
+	unsigned long ulRecords;
+#if defined(_WIN32)
+	HANDLE hFile;
+	HANDLE hMapping;
+#endif
+} MEASUREMENT_LOG_SEGMENT_T;
+
+unsigned long long measurement_log_time(void);
+
+MEASUREMENT_LOG_T* measurement_log_open  (const char* pcPrefix, unsigned long ulSegmentRecords);
+int                measurement_log_append(MEASUREMENT_LOG_T* ptLog, const MEASUREMENT_LOG_RECORD_T* ptRecord);
+unsigned long      measurement_log_next_measurement(MEASUREMENT_LOG_T* ptLog);
+int                measurement_log_flush (MEASUREMENT_LOG_T* ptLog);
+int                measurement_log_close (MEASUREMENT_LOG_T* ptLog);
+char*              measurement_log_segment_path(const char* pcPrefix, unsigned long ulSegment);
+
+int                measurement_log_read_index(const char* pcPrefix, MEASUREMENT_LOG_INDEX_T** pptIndex, unsigned int* puiEntries);
+
+MEASUREMENT_LOG_SEGMENT_T* measurement_log_segment_open (const char* pcPath);
+void                       measurement_log_segment_close(MEASUREMENT_LOG_SEGMENT_T* ptSegment);
+void                       measurement_log_segment_get  (const MEASUREMENT_LOG_SEGMENT_T* ptSegment, unsigned long ulRecord, MEASUREMENT_LOG_RECORD_T* ptRecord);
+unsigned long              measurement_log_segment_find (const MEASUREMENT_LOG_SEGMENT_T* ptSegment, unsigned long long ullTime);
+
+#endif	/* __MEASUREMENT_LOG_H__ */
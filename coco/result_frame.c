@@ -0,0 +1,372 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+ 
+
+
+/** \file result_frame.c
+
+	 \brief Binary frame format for the measurement results
+
+result_frame writes and reads the records of a result frame byte by byte, so the format does not depend on the byte order
+or the structure packing of the compiler. See result_frame.h for the layout.
+
+ */
+
+#include "result_frame.h"
+
+#include <string.h>
+#include <math.h>
+
+
+static void put_u16(unsigned char* pucData, unsigned int uiValue)
+{
+	pucData[0] = (unsigned char)( uiValue       & 0xffU);
+	pucData[1] = (unsigned char)((uiValue >> 8) & 0xffU);
+}
+
+
+
+static void put_u32(unsigned char* pucData, unsigned long ulValue)
+{
+	pucData[0] = (unsigned char)( ulValue        & 0xffU);
+	pucData[1] = (unsigned char)((ulValue >>  8) & 0xffU);
+	pucData[2] = (unsigned char)((ulValue >> 16) & 0xffU);
+	pucData[3] = (unsigned char)((ulValue >> 24) & 0xffU);
+}
+
+
+
+static void put_f32(unsigned char* pucData, float fValue)
+{
+	unsigned int uiBits;
+
+
+	/* The float is stored in IEEE 754 single precision. */
+	memcpy(&uiBits, &fValue, sizeof(uiBits));
+	put_u32(pucData, uiBits);
+}
+
+
+
+static unsigned int get_u16(const unsigned char* pucData)
+{
+	return (unsigned int)pucData[0] | ((unsigned int)pucData[1] << 8);
+}
+
+
+
+static unsigned long get_u32(const unsigned char* pucData)
+{
+	return (unsigned long)pucData[0] | ((unsigned long)pucData[1] << 8) | ((unsigned long)pucData[2] << 16) | ((unsigned long)pucData[3] << 24);
+}
+
+
+
+static float get_f32(const unsigned char* pucData)
+{
+	unsigned int uiBits;
+	float fValue;
+
+
+	uiBits = (unsigned int)get_u32(pucData);
+	memcpy(&fValue, &uiBits, sizeof(fValue));
+
+	return fValue;
+}
+
+
+
+/** \brief returns the number of bytes of one device in a frame.
+	@param uiSerialLength	length of the serial number
+	@param uiLanes			number of lanes
+	@param ucFlags			frame flags (RESULT_FRAME_FLAG_*)
+
+	@return 				number of bytes
+	*/
+unsigned int result_frame_device_size(unsigned int uiSerialLength, unsigned int uiLanes, unsigned char ucFlags)
+{
+	unsigned int uiLaneSize;
+
+
+	uiLaneSize = RESULT_FRAME_LANE_SIZE;
+	if( (ucFlags & RESULT_FRAME_FLAG_RAW)!=0 )
+	{
+		uiLaneSize += RESULT_FRAME_RAW_SIZE;
+	}
+
+	return 1 + uiSerialLength + 4 + 1 + uiLanes * uiLaneSize;
+}
+
+
+
+/** \brief writes the frame header.
+	@param pucFrame		start of the frame, RESULT_FRAME_HEADER_SIZE bytes are written
+	@param uiDevices	number of devices in the frame
+	@param ucFlags		frame flags (RESULT_FRAME_FLAG_*)
+
+	@return 			number of bytes written
+	*/
+unsigned int result_frame_put_header(unsigned char* pucFrame, unsigned int uiDevices, unsigned char ucFlags)
+{
+	memcpy(pucFrame, RESULT_FRAME_MAGIC, 4);
+	pucFrame[4] = RESULT_FRAME_VERSION;
+	pucFrame[5] = ucFlags;
+	put_u16(pucFrame + 6, uiDevices);
+
+	return RESULT_FRAME_HEADER_SIZE;
+}
+
+
+
+/** \brief writes the header of one device, the lane records must follow.
+	@param pucFrame			position in the frame
+	@param pcSerial			serial number of the device
+	@param uiSerialLength	length of the serial number, at most RESULT_FRAME_MAX_SERIAL
+	@param iResult			result of the measurement
+	@param uiLanes			number of lane records which follow, at most 255
+
+	@return 				number of bytes written
+	*/
+unsigned int result_frame_put_device(unsigned char* pucFrame, const char* pcSerial, unsigned int uiSerialLength, int iResult, unsigned int uiLanes)
+{
+	pucFrame[0] = (unsigned char)uiSerialLength;
+	memcpy(pucFrame + 1, pcSerial, uiSerialLength);
+	put_u32(pucFrame + 1 + uiSerialLength, (unsigned long)(unsigned int)iResult);
+	pucFrame[5 + uiSerialLength] = (unsigned char)uiLanes;
+
+	return 6 + uiSerialLength;
+}
+
+
+
+/** \brief writes one lane record and the raw readings if RESULT_FRAME_FLAG_RAW is set.
+	@param pucFrame		position in the frame
+	@param ptLane		lane
+	@param ucFlags		frame flags (RESULT_FRAME_FLAG_*)
+
+	@return 			number of bytes written
+	*/
+unsigned int result_frame_put_lane(unsigned char* pucFrame, const RESULT_FRAME_LANE_T* ptLane, unsigned char ucFlags)
+{
+	pucFrame[0] = ptLane->ucFlags;
+	pucFrame[1] = ptLane->ucGain;
+	pucFrame[2] = ptLane->ucIntegrationtime;
+	pucFrame[3] = 0;
+	put_u16(pucFrame + 4, ptLane->usNm);
+	put_u16(pucFrame + 6, 0);
+	put_f32(pucFrame +  8, ptLane->fSat);
+	put_f32(pucFrame + 12, ptLane->fLux);
+	put_f32(pucFrame + 16, ptLane->fCCT);
+	put_f32(pucFrame + 20, ptLane->fClearRatio);
+	put_f32(pucFrame + 24, ptLane->fR_n);
+	put_f32(pucFrame + 28, ptLane->fG_n);
+	put_f32(pucFrame + 32, ptLane->fB_n);
+	put_f32(pucFrame + 36, ptLane->fX);
+	put_f32(pucFrame + 40, ptLane->fY);
+	put_f32(pucFrame + 44, ptLane->fZ);
+	put_f32(pucFrame + 48, ptLane->fx);
+	put_f32(pucFrame + 52, ptLane->fy);
+	put_f32(pucFrame + 56, ptLane->fH);
+	put_f32(pucFrame + 60, ptLane->fS);
+	put_f32(pucFrame + 64, ptLane->fV);
+
+	if( (ucFlags & RESULT_FRAME_FLAG_RAW)==0 )
+	{
+		return RESULT_FRAME_LANE_SIZE;
+	}
+
+	pucFrame += RESULT_FRAME_LANE_SIZE;
+	put_u16(pucFrame,     ptLane->usClear);
+	put_u16(pucFrame + 2, ptLane->usRed);
+	put_u16(pucFrame + 4, ptLane->usGreen);
+	put_u16(pucFrame + 6, ptLane->usBlue);
+
+	return RESULT_FRAME_LANE_SIZE + RESULT_FRAME_RAW_SIZE;
+}
+
+
+
+/** \brief checks and reads the frame header.
+	@param pucFrame		start of the frame
+	@param uiSize		size of the frame in bytes
+	@param puiDevices	returns the number of devices
+	@param pucFlags		returns the frame flags
+
+	@retval 0			header is valid
+	@retval -1			frame is shorter than the header
+	@retval -2			magic does not match
+	@retval -3			unsupported version
+	*/
+int result_frame_get_header(const unsigned char* pucFrame, unsigned int uiSize, unsigned int* puiDevices, unsigned char* pucFlags)
+{
+	if( uiSize<RESULT_FRAME_HEADER_SIZE )
+	{
+		return -1;
+	}
+	if( memcmp(pucFrame, RESULT_FRAME_MAGIC, 4)!=0 )
+	{
+		return -2;
+	}
+	if( pucFrame[4]!=RESULT_FRAME_VERSION )
+	{
+		return -3;
+	}
+
+	*pucFlags = pucFrame[5];
+	*puiDevices = get_u16(pucFrame + 6);
+
+	return 0;
+}
+
+
+
+/** \brief reads the header of one device and checks that all of its lanes are in the frame.
+	@param pucFrame			position in the frame
+	@param uiSize			number of bytes left in the frame
+	@param ppcSerial		returns a pointer to the serial number in the frame (not terminated with 0)
+	@param puiSerialLength	returns the length of the serial number
+	@param piResult			returns the result of the measurement
+	@param puiLanes			returns the number of lanes
+
+	@return 				size of the device header in bytes, the lane records follow, or -1 if the frame is too short
+	*/
+int result_frame_get_device(const unsigned char* pucFrame, unsigned int uiSize, const char** ppcSerial, unsigned int* puiSerialLength,
+                            int* piResult, unsigned int* puiLanes)
+{
+	unsigned int uiSerialLength;
+
+
+	if( uiSize<1 )
+	{
+		return -1;
+	}
+	uiSerialLength = pucFrame[0];
+	if( uiSize<6 + uiSerialLength )
+	{
+		return -1;
+	}
+
+	*ppcSerial = (const char*)(pucFrame + 1);
+	*puiSerialLength = uiSerialLength;
+	*piResult = (int)(unsigned int)get_u32(pucFrame + 1 + uiSerialLength);
+	*puiLanes = pucFrame[5 + uiSerialLength];
+
+	return (int)(6 + uiSerialLength);
+}
+
+
+
+/** \brief reads one lane record and the raw readings if RESULT_FRAME_FLAG_RAW is set.
+
+The caller must check the size of the frame, e.g. with result_frame_device_size.
+	@param pucFrame		position in the frame
+	@param ptLane		returns the lane, the raw readings are 0 if they are not in the frame
+	@param ucFlags		frame flags (RESULT_FRAME_FLAG_*)
+
+	@return 			number of bytes read
+	*/
+unsigned int result_frame_get_lane(const unsigned char* pucFrame, RESULT_FRAME_LANE_T* ptLane, unsigned char ucFlags)
+{
+	ptLane->ucFlags           = pucFrame[0];
+	ptLane->ucGain            = pucFrame[1];
+	ptLane->ucIntegrationtime = pucFrame[2];
+	ptLane->usNm        = (unsigned short)get_u16(pucFrame + 4);
+	ptLane->fSat        = get_f32(pucFrame +  8);
+	ptLane->fLux        = get_f32(pucFrame + 12);
+	ptLane->fCCT        = get_f32(pucFrame + 16);
+	ptLane->fClearRatio = get_f32(pucFrame + 20);
+	ptLane->fR_n        = get_f32(pucFrame + 24);
+	ptLane->fG_n        = get_f32(pucFrame + 28);
+	ptLane->fB_n        = get_f32(pucFrame + 32);
+	ptLane->fX          = get_f32(pucFrame + 36);
+	ptLane->fY          = get_f32(pucFrame + 40);
+	ptLane->fZ          = get_f32(pucFrame + 44);
+	ptLane->fx          = get_f32(pucFrame + 48);
+	ptLane->fy          = get_f32(pucFrame + 52);
+	ptLane->fH          = get_f32(pucFrame + 56);
+	ptLane->fS          = get_f32(pucFrame + 60);
+	ptLane->fV          = get_f32(pucFrame + 64);
+
+	if( (ucFlags & RESULT_FRAME_FLAG_RAW)==0 )
+	{
+		ptLane->usClear = 0;
+		ptLane->usRed   = 0;
+		ptLane->usGreen = 0;
+		ptLane->usBlue  = 0;
+		return RESULT_FRAME_LANE_SIZE;
+	}
+
+	pucFrame += RESULT_FRAME_LANE_SIZE;
+	ptLane->usClear = (unsigned short)get_u16(pucFrame);
+	ptLane->usRed   = (unsigned short)get_u16(pucFrame + 2);
+	ptLane->usGreen = (unsigned short)get_u16(pucFrame + 4);
+	ptLane->usBlue  = (unsigned short)get_u16(pucFrame + 6);
+
+	return RESULT_FRAME_LANE_SIZE + RESULT_FRAME_RAW_SIZE;
+}
+
+
+
+/** \brief fills a lane from the converted colors, without building the Lua tables first.
+
+The values are the same as in the color table of led_analyzer_push_colorTable.
+	@param ptLane				returns the lane
+	@param ptColorSpaces		converted colors, calculated with color_spaces_calculate
+	@param uiLane				index of the lane in ptColorSpaces and in the arrays
+	@param ausClear, ausRed, ausGreen, ausBlue	raw readings
+	@param aucIntegrationtime	integration time settings
+	@param aucGain				gain settings
+	*/
+void result_frame_lane_from_color_spaces(RESULT_FRAME_LANE_T* ptLane, const COLOR_SPACES_T* ptColorSpaces, unsigned int uiLane,
+                                         const unsigned short* ausClear, const unsigned short* ausRed,
+                                         const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                         const unsigned char* aucIntegrationtime, const unsigned char* aucGain)
+{
+	memset(ptLane, 0, sizeof(RESULT_FRAME_LANE_T));
+
+	ptLane->ucGain = aucGain[uiLane];
+	ptLane->ucIntegrationtime = aucIntegrationtime[uiLane];
+	ptLane->fLux = (float)ptColorSpaces->adLux[uiLane];
+	ptLane->fClearRatio = (float)ptColorSpaces->adClearRatio[uiLane];
+	ptLane->usClear = ausClear[uiLane];
+	ptLane->usRed = ausRed[uiLane];
+	ptLane->usGreen = ausGreen[uiLane];
+	ptLane->usBlue = ausBlue[uiLane];
+
+	if( ptColorSpaces->aucValid[uiLane]!=0 )
+	{
+		ptLane->ucFlags = RESULT_FRAME_LANE_VALID;
+		ptLane->usNm = (unsigned short)floor(ptColorSpaces->adWavelength[uiLane] + 0.5);
+		ptLane->fSat = (float)(ptColorSpaces->adSaturation[uiLane] * 100);
+		ptLane->fCCT = (float)ptColorSpaces->adCCT[uiLane];
+		ptLane->fR_n = (float)ptColorSpaces->adR_n[uiLane];
+		ptLane->fG_n = (float)ptColorSpaces->adG_n[uiLane];
+		ptLane->fB_n = (float)ptColorSpaces->adB_n[uiLane];
+		ptLane->fX = (float)ptColorSpaces->adX[uiLane];
+		ptLane->fY = (float)ptColorSpaces->adY[uiLane];
+		ptLane->fZ = (float)ptColorSpaces->adZ[uiLane];
+		ptLane->fx = (float)ptColorSpaces->adx[uiLane];
+		ptLane->fy = (float)ptColorSpaces->ady[uiLane];
+		ptLane->fH = (float)ptColorSpaces->adH[uiLane];
+		ptLane->fS = (float)ptColorSpaces->adS[uiLane];
+		ptLane->fV = (float)ptColorSpaces->adV[uiLane];
+	}
+}
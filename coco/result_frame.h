@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+ 
+
+
+/** \file result_frame.h
+
+	 \brief Binary frame format for the measurement results (header)
+
+A result frame carries the color tables of several devices in fixed-layout records. It replaces the JSON encoding of
+Color_control.tColorTable between CoCo_server and CoCo_client. All values are little endian.
+
+Frame:
+	- header, RESULT_FRAME_HEADER_SIZE bytes: magic "CoCR", version (u8), flags (u8, RESULT_FRAME_FLAG_*), number of devices (u16)
+	- for every device:
+		- length of the serial number (u8), serial number (without terminating 0)
+		- result of the measurement (i32)
+		- number of lanes (u8)
+		- one lane record per lane, RESULT_FRAME_LANE_SIZE bytes, followed by RESULT_FRAME_RAW_SIZE bytes if RESULT_FRAME_FLAG_RAW is set
+
+Lane record:
+	flags (u8, RESULT_FRAME_LANE_*), gain (u8), integration time (u8), reserved (u8), nm (u16), reserved (u16),
+	sat, lux, cct, clear_ratio, R_n, G_n, B_n, X, Y, Z, x, y, H, S, V (f32 each)
+Raw record:
+	clear, red, green, blue (u16 each)
+
+ */
+
+#ifndef __RESULT_FRAME_H__
+#define __RESULT_FRAME_H__
+
+#include "color_conversions.h"
+
+/** magic bytes at the start of every result frame */
+#define RESULT_FRAME_MAGIC "CoCR"
+/** version of the frame format */
+#define RESULT_FRAME_VERSION 1
+/** size of the frame header in bytes */
+#define RESULT_FRAME_HEADER_SIZE 8
+/** size of a lane record in bytes */
+#define RESULT_FRAME_LANE_SIZE 68
+/** size of the raw readings of a lane in bytes */
+#define RESULT_FRAME_RAW_SIZE 8
+/** maximum length of a serial number in a frame */
+#define RESULT_FRAME_MAX_SERIAL 255
+
+/** frame flag - every lane record is followed by the raw readings */
+#define RESULT_FRAME_FLAG_RAW 0x01
+
+/** lane flag - the lane was bright enough for the color calculations, otherwise only lux and clear_ratio are valid */
+#define RESULT_FRAME_LANE_VALID 0x01
+
+/** \brief one lane of a result frame */
+typedef struct RESULT_FRAME_LANE_STRUCT
+{
+	unsigned char ucFlags;
+	unsigned char ucGain;
+	unsigned char ucIntegrationtime;
+	unsigned short usNm;
+	float fSat;
+	float fLux;
+	float fCCT;
+	float fClearRatio;
+	float fR_n;
+	float fG_n;
+	float fB_n;
+	float fX;
+	float fY;
+	float fZ;
+	float fx;
+	float fy;
+	float fH;
+	float fS;
+	float fV;
+	unsigned short usClear;
+	unsigned short usRed;
+	unsigned short usGreen;
+	unsigned short usBlue;
+} RESULT_FRAME_LANE_T;
+
+unsigned int result_frame_device_size(unsigned int uiSerialLength, unsigned int uiLanes, unsigned char ucFlags);
+
+unsigned int result_frame_put_header(unsigned char* pucFrame, unsigned int uiDevices, unsigned char ucFlags);
+unsigned int result_frame_put_device(unsigned char* pucFrame, const char* pcSerial, unsigned int uiSerialLength, int iResult, unsigned int uiLanes);
+unsigned int result_frame_put_lane  (unsigned char* pucFrame, const RESULT_FRAME_LANE_T* ptLane, unsigned char ucFlags);
+
+int          result_frame_get_header(const unsigned char* pucFrame, unsigned int uiSize, unsigned int* puiDevices, unsigned char* pucFlags);
+int          result_frame_get_device(const unsigned char* pucFrame, unsigned int uiSize, const char** ppcSerial, unsigned int* puiSerialLength,
+                                     int* piResult, unsigned int* puiLanes);
+unsigned int result_frame_get_lane  (const unsigned char* pucFrame, RESULT_FRAME_LANE_T* ptLane, unsigned char ucFlags);
+
+void         result_frame_lane_from_color_spaces(RESULT_FRAME_LANE_T* ptLane, const COLOR_SPACES_T* ptColorSpaces, unsigned int uiLane,
+                                                 const unsigned short* ausClear, const unsigned short* ausRed,
+                                                 const unsigned short* ausGreen, const unsigned short* ausBlue,
+                                                 const unsigned char* aucIntegrationtime, const unsigned char* aucGain);
+
+#endif	/* __RESULT_FRAME_H__ */
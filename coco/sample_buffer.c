@@ -0,0 +1,144 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+/** \file sample_buffer.c
+
+	 \brief Buffer for the raw readings of several color controller devices
+
+ */
+
+#include "sample_buffer.h"
+#include "led_analyzer.h"
+#include "async_measurement.h"
+#include "timestamp_us.h"
+
+#include <stdlib.h>
+
+
+/** \brief allocates a sample buffer for a number of devices.
+
+The buffer and all of its arrays are allocated in one memory block and are initialized with 0.
+	@param uiDevices	number of devices the buffer can hold
+
+	@return 			pointer to the buffer or NULL if no memory could be allocated
+	*/
+SAMPLE_BUFFER_T* sample_buffer_new(unsigned int uiDevices)
+{
+	SAMPLE_BUFFER_T* ptBuffer;
+	unsigned int uiLanes;
+	unsigned char* pucData;
+
+
+	uiLanes = 16 * uiDevices;
+	/* The int array comes first to keep it aligned, then the short arrays and the char arrays. */
+	ptBuffer = (SAMPLE_BUFFER_T*)calloc(1, sizeof(SAMPLE_BUFFER_T) + uiDevices * sizeof(int) + 4 * uiLanes * sizeof(unsigned short) + 2 * uiLanes);
+	if( ptBuffer!=NULL )
+	{
+		pucData = (unsigned char*)(ptBuffer + 1);
+
+		ptBuffer->uiDevices = uiDevices;
+		ptBuffer->aiResults = (int*)pucData;
+		pucData += uiDevices * sizeof(int);
+		ptBuffer->ausClear = (unsigned short*)pucData;
+		ptBuffer->ausRed   = ptBuffer->ausClear + uiLanes;
+		ptBuffer->ausGreen = ptBuffer->ausClear + 2*uiLanes;
+		ptBuffer->ausBlue  = ptBuffer->ausClear + 3*uiLanes;
+		pucData += 4 * uiLanes * sizeof(unsigned short);
+		ptBuffer->aucIntegrationtime = pucData;
+		ptBuffer->aucGain = pucData + uiLanes;
+	}
+
+	return ptBuffer;
+}
+
+
+
+/** \brief frees a sample buffer allocated with sample_buffer_new.
+
+A running asynchronous measurement may still write into the buffer, it is waited for first.
+	@param ptBuffer		pointer to the buffer, can be NULL
+	*/
+void sample_buffer_free(SAMPLE_BUFFER_T* ptBuffer)
+{
+	async_measurement_wait_running();
+	free(ptBuffer);
+}
+
+
+
+/** \brief reads all connected devices into a sample buffer.
+
+Devices which do not fit into the buffer are not read.
+	@param apHandles	array that stores ftdi2232h handles
+	@param ptBuffer		sample buffer
+
+	@return 			number of devices which were read
+	*/
+int sample_buffer_read(void** apHandles, SAMPLE_BUFFER_T* ptBuffer)
+{
+	unsigned int uiDevices;
+	int devIndex;
+
+
+	uiDevices = (unsigned int)get_number_of_handles(apHandles) / 2;
+	if( uiDevices>ptBuffer->uiDevices )
+	{
+		uiDevices = ptBuffer->uiDevices;
+	}
+
+	for(devIndex=0; devIndex<(int)uiDevices; devIndex++)
+	{
+		ptBuffer->aiResults[devIndex] = read_colors(apHandles, devIndex,
+		                                            ptBuffer->ausClear + devIndex*16, ptBuffer->ausRed + devIndex*16,
+		                                            ptBuffer->ausGreen + devIndex*16, ptBuffer->ausBlue + devIndex*16,
+		                                            ptBuffer->aucIntegrationtime + devIndex*16, ptBuffer->aucGain + devIndex*16);
+	}
+	ptBuffer->uiValidDevices = uiDevices;
+	ptBuffer->ulSequence++;
+
+	return (int)uiDevices;
+}
+
+
+
+/** \brief reads all connected devices into a sample buffer like sample_buffer_read and measures the time of the reading.
+
+The time is the USB and I2C round trip of all devices without any conversion wait, it is used to plan measurements with a
+deadline (see Color_control:measureWithin in lua/color_control.lua).
+	@param apHandles	array that stores ftdi2232h handles
+	@param ptBuffer		sample buffer
+	@param pulTime_us	returns the time of the reading in microseconds
+
+	@return 			number of devices which were read
+	*/
+int sample_buffer_read_timed(void** apHandles, SAMPLE_BUFFER_T* ptBuffer, unsigned long* pulTime_us)
+{
+	unsigned long long ullStart;
+	int iDevices;
+
+
+	ullStart = timestamp_us();
+	iDevices = sample_buffer_read(apHandles, ptBuffer);
+	*pulTime_us = (unsigned long)(timestamp_us() - ullStart);
+
+	return iDevices;
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+/** \file sample_buffer.h
+
+	 \brief Buffer for the raw readings of several color controller devices (header)
+
+A sample buffer holds the raw readings, the settings and the results of a fixed number of devices in contiguous arrays,
+16 lanes per device. It is filled by the acquisition functions in C and read from Lua through views, without copying
+the values into Lua tables.
+
+ */
+
+#ifndef __SAMPLE_BUFFER_H__
+#define __SAMPLE_BUFFER_H__
+
+/** \brief raw readings of several devices, the values of device n start at index n*16 */
+typedef struct SAMPLE_BUFFER_STRUCT
+{
+	/** number of devices the buffer can hold */
+	unsigned int uiDevices;
+	/** number of devices which were stored with the last reading */
+	unsigned int uiValidDevices;
+	/** number of readings which were stored in the buffer so far */
+	unsigned long ulSequence;
+	/** clear values */
+	unsigned short* ausClear;
+	/** red values */
+	unsigned short* ausRed;
+	/** green values */
+	unsigned short* ausGreen;
+	/** blue values */
+	unsigned short* ausBlue;
+	/** integration time settings */
+	unsigned char* aucIntegrationtime;
+	/** gain settings */
+	unsigned char* aucGain;
+	/** result of read_colors, one per device */
+	int* aiResults;
+} SAMPLE_BUFFER_T;
+
+SAMPLE_BUFFER_T* sample_buffer_new (unsigned int uiDevices);
+void             sample_buffer_free(SAMPLE_BUFFER_T* ptBuffer);
+int              sample_buffer_read(void** apHandles, SAMPLE_BUFFER_T* ptBuffer);
+int              sample_buffer_read_timed(void** apHandles, SAMPLE_BUFFER_T* ptBuffer, unsigned long* pulTime_us);
+
+#endif	/* __SAMPLE_BUFFER_H__ */
@@ -5,13 +5,17 @@
 	\brief defines a sleep macro which distinguishes between windows / linux
 	
 This file provides a sleep_ms(ms) macro which calls the right sleep function depending on the operating system
+and a sleep_us(us) macro for waits shorter than one millisecond. Sleep on windows has the resolution of the system
+timer tick (up to 15.6 ms), so sleep_us only gives up the rest of the time slice there.
 */
 
 #if defined(_WIN32)
 #       define sleep_ms(ms) Sleep(ms)
+#       define sleep_us(us) Sleep(0)
 #else
 #       include <unistd.h>
-#       define sleep_ms(ms) usleep(1000*ms)
+#       define sleep_ms(ms) usleep(1000*(ms))
+#       define sleep_us(us) usleep(us)
 #endif
 
 
@@ -50,6 +50,7 @@ int tcs_identify(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigne
 {
     unsigned int uiErrorcounter = 0;
     unsigned int uiSuccesscounter = 0;
+	unsigned int uiSensors;
 	int usErrorMask = 0;
 	int iRetval;
     int i = 0;
@@ -58,11 +59,14 @@ int tcs_identify(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigne
     unsigned char aucErrorbuffer[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
         if((iRetval = i2c_read8(ftdiA, ftdiB, aucTempbuffer, sizeof(aucTempbuffer), aucReadbuffer, sizeof(aucReadbuffer))) < 0) return iRetval;
-		
+
+		/* The sensors of a channel which is not open are not identified */
+		uiSensors = get_channel_sensors(ftdiA, ftdiB);
+
             for(i = 0; i<=15; i++)
             {
 				/* 0x14 = ID for tcs3471        0x44 = ID for tcs3472 */
-               if(aucReadbuffer[i] != TCS3472_1_5_VALUE && aucReadbuffer[i] != TCS3472_2_5_VALUE)
+               if((uiSensors & (1U<<i)) != 0 && aucReadbuffer[i] != TCS3472_1_5_VALUE && aucReadbuffer[i] != TCS3472_2_5_VALUE)
                {
                     aucErrorbuffer[i] = i+1;
                     uiErrorcounter ++;
@@ -88,6 +92,34 @@ int tcs_identify(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigne
 		
 }
 
+
+/** \brief checks which of the 16 sensors acknowledge their address.
+
+Function sends only the address of the sensors and checks their acknowledge bits (see i2c_probe). This takes one very short
+transaction, so missing or broken sensors are found before they are identified or read. The sensors of a channel which is
+not open are not checked.
+	@param ftdiA, ftdiB 	pointer to ftdi_context
+
+	@retval 0  Succesful, all sensors acknowledged
+	@retval >0 One or more sensors did not acknowledge,
+			   if the return code is 0b0000000000101100 for example, sensor 3, sensor 4 and sensor 6 are missing
+	@retval <0 USB or i2c errors occured, check return value for further information
+	*/
+int tcs_probe(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB)
+{
+	unsigned int uiPresent;
+	int iRetval;
+
+
+	iRetval = i2c_probe(ftdiA, ftdiB, (TCS_ADDRESS<<1), &uiPresent);
+	if( iRetval<0 )
+	{
+		return iRetval;
+	}
+
+	return (int)(get_channel_sensors(ftdiA, ftdiB) & ~uiPresent);
+}
+
    
 /** \brief turns 16 tcs3472 sensors on, releasing them from their sleep state.
 
@@ -181,6 +213,94 @@ int tcs_setGain_x(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, tcs347
     return i2c_write8_x(ftdiA, ftdiB, aucTempbuffer, sizeof(aucTempbuffer), uiX);
 }
 
+/** \brief sets an individual integration time for each of the 16 sensors at once.
+
+Function writes the integration time register of all 16 sensors in one i2c transaction, each sensor gets
+its own value. This is much faster than calling tcs_setIntegrationTime_x 16 times.
+	@param ftdiA, ftdiB 		pointer to ftdi_context
+	@param aucIntegrationtime	integration time for each of the 16 sensors
+
+	@retval 0  Succesful
+	@retval <0 USB or i2c errors occured, check return value for further information
+*/
+int tcs_setIntegrationTime_lanes(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucIntegrationtime)
+{
+    unsigned char aucTempbuffer[2] = {(TCS_ADDRESS<<1), TCS3472_ATIME_REG | TCS3472_COMMAND_BIT};
+    return i2c_write8_lanes(ftdiA, ftdiB, aucTempbuffer, aucIntegrationtime);
+}
+
+/** \brief sets an individual gain for each of the 16 sensors at once.
+
+Function writes the gain register of all 16 sensors in one i2c transaction, each sensor gets
+its own value. This is much faster than calling tcs_setGain_x 16 times.
+	@param ftdiA, ftdiB 		pointer to ftdi_context
+	@param aucGain				gain setting for each of the 16 sensors
+
+	@retval 0  Succesful
+	@retval <0 USB or i2c errors occured, check return value for further information
+*/
+int tcs_setGain_lanes(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucGain)
+{
+    unsigned char aucTempbuffer[2] = {(TCS_ADDRESS<<1), TCS3472_CONTROL_REG | TCS3472_COMMAND_BIT};
+    return i2c_write8_lanes(ftdiA, ftdiB, aucTempbuffer, aucGain);
+}
+
+/** \brief restarts the RGBC integration cycle of 16 sensors.
+
+A new integration time or gain setting takes effect with the next integration cycle. The function disables
+the RGBC ADCs and enables them again, thus the sensors discard the cycle which is currently running and start
+a fresh one with the current settings. The results are valid after the init time (2.4ms) plus one integration time.
+	@param ftdiA, ftdiB 	pointer to ftdi_context
+
+	@retval 0  Succesful
+	@retval <0 USB or i2c errors occured, check return value for further information
+*/
+int tcs_restartIntegration(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB)
+{
+	int iRetval;
+	unsigned char aucTempbuffer[3] = {(TCS_ADDRESS<<1), TCS3472_ENABLE_REG | TCS3472_COMMAND_BIT, TCS3472_PON_BIT};
+
+	iRetval = i2c_write8(ftdiA, ftdiB, aucTempbuffer, sizeof(aucTempbuffer));
+	if( iRetval<0 )
+	{
+		return iRetval;
+	}
+
+	return tcs_ON(ftdiA, ftdiB);
+}
+
+/** \brief returns the time in milliseconds one integration cycle takes with a given integration time register value.
+
+The integration time is 2.4ms * (256 - ATIME). The result is rounded up to full milliseconds.
+	@param ucIntegrationtime	content of the integration time register
+	@return						integration time in milliseconds
+*/
+unsigned int tcs_getConversionTime_ms(unsigned char ucIntegrationtime)
+{
+	return (24U * (256U - ucIntegrationtime) + 9U) / 10U;
+}
+
+/** \brief returns the maximum clear count which can be reached with a given integration time register value.
+
+The maximum count of the ADCs is 1024 * (256 - ATIME), but at most 65535. Refer to the RGBC timing register
+in the sensor's datasheet.
+	@param ucIntegrationtime	content of the integration time register
+	@return						maximum clear count
+*/
+unsigned int tcs_getMaxClear(unsigned char ucIntegrationtime)
+{
+	unsigned int uiMaxClear;
+
+
+	uiMaxClear = 1024U * (256U - ucIntegrationtime);
+	if( uiMaxClear>65535U )
+	{
+		uiMaxClear = 65535U;
+	}
+
+	return uiMaxClear;
+}
+
 
 /** \brief checks if the ADCs for color measurement have already completed.
 
@@ -197,44 +317,12 @@ code can be used to determine which of the 16 sensor(s) failed.
 	*/
 int tcs_waitForData(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB)
 {
-    unsigned int uiErrorcounter = 0;
-    unsigned int uiSuccesscounter = 0;
-	
-	int usErrorMask = 0;
-    int i = 0;
-
     unsigned char aucTempbuffer[2] = {(TCS_ADDRESS<<1), TCS3472_STATUS_REG | TCS3472_COMMAND_BIT};
     unsigned char aucReadbuffer[16];
-	unsigned char aucErrorbuffer[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
         i2c_read8(ftdiA, ftdiB, aucTempbuffer, sizeof(aucTempbuffer), aucReadbuffer, sizeof(aucReadbuffer));
 
-            for(i = 0; i<=15; i++)
-            {
-               if((aucReadbuffer[i]&TCS3472_AVALID_BIT) != TCS3472_AVALID_BIT)
-               {
-                    aucErrorbuffer[i] = i+1;
-					usErrorMask  |= (1<<i);
-                    uiErrorcounter ++;
-               }
-               else uiSuccesscounter ++;
-
-               if(uiSuccesscounter == 16)
-               {
-                   printf("Conversions complete.\n");
-                   return 0; 
-               }
-            }
-
-        printf("Incomplete conversions for following Sensors ...\n");
-        for(i = 0; i<16; i++)
-        {
-            if(aucErrorbuffer[i] != 0xFF) printf("%d ", aucErrorbuffer[i]);
-        }
-        printf("\n");
-       			
-		return usErrorMask;
-		
+		return tcs_conversions_complete(aucReadbuffer, get_channel_sensors(ftdiA, ftdiB));
 }
 
 /** \brief checks if the ADCs for color measurement have already completed. Takes the status register as parameter.
@@ -244,13 +332,14 @@ read and used for further calculations. This can be checked by reading a special
 If TCS3472_AVALID_BIT is set in this register, the ADCs have completed color measurements. If measurements are not completed, the return 
 code can be used to determine which of the 16 sensor(s) failed.
 	@param aucStatusRegister 	holds the values of the status register for all 16 sensors 
+	@param uiSensors			the sensors to check, bit 0 is sensor 0, the others count as complete (see get_channel_sensors)
 	
 	@retval 0  Succesful 
 	@retval >0 One or more sensors have not completed the conversion cycle yet, 
 			   if the return code is 0b0000000000101100 for example, we have uncompleted conversions for sensor 3, sensor 4 and sensor 6 
 	*/
 	
-int tcs_conversions_complete(unsigned char* aucStatusRegister)
+int tcs_conversions_complete(unsigned char* aucStatusRegister, unsigned int uiSensors)
 {
     unsigned int uiErrorcounter = 0;
     unsigned int uiSuccesscounter = 0;
@@ -262,7 +351,7 @@ int tcs_conversions_complete(unsigned char* aucStatusRegister)
 
             for(i = 0; i<=15; i++)
             {
-               if((aucStatusRegister[i]&TCS3472_AVALID_BIT) != TCS3472_AVALID_BIT)
+               if((uiSensors & (1U<<i)) != 0 && (aucStatusRegister[i]&TCS3472_AVALID_BIT) != TCS3472_AVALID_BIT)
                {
                     aucErrorbuffer[i] = i+1;
 					usErrorMask  |= (1<<i);
@@ -358,11 +447,94 @@ int tcs_readColors(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsig
 	}
 	
 	/* Now check if conversions had already completed - 0 if so */
-	return tcs_conversions_complete(aucStatusRegister);
+	return tcs_conversions_complete(aucStatusRegister, get_channel_sensors(ftdiA, ftdiB));
 	
 }
 
 
+/** \brief reads a window of the color registers of 16 sensors in one i2c command.
+
+The window starts at its first register and all registers of the window are read with the autoincrement bit, so the
+i2c frame only has the bytes which are needed, e.g. 2 bytes per sensor for the clear channel instead of the 9 bytes of
+tcs_readColors. The channels which are not part of the window are not changed and can be NULL.
+	@param ftdiA, ftdiB 	pointer to ftdi_context
+	@param tWindow			the registers to read, see tcs_window_t
+	@param ausClear      	will contain color value read back from 16 sensors
+	@param ausRed        	will contain color value read back from 16 sensors
+	@param ausGreen      	will contain color value read back from 16 sensors
+	@param ausBlue       	will contain color value read back from 16 sensors
+
+	@retval 0  Succesful
+	@retval <0 USB or i2c errors occured, check return value for further information
+	@retval >0 One or more sensors have not completed the conversion cycle yet (only windows with the status register),
+			   if the return code is 0b0000000000101100 for example, we have uncompleted conversions for sensor 3, sensor 4 and sensor 6
+	*/
+int tcs_readWindow(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, tcs_window_t tWindow, unsigned short* ausClear,
+					unsigned short* ausRed, unsigned short* ausGreen, unsigned short* ausBlue)
+{
+	int iRetval;
+	unsigned char aucTempbuffer[2] = {(TCS_ADDRESS<<1), TCS3472_AUTOINCR_BIT | TCS3472_COMMAND_BIT};
+	unsigned char aucReadbuffer[16*TCS_WINDOW_MAX_BYTES];
+	unsigned char ucBytes;
+	unsigned int uiOffset;
+	unsigned int uiRgb;
+	unsigned int i;
+
+	switch(tWindow)
+	{
+		case TCS_WINDOW_CLEAR:
+			aucTempbuffer[1] |= TCS3472_CDATA_REG;
+			ucBytes = 2;
+			break;
+		case TCS_WINDOW_STATUS_CLEAR:
+			aucTempbuffer[1] |= TCS3472_STATUS_REG;
+			ucBytes = 3;
+			break;
+		case TCS_WINDOW_RGB:
+			aucTempbuffer[1] |= TCS3472_RDATA_REG;
+			ucBytes = 6;
+			break;
+		case TCS_WINDOW_FULL:
+			aucTempbuffer[1] |= TCS3472_STATUS_REG;
+			ucBytes = 9;
+			break;
+		default:
+			printf("Unknown register window ... \n");
+			return ERR_INCORRECT_AMOUNT;
+	}
+
+	if((iRetval = i2c_read_bytes(ftdiA, ftdiB, aucTempbuffer, sizeof(aucTempbuffer), aucReadbuffer, ucBytes)) < 0)
+	{
+		/* Fatal error has occured */
+		return iRetval;
+	}
+
+	/* The words are little endian, the status register comes before them and RDATA follows CDATAH in the full window */
+	uiOffset = (tWindow==TCS_WINDOW_STATUS_CLEAR || tWindow==TCS_WINDOW_FULL) ? 16 : 0;
+	uiRgb = (tWindow==TCS_WINDOW_FULL) ? uiOffset+32 : 0;
+	for(i=0; i<16; i++)
+	{
+		if( tWindow!=TCS_WINDOW_RGB )
+		{
+			ausClear[i] = (unsigned short)(aucReadbuffer[uiOffset+i] | (aucReadbuffer[uiOffset+16+i]<<8));
+		}
+		if( tWindow==TCS_WINDOW_RGB || tWindow==TCS_WINDOW_FULL )
+		{
+			ausRed[i]   = (unsigned short)(aucReadbuffer[uiRgb+i]    | (aucReadbuffer[uiRgb+16+i]<<8));
+			ausGreen[i] = (unsigned short)(aucReadbuffer[uiRgb+32+i] | (aucReadbuffer[uiRgb+48+i]<<8));
+			ausBlue[i]  = (unsigned short)(aucReadbuffer[uiRgb+64+i] | (aucReadbuffer[uiRgb+80+i]<<8));
+		}
+	}
+
+	if( uiOffset==0 )
+	{
+		return 0;
+	}
+	/* Now check if conversions had already completed - 0 if so */
+	return tcs_conversions_complete(aucReadbuffer, get_channel_sensors(ftdiA, ftdiB));
+}
+
+
 /** \brief sends 16 sensors to sleep.
 
 Function sends 16 color sensors to sleep state.
@@ -628,13 +800,33 @@ integration time settings.
 	@param ftdiA, ftdiB 		pointer to ftdi_context
 	@param aucIntegrationtime	pointer to buffer which will store the integration time settings of the 16 sensors
 	
+	The sensors of a channel which is not open get the shortest integration time, so they do not lengthen any wait time.
+
 	@retval 0  Succesful 
 	@retval <0 USB or i2c errors occured, check return value for further information 	
 */
 int tcs_getIntegrationtime(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucIntegrationtime)
 {
 	unsigned char aucTempbuffer[2] = {(TCS_ADDRESS<<1), TCS3472_ATIME_REG | TCS3472_COMMAND_BIT};	
-	return i2c_read8(ftdiA, ftdiB, aucTempbuffer, sizeof(aucTempbuffer), aucIntegrationtime, sizeof(aucIntegrationtime));
+	unsigned int uiSensors;
+	int iRetval;
+	int i;
+
+
+	iRetval = i2c_read8(ftdiA, ftdiB, aucTempbuffer, sizeof(aucTempbuffer), aucIntegrationtime, sizeof(aucIntegrationtime));
+	if( iRetval==0 )
+	{
+		uiSensors = get_channel_sensors(ftdiA, ftdiB);
+		for(i=0; i<16; i++)
+		{
+			if( (uiSensors & (1U<<i))==0 )
+			{
+				aucIntegrationtime[i] = TCS3472_INTEGRATION_2_4ms;
+			}
+		}
+	}
+
+	return iRetval;
 }
 
 /** \brief returns a divisor which corresponds to a specific gain setting.
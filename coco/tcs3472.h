@@ -171,10 +171,31 @@ typedef enum
 	CLEAR     = 0x03  
 }
  tcs_color_t;
+
+/** \brief register windows for a reading of consecutive registers with the autoincrement bit (see tcs_readWindow)
+
+A window starts at its first register and is read in one i2c transaction, a smaller window needs less bytes on the bus.
+*/
+typedef enum
+{
+	/** clear channel only (CDATA, CDATAH), 2 bytes */
+	TCS_WINDOW_CLEAR        = 0,
+	/** status register and clear channel (STATUS, CDATA, CDATAH), 3 bytes */
+	TCS_WINDOW_STATUS_CLEAR = 1,
+	/** red, green and blue channels (RDATA to BDATAH), 6 bytes */
+	TCS_WINDOW_RGB          = 2,
+	/** status register and all 4 channels (STATUS to BDATAH), 9 bytes, the same as tcs_readColors */
+	TCS_WINDOW_FULL         = 3
+}
+ tcs_window_t;
+
+/** maximum number of bytes of a register window */
+#define TCS_WINDOW_MAX_BYTES 9
  
 int tcs_identify			(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucReadbuffer);
+int tcs_probe				(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB);
 int tcs_waitForData			(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB);
-int tcs_conversions_complete(unsigned char* aucStatusRegister);
+int tcs_conversions_complete(unsigned char* aucStatusRegister, unsigned int uiSensors);
 int tcs_readColor			(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned short* ausColourArray, tcs_color_t color);
 int tcs_sleep				(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB);
 int tcs_wakeUp				(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB);
@@ -187,9 +208,16 @@ int tcs_getGain				 (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, uns
 int tcs_setIntegrationTime   (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, tcs3472Integration_t integration);
 int tcs_setIntegrationTime_x (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, tcs3472Integration_t integration, unsigned int uiX);
 int tcs_setGain  		     (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, tcs3472Gain_t gain);
-int tcs_setGain_x 			 (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, tcs3472Gain_t gain, unsigned int uiX); 
+int tcs_setGain_x 			 (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, tcs3472Gain_t gain, unsigned int uiX);
+int tcs_setIntegrationTime_lanes(struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucIntegrationtime);
+int tcs_setGain_lanes		 (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned char* aucGain);
+int tcs_restartIntegration	 (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB);
+unsigned int tcs_getConversionTime_ms(unsigned char ucIntegrationtime);
+unsigned int tcs_getMaxClear (unsigned char ucIntegrationtime);
 int tcs_readColors 		     (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, unsigned short* ausClear, unsigned short* ausRed,
 											 unsigned short* ausGreen, unsigned short* ausBlue);
+int tcs_readWindow 		     (struct ftdi_context* ftdiA, struct ftdi_context* ftdiB, tcs_window_t tWindow, unsigned short* ausClear,
+											 unsigned short* ausRed, unsigned short* ausGreen, unsigned short* ausBlue);
 void tcs_calculate_CCT_Lux	(unsigned char* aucGain, unsigned char* aucIntegrationtime, unsigned short* ausClear, unsigned short* ausRed,
 											 unsigned short* ausGreen, unsigned short* ausBlue, unsigned short* CCT, float* afLUX);
 									
@@ -0,0 +1,854 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+/** \file tcs_chroma_table.c
+
+	 \brief Chromaticity data of the TCS3472 color sensor
+
+The table contains the direction vectors from the reference white point (x = 0.312727, y = 0.329023) to the spectral
+locus of the TCS3472, in steps of 0.3125nm from 405nm to 660nm. The spectral sensitivity data of the sensor was provided by
+AMS/TAOS, interpolated and converted into Yxy. The data is the same as tTCS_dirVector in lua/tcs_chromaTable.lua.
+
+ */
+
+#include "tcs_chroma_table.h"
+
+
+const TCS_CHROMA_ENTRY_T atTcsDirVector[TCS_CHROMA_ENTRIES] =
+{
+	{ 405.0000, -0.129474393323561, -0.241324188628289 },
+	{ 405.3125, -0.129967374547898, -0.241598079404717 },
+	{ 405.6250, -0.130478111350176, -0.241887586050175 },
+	{ 405.9375, -0.131004067219260, -0.242190477726230 },
+	{ 406.2500, -0.131542705644016, -0.242504523594449 },
+	{ 406.5625, -0.132091490113310, -0.242827492816399 },
+	{ 406.8750, -0.132647884116006, -0.243157154553647 },
+	{ 407.1875, -0.133209351140971, -0.243491277967760 },
+	{ 407.5000, -0.133773354677071, -0.243827632220307 },
+	{ 407.8125, -0.134337358213171, -0.244163986472853 },
+	{ 408.1250, -0.134898825238136, -0.244498109886967 },
+	{ 408.4375, -0.135455219240832, -0.244827771624215 },
+	{ 408.7500, -0.136004003710126, -0.245150740846165 },
+	{ 409.0625, -0.136542642134882, -0.245464786714384 },
+	{ 409.3750, -0.137068598003966, -0.245767678390438 },
+	{ 409.6875, -0.137579334806244, -0.246057185035896 },
+	{ 410.0000, -0.138072316030581, -0.246331075812325 },
+	{ 410.3125, -0.138546006229236, -0.246587972095951 },
+	{ 410.6250, -0.139002874208035, -0.246829904121643 },
+	{ 410.9375, -0.139446389836197, -0.247059754338929 },
+	{ 411.2500, -0.139880022982941, -0.247280405197336 },
+	{ 411.5625, -0.140307243517486, -0.247494739146394 },
+	{ 411.8750, -0.140731521309050, -0.247705638635629 },
+	{ 412.1875, -0.141156326226854, -0.247915986114570 },
+	{ 412.5000, -0.141585128140115, -0.248128664032745 },
+	{ 412.8125, -0.142020463559968, -0.248345903228587 },
+	{ 413.1250, -0.142461135565209, -0.248567328096147 },
+	{ 413.4375, -0.142905013876550, -0.248791911418383 },
+	{ 413.7500, -0.143349968214702, -0.249018625978250 },
+	{ 414.0625, -0.143793868300376, -0.249246444558705 },
+	{ 414.3750, -0.144234583854284, -0.249474339942705 },
+	{ 414.6875, -0.144669984597138, -0.249701284913207 },
+	{ 415.0000, -0.145097940249648, -0.249926252253166 },
+	{ 415.3125, -0.145517172854514, -0.250148657913486 },
+	{ 415.6250, -0.145929813742381, -0.250369690516857 },
+	{ 415.9375, -0.146338846565885, -0.250590981853912 },
+	{ 416.2500, -0.146747254977657, -0.250814163715289 },
+	{ 416.5625, -0.147158022630332, -0.251040867891621 },
+	{ 416.8750, -0.147574133176544, -0.251272726173546 },
+	{ 417.1875, -0.147998570268926, -0.251511370351697 },
+	{ 417.5000, -0.148434317560112, -0.251758432216711 },
+	{ 417.8125, -0.148882571971305, -0.252014287374536 },
+	{ 418.1250, -0.149337383497991, -0.252274286692371 },
+	{ 418.4375, -0.149791015404226, -0.252532524852728 },
+	{ 418.7500, -0.150235730954066, -0.252783096538118 },
+	{ 419.0625, -0.150663793411564, -0.253020096431055 },
+	{ 419.3750, -0.151067466040779, -0.253237619214048 },
+	{ 419.6875, -0.151439012105764, -0.253429759569612 },
+	{ 420.0000, -0.151770694870575, -0.253590612180257 },
+	{ 420.3125, -0.152057453051383, -0.253716366070421 },
+	{ 420.6250, -0.152304927172813, -0.253811587632247 },
+	{ 420.9375, -0.152521433211604, -0.253882937599802 },
+	{ 421.2500, -0.152715287144497, -0.253937076707156 },
+	{ 421.5625, -0.152894804948232, -0.253980665688375 },
+	{ 421.8750, -0.153068302599548, -0.254020365277529 },
+	{ 422.1875, -0.153244096075186, -0.254062836208685 },
+	{ 422.5000, -0.153430501351885, -0.254114739215911 },
+	{ 422.8125, -0.153633468434160, -0.254180723432009 },
+	{ 423.1250, -0.153849483437625, -0.254257391584709 },
+	{ 423.4375, -0.154072666505670, -0.254339334800477 },
+	{ 423.7500, -0.154297137781682, -0.254421144205775 },
+	{ 424.0625, -0.154517017409052, -0.254497410927069 },
+	{ 424.3750, -0.154726425531168, -0.254562726090823 },
+	{ 424.6875, -0.154919482291419, -0.254611680823500 },
+	{ 425.0000, -0.155090307833195, -0.254638866251565 },
+	{ 425.3125, -0.155234788458951, -0.254640510255732 },
+	{ 425.6250, -0.155355875107420, -0.254619387733711 },
+	{ 425.9375, -0.155458284876398, -0.254579910337463 },
+	{ 426.2500, -0.155546734863684, -0.254526489718948 },
+	{ 426.5625, -0.155625942167077, -0.254463537530128 },
+	{ 426.8750, -0.155700623884374, -0.254395465422961 },
+	{ 427.1875, -0.155775497113374, -0.254326685049410 },
+	{ 427.5000, -0.155855278951876, -0.254261608061433 },
+	{ 427.8125, -0.155943483284264, -0.254203631731300 },
+	{ 428.1250, -0.156038811141276, -0.254152095812511 },
+	{ 428.4375, -0.156138760340234, -0.254105325678876 },
+	{ 428.7500, -0.156240828698463, -0.254061646704202 },
+	{ 429.0625, -0.156342514033286, -0.254019384262299 },
+	{ 429.3750, -0.156441314162027, -0.253976863726975 },
+	{ 429.6875, -0.156534726902009, -0.253932410472039 },
+	{ 430.0000, -0.156620250070557, -0.253884349871301 },
+	{ 430.3125, -0.156696139109888, -0.253831414198834 },
+	{ 430.6250, -0.156763679961803, -0.253773963329779 },
+	{ 430.9375, -0.156824916192993, -0.253712764039542 },
+	{ 431.2500, -0.156881891370154, -0.253648583103532 },
+	{ 431.5625, -0.156936649059978, -0.253582187297152 },
+	{ 431.8750, -0.156991232829159, -0.253514343395812 },
+	{ 432.1875, -0.157047686244391, -0.253445818174916 },
+	{ 432.5000, -0.157108052872367, -0.253377378409872 },
+	{ 432.8125, -0.157173631682352, -0.253309684347178 },
+	{ 433.1250, -0.157242743253891, -0.253242970117706 },
+	{ 433.4375, -0.157312963569097, -0.253177363323418 },
+	{ 433.7500, -0.157381868610087, -0.253112991566277 },
+	{ 434.0625, -0.157447034358974, -0.253049982448246 },
+	{ 434.3750, -0.157506036797876, -0.252988463571288 },
+	{ 434.6875, -0.157556451908905, -0.252928562537366 },
+	{ 435.0000, -0.157595855674178, -0.252870406948443 },
+	{ 435.3125, -0.157622600522458, -0.252814078718406 },
+	{ 435.6250, -0.157638144669105, -0.252759477008833 },
+	{ 435.9375, -0.157644722776126, -0.252706455293229 },
+	{ 436.2500, -0.157644569505529, -0.252654867045096 },
+	{ 436.5625, -0.157639919519324, -0.252604565737936 },
+	{ 436.8750, -0.157633007479517, -0.252555404845254 },
+	{ 437.1875, -0.157626068048118, -0.252507237840551 },
+	{ 437.5000, -0.157621335887133, -0.252459918197331 },
+	{ 437.8125, -0.157620490417019, -0.252413211784723 },
+	{ 438.1250, -0.157622990092019, -0.252366534054365 },
+	{ 438.4375, -0.157627738124823, -0.252319212853520 },
+	{ 438.7500, -0.157633637728122, -0.252270576029452 },
+	{ 439.0625, -0.157639592114608, -0.252219951429424 },
+	{ 439.3750, -0.157644504496970, -0.252166666900700 },
+	{ 439.6875, -0.157647278087900, -0.252110050290544 },
+	{ 440.0000, -0.157646816100088, -0.252049429446219 },
+	{ 440.3125, -0.157642358083645, -0.251984493744791 },
+	{ 440.6250, -0.157634488938360, -0.251916378682531 },
+	{ 440.9375, -0.157624129901444, -0.251846581285511 },
+	{ 441.2500, -0.157612202210105, -0.251776598579806 },
+	{ 441.5625, -0.157599627101555, -0.251707927591487 },
+	{ 441.8750, -0.157587325813001, -0.251642065346628 },
+	{ 442.1875, -0.157576219581655, -0.251580508871302 },
+	{ 442.5000, -0.157567229644725, -0.251524755191581 },
+	{ 442.8125, -0.157560897547968, -0.251475388855829 },
+	{ 443.1250, -0.157556246071328, -0.251429344501569 },
+	{ 443.4375, -0.157551918303294, -0.251382644288616 },
+	{ 443.7500, -0.157546557332356, -0.251331310376783 },
+	{ 444.0625, -0.157538806247004, -0.251271364925886 },
+	{ 444.3750, -0.157527308135728, -0.251198830095737 },
+	{ 444.6875, -0.157510706087017, -0.251109728046151 },
+	{ 445.0000, -0.157487643189362, -0.251000080936943 },
+	{ 445.3125, -0.157457277535630, -0.250867507227409 },
+	{ 445.6250, -0.157420827236202, -0.250716010574780 },
+	{ 445.9375, -0.157380025405837, -0.250551190935769 },
+	{ 446.2500, -0.157336605159292, -0.250378648267090 },
+	{ 446.5625, -0.157292299611327, -0.250203982525456 },
+	{ 446.8750, -0.157248841876700, -0.250032793667581 },
+	{ 447.1875, -0.157207965070168, -0.249870681650179 },
+	{ 447.5000, -0.157171402306492, -0.249723246429962 },
+	{ 447.8125, -0.157140130805727, -0.249593553369408 },
+	{ 448.1250, -0.157112104209124, -0.249474529454042 },
+	{ 448.4375, -0.157084520263232, -0.249356567075154 },
+	{ 448.7500, -0.157054576714598, -0.249230058624031 },
+	{ 449.0625, -0.157019471309771, -0.249085396491964 },
+	{ 449.3750, -0.156976401795301, -0.248912973070241 },
+	{ 449.6875, -0.156922565917735, -0.248703180750150 },
+	{ 450.0000, -0.156855161423622, -0.248446411922982 },
+	{ 450.3125, -0.156772503537824, -0.248136934172203 },
+	{ 450.6250, -0.156677377398453, -0.247784515850003 },
+	{ 450.9375, -0.156573685621936, -0.247402800500748 },
+	{ 451.2500, -0.156465330824699, -0.247005431668807 },
+	{ 451.5625, -0.156356215623168, -0.246606052898545 },
+	{ 451.8750, -0.156250242633769, -0.246218307734331 },
+	{ 452.1875, -0.156151314472928, -0.245855839720532 },
+	{ 452.5000, -0.156063333757071, -0.245532292401515 },
+	{ 452.8125, -0.155988346844948, -0.245254738791755 },
+	{ 453.1250, -0.155920975064604, -0.245003969786149 },
+	{ 453.4375, -0.155853983486407, -0.244754205749703 },
+	{ 453.7500, -0.155780137180726, -0.244479667047423 },
+	{ 454.0625, -0.155692201217928, -0.244154574044312 },
+	{ 454.3750, -0.155582940668382, -0.243753147105376 },
+	{ 454.6875, -0.155445120602457, -0.243249606595620 },
+	{ 455.0000, -0.155271506090520, -0.242618172880049 },
+	{ 455.3125, -0.155057074824307, -0.241840956275878 },
+	{ 455.6250, -0.154805654981017, -0.240931626909161 },
+	{ 455.9375, -0.154523287359217, -0.239911744858164 },
+	{ 456.2500, -0.154216012757473, -0.238802870201151 },
+	{ 456.5625, -0.153889871974351, -0.237626563016387 },
+	{ 456.8750, -0.153550905808419, -0.236404383382136 },
+	{ 457.1875, -0.153205155058242, -0.235157891376663 },
+	{ 457.5000, -0.152858660522386, -0.233908647078233 },
+	{ 457.8125, -0.152516800872808, -0.232675859591948 },
+	{ 458.1250, -0.152182306275018, -0.231469334130254 },
+	{ 458.4375, -0.151857244767916, -0.230296524932435 },
+	{ 458.7500, -0.151543684390404, -0.229164886237776 },
+	{ 459.0625, -0.151243693181381, -0.228081872285561 },
+	{ 459.3750, -0.150959339179748, -0.227054937315074 },
+	{ 459.6875, -0.150692690424405, -0.226091535565598 },
+	{ 460.0000, -0.150445814954253, -0.225199121276418 },
+	{ 460.3125, -0.150220008548922, -0.224382365306130 },
+	{ 460.6250, -0.150013477950965, -0.223634804990576 },
+	{ 460.9375, -0.149823657643665, -0.222947194284912 },
+	{ 461.2500, -0.149647982110306, -0.222310287144292 },
+	{ 461.5625, -0.149483885834170, -0.221714837523871 },
+	{ 461.8750, -0.149328803298541, -0.221151599378804 },
+	{ 462.1875, -0.149180168986701, -0.220611326664246 },
+	{ 462.5000, -0.149035417381935, -0.220084773335352 },
+	{ 462.8125, -0.148891818318730, -0.219562134179674 },
+	{ 463.1250, -0.148745983036397, -0.219031367314355 },
+	{ 463.4375, -0.148594358125453, -0.218479871688936 },
+	{ 463.7500, -0.148433390176412, -0.217895046252959 },
+	{ 464.0625, -0.148259525779793, -0.217264289955964 },
+	{ 464.3750, -0.148069211526109, -0.216575001747493 },
+	{ 464.6875, -0.147858894005879, -0.215814580577087 },
+	{ 465.0000, -0.147625019809617, -0.214970425394286 },
+	{ 465.3125, -0.147365253559390, -0.214034251056757 },
+	{ 465.6250, -0.147082132003470, -0.213015036054668 },
+	{ 465.9375, -0.146779409921678, -0.211926074786314 },
+	{ 466.2500, -0.146460842093835, -0.210780661649986 },
+	{ 466.5625, -0.146130183299762, -0.209592091043981 },
+	{ 466.8750, -0.145791188319282, -0.208373657366589 },
+	{ 467.1875, -0.145447611932215, -0.207138655016107 },
+	{ 467.5000, -0.145103208918384, -0.205900378390827 },
+	{ 467.8125, -0.144761368038477, -0.204670869373605 },
+	{ 468.1250, -0.144424013976655, -0.203457159785551 },
+	{ 468.4375, -0.144092705397948, -0.202265028932337 },
+	{ 468.7500, -0.143769000967385, -0.201100256119633 },
+	{ 469.0625, -0.143454459349995, -0.199968620653113 },
+	{ 469.3750, -0.143150639210806, -0.198875901838447 },
+	{ 469.6875, -0.142859099214849, -0.197827878981308 },
+	{ 470.0000, -0.142581398027151, -0.196830331387367 },
+	{ 470.3125, -0.142318385500989, -0.195886433621871 },
+	{ 470.6250, -0.142068076242628, -0.194988941288363 },
+	{ 470.9375, -0.141827776046580, -0.194128005249963 },
+	{ 471.2500, -0.141594790707358, -0.193293776369789 },
+	{ 471.5625, -0.141366426019473, -0.192476405510959 },
+	{ 471.8750, -0.141139987777437, -0.191666043536593 },
+	{ 472.1875, -0.140912781775763, -0.190852841309808 },
+	{ 472.5000, -0.140682113808963, -0.190026949693724 },
+	{ 472.8125, -0.140446059192875, -0.189181336867231 },
+	{ 473.1250, -0.140205771328646, -0.188320240272312 },
+	{ 473.4375, -0.139963173138749, -0.187450714666720 },
+	{ 473.7500, -0.139720187545655, -0.186579814808211 },
+	{ 474.0625, -0.139478737471838, -0.185714595454538 },
+	{ 474.3750, -0.139240745839770, -0.184862111363455 },
+	{ 474.6875, -0.139008135571925, -0.184029417292718 },
+	{ 475.0000, -0.138782829590775, -0.183223568000080 },
+	{ 475.3125, -0.138566206529588, -0.182449610725128 },
+	{ 475.6250, -0.138357467864813, -0.181704562634776 },
+	{ 475.9375, -0.138155270783697, -0.180983433377769 },
+	{ 476.2500, -0.137958272473485, -0.180281232602854 },
+	{ 476.5625, -0.137765130121421, -0.179592969958776 },
+	{ 476.8750, -0.137574500914752, -0.178913655094281 },
+	{ 477.1875, -0.137385042040721, -0.178238297658116 },
+	{ 477.5000, -0.137195410686576, -0.177561907299025 },
+	{ 477.8125, -0.137004453451169, -0.176880246575028 },
+	{ 478.1250, -0.136811774579791, -0.176192089681233 },
+	{ 478.4375, -0.136617167729338, -0.175496963722018 },
+	{ 478.7500, -0.136420426556708, -0.174794395801765 },
+	{ 479.0625, -0.136221344718799, -0.174083913024854 },
+	{ 479.3750, -0.136019715872509, -0.173365042495664 },
+	{ 479.6875, -0.135815333674736, -0.172637311318576 },
+	{ 480.0000, -0.135607991782377, -0.171900246597970 },
+	{ 480.3125, -0.135397897713436, -0.171154773811489 },
+	{ 480.6250, -0.135186914430333, -0.170407411929822 },
+	{ 480.9375, -0.134977318756597, -0.169666078296922 },
+	{ 481.2500, -0.134771387515754, -0.168938690256742 },
+	{ 481.5625, -0.134571397531331, -0.168233165153233 },
+	{ 481.8750, -0.134379625626855, -0.167557420330350 },
+	{ 482.1875, -0.134198348625854, -0.166919373132043 },
+	{ 482.5000, -0.134029843351854, -0.166326940902267 },
+	{ 482.8125, -0.133874505559566, -0.165781349445912 },
+	{ 483.1250, -0.133725206728438, -0.165257058411630 },
+	{ 483.4375, -0.133572937269099, -0.164721835909011 },
+	{ 483.7500, -0.133408687592181, -0.164143450047648 },
+	{ 484.0625, -0.133223448108314, -0.163489668937131 },
+	{ 484.3750, -0.133008209228130, -0.162728260687050 },
+	{ 484.6875, -0.132753961362258, -0.161826993406997 },
+	{ 485.0000, -0.132451694921331, -0.160753635206563 },
+	{ 485.3125, -0.132095972874810, -0.159488755601133 },
+	{ 485.6250, -0.131695648427481, -0.158064129729270 },
+	{ 485.9375, -0.131263147342961, -0.156524334135334 },
+	{ 486.2500, -0.130810895384870, -0.154913945363682 },
+	{ 486.5625, -0.130351318316823, -0.153277539958673 },
+	{ 486.8750, -0.129896841902439, -0.151659694464664 },
+	{ 487.1875, -0.129459891905334, -0.150104985426014 },
+	{ 487.5000, -0.129052894089128, -0.148657989387082 },
+	{ 487.8125, -0.128682976974373, -0.147344246699216 },
+	{ 488.1250, -0.128336080109364, -0.146113152941728 },
+	{ 488.4375, -0.127992845799332, -0.144895067500918 },
+	{ 488.7500, -0.127633916349509, -0.143620349763088 },
+	{ 489.0625, -0.127239934065126, -0.142219359114540 },
+	{ 489.3750, -0.126791541251413, -0.140622454941575 },
+	{ 489.6875, -0.126269380213603, -0.138759996630495 },
+	{ 490.0000, -0.125654093256925, -0.136562343567602 },
+	{ 490.3125, -0.124932771691950, -0.133983040814698 },
+	{ 490.6250, -0.124118302850597, -0.131068376135590 },
+	{ 490.9375, -0.123230023070127, -0.127887822969590 },
+	{ 491.2500, -0.122287268687798, -0.124510854756005 },
+	{ 491.5625, -0.121309376040868, -0.121006944934145 },
+	{ 491.8750, -0.120315681466597, -0.117445566943320 },
+	{ 492.1875, -0.119325521302244, -0.113896194222838 },
+	{ 492.5000, -0.118358231885068, -0.110428300212009 },
+	{ 492.8125, -0.117427873666773, -0.107092489331522 },
+	{ 493.1250, -0.116527403556845, -0.103863889927584 },
+	{ 493.4375, -0.115644502579218, -0.100698761327785 },
+	{ 493.7500, -0.114766851757822, -0.097553362859710 },
+	{ 494.0625, -0.113882132116592, -0.094383953850948 },
+	{ 494.3750, -0.112978024679458, -0.091146793629087 },
+	{ 494.6875, -0.112042210470354, -0.087798141521713 },
+	{ 495.0000, -0.111062370513211, -0.084294256856416 },
+	{ 495.3125, -0.110029812016887, -0.080604221782079 },
+	{ 495.6250, -0.108950346929949, -0.076748409732773 },
+	{ 495.9375, -0.107833413385888, -0.072760016963865 },
+	{ 496.2500, -0.106688449518194, -0.068672239730722 },
+	{ 496.5625, -0.105524893460360, -0.064518274288712 },
+	{ 496.8750, -0.104352183345876, -0.060331316893201 },
+	{ 497.1875, -0.103179757308235, -0.056144563799558 },
+	{ 497.5000, -0.102017053480927, -0.051991211263149 },
+	{ 497.8125, -0.100871114954467, -0.047896130937767 },
+	{ 498.1250, -0.099739404647454, -0.043850896070902 },
+	{ 498.4375, -0.098616990435511, -0.039838755308470 },
+	{ 498.7500, -0.097498940194261, -0.035842957296389 },
+	{ 499.0625, -0.096380321799327, -0.031846750680573 },
+	{ 499.3750, -0.095256203126331, -0.027833384106940 },
+	{ 499.6875, -0.094121652050896, -0.023786106221404 },
+	{ 500.0000, -0.092971736448644, -0.019688165669882 },
+	{ 500.3125, -0.091803019239230, -0.015527777900142 },
+	{ 500.6250, -0.090618043518428, -0.011313025567353 },
+	{ 500.9375, -0.089420847426048, -0.007056958128539 },
+	{ 501.2500, -0.088215469101897, -0.002772625040722 },
+	{ 501.5625, -0.087005946685782, 0.001526924239077 },
+	{ 501.8750, -0.085796318317511, 0.005828640253835 },
+	{ 502.1875, -0.084590622136891, 0.010119473546530 },
+	{ 502.5000, -0.083392896283730, 0.014386374660140 },
+	{ 502.8125, -0.082205677839427, 0.018620916842156 },
+	{ 503.1250, -0.081025499651748, 0.022833164158123 },
+	{ 503.4375, -0.079847393510051, 0.027037803378100 },
+	{ 503.7500, -0.078666391203694, 0.031249521272144 },
+	{ 504.0625, -0.077477524522034, 0.035483004610314 },
+	{ 504.3750, -0.076275825254429, 0.039752940162669 },
+	{ 504.6875, -0.075056325190237, 0.044074014699265 },
+	{ 505.0000, -0.073814056118815, 0.048460914990162 },
+	{ 505.3125, -0.072545218588974, 0.052925133157005 },
+	{ 505.6250, -0.071250688187336, 0.057465382727787 },
+	{ 505.9375, -0.069932509259975, 0.062077182582088 },
+	{ 506.2500, -0.068592726152964, 0.066756051599488 },
+	{ 506.5625, -0.067233383212379, 0.071497508659569 },
+	{ 506.8750, -0.065856524784293, 0.076297072641909 },
+	{ 507.1875, -0.064464195214780, 0.081150262426089 },
+	{ 507.5000, -0.063058438849916, 0.086052596891690 },
+	{ 507.8125, -0.061642722841933, 0.090994011973166 },
+	{ 508.1250, -0.060226205567706, 0.095942111824473 },
+	{ 508.4375, -0.058819468210265, 0.100858917654440 },
+	{ 508.7500, -0.057433091952645, 0.105706450671896 },
+	{ 509.0625, -0.056077657977878, 0.110446732085673 },
+	{ 509.3750, -0.054763747468995, 0.115041783104599 },
+	{ 509.6875, -0.053501941609031, 0.119453624937504 },
+	{ 510.0000, -0.052302821581017, 0.123644278793218 },
+	{ 510.3125, -0.051172788670563, 0.127590780608931 },
+	{ 510.6250, -0.050101524573583, 0.131330225235270 },
+	{ 510.9375, -0.049074531088570, 0.134914722251222 },
+	{ 511.2500, -0.048077310014015, 0.138396381235774 },
+	{ 511.5625, -0.047095363148408, 0.141827311767915 },
+	{ 511.8750, -0.046114192290242, 0.145259623426630 },
+	{ 512.1875, -0.045119299238009, 0.148745425790907 },
+	{ 512.5000, -0.044096185790199, 0.152336828439733 },
+	{ 512.8125, -0.043035693569940, 0.156066227219154 },
+	{ 513.1250, -0.041950023498901, 0.159887163043446 },
+	{ 513.4375, -0.040856716323387, 0.163733463093944 },
+	{ 513.7500, -0.039773312789704, 0.167538954551983 },
+	{ 514.0625, -0.038717353644157, 0.171237464598898 },
+	{ 514.3750, -0.037706379633051, 0.174762820416024 },
+	{ 514.6875, -0.036757931502690, 0.178048849184696 },
+	{ 515.0000, -0.035889549999381, 0.181029378086248 },
+	{ 515.3125, -0.035113036093435, 0.183659815865150 },
+	{ 515.6250, -0.034417231651197, 0.185981897518407 },
+	{ 515.9375, -0.033785238763019, 0.188058939606160 },
+	{ 516.2500, -0.033200159519252, 0.189954258688547 },
+	{ 516.5625, -0.032645096010247, 0.191731171325710 },
+	{ 516.8750, -0.032103150326357, 0.193452994077787 },
+	{ 517.1875, -0.031557424557932, 0.195183043504919 },
+	{ 517.5000, -0.030991020795325, 0.196984636167246 },
+	{ 517.8125, -0.030391738116866, 0.198904231150490 },
+	{ 518.1250, -0.029766163552802, 0.200920857642707 },
+	{ 518.4375, -0.029125581121355, 0.202996687357537 },
+	{ 518.7500, -0.028481274840752, 0.205093892008619 },
+	{ 519.0625, -0.027844528729218, 0.207174643309591 },
+	{ 519.3750, -0.027226626804976, 0.209201112974093 },
+	{ 519.6875, -0.026638853086252, 0.211135472715764 },
+	{ 520.0000, -0.026092491591270, 0.212939894248243 },
+	{ 520.3125, -0.025595283409888, 0.214588375132199 },
+	{ 520.6250, -0.025140797918496, 0.216102216316418 },
+	{ 520.9375, -0.024719061565115, 0.217514544596718 },
+	{ 521.2500, -0.024320100797769, 0.218858486768914 },
+	{ 521.5625, -0.023933942064480, 0.220167169628824 },
+	{ 521.8750, -0.023550611813269, 0.221473719972265 },
+	{ 522.1875, -0.023160136492160, 0.222811264595052 },
+	{ 522.5000, -0.022752542549175, 0.224212930293003 },
+	{ 522.8125, -0.022321242954068, 0.225699687878061 },
+	{ 523.1250, -0.021873196763519, 0.227243884226681 },
+	{ 523.4375, -0.021418749555942, 0.228805710231444 },
+	{ 523.7500, -0.020968246909750, 0.230345356784932 },
+	{ 524.0625, -0.020532034403355, 0.231823014779726 },
+	{ 524.3750, -0.020120457615170, 0.233198875108408 },
+	{ 524.6875, -0.019743862123607, 0.234433128663560 },
+	{ 525.0000, -0.019412593507080, 0.235485966337762 },
+	{ 525.3125, -0.019133677499281, 0.236330394110983 },
+	{ 525.6250, -0.018900860455021, 0.236990678312734 },
+	{ 525.9375, -0.018704568884393, 0.237503900359911 },
+	{ 526.2500, -0.018535229297487, 0.237907141669412 },
+	{ 526.5625, -0.018383268204396, 0.238237483658133 },
+	{ 526.8750, -0.018239112115210, 0.238532007742972 },
+	{ 527.1875, -0.018093187540021, 0.238827795340826 },
+	{ 527.5000, -0.017935920988921, 0.239161927868592 },
+	{ 527.8125, -0.017760353405229, 0.239562058449816 },
+	{ 528.1250, -0.017569983465173, 0.240018127034639 },
+	{ 528.4375, -0.017370924278210, 0.240510645279851 },
+	{ 528.7500, -0.017169288953797, 0.241020124842244 },
+	{ 529.0625, -0.016971190601389, 0.241527077378607 },
+	{ 529.3750, -0.016782742330443, 0.242012014545731 },
+	{ 529.6875, -0.016610057250415, 0.242455448000406 },
+	{ 530.0000, -0.016459248470762, 0.242837889399422 },
+	{ 530.3125, -0.016334580549044, 0.243145409837842 },
+	{ 530.6250, -0.016232923835233, 0.243386318163810 },
+	{ 530.9375, -0.016149300127407, 0.243574482663744 },
+	{ 531.2500, -0.016078731223643, 0.243723771624061 },
+	{ 531.5625, -0.016016238922018, 0.243848053331176 },
+	{ 531.8750, -0.015956845020607, 0.243961196071507 },
+	{ 532.1875, -0.015895571317490, 0.244077068131471 },
+	{ 532.5000, -0.015827439610741, 0.244209537797485 },
+	{ 532.8125, -0.015748951224133, 0.244368665119406 },
+	{ 533.1250, -0.015662525584214, 0.244549277200860 },
+	{ 533.4375, -0.015572061643225, 0.244742392908915 },
+	{ 533.7500, -0.015481458353409, 0.244939031110638 },
+	{ 534.0625, -0.015394614667009, 0.245130210673095 },
+	{ 534.3750, -0.015315429536265, 0.245306950463354 },
+	{ 534.6875, -0.015247801913422, 0.245460269348482 },
+	{ 535.0000, -0.015195630750720, 0.245581186195547 },
+	{ 535.3125, -0.015161649611459, 0.245663137521996 },
+	{ 535.6250, -0.015143930503161, 0.245709230446807 },
+	{ 535.9375, -0.015139380044404, 0.245724989739337 },
+	{ 536.2500, -0.015144904853768, 0.245715940168944 },
+	{ 536.5625, -0.015157411549832, 0.245687606504986 },
+	{ 536.8750, -0.015173806751173, 0.245645513516821 },
+	{ 537.1875, -0.015190997076372, 0.245595185973807 },
+	{ 537.5000, -0.015205889144006, 0.245542148645302 },
+	{ 537.8125, -0.015216063527528, 0.245491574427680 },
+	{ 538.1250, -0.015221796619882, 0.245447228725383 },
+	{ 538.4375, -0.015224038768886, 0.245412525069869 },
+	{ 538.7500, -0.015223740322359, 0.245390876992595 },
+	{ 539.0625, -0.015221851628118, 0.245385698025018 },
+	{ 539.3750, -0.015219323033981, 0.245400401698598 },
+	{ 539.6875, -0.015217104887766, 0.245438401544792 },
+	{ 540.0000, -0.015216147537291, 0.245503111095057 },
+	{ 540.3125, -0.015217278076812, 0.245596716922691 },
+	{ 540.6250, -0.015220830586337, 0.245716497768341 },
+	{ 540.9375, -0.015227015892312, 0.245858505414498 },
+	{ 541.2500, -0.015236044821184, 0.246018791643649 },
+	{ 541.5625, -0.015248128199398, 0.246193408238282 },
+	{ 541.8750, -0.015263476853401, 0.246378406980886 },
+	{ 542.1875, -0.015282301609638, 0.246569839653949 },
+	{ 542.5000, -0.015304813294557, 0.246763758039958 },
+	{ 542.8125, -0.015330735515212, 0.246956396734474 },
+	{ 543.1250, -0.015357843001096, 0.247144721585336 },
+	{ 543.4375, -0.015383423262308, 0.247325881253457 },
+	{ 543.7500, -0.015404763808949, 0.247497024399749 },
+	{ 544.0625, -0.015419152151120, 0.247655299685123 },
+	{ 544.3750, -0.015423875798923, 0.247797855770492 },
+	{ 544.6875, -0.015416222262457, 0.247921841316766 },
+	{ 545.0000, -0.015393479051823, 0.248024404984859 },
+	{ 545.3125, -0.015354019465468, 0.248103827180780 },
+	{ 545.6250, -0.015300559955222, 0.248162915290930 },
+	{ 545.9375, -0.015236902761260, 0.248205608446809 },
+	{ 546.2500, -0.015166850123758, 0.248235845779919 },
+	{ 546.5625, -0.015094204282891, 0.248257566421757 },
+	{ 546.8750, -0.015022767478836, 0.248274709503825 },
+	{ 547.1875, -0.014956341951767, 0.248291214157622 },
+	{ 547.5000, -0.014898729941860, 0.248311019514649 },
+	{ 547.8125, -0.014852156719624, 0.248337159727063 },
+	{ 548.1250, -0.014812539676898, 0.248369049029659 },
+	{ 548.4375, -0.014774219235854, 0.248405196677891 },
+	{ 548.7500, -0.014731535818665, 0.248444111927211 },
+	{ 549.0625, -0.014678829847503, 0.248484304033072 },
+	{ 549.3750, -0.014610441744539, 0.248524282250929 },
+	{ 549.6875, -0.014520711931946, 0.248562555836233 },
+	{ 550.0000, -0.014403980831897, 0.248597634044438 },
+	{ 550.3125, -0.014256790701763, 0.248628856092500 },
+	{ 550.6250, -0.014084491139720, 0.248658881043389 },
+	{ 550.9375, -0.013894633579144, 0.248691197921576 },
+	{ 551.2500, -0.013694769453409, 0.248729295751532 },
+	{ 551.5625, -0.013492450195892, 0.248776663557730 },
+	{ 551.8750, -0.013295227239967, 0.248836790364643 },
+	{ 552.1875, -0.013110652019010, 0.248913165196740 },
+	{ 552.5000, -0.012946275966397, 0.249009277078495 },
+	{ 552.8125, -0.012806181690288, 0.249125711775114 },
+	{ 553.1250, -0.012680576497984, 0.249251442014737 },
+	{ 553.4375, -0.012556198871572, 0.249372537266238 },
+	{ 553.7500, -0.012419787293137, 0.249475066998494 },
+	{ 554.0625, -0.012258080244766, 0.249545100680379 },
+	{ 554.3750, -0.012057816208545, 0.249568707780767 },
+	{ 554.6875, -0.011805733666560, 0.249531957768533 },
+	{ 555.0000, -0.011488571100897, 0.249420920112553 },
+	{ 555.3125, -0.011097893972895, 0.249226737872417 },
+	{ 555.6250, -0.010644575660902, 0.248960848470583 },
+	{ 555.9375, -0.010144316522516, 0.248639762920225 },
+	{ 556.2500, -0.009612816915337, 0.248279992234518 },
+	{ 556.5625, -0.009065777196964, 0.247898047426635 },
+	{ 556.8750, -0.008518897724998, 0.247510439509750 },
+	{ 557.1875, -0.007987878857038, 0.247133679497037 },
+	{ 557.5000, -0.007488420950682, 0.246784278401671 },
+	{ 557.8125, -0.007030316698631, 0.246473263495511 },
+	{ 558.1250, -0.006599728133980, 0.246189727085155 },
+	{ 558.4375, -0.006176909624927, 0.245917277735887 },
+	{ 558.7500, -0.005742115539665, 0.245639524012990 },
+	{ 559.0625, -0.005275600246393, 0.245340074481748 },
+	{ 559.3750, -0.004757618113305, 0.245002537707445 },
+	{ 559.6875, -0.004168423508598, 0.244610522255365 },
+	{ 560.0000, -0.003488270800467, 0.244147636690790 },
+	{ 560.3125, -0.002705609347675, 0.243604429642538 },
+	{ 560.6250, -0.001841668471242, 0.242999209993550 },
+	{ 560.9375, -0.000925872482756, 0.242357226690303 },
+	{ 561.2500, 0.000012354306195, 0.241703728679272 },
+	{ 561.5625, 0.000943587584025, 0.241063964906934 },
+	{ 561.8750, 0.001838403039147, 0.240463184319762 },
+	{ 562.1875, 0.002667376359972, 0.239926635864233 },
+	{ 562.5000, 0.003401083234915, 0.239479568486823 },
+	{ 562.8125, 0.004025685697071, 0.239132889880932 },
+	{ 563.1250, 0.004589691158272, 0.238840142727665 },
+	{ 563.4375, 0.005157193375034, 0.238540528455053 },
+	{ 563.7500, 0.005792286103873, 0.238173248491124 },
+	{ 564.0625, 0.006559063101303, 0.237677504263910 },
+	{ 564.3750, 0.007521618123840, 0.236992497201441 },
+	{ 564.6875, 0.008744044927999, 0.236057428731746 },
+	{ 565.0000, 0.010290437270297, 0.234811500282855 },
+	{ 565.3125, 0.012202326731862, 0.233215096340539 },
+	{ 565.6250, 0.014430996192280, 0.231313333621519 },
+	{ 565.9375, 0.016905166355749, 0.229172511900261 },
+	{ 566.2500, 0.019553557926469, 0.226858930951225 },
+	{ 566.5625, 0.022304891608638, 0.224438890548874 },
+	{ 566.8750, 0.025087888106456, 0.221978690467673 },
+	{ 567.1875, 0.027831268124122, 0.219544630482082 },
+	{ 567.5000, 0.030463752365835, 0.217203010366565 },
+	{ 567.8125, 0.032936833419764, 0.215000287440018 },
+	{ 568.1250, 0.035293091409952, 0.212903549199068 },
+	{ 568.4375, 0.037597878344416, 0.210860040684775 },
+	{ 568.7500, 0.039916546231170, 0.208817006938199 },
+	{ 569.0625, 0.042314447078228, 0.206721693000401 },
+	{ 569.3750, 0.044856932893605, 0.204521343912441 },
+	{ 569.6875, 0.047609355685315, 0.202163204715379 },
+	{ 570.0000, 0.050637067461374, 0.199594520450276 },
+	{ 570.3125, 0.053985229243983, 0.196778411995582 },
+	{ 570.6250, 0.057618238112097, 0.193741503579316 },
+	{ 570.9375, 0.061480300158859, 0.190526295266886 },
+	{ 571.2500, 0.065515621477409, 0.187175287123701 },
+	{ 571.5625, 0.069668408160891, 0.183730979215168 },
+	{ 571.8750, 0.073882866302447, 0.180235871606698 },
+	{ 572.1875, 0.078103201995219, 0.176732464363698 },
+	{ 572.5000, 0.082273621332348, 0.173263257551577 },
+	{ 572.8125, 0.086351544189790, 0.169861163673709 },
+	{ 573.1250, 0.090347245574749, 0.166520744985320 },
+	{ 573.4375, 0.094284214277243, 0.163226976179605 },
+	{ 573.7500, 0.098185939087288, 0.159964831949757 },
+	{ 574.0625, 0.102075908794901, 0.156719286988967 },
+	{ 574.3750, 0.105977612190100, 0.153475315990429 },
+	{ 574.6875, 0.109914538062901, 0.150217893647335 },
+	{ 575.0000, 0.113910175203322, 0.146931994652879 },
+	{ 575.3125, 0.117983284016844, 0.143605062645648 },
+	{ 575.6250, 0.122133711370803, 0.140234417045809 },
+	{ 575.9375, 0.126356575748002, 0.136819846218924 },
+	{ 576.2500, 0.130646995631242, 0.133361138530555 },
+	{ 576.5625, 0.135000089503324, 0.129858082346264 },
+	{ 576.8750, 0.139410975847050, 0.126310466031614 },
+	{ 577.1875, 0.143874773145220, 0.122718077952165 },
+	{ 577.5000, 0.148386599880637, 0.119080706473481 },
+	{ 577.8125, 0.152936181046096, 0.115403789340333 },
+	{ 578.1250, 0.157491667674368, 0.111715361814328 },
+	{ 578.4375, 0.162015817308219, 0.108049108536284 },
+	{ 578.7500, 0.166471387490414, 0.104438714147018 },
+	{ 579.0625, 0.170821135763719, 0.100917863287348 },
+	{ 579.3750, 0.175027819670900, 0.097520240598090 },
+	{ 579.6875, 0.179054196754723, 0.094279530720063 },
+	{ 580.0000, 0.182863024557952, 0.091229418294083 },
+	{ 580.3125, 0.186430788061389, 0.088391307093532 },
+	{ 580.6250, 0.189788881997976, 0.085737477422045 },
+	{ 580.9375, 0.192982428538693, 0.083227928715822 },
+	{ 581.2500, 0.196056549854518, 0.080822660411062 },
+	{ 581.5625, 0.199056368116429, 0.078481671943964 },
+	{ 581.8750, 0.202027005495404, 0.076164962750729 },
+	{ 582.1875, 0.205013584162422, 0.073832532267556 },
+	{ 582.5000, 0.208061226288461, 0.071444379930643 },
+	{ 582.8125, 0.211201780840750, 0.068972470478384 },
+	{ 583.1250, 0.214414003971518, 0.066436629857939 },
+	{ 583.4375, 0.217663378629242, 0.063868649318663 },
+	{ 583.7500, 0.220915387762402, 0.061300320109910 },
+	{ 584.0625, 0.224135514319477, 0.058763433481033 },
+	{ 584.3750, 0.227289241248944, 0.056289780681387 },
+	{ 584.6875, 0.230342051499282, 0.053911152960326 },
+	{ 585.0000, 0.233259428018971, 0.051659341567203 },
+	{ 585.3125, 0.236018648168794, 0.049555410018211 },
+	{ 585.6250, 0.238644166958759, 0.047577510896889 },
+	{ 585.9375, 0.241172233811178, 0.045693069053615 },
+	{ 586.2500, 0.243639098148366, 0.043869509338767 },
+	{ 586.5625, 0.246081009392634, 0.042074256602722 },
+	{ 586.8750, 0.248534216966296, 0.040274735695859 },
+	{ 587.1875, 0.251034970291666, 0.038438371468555 },
+	{ 587.5000, 0.253619518791055, 0.036532588771187 },
+	{ 587.8125, 0.256309106312237, 0.034537561656594 },
+	{ 588.1250, 0.259064954404814, 0.032484460987458 },
+	{ 588.4375, 0.261833279043852, 0.030417206828920 },
+	{ 588.7500, 0.264560296204411, 0.028379719246122 },
+	{ 589.0625, 0.267192221861557, 0.026415918304206 },
+	{ 589.3750, 0.269675271990352, 0.024569724068314 },
+	{ 589.6875, 0.271955662565858, 0.022885056603588 },
+	{ 590.0000, 0.273979609563140, 0.021405835975170 },
+	{ 590.3125, 0.275711233353801, 0.020161520771700 },
+	{ 590.6250, 0.277186271895606, 0.019123723675806 },
+	{ 590.9375, 0.278458367542862, 0.018249595893618 },
+	{ 591.2500, 0.279581162649875, 0.017496288631261 },
+	{ 591.5625, 0.280608299570950, 0.016820953094864 },
+	{ 591.8750, 0.281593420660394, 0.016180740490554 },
+	{ 592.1875, 0.282590168272513, 0.015532802024457 },
+	{ 592.5000, 0.283652184761613, 0.014834288902703 },
+	{ 592.8125, 0.284818248578089, 0.014054030262608 },
+	{ 593.1250, 0.286067682556693, 0.013207566966259 },
+	{ 593.4375, 0.287364945628265, 0.012322117806929 },
+	{ 593.7500, 0.288674496723647, 0.011424901577896 },
+	{ 594.0625, 0.289960794773680, 0.010543137072434 },
+	{ 594.3750, 0.291188298709203, 0.009704043083820 },
+	{ 594.6875, 0.292321467461058, 0.008934838405328 },
+	{ 595.0000, 0.293324759960085, 0.008262741830235 },
+	{ 595.3125, 0.294173061371120, 0.007706957903704 },
+	{ 595.6250, 0.294882961794969, 0.007254634178448 },
+	{ 595.9375, 0.295481477566434, 0.006884903959068 },
+	{ 596.2500, 0.295995625020317, 0.006576900550165 },
+	{ 596.5625, 0.296452420491419, 0.006309757256339 },
+	{ 596.8750, 0.296878880314541, 0.006062607382191 },
+	{ 597.1875, 0.297302020824486, 0.005814584232323 },
+	{ 597.5000, 0.297748858356054, 0.005544821111334 },
+	{ 597.8125, 0.298240070074493, 0.005237777157141 },
+	{ 598.1250, 0.298770976466841, 0.004899214840919 },
+	{ 598.4375, 0.299330558850579, 0.004540222467159 },
+	{ 598.7500, 0.299907798543190, 0.004171888340349 },
+	{ 599.0625, 0.300491676862157, 0.003805300764982 },
+	{ 599.3750, 0.301071175124963, 0.003451548045547 },
+	{ 599.6875, 0.301635274649090, 0.003121718486534 },
+	{ 600.0000, 0.302172956752022, 0.002826900392433 },
+	{ 600.3125, 0.302676437389556, 0.002574980166288 },
+	{ 600.6250, 0.303150871070752, 0.002361036605350 },
+	{ 600.9375, 0.303604646942983, 0.002176946605424 },
+	{ 601.2500, 0.304046154153625, 0.002014587062313 },
+	{ 601.5625, 0.304483781850052, 0.001865834871824 },
+	{ 601.8750, 0.304925919179637, 0.001722566929759 },
+	{ 602.1875, 0.305380955289756, 0.001576660131924 },
+	{ 602.5000, 0.305857279327782, 0.001419991374122 },
+	{ 602.8125, 0.306359570806680, 0.001246798185179 },
+	{ 603.1250, 0.306877670701773, 0.001060760626000 },
+	{ 603.4375, 0.307397710353974, 0.000867919390511 },
+	{ 603.7500, 0.307905821104195, 0.000674315172637 },
+	{ 604.0625, 0.308388134293350, 0.000485988666304 },
+	{ 604.3750, 0.308830781262351, 0.000308980565438 },
+	{ 604.6875, 0.309219893352111, 0.000149331563966 },
+	{ 605.0000, 0.309541601903542, 0.000013082355811 },
+	{ 605.3125, 0.309786572327174, -0.000095537835686 },
+	{ 605.6250, 0.309963606311997, -0.000179545669537 },
+	{ 605.9375, 0.310086039616619, -0.000243769275339 },
+	{ 606.2500, 0.310167207999647, -0.000293036782690 },
+	{ 606.5625, 0.310220447219688, -0.000332176321188 },
+	{ 606.8750, 0.310259093035349, -0.000366016020431 },
+	{ 607.1875, 0.310296481205237, -0.000399384010015 },
+	{ 607.5000, 0.310345947487959, -0.000437108419540 },
+	{ 607.8125, 0.310417650908193, -0.000482869309910 },
+	{ 608.1250, 0.310509043554894, -0.000535754467262 },
+	{ 608.4375, 0.310614400783088, -0.000593703609041 },
+	{ 608.7500, 0.310727997947802, -0.000654656452691 },
+	{ 609.0625, 0.310844110404062, -0.000716552715656 },
+	{ 609.3750, 0.310957013506893, -0.000777332115382 },
+	{ 609.6875, 0.311060982611323, -0.000834934369312 },
+	{ 610.0000, 0.311150293072376, -0.000887299194890 },
+	{ 610.3125, 0.311220758093933, -0.000932914360029 },
+	{ 610.6250, 0.311274342275281, -0.000972459834503 },
+	{ 610.9375, 0.311314548064563, -0.001007163638553 },
+	{ 611.2500, 0.311344877909920, -0.001038253792422 },
+	{ 611.5625, 0.311368834259495, -0.001066958316352 },
+	{ 611.8750, 0.311389919561429, -0.001094505230584 },
+	{ 612.1875, 0.311411636263863, -0.001122122555360 },
+	{ 612.5000, 0.311437486814940, -0.001151038310921 },
+	{ 612.8125, 0.311470019125704, -0.001182164711131 },
+	{ 613.1250, 0.311507962958805, -0.001215150744340 },
+	{ 613.4375, 0.311549093539798, -0.001249329592519 },
+	{ 613.7500, 0.311591186094235, -0.001284034437638 },
+	{ 614.0625, 0.311632015847671, -0.001318598461670 },
+	{ 614.3750, 0.311669358025659, -0.001352354846585 },
+	{ 614.6875, 0.311700987853752, -0.001384636774355 },
+	{ 615.0000, 0.311724680557504, -0.001414777426951 },
+	{ 615.3125, 0.311738871226685, -0.001442273732835 },
+	{ 615.6250, 0.311744634407932, -0.001467277606431 },
+	{ 615.9375, 0.311743704512096, -0.001490104708655 },
+	{ 616.2500, 0.311737815950033, -0.001511070700422 },
+	{ 616.5625, 0.311728703132593, -0.001530491242647 },
+	{ 616.8750, 0.311718100470632, -0.001548681996247 },
+	{ 617.1875, 0.311707742375001, -0.001565958622136 },
+	{ 617.5000, 0.311699363256553, -0.001582636781229 },
+	{ 617.8125, 0.311694233352638, -0.001599067485177 },
+	{ 618.1250, 0.311691766206585, -0.001615743148571 },
+	{ 618.4375, 0.311690911188219, -0.001633191536736 },
+	{ 618.7500, 0.311690617667367, -0.001651940414996 },
+	{ 619.0625, 0.311689835013854, -0.001672517548678 },
+	{ 619.3750, 0.311687512597505, -0.001695450703107 },
+	{ 619.6875, 0.311682599788146, -0.001721267643608 },
+	{ 620.0000, 0.311674045955602, -0.001750496135507 },
+	{ 620.3125, 0.311661341914275, -0.001783404651168 },
+	{ 620.6250, 0.311646144256868, -0.001819224491114 },
+	{ 620.9375, 0.311630651020658, -0.001856927662908 },
+	{ 621.2500, 0.311617060242926, -0.001895486174111 },
+	{ 621.5625, 0.311607569960950, -0.001933872032288 },
+	{ 621.8750, 0.311604378212008, -0.001971057244999 },
+	{ 622.1875, 0.311609683033380, -0.002006013819807 },
+	{ 622.5000, 0.311625682462344, -0.002037713764276 },
+	{ 622.8125, 0.311652962955570, -0.002065664663813 },
+	{ 623.1250, 0.311685664647292, -0.002091516415218 },
+	{ 623.4375, 0.311716316091136, -0.002117454493137 },
+	{ 623.7500, 0.311737445840728, -0.002145664372216 },
+	{ 624.0625, 0.311741582449693, -0.002178331527100 },
+	{ 624.3750, 0.311721254471657, -0.002217641432436 },
+	{ 624.6875, 0.311668990460246, -0.002265779562869 },
+	{ 625.0000, 0.311577318969085, -0.002324931393044 },
+	{ 625.3125, 0.311441147792781, -0.002396585915722 },
+	{ 625.6250, 0.311264901689860, -0.002479446196113 },
+	{ 625.9375, 0.311055384659829, -0.002571518817542 },
+	{ 626.2500, 0.310819400702195, -0.002670810363331 },
+	{ 626.5625, 0.310563753816466, -0.002775327416806 },
+	{ 626.8750, 0.310295248002148, -0.002883076561290 },
+	{ 627.1875, 0.310020687258750, -0.002992064380108 },
+	{ 627.5000, 0.309746875585777, -0.003100297456584 },
+	{ 627.8125, 0.309479672848995, -0.003206125893918 },
+	{ 628.1250, 0.309221162379204, -0.003309273874822 },
+	{ 628.4375, 0.308972483373461, -0.003409809101884 },
+	{ 628.7500, 0.308734775028823, -0.003507799277691 },
+	{ 629.0625, 0.308509176542347, -0.003603312104830 },
+	{ 629.3750, 0.308296827111091, -0.003696415285890 },
+	{ 629.6875, 0.308098865932112, -0.003787176523458 },
+	{ 630.0000, 0.307916432202468, -0.003875663520123 },
+	{ 630.3125, 0.307750026242596, -0.003961960085707 },
+	{ 630.6250, 0.307597592866450, -0.004046214458976 },
+	{ 630.9375, 0.307456438011366, -0.004128590985933 },
+	{ 631.2500, 0.307323867614678, -0.004209254012579 },
+	{ 631.5625, 0.307197187613722, -0.004288367884915 },
+	{ 631.8750, 0.307073703945832, -0.004366096948943 },
+	{ 632.1875, 0.306950722548343, -0.004442605550665 },
+	{ 632.5000, 0.306825549358590, -0.004518058036083 },
+	{ 632.8125, 0.306696101045774, -0.004592730222485 },
+	{ 633.1250, 0.306562737206561, -0.004667343812314 },
+	{ 633.4375, 0.306426428169482, -0.004742731979297 },
+	{ 633.7500, 0.306288144263069, -0.004819727897164 },
+	{ 634.0625, 0.306148855815854, -0.004899164739643 },
+	{ 634.3750, 0.306009533156368, -0.004981875680463 },
+	{ 634.6875, 0.305871146613143, -0.005068693893354 },
+	{ 635.0000, 0.305734666514712, -0.005160452552043 },
+	{ 635.3125, 0.305601457764670, -0.005257505042494 },
+	{ 635.6250, 0.305474463566875, -0.005358285599605 },
+	{ 635.9375, 0.305357021700248, -0.005460748670507 },
+	{ 636.2500, 0.305252469943712, -0.005562848702334 },
+	{ 636.5625, 0.305164146076189, -0.005662540142217 },
+	{ 636.8750, 0.305095387876600, -0.005757777437288 },
+	{ 637.1875, 0.305049533123868, -0.005846515034679 },
+	{ 637.5000, 0.305029919596915, -0.005926707381523 },
+	{ 637.8125, 0.305036187699075, -0.005997632775378 },
+	{ 638.1250, 0.305053188331333, -0.006063864915512 },
+	{ 638.4375, 0.305062075019083, -0.006131301351617 },
+	{ 638.7500, 0.305044001287724, -0.006205839633388 },
+	{ 639.0625, 0.304980120662652, -0.006293377310519 },
+	{ 639.3750, 0.304851586669263, -0.006399811932702 },
+	{ 639.6875, 0.304639552832953, -0.006531041049633 },
+	{ 640.0000, 0.304325172679119, -0.006692962211003 },
+	{ 640.3125, 0.303895609078499, -0.006889656866246 },
+	{ 640.6250, 0.303362062283200, -0.007117942063748 },
+	{ 640.9375, 0.302741741890668, -0.007372818751634 },
+	{ 641.2500, 0.302051857498353, -0.007649287878028 },
+	{ 641.5625, 0.301309618703702, -0.007942350391056 },
+	{ 641.8750, 0.300532235104162, -0.008247007238841 },
+	{ 642.1875, 0.299736916297182, -0.008558259369510 },
+	{ 642.5000, 0.298940871880209, -0.008871107731187 },
+	{ 642.8125, 0.298159250952260, -0.009180978624604 },
+	{ 643.1250, 0.297398960618622, -0.009484999760930 },
+	{ 643.4375, 0.296664847486153, -0.009780724203939 },
+	{ 643.7500, 0.295961758161708, -0.010065705017407 },
+	{ 644.0625, 0.295294539252144, -0.010337495265108 },
+	{ 644.3750, 0.294668037364317, -0.010593648010819 },
+	{ 644.6875, 0.294087099105083, -0.010831716318315 },
+	{ 645.0000, 0.293556571081299, -0.011049253251370 },
+	{ 645.3125, 0.293079340947798, -0.011244698411271 },
+	{ 645.6250, 0.292650460551314, -0.011420037549340 },
+	{ 645.9375, 0.292263022786560, -0.011578142954410 },
+	{ 646.2500, 0.291910120548248, -0.011721886915315 },
+	{ 646.5625, 0.291584846731089, -0.011854141720887 },
+	{ 646.8750, 0.291280294229794, -0.011977779659961 },
+	{ 647.1875, 0.290989555939076, -0.012095673021368 },
+	{ 647.5000, 0.290705724753647, -0.012210694093942 },
+	{ 647.8125, 0.290421893568217, -0.012325715166516 },
+	{ 648.1250, 0.290131155277499, -0.012443608527923 },
+	{ 648.4375, 0.289826602776205, -0.012567246466996 },
+	{ 648.7500, 0.289501328959045, -0.012699501272569 },
+	{ 649.0625, 0.289148426720733, -0.012843245233473 },
+	{ 649.3750, 0.288760988955979, -0.013001350638544 },
+	{ 649.6875, 0.288332108559495, -0.013176689776613 },
+	{ 650.0000, 0.287854878425994, -0.013372134936513 },
+	{ 650.3125, 0.287830460702500, -0.013400303472100 },
+	{ 650.6250, 0.287915204414200, -0.013389575070600 },
+	{ 650.9375, 0.288092081295800, -0.013345982813400 },
+	{ 651.2500, 0.288344063082000, -0.013275559782300 },
+	{ 651.5625, 0.288654121507800, -0.013184339058700 },
+	{ 651.8750, 0.289005228307700, -0.013078353724300 },
+	{ 652.1875, 0.289380355216700, -0.012963636860500 },
+	{ 652.5000, 0.289762473969500, -0.012846221549100 },
+	{ 652.8125, 0.290135810853500, -0.012731724042300 },
+	{ 653.1250, 0.290489610366900, -0.012624093275600 },
+	{ 653.4375, 0.290814371560600, -0.012526861355000 },
+	{ 653.7500, 0.291100593485400, -0.012443560386900 },
+	{ 654.0625, 0.291338775192200, -0.012377722477300 },
+	{ 654.3750, 0.291519415731800, -0.012332879732500 },
+	{ 654.6875, 0.291633014155100, -0.012312564258500 },
+	{ 655.0000, 0.291670069512900, -0.012320308161700 },
+	{ 655.3125, 0.291624456931300, -0.012358396707800 },
+	{ 655.6250, 0.291503555836800, -0.012424127801800 },
+	{ 655.9375, 0.291318121731400, -0.012513552508300 },
+	{ 656.2500, 0.291078910116800, -0.012622721891800 },
+	{ 656.5625, 0.290796676495000, -0.012747687016900 },
+	{ 656.8750, 0.290482176367600, -0.012884498948200 },
+	{ 657.1875, 0.290146165236600, -0.013029208750400 },
+	{ 657.5000, 0.289799398603700, -0.013177867487900 },
+	{ 657.8125, 0.289452631970900, -0.013326526225500 },
+	{ 658.1250, 0.289116620839900, -0.013471236027600 },
+	{ 658.4375, 0.288802120712500, -0.013608047958900 },
+	{ 658.7500, 0.288519887090600, -0.013733013084000 },
+	{ 659.0625, 0.288280675476100, -0.013842182467500 },
+	{ 659.3750, 0.288095241370600, -0.013931607174000 },
+	{ 659.6875, 0.287974340276200, -0.013997338268000 },
+	{ 660.0000, 0.287928727694500, -0.014035426814100 }
+};
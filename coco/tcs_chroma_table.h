@@ -0,0 +1,47 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+/** \file tcs_chroma_table.h
+
+	 \brief Chromaticity data of the TCS3472 color sensor (header)
+
+ */
+
+#ifndef __TCS_CHROMA_TABLE_H__
+#define __TCS_CHROMA_TABLE_H__
+
+/** Number of entries in the chromaticity table */
+#define TCS_CHROMA_ENTRIES 817
+
+/** \brief one point of the spectral locus, given as direction vector from the reference white point */
+typedef struct TCS_CHROMA_ENTRY_STRUCT
+{
+	/** wavelength in nm */
+	double dNm;
+	/** x component of the direction vector */
+	double dX;
+	/** y component of the direction vector */
+	double dY;
+} TCS_CHROMA_ENTRY_T;
+
+extern const TCS_CHROMA_ENTRY_T atTcsDirVector[TCS_CHROMA_ENTRIES];
+
+#endif	/* __TCS_CHROMA_TABLE_H__ */
@@ -0,0 +1,463 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+
+/** \file test_plan.c
+
+	 \brief Compiled test plans for the validation of the lanes
+
+ */
+
+#include "test_plan.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/** \brief allocates a test plan without any tested lanes.
+
+The plan and its lanes are allocated in one memory block and are initialized with 0.
+	@param uiSteps		number of test steps
+	@param uiDevices	number of devices per step
+
+	@return 			pointer to the plan or NULL if no memory could be allocated
+	*/
+TEST_PLAN_T* test_plan_new(unsigned int uiSteps, unsigned int uiDevices)
+{
+	TEST_PLAN_T* ptPlan;
+	size_t sizLanes;
+
+
+	ptPlan = NULL;
+
+	sizLanes = (size_t)uiSteps * uiDevices * TEST_PLAN_LANES;
+	/* Do not allocate a plan whose size overflows. */
+	if( uiDevices==0 || sizLanes/uiDevices/TEST_PLAN_LANES==uiSteps )
+	{
+		ptPlan = (TEST_PLAN_T*)calloc(1, sizeof(TEST_PLAN_T) + sizLanes * sizeof(TEST_PLAN_LANE_T));
+		if( ptPlan!=NULL )
+		{
+			ptPlan->uiSteps = uiSteps;
+			ptPlan->uiDevices = uiDevices;
+			ptPlan->atLanes = (TEST_PLAN_LANE_T*)(ptPlan + 1);
+		}
+	}
+
+	return ptPlan;
+}
+
+
+
+/** \brief frees a test plan allocated with test_plan_new.
+	@param ptPlan		pointer to the plan, can be NULL
+	*/
+void test_plan_free(TEST_PLAN_T* ptPlan)
+{
+	free(ptPlan);
+}
+
+
+
+/** \brief returns a lane of a test plan.
+	@param ptPlan		pointer to the plan
+	@param uiStep		test step, starting at 0
+	@param uiDevice		device, starting at 0
+	@param uiLane		lane, starting at 0
+
+	@return 			pointer to the lane or NULL if one of the indices is out of range
+	*/
+TEST_PLAN_LANE_T* test_plan_get_lane(TEST_PLAN_T* ptPlan, unsigned int uiStep, unsigned int uiDevice, unsigned int uiLane)
+{
+	TEST_PLAN_LANE_T* ptLane;
+
+
+	ptLane = NULL;
+	if( uiStep<ptPlan->uiSteps && uiDevice<ptPlan->uiDevices && uiLane<TEST_PLAN_LANES )
+	{
+		ptLane = ptPlan->atLanes + ((size_t)uiStep * ptPlan->uiDevices + uiDevice) * TEST_PLAN_LANES + uiLane;
+	}
+
+	return ptLane;
+}
+
+
+
+/** \brief gets the checked values of a lane like the color tables: the rounded wavelength, the saturation in percent and
+the illumination. Lanes which were too dark for the color calculations have a wavelength and saturation of 0.
+	*/
+static void get_lane_values(const COLOR_SPACES_T* ptColorSpaces, unsigned int uiIndex, double* pdNm, double* pdSat, double* pdLux)
+{
+	if( ptColorSpaces->aucValid[uiIndex]!=0 )
+	{
+		*pdNm = floor(ptColorSpaces->adWavelength[uiIndex] + 0.5);
+		*pdSat = ptColorSpaces->adSaturation[uiIndex] * 100;
+	}
+	else
+	{
+		*pdNm = 0;
+		*pdSat = 0;
+	}
+	*pdLux = ptColorSpaces->adLux[uiIndex];
+}
+
+
+
+/** \brief validates the converted colors of one device with one step of a test plan.
+
+The wavelength is rounded and the saturation is scaled to percent like in the color tables, lanes which were too dark for
+the color calculations have a wavelength and saturation of 0. The illumination is only checked if fLuxCheck is not 0.
+	@param ptPlan			pointer to the plan
+	@param uiStep			test step, starting at 0
+	@param uiDevice			device in the plan, starting at 0
+	@param ptColorSpaces	converted colors, calculated with color_spaces_calculate
+	@param uiFirstLane		index of the first lane of the device in ptColorSpaces (e.g. devIndex*16)
+	@param fLuxCheck		check the illumination as well
+	@param puiTested		returns the bitmask of the lanes with a test entry, bit 0 is the first lane
+	@param aucChecks		returns the TEST_PLAN_CHECK_* flags of the failed checks of each lane, TEST_PLAN_LANES elements
+
+	@return 				bitmask of the failed lanes, bit 0 is the first lane
+	*/
+unsigned int test_plan_validate(const TEST_PLAN_T* ptPlan, unsigned int uiStep, unsigned int uiDevice,
+                                const COLOR_SPACES_T* ptColorSpaces, unsigned int uiFirstLane, int fLuxCheck,
+                                unsigned int* puiTested, unsigned char* aucChecks)
+{
+	const TEST_PLAN_LANE_T* ptLane;
+	unsigned int uiFailed;
+	unsigned int uiTested;
+	unsigned int uiLane;
+	unsigned int uiIndex;
+	unsigned char ucChecks;
+	double dNm;
+	double dSat;
+	double dLux;
+
+
+	uiFailed = 0;
+	uiTested = 0;
+
+	for(uiLane=0; uiLane<TEST_PLAN_LANES; uiLane++)
+	{
+		aucChecks[uiLane] = 0;
+	}
+
+	uiIndex = uiFirstLane;
+	if( uiStep<ptPlan->uiSteps && uiDevice<ptPlan->uiDevices && uiIndex+TEST_PLAN_LANES<=ptColorSpaces->uiLanes )
+	{
+		ptLane = ptPlan->atLanes + ((size_t)uiStep * ptPlan->uiDevices + uiDevice) * TEST_PLAN_LANES;
+		for(uiLane=0; uiLane<TEST_PLAN_LANES; uiLane++)
+		{
+			if( (ptLane->ucFlags & TEST_PLAN_LANE_TESTED)!=0 )
+			{
+				get_lane_values(ptColorSpaces, uiIndex, &dNm, &dSat, &dLux);
+
+				ucChecks = 0;
+				if( dNm<(double)ptLane->fNm-ptLane->fTolNm || dNm>(double)ptLane->fNm+ptLane->fTolNm )
+				{
+					ucChecks |= TEST_PLAN_CHECK_NM;
+				}
+				if( dSat<(double)ptLane->fSat-ptLane->fTolSat || dSat>(double)ptLane->fSat+ptLane->fTolSat )
+				{
+					ucChecks |= TEST_PLAN_CHECK_SAT;
+				}
+				if( fLuxCheck!=0 )
+				{
+					if( dLux<(double)ptLane->fLux-ptLane->fTolLux )
+					{
+						ucChecks |= TEST_PLAN_CHECK_LUX_LOW;
+					}
+					else if( dLux>(double)ptLane->fLux+ptLane->fTolLux )
+					{
+						ucChecks |= TEST_PLAN_CHECK_LUX_HIGH;
+					}
+				}
+
+				uiTested |= 1U << uiLane;
+				if( ucChecks!=0 )
+				{
+					uiFailed |= 1U << uiLane;
+				}
+				aucChecks[uiLane] = ucChecks;
+			}
+			++ptLane;
+			++uiIndex;
+		}
+	}
+
+	*puiTested = uiTested;
+
+	return uiFailed;
+}
+
+
+
+/** \brief allocates the state of a sequential test for uiLanes lanes (16 per device) without any samples.
+	@param uiLanes		number of lanes
+
+	@return 			pointer to the state or NULL if no memory could be allocated
+	*/
+TEST_PLAN_SEQUENTIAL_T* test_plan_sequential_new(unsigned int uiLanes)
+{
+	TEST_PLAN_SEQUENTIAL_T* ptSequential;
+
+
+	ptSequential = (TEST_PLAN_SEQUENTIAL_T*)calloc(1, sizeof(TEST_PLAN_SEQUENTIAL_T) + (size_t)uiLanes * sizeof(TEST_PLAN_ESTIMATE_T));
+	if( ptSequential!=NULL )
+	{
+		ptSequential->uiLanes = uiLanes;
+		ptSequential->atEstimates = (TEST_PLAN_ESTIMATE_T*)(ptSequential + 1);
+		ptSequential->ptColorSpaces = color_spaces_new(uiLanes);
+		if( ptSequential->ptColorSpaces==NULL )
+		{
+			free(ptSequential);
+			ptSequential = NULL;
+		}
+	}
+
+	return ptSequential;
+}
+
+
+
+/** \brief frees the state of a sequential test allocated with test_plan_sequential_new.
+	@param ptSequential		pointer to the state, can be NULL
+	*/
+void test_plan_sequential_free(TEST_PLAN_SEQUENTIAL_T* ptSequential)
+{
+	if( ptSequential!=NULL )
+	{
+		color_spaces_free(ptSequential->ptColorSpaces);
+		free(ptSequential);
+	}
+}
+
+
+
+/** \brief removes all samples from a sequential test.
+	@param ptSequential		pointer to the state
+	*/
+void test_plan_sequential_reset(TEST_PLAN_SEQUENTIAL_T* ptSequential)
+{
+	memset(ptSequential->atEstimates, 0, (size_t)ptSequential->uiLanes * sizeof(TEST_PLAN_ESTIMATE_T));
+	ptSequential->ulSamples = 0;
+}
+
+
+
+/** \brief adds one reading of all lanes to a sequential test.
+
+The reading is converted into the color spaces, the mean and the variance of the checked values are updated with Welford's
+algorithm and the raw readings are summed up for test_plan_sequential_mean. All arrays have at least uiLanes elements.
+	@param ptSequential			pointer to the state
+	@param ausClear				clear readings
+	@param ausRed				red readings
+	@param ausGreen				green readings
+	@param ausBlue				blue readings
+	@param aucIntegrationtime	integration time settings of the lanes
+	@param aucGain				gain settings of the lanes
+	*/
+void test_plan_sequential_add(TEST_PLAN_SEQUENTIAL_T* ptSequential, const unsigned short* ausClear,
+                              const unsigned short* ausRed, const unsigned short* ausGreen,
+                              const unsigned short* ausBlue, const unsigned char* aucIntegrationtime,
+                              const unsigned char* aucGain)
+{
+	TEST_PLAN_ESTIMATE_T* ptEstimate;
+	unsigned int uiIndex;
+	unsigned int uiValue;
+	double adValues[3];
+	double dSamples;
+	double dDelta;
+
+
+	color_spaces_calculate(ptSequential->ptColorSpaces, ausClear, ausRed, ausGreen, ausBlue, aucIntegrationtime, aucGain);
+
+	ptSequential->ulSamples++;
+	dSamples = (double)ptSequential->ulSamples;
+
+	ptEstimate = ptSequential->atEstimates;
+	for(uiIndex=0; uiIndex<ptSequential->uiLanes; uiIndex++)
+	{
+		get_lane_values(ptSequential->ptColorSpaces, uiIndex, adValues, adValues + 1, adValues + 2);
+		for(uiValue=0; uiValue<3; uiValue++)
+		{
+			dDelta = adValues[uiValue] - ptEstimate->adMean[uiValue];
+			ptEstimate->adMean[uiValue] += dDelta / dSamples;
+			ptEstimate->adM2[uiValue] += dDelta * (adValues[uiValue] - ptEstimate->adMean[uiValue]);
+		}
+		ptEstimate->adSum[0] += ausClear[uiIndex];
+		ptEstimate->adSum[1] += ausRed[uiIndex];
+		ptEstimate->adSum[2] += ausGreen[uiIndex];
+		ptEstimate->adSum[3] += ausBlue[uiIndex];
+		++ptEstimate;
+	}
+}
+
+
+
+/** \brief compares the confidence interval of a mean with a tolerance band.
+	@return 			1 if the interval is inside of the band, -1 if it is outside and 0 if it overlaps a limit
+	*/
+static int compare_interval(double dMean, double dHalfWidth, double dLow, double dHigh)
+{
+	int iResult;
+
+
+	iResult = 0;
+	if( dMean-dHalfWidth>=dLow && dMean+dHalfWidth<=dHigh )
+	{
+		iResult = 1;
+	}
+	else if( dMean+dHalfWidth<dLow || dMean-dHalfWidth>dHigh )
+	{
+		iResult = -1;
+	}
+
+	return iResult;
+}
+
+
+
+/** \brief checks which tested lanes of one device are not decided yet.
+
+The half width of the confidence interval of a mean is dZ times its standard error, e.g. 2.58 for a confidence of 99%. The
+interval needs at least 2 samples, before that no lane is decided. The illumination is only checked if fLuxCheck is not 0.
+	@param ptSequential		pointer to the state
+	@param ptPlan			pointer to the plan
+	@param uiStep			test step, starting at 0
+	@param uiDevice			device in the plan, starting at 0
+	@param uiFirstLane		index of the first lane of the device in the state (e.g. devIndex*16)
+	@param fLuxCheck		check the illumination as well
+	@param dZ				width of the confidence interval in standard errors
+	@param puiTested		returns the bitmask of the lanes with a test entry, bit 0 is the first lane
+
+	@return 				bitmask of the tested lanes which are not decided yet, bit 0 is the first lane
+	*/
+unsigned int test_plan_sequential_decide(const TEST_PLAN_SEQUENTIAL_T* ptSequential, const TEST_PLAN_T* ptPlan,
+                                         unsigned int uiStep, unsigned int uiDevice, unsigned int uiFirstLane,
+                                         int fLuxCheck, double dZ, unsigned int* puiTested)
+{
+	const TEST_PLAN_LANE_T* ptLane;
+	const TEST_PLAN_ESTIMATE_T* ptEstimate;
+	unsigned int uiUndecided;
+	unsigned int uiTested;
+	unsigned int uiLane;
+	unsigned int uiValue;
+	int iInside;
+	int iCompare;
+	double dSamples;
+	double adHalfWidth[3];
+	double adLow[3];
+	double adHigh[3];
+
+
+	uiUndecided = 0;
+	uiTested = 0;
+
+	if( uiStep<ptPlan->uiSteps && uiDevice<ptPlan->uiDevices && uiFirstLane+TEST_PLAN_LANES<=ptSequential->uiLanes )
+	{
+		dSamples = (double)ptSequential->ulSamples;
+		ptLane = ptPlan->atLanes + ((size_t)uiStep * ptPlan->uiDevices + uiDevice) * TEST_PLAN_LANES;
+		ptEstimate = ptSequential->atEstimates + uiFirstLane;
+		for(uiLane=0; uiLane<TEST_PLAN_LANES; uiLane++)
+		{
+			if( (ptLane->ucFlags & TEST_PLAN_LANE_TESTED)!=0 )
+			{
+				uiTested |= 1U << uiLane;
+				if( ptSequential->ulSamples<2 )
+				{
+					uiUndecided |= 1U << uiLane;
+				}
+				else
+				{
+					for(uiValue=0; uiValue<3; uiValue++)
+					{
+						adHalfWidth[uiValue] = dZ * sqrt(ptEstimate->adM2[uiValue] / (dSamples - 1) / dSamples);
+					}
+					adLow[0] = (double)ptLane->fNm - ptLane->fTolNm;
+					adHigh[0] = (double)ptLane->fNm + ptLane->fTolNm;
+					adLow[1] = (double)ptLane->fSat - ptLane->fTolSat;
+					adHigh[1] = (double)ptLane->fSat + ptLane->fTolSat;
+					adLow[2] = (double)ptLane->fLux - ptLane->fTolLux;
+					adHigh[2] = (double)ptLane->fLux + ptLane->fTolLux;
+
+					/* One check which fails for sure decides the lane, a pass needs all of them. */
+					iInside = 1;
+					for(uiValue=0; uiValue<((fLuxCheck!=0) ? 3U : 2U); uiValue++)
+					{
+						iCompare = compare_interval(ptEstimate->adMean[uiValue], adHalfWidth[uiValue], adLow[uiValue], adHigh[uiValue]);
+						if( iCompare<0 )
+						{
+							iInside = -1;
+							break;
+						}
+						else if( iCompare==0 )
+						{
+							iInside = 0;
+						}
+					}
+					if( iInside==0 )
+					{
+						uiUndecided |= 1U << uiLane;
+					}
+				}
+			}
+			++ptLane;
+			++ptEstimate;
+		}
+	}
+
+	*puiTested = uiTested;
+
+	return uiUndecided;
+}
+
+
+
+/** \brief writes the rounded mean of the readings of all lanes, e.g. for the validation with test_plan_validate.
+	@param ptSequential		pointer to the state
+	@param ausClear			returns the mean clear readings, uiLanes elements
+	@param ausRed			returns the mean red readings
+	@param ausGreen			returns the mean green readings
+	@param ausBlue			returns the mean blue readings
+	*/
+void test_plan_sequential_mean(const TEST_PLAN_SEQUENTIAL_T* ptSequential, unsigned short* ausClear,
+                               unsigned short* ausRed, unsigned short* ausGreen, unsigned short* ausBlue)
+{
+	const TEST_PLAN_ESTIMATE_T* ptEstimate;
+	unsigned int uiIndex;
+	double dSamples;
+
+
+	if( ptSequential->ulSamples!=0 )
+	{
+		dSamples = (double)ptSequential->ulSamples;
+		ptEstimate = ptSequential->atEstimates;
+		for(uiIndex=0; uiIndex<ptSequential->uiLanes; uiIndex++)
+		{
+			ausClear[uiIndex] = (unsigned short)(ptEstimate->adSum[0] / dSamples + 0.5);
+			ausRed[uiIndex] = (unsigned short)(ptEstimate->adSum[1] / dSamples + 0.5);
+			ausGreen[uiIndex] = (unsigned short)(ptEstimate->adSum[2] / dSamples + 0.5);
+			ausBlue[uiIndex] = (unsigned short)(ptEstimate->adSum[3] / dSamples + 0.5);
+			++ptEstimate;
+		}
+	}
+}
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+ 
+
+
+
+/** \file test_plan.h
+
+	 \brief Compiled test plans for the validation of the lanes (header)
+
+A test plan holds the set points and tolerances of all lanes of all devices for a number of test steps in one flat array.
+It is compiled once from the test sets (see lua/test_plan.lua) and validates the converted colors of a measurement without
+walking any Lua tables. The checks are the same as in Color_validation:validateSensor in lua/color_validation.lua.
+
+A sequential test takes samples until the result of every tested lane is certain: after each sample the confidence
+interval of the mean of each checked value is compared with its tolerance band. A lane is decided when one interval is
+completely outside of its band (failed) or all of them are completely inside (passed).
+
+ */
+
+#ifndef __TEST_PLAN_H__
+#define __TEST_PLAN_H__
+
+#include "color_conversions.h"
+
+/** number of lanes of a device in a test plan */
+#define TEST_PLAN_LANES 16
+
+/** the lane has a test entry */
+#define TEST_PLAN_LANE_TESTED 0x01
+
+/* The failed checks of a lane, the same values as Color_validation.VALIDATION_* in lua/color_validation.lua. */
+/** the wavelength is out of range */
+#define TEST_PLAN_CHECK_NM       0x01
+/** the saturation is out of range */
+#define TEST_PLAN_CHECK_SAT      0x02
+/** the illumination is too low */
+#define TEST_PLAN_CHECK_LUX_LOW  0x04
+/** the illumination is too high */
+#define TEST_PLAN_CHECK_LUX_HIGH 0x08
+
+/** \brief set points and tolerances of one lane */
+typedef struct TEST_PLAN_LANE_STRUCT
+{
+	float fNm;
+	float fTolNm;
+	float fSat;
+	float fTolSat;
+	float fLux;
+	float fTolLux;
+	/** TEST_PLAN_LANE_* flags */
+	unsigned char ucFlags;
+	/** gain setting of the lane, only stored for the caller */
+	unsigned char ucGain;
+	/** integration time setting of the lane, only stored for the caller */
+	unsigned char ucIntegrationtime;
+	unsigned char ucReserved;
+} TEST_PLAN_LANE_T;
+
+/** \brief the lanes of all devices and steps, lane l of device d in step s is at index (s*uiDevices + d)*TEST_PLAN_LANES + l */
+typedef struct TEST_PLAN_STRUCT
+{
+	/** number of test steps */
+	unsigned int uiSteps;
+	/** number of devices per step */
+	unsigned int uiDevices;
+	/** uiSteps*uiDevices*TEST_PLAN_LANES lanes */
+	TEST_PLAN_LANE_T* atLanes;
+} TEST_PLAN_T;
+
+/** running estimates of one lane for the sequential test */
+typedef struct TEST_PLAN_ESTIMATE_STRUCT
+{
+	/** mean of nm, sat and lux of the samples */
+	double adMean[3];
+	/** sum of the squared differences from the mean of nm, sat and lux (Welford) */
+	double adM2[3];
+	/** sum of the clear, red, green and blue readings */
+	double adSum[4];
+} TEST_PLAN_ESTIMATE_T;
+
+/** state of a sequential test: the estimates of all lanes of all devices over the samples taken so far */
+typedef struct TEST_PLAN_SEQUENTIAL_STRUCT
+{
+	/** number of lanes, 16 per device */
+	unsigned int uiLanes;
+	/** number of samples added so far */
+	unsigned long ulSamples;
+	/** uiLanes estimates */
+	TEST_PLAN_ESTIMATE_T* atEstimates;
+	/** converted colors of the last sample */
+	COLOR_SPACES_T* ptColorSpaces;
+} TEST_PLAN_SEQUENTIAL_T;
+
+TEST_PLAN_T*      test_plan_new     (unsigned int uiSteps, unsigned int uiDevices);
+void              test_plan_free    (TEST_PLAN_T* ptPlan);
+TEST_PLAN_LANE_T* test_plan_get_lane(TEST_PLAN_T* ptPlan, unsigned int uiStep, unsigned int uiDevice, unsigned int uiLane);
+unsigned int      test_plan_validate(const TEST_PLAN_T* ptPlan, unsigned int uiStep, unsigned int uiDevice,
+                                     const COLOR_SPACES_T* ptColorSpaces, unsigned int uiFirstLane, int fLuxCheck,
+                                     unsigned int* puiTested, unsigned char* aucChecks);
+
+TEST_PLAN_SEQUENTIAL_T* test_plan_sequential_new   (unsigned int uiLanes);
+void                    test_plan_sequential_free  (TEST_PLAN_SEQUENTIAL_T* ptSequential);
+void                    test_plan_sequential_reset (TEST_PLAN_SEQUENTIAL_T* ptSequential);
+void                    test_plan_sequential_add   (TEST_PLAN_SEQUENTIAL_T* ptSequential, const unsigned short* ausClear,
+                                                    const unsigned short* ausRed, const unsigned short* ausGreen,
+                                                    const unsigned short* ausBlue, const unsigned char* aucIntegrationtime,
+                                                    const unsigned char* aucGain);
+unsigned int            test_plan_sequential_decide(const TEST_PLAN_SEQUENTIAL_T* ptSequential, const TEST_PLAN_T* ptPlan,
+                                                    unsigned int uiStep, unsigned int uiDevice, unsigned int uiFirstLane,
+                                                    int fLuxCheck, double dZ, unsigned int* puiTested);
+void                    test_plan_sequential_mean  (const TEST_PLAN_SEQUENTIAL_T* ptSequential, unsigned short* ausClear,
+                                                    unsigned short* ausRed, unsigned short* ausGreen, unsigned short* ausBlue);
+
+#endif	/* __TEST_PLAN_H__ */
@@ -0,0 +1,101 @@
+-- Compares the LuaJIT FFI binding (led_analyzer_ffi) with the SWIG module (led_analyzer).
+-- Both bindings use the same library, no device is needed. Run it with LuaJIT from the installation folder, so that
+-- require finds the led_analyzer module and the lua scripts:
+--
+--   luajit benchmark_ffi.lua [lanes] [rounds]
+--
+-- For every binding it measures the element access of the arrays, the element access of the views of a sample buffer
+-- and aus2colorTable. The times are printed per element or per call.
+
+local led_analyzer_swig = require "led_analyzer"
+local led_analyzer_ffi = require "led_analyzer_ffi"
+
+local uiLanes = tonumber(arg[1]) or 64
+local uiRounds = tonumber(arg[2]) or 10000
+
+-- runs fnBenchmark uiRounds times and returns the time of one round in microseconds
+local function measure(fnBenchmark)
+	-- warm up, this gives the JIT compiler a chance to compile the loop
+	for _ = 1, 100 do
+		fnBenchmark()
+	end
+
+	local tStart = os.clock()
+	for _ = 1, uiRounds do
+		fnBenchmark()
+	end
+	return (os.clock() - tStart) * 1000000 / uiRounds
+end
+
+local function benchmark(strName, led_analyzer)
+	local ausClear = led_analyzer.new_ushort(uiLanes)
+	local ausRed = led_analyzer.new_ushort(uiLanes)
+	local ausGreen = led_analyzer.new_ushort(uiLanes)
+	local ausBlue = led_analyzer.new_ushort(uiLanes)
+	local aucIntTimes = led_analyzer.new_puchar(uiLanes)
+	local aucGains = led_analyzer.new_puchar(uiLanes)
+
+	-- some plausible readings, all lanes are bright enough to get color values
+	for uiLane = 0, uiLanes - 1 do
+		led_analyzer.ushort_setitem(ausClear, uiLane, 20000 + uiLane)
+		led_analyzer.ushort_setitem(ausRed, uiLane, 9000 + uiLane)
+		led_analyzer.ushort_setitem(ausGreen, uiLane, 6000 + uiLane)
+		led_analyzer.ushort_setitem(ausBlue, uiLane, 4000 + uiLane)
+		led_analyzer.puchar_setitem(aucIntTimes, uiLane, 0xc0)
+		led_analyzer.puchar_setitem(aucGains, uiLane, 0x01)
+	end
+
+	local ushort_getitem = led_analyzer.ushort_getitem
+	local dArray =
+		measure(
+		function()
+			local uiSum = 0
+			for uiLane = 0, uiLanes - 1 do
+				uiSum = uiSum + ushort_getitem(ausClear, uiLane)
+			end
+			return uiSum
+		end
+	)
+
+	local tBuffer = led_analyzer.new_sample_buffer(math.ceil(uiLanes / 16))
+	local tClear = tBuffer.clear
+	local dView =
+		measure(
+		function()
+			local uiSum = 0
+			for uiLane = 1, uiLanes do
+				uiSum = uiSum + tClear[uiLane]
+			end
+			return uiSum
+		end
+	)
+	tBuffer:free()
+
+	local dConvert =
+		measure(
+		function()
+			return led_analyzer.aus2colorTable(ausClear, ausRed, ausGreen, ausBlue, aucIntTimes, aucGains, uiLanes)
+		end
+	)
+
+	print(
+		string.format(
+			"%-5s array read: %8.2f ns/element   view read: %8.2f ns/element   aus2colorTable: %8.2f us",
+			strName,
+			dArray * 1000 / uiLanes,
+			dView * 1000 / uiLanes,
+			dConvert
+		)
+	)
+
+	led_analyzer.delete_ushort(ausClear)
+	led_analyzer.delete_ushort(ausRed)
+	led_analyzer.delete_ushort(ausGreen)
+	led_analyzer.delete_ushort(ausBlue)
+	led_analyzer.delete_puchar(aucIntTimes)
+	led_analyzer.delete_puchar(aucGains)
+end
+
+print(string.format("%s, %d lanes, %d rounds", jit and jit.version or _VERSION, uiLanes, uiRounds))
+benchmark("SWIG", led_analyzer_swig)
+benchmark("FFI", led_analyzer_ffi)
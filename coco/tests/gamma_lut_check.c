@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+/** \file gamma_lut_check.c
+
+	 \brief Checks the sRGB gamma decoding table against pow and measures both
+
+The normalized colors are ratios of two 16 bit counts. This check decodes GAMMA_CHECK_POINTS equidistant values from 0.0
+to GAMMA_CHECK_END with color_srgb_decode (table) and color_srgb_decode_exact (pow). It fails if the absolute or the
+relative difference exceeds the bounds documented at color_srgb_decode. The time of both decodings is printed.
+
+ */
+
+#include "color_conversions.h"
+#include "timestamp_us.h"
+
+#include <math.h>
+#include <stdio.h>
+
+/** Number of decoded values, this is more than 100 values per table interval */
+#define GAMMA_CHECK_POINTS 1000000
+/** Upper end of the checked range, above the end of the table to include the pow branch */
+#define GAMMA_CHECK_END 2.5
+/** Maximum absolute difference of the table to pow */
+#define GAMMA_CHECK_MAX_ABS 1.2e-7
+/** Maximum relative difference of the table to pow */
+#define GAMMA_CHECK_MAX_REL 1.1e-5
+
+
+
+/** \brief decodes all check values with one decoding function and measures the time.
+	@param pfnDecode	decoding function
+	@param pdSum		stores the sum of all decoded values, this keeps the compiler from dropping the loop
+
+	@return 			time in microseconds
+	*/
+static unsigned long long time_decode(double (*pfnDecode)(double), double* pdSum)
+{
+	unsigned long long ullStart;
+	double dSum;
+	int i;
+
+
+	dSum = 0.0;
+	ullStart = timestamp_us();
+	for(i=0; i<GAMMA_CHECK_POINTS; i++)
+	{
+		dSum += pfnDecode(i * (GAMMA_CHECK_END / GAMMA_CHECK_POINTS));
+	}
+	*pdSum = dSum;
+
+	return timestamp_us() - ullStart;
+}
+
+
+
+int main(void)
+{
+	double dValue;
+	double dTable;
+	double dExact;
+	double dAbs;
+	double dMaxAbs;
+	double dMaxRel;
+	double dSumTable;
+	double dSumExact;
+	unsigned long long ullTable;
+	unsigned long long ullExact;
+	int i;
+
+
+	dMaxAbs = 0.0;
+	dMaxRel = 0.0;
+	for(i=0; i<=GAMMA_CHECK_POINTS; i++)
+	{
+		dValue = i * (GAMMA_CHECK_END / GAMMA_CHECK_POINTS);
+		dTable = color_srgb_decode(dValue);
+		dExact = color_srgb_decode_exact(dValue);
+		dAbs = fabs(dTable - dExact);
+		if( dAbs>dMaxAbs )
+		{
+			dMaxAbs = dAbs;
+		}
+		if( dExact>0.0 && dAbs/dExact>dMaxRel )
+		{
+			dMaxRel = dAbs / dExact;
+		}
+	}
+
+	ullTable = time_decode(color_srgb_decode, &dSumTable);
+	ullExact = time_decode(color_srgb_decode_exact, &dSumExact);
+
+	printf("checked %d values from 0.0 to %.1f\n", GAMMA_CHECK_POINTS + 1, GAMMA_CHECK_END);
+	printf("maximum absolute difference: %.3e (bound %.1e)\n", dMaxAbs, GAMMA_CHECK_MAX_ABS);
+	printf("maximum relative difference: %.3e (bound %.1e)\n", dMaxRel, GAMMA_CHECK_MAX_REL);
+	printf("table: %llu us, pow: %llu us (sums %.6f %.6f)\n", ullTable, ullExact, dSumTable, dSumExact);
+
+	if( dMaxAbs>GAMMA_CHECK_MAX_ABS || dMaxRel>GAMMA_CHECK_MAX_REL )
+	{
+		printf("The gamma decoding table exceeds its bounds!\n");
+		return 1;
+	}
+
+	return 0;
+}
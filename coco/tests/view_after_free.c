@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+/** \file view_after_free.c
+
+	 \brief Checks that the views of a freed sample buffer raise an error
+
+The check creates a sample buffer, keeps its clear view and frees the buffer. Every access to the view must raise a Lua error
+instead of reading the freed memory. The access with ipairs is only checked with Lua 5.3 and later, ipairs of Lua 5.1 ignores
+__index.
+
+ */
+
+#include "led_analyzer_lua.h"
+
+#include "lauxlib.h"
+#include "lualib.h"
+
+#include <stdio.h>
+
+/** Lua part of the check, it gets the sample buffer and returns the number of accesses which did not fail */
+static const char s_acCheck[] =
+	"local tBuffer = ...\n"
+	"local tClear = tBuffer.clear\n"
+	"local uiFailed = 0\n"
+	"if #tClear ~= 32 or tClear[1] ~= 0 then\n"
+	"  print('the view of the new buffer is wrong')\n"
+	"  uiFailed = uiFailed + 1\n"
+	"end\n"
+	"tBuffer:free()\n"
+	"local atAccess = {\n"
+	"  index   = function() return tClear[1] end,\n"
+	"  length  = function() return #tClear end,\n"
+	"  get     = function() return tClear:get(1) end,\n"
+	"  totable = function() return tClear:totable() end,\n"
+	"  buffer  = function() return tBuffer.red end\n"
+	"}\n"
+	"if _VERSION ~= 'Lua 5.1' and _VERSION ~= 'Lua 5.2' then\n"
+	"  atAccess.ipairs = function() for _ in ipairs(tClear) do end end\n"
+	"end\n"
+	"for strName, fnAccess in pairs(atAccess) do\n"
+	"  local fOk, strError = pcall(fnAccess)\n"
+	"  if fOk == true then\n"
+	"    print(string.format('%s of a freed buffer did not fail', strName))\n"
+	"    uiFailed = uiFailed + 1\n"
+	"  else\n"
+	"    print(string.format('%s: %s', strName, tostring(strError)))\n"
+	"  end\n"
+	"end\n"
+	"return uiFailed\n";
+
+
+
+int main(void)
+{
+	lua_State* L;
+	int iResult;
+
+
+	L = luaL_newstate();
+	if( L==NULL )
+	{
+		printf("Failed to create the Lua state.\n");
+		return 1;
+	}
+	luaL_openlibs(L);
+
+	iResult = luaL_loadstring(L, s_acCheck);
+	if( iResult==0 )
+	{
+		if( led_analyzer_push_sample_buffer(L, 2)==NULL )
+		{
+			printf("Failed to create the sample buffer.\n");
+			iResult = 1;
+		}
+		else
+		{
+			iResult = lua_pcall(L, 1, 1, 0);
+		}
+	}
+	if( iResult!=0 )
+	{
+		printf("The check failed: %s\n", lua_tostring(L, -1));
+	}
+	else if( lua_tonumber(L, -1)!=0 )
+	{
+		iResult = 1;
+	}
+	lua_close(L);
+
+	return iResult;
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by Subhan Waizi                                    *
+ *                                                                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef __TIMESTAMP_US_H__
+#define __TIMESTAMP_US_H__
+
+/** \file timestamp_us.h
+	\brief defines a monotonic microsecond timestamp which distinguishes between windows / linux
+
+This file provides a timestamp_us() function which returns a monotonic timestamp in microseconds. The timestamp
+has no defined starting point, only the difference of two timestamps is meaningful.
+*/
+
+#if defined(_WIN32)
+#       include <windows.h>
+static unsigned long long timestamp_us(void)
+{
+	LARGE_INTEGER tFrequency;
+	LARGE_INTEGER tCounter;
+
+	QueryPerformanceFrequency(&tFrequency);
+	QueryPerformanceCounter(&tCounter);
+	return (unsigned long long)((tCounter.QuadPart / tFrequency.QuadPart) * 1000000ULL
+	                          + ((tCounter.QuadPart % tFrequency.QuadPart) * 1000000ULL) / tFrequency.QuadPart);
+}
+#else
+#       include <time.h>
+static unsigned long long timestamp_us(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long long)tNow.tv_sec * 1000000ULL + (unsigned long long)tNow.tv_nsec / 1000ULL;
+}
+#endif
+
+
+#endif  /* __TIMESTAMP_US_H__ */
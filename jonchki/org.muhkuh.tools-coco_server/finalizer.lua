@@ -8,7 +8,18 @@ t:install{
   ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/CoCo_server.lua'] = '${install_base}/',
   ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/color_control.lua'] = '${install_base}/lua/',
   ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/color_conversions.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/color_validation.lua'] = '${install_base}/lua/',
   ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/tcs_chromaTable.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/led_analyzer_ffi.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/result_frame.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/coco_protocol.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/coco_scheduler.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/coco_worker.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/test_plan.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/measurement_log.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/coco_statistics.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/dark_offset.lua'] = '${install_base}/lua/',
+  ['${depack_path_org.muhkuh.lua.coco.lua5.4-coco}/lua/exposure_plan.lua'] = '${install_base}/lua/',
   ['${report_path}']                                       = '${install_base}/.jonchki/'
 }
 